@@ -0,0 +1,618 @@
+/*---------------------------------------------------------------------------------
+--	SOURCE FILE:	Capture.cpp -
+--
+--	PROGRAM:		Transport Layer Protocol Analyser
+--
+--	FUNCTIONS:
+--					BOOL openCapture(HANDLE file, PLACEMENT *placement)
+--					void captureUdp(SOCKADDR_IN *source, SOCKADDR_IN *destination, char *data, DWORD length)
+--					void captureTcp(SOCKADDR_IN *source, SOCKADDR_IN *destination, DWORD sequence, char *data, DWORD length)
+--					void getCaptureStats(CAPTURE_STATS *stats)
+--					void closeCapture()
+--					void captureRecord(BYTE protocol, SOCKADDR_IN *source, SOCKADDR_IN *destination, DWORD sequence, char *data, DWORD length)
+--					char *reserveRecord(DWORD size)
+--					ULONGLONG captureTime()
+--					WORD ipChecksum(BYTE *header, int length)
+--					DWORD WINAPI captureWriter(LPVOID)
+--
+--	DATE:			Oct 19, 2026
+--
+--	REVISIONS:		Oct 19, 2026
+--
+--	DESIGNER:		Gabriella Cheung
+--
+--	PROGRAMMER:		Gabriella Cheung
+--
+--	NOTES:
+--	This file writes received traffic to a pcapng file that Wireshark and tcpdump
+--  can open. Winsock only hands the server payloads, so every packet is given a
+--  synthesized Ethernet, IPv4 and UDP or TCP header carrying the real peer
+--  address and ports. TCP receives are numbered by their offset in the stream,
+--  so the capture reassembles the same way the server read it. Checksums in the
+--  UDP and TCP headers are left at zero.
+--
+--  Timestamps are in nanoseconds (if_tsresol 9). The wall clock is read once
+--  when the capture opens and QueryPerformanceCounter gives the time since.
+--
+--  Receive threads copy records into one of CAPTURE_BUFFERS large buffers under
+--  a critical section. Full buffers are passed to a writer thread, so receive
+--  threads never wait on the disk. If every buffer is still waiting to be
+--  written, the packet is counted as dropped instead of stalling the receive.
+--
+---------------------------------------------------------------------------------*/
+#include "resource.h"
+
+#define PCAPNG_SECTION_HEADER	0x0A0D0D0A
+#define PCAPNG_INTERFACE		0x00000001
+#define PCAPNG_ENHANCED_PACKET	0x00000006
+#define PCAPNG_BYTE_ORDER		0x1A2B3C4D
+#define PCAPNG_TSRESOL			9
+#define FILETIME_UNIX_EPOCH		116444736000000000ULL
+
+#pragma pack(push, 1)
+typedef struct _ETHERNET_HEADER {
+	BYTE destination[6];
+	BYTE source[6];
+	WORD type;
+} ETHERNET_HEADER;
+
+typedef struct _PACKET_BLOCK {
+	DWORD type;
+	DWORD length;
+	DWORD interfaceId;
+	DWORD timestampHigh;
+	DWORD timestampLow;
+	DWORD capturedLength;
+	DWORD originalLength;
+} PACKET_BLOCK;
+#pragma pack(pop)
+
+typedef struct _CAPTURE {
+	HANDLE file;
+	HANDLE writer;
+	HANDLE filled;				// buffers waiting for the writer thread
+	HANDLE empty;				// buffers the receive threads may fill next
+	CRITICAL_SECTION lock;
+	char *buffers[CAPTURE_BUFFERS];
+	DWORD used[CAPTURE_BUFFERS];
+	int current;				// buffer the receive threads are filling
+	int writing;				// next buffer the writer thread will write
+	BOOL stopping;
+	WORD nextId;
+	ULONGLONG startTime;		// ns since 1970 when the capture opened
+	LARGE_INTEGER startCounter;
+	LARGE_INTEGER frequency;
+	CAPTURE_STATS stats;
+} CAPTURE;
+
+void captureRecord(BYTE, SOCKADDR_IN *, SOCKADDR_IN *, DWORD, char *, DWORD);
+char *reserveRecord(DWORD);
+ULONGLONG captureTime();
+WORD ipChecksum(BYTE *, int);
+DWORD WINAPI captureWriter(LPVOID);
+
+static CAPTURE capture;
+static BOOL captureOpen = false;
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: openCapture
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--				Oct 19, 2026 - NUMA-local buffers and a pinned writer thread
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	BOOL openCapture(HANDLE file, PLACEMENT *placement)
+--
+--	PARAMETERS:	HANDLE file - file opened for writing by the server setup dialog
+--				PLACEMENT *placement - CPUs for the writer thread
+--
+--	RETURNS:	TRUE if the capture is ready, FALSE otherwise
+--
+--	NOTES:
+--	This function empties the file, queues the section header and interface
+--  description blocks, and starts the writer thread. The buffers come from the
+--  placement's NUMA node.
+--
+---------------------------------------------------------------------------------*/
+BOOL openCapture(HANDLE file, PLACEMENT *placement)
+{
+	FILETIME fileTime;
+	ULARGE_INTEGER now;
+	DWORD *block;
+	WORD *linkType;
+
+	if (captureOpen || file == NULL)
+	{
+		return FALSE;
+	}
+	ZeroMemory(&capture, sizeof(CAPTURE));
+	for (int i = 0; i < CAPTURE_BUFFERS; i++)
+	{
+		if ((capture.buffers[i] = (char *)nodeAlloc(CAPTURE_BUFFER_SIZE)) == NULL)
+		{
+			writeToScreen("Unable to allocate capture buffers");
+			for (int j = 0; j < i; j++)
+			{
+				VirtualFree(capture.buffers[j], 0, MEM_RELEASE);
+			}
+			return FALSE;
+		}
+	}
+	SetFilePointer(file, 0, NULL, FILE_BEGIN);
+	SetEndOfFile(file);
+	capture.file = file;
+	capture.filled = CreateSemaphore(NULL, 0, CAPTURE_BUFFERS, NULL);
+	capture.empty = CreateSemaphore(NULL, CAPTURE_BUFFERS - 1, CAPTURE_BUFFERS, NULL);
+	InitializeCriticalSection(&capture.lock);
+
+	QueryPerformanceFrequency(&capture.frequency);
+	QueryPerformanceCounter(&capture.startCounter);
+	GetSystemTimeAsFileTime(&fileTime);
+	now.LowPart = fileTime.dwLowDateTime;
+	now.HighPart = fileTime.dwHighDateTime;
+	capture.startTime = (now.QuadPart - FILETIME_UNIX_EPOCH) * 100;
+
+	//section header block, section length unknown
+	block = (DWORD *)capture.buffers[0];
+	block[0] = PCAPNG_SECTION_HEADER;
+	block[1] = 28;
+	block[2] = PCAPNG_BYTE_ORDER;
+	block[3] = 1;				// major 1, minor 0
+	block[4] = 0xFFFFFFFF;
+	block[5] = 0xFFFFFFFF;
+	block[6] = 28;
+
+	//interface description block with nanosecond timestamps
+	block += 7;
+	block[0] = PCAPNG_INTERFACE;
+	block[1] = 32;
+	linkType = (WORD *)&block[2];
+	linkType[0] = LINKTYPE_ETHERNET;
+	linkType[1] = 0;
+	block[3] = CAPTURE_SNAPLEN;
+	block[4] = 9 | (1 << 16);	// if_tsresol, one byte
+	block[5] = PCAPNG_TSRESOL;
+	block[6] = 0;				// opt_endofopt
+	block[7] = 32;
+	capture.used[0] = 28 + 32;
+	capture.stats.bytes = capture.used[0];
+
+	if ((capture.writer = CreateThread(NULL, 0, captureWriter, NULL, 0, NULL)) == NULL)
+	{
+		writeToScreen("Unable to start capture writer");
+		CloseHandle(capture.filled);
+		CloseHandle(capture.empty);
+		DeleteCriticalSection(&capture.lock);
+		for (int i = 0; i < CAPTURE_BUFFERS; i++)
+		{
+			VirtualFree(capture.buffers[i], 0, MEM_RELEASE);
+		}
+		return FALSE;
+	}
+	placeThread(capture.writer, placement, PLACE_WRITER);
+	captureOpen = true;
+	return TRUE;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: captureUdp
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void captureUdp(SOCKADDR_IN *source, SOCKADDR_IN *destination, char *data, DWORD length)
+--
+--	PARAMETERS:	SOCKADDR_IN *source - peer address from WSARecvFrom
+--				SOCKADDR_IN *destination - address the server received on
+--				char *data - datagram payload
+--				DWORD length - payload length in bytes
+--
+--	RETURNS:	none
+--
+--	NOTES:
+--	Records one received datagram.
+--
+---------------------------------------------------------------------------------*/
+void captureUdp(SOCKADDR_IN *source, SOCKADDR_IN *destination, char *data, DWORD length)
+{
+	captureRecord(IPPROTO_UDP, source, destination, 0, data, length);
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: captureTcp
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void captureTcp(SOCKADDR_IN *source, SOCKADDR_IN *destination, DWORD sequence, char *data, DWORD length)
+--
+--	PARAMETERS:	SOCKADDR_IN *source - peer address from accept
+--				SOCKADDR_IN *destination - local address of the connection
+--				DWORD sequence - bytes received on the connection before this read
+--				char *data - bytes returned by the read
+--				DWORD length - number of bytes read
+--
+--	RETURNS:	none
+--
+--	NOTES:
+--	Records one read from a TCP connection as a single segment. A read can hold
+--  several wire segments; the capture shows what the server saw, not how the
+--  sender's stack cut the stream.
+--
+---------------------------------------------------------------------------------*/
+void captureTcp(SOCKADDR_IN *source, SOCKADDR_IN *destination, DWORD sequence, char *data, DWORD length)
+{
+	captureRecord(IPPROTO_TCP, source, destination, sequence, data, length);
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: getCaptureStats
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void getCaptureStats(CAPTURE_STATS *stats)
+--
+--	PARAMETERS:	CAPTURE_STATS *stats - receives the counters
+--
+--	RETURNS:	none
+--
+--	NOTES:
+--	Fills the structure with zeros if no capture is open.
+--
+---------------------------------------------------------------------------------*/
+void getCaptureStats(CAPTURE_STATS *stats)
+{
+	if (!captureOpen)
+	{
+		ZeroMemory(stats, sizeof(CAPTURE_STATS));
+		return;
+	}
+	EnterCriticalSection(&capture.lock);
+	*stats = capture.stats;
+	LeaveCriticalSection(&capture.lock);
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: closeCapture
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void closeCapture()
+--
+--	PARAMETERS:	none
+--
+--	RETURNS:	none
+--
+--	NOTES:
+--	Hands the partly filled buffer to the writer thread and waits for it to
+--  finish. The file itself is closed by the caller.
+--
+---------------------------------------------------------------------------------*/
+void closeCapture()
+{
+	if (!captureOpen)
+	{
+		return;
+	}
+	EnterCriticalSection(&capture.lock);
+	capture.stopping = true;
+	ReleaseSemaphore(capture.filled, 1, NULL);
+	LeaveCriticalSection(&capture.lock);
+
+	WaitForSingleObject(capture.writer, INFINITE);
+	CloseHandle(capture.writer);
+	CloseHandle(capture.filled);
+	CloseHandle(capture.empty);
+	DeleteCriticalSection(&capture.lock);
+	for (int i = 0; i < CAPTURE_BUFFERS; i++)
+	{
+		VirtualFree(capture.buffers[i], 0, MEM_RELEASE);
+	}
+	captureOpen = false;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: captureRecord
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void captureRecord(BYTE protocol, SOCKADDR_IN *source, SOCKADDR_IN *destination,
+--					DWORD sequence, char *data, DWORD length)
+--
+--	PARAMETERS:	BYTE protocol - IPPROTO_UDP or IPPROTO_TCP
+--				SOCKADDR_IN *source - sender of the data
+--				SOCKADDR_IN *destination - receiver of the data
+--				DWORD sequence - TCP sequence number, ignored for UDP
+--				char *data - payload
+--				DWORD length - payload length in bytes
+--
+--	RETURNS:	none
+--
+--	NOTES:
+--	Builds an enhanced packet block in place in the current buffer, so the
+--  payload is copied once.
+--
+---------------------------------------------------------------------------------*/
+void captureRecord(BYTE protocol, SOCKADDR_IN *source, SOCKADDR_IN *destination, DWORD sequence, char *data, DWORD length)
+{
+	static const BYTE serverMac[6] = { 0x02, 0, 0, 0, 0, 0x01 };
+	static const BYTE clientMac[6] = { 0x02, 0, 0, 0, 0, 0x02 };
+	DWORD transport = protocol == IPPROTO_TCP ? sizeof(TCP_HEADER) : sizeof(UDP_HEADER);
+	DWORD packetLength = sizeof(ETHERNET_HEADER) + sizeof(IP_HEADER) + transport + length;
+	DWORD blockLength = sizeof(PACKET_BLOCK) + ((packetLength + 3) & ~3) + sizeof(DWORD);
+	ULONGLONG timestamp;
+	PACKET_BLOCK *block;
+	ETHERNET_HEADER *ethernet;
+	IP_HEADER *ip;
+	char *record;
+
+	if (!captureOpen || packetLength > 0xFFFF + sizeof(ETHERNET_HEADER))
+	{
+		return;
+	}
+	timestamp = captureTime();
+
+	EnterCriticalSection(&capture.lock);
+	if ((record = reserveRecord(blockLength)) == NULL)
+	{
+		capture.stats.dropped++;
+		LeaveCriticalSection(&capture.lock);
+		return;
+	}
+
+	block = (PACKET_BLOCK *)record;
+	block->type = PCAPNG_ENHANCED_PACKET;
+	block->length = blockLength;
+	block->interfaceId = 0;
+	block->timestampHigh = (DWORD)(timestamp >> 32);
+	block->timestampLow = (DWORD)timestamp;
+	block->capturedLength = packetLength;
+	block->originalLength = packetLength;
+
+	ethernet = (ETHERNET_HEADER *)(block + 1);
+	memcpy(ethernet->destination, serverMac, 6);
+	memcpy(ethernet->source, clientMac, 6);
+	ethernet->type = htons(0x0800);
+
+	ip = (IP_HEADER *)(ethernet + 1);
+	ip->versionLength = 0x45;
+	ip->tos = 0;
+	ip->totalLength = htons((WORD)(packetLength - sizeof(ETHERNET_HEADER)));
+	ip->id = htons(capture.nextId++);
+	ip->fragment = htons(0x4000);	// don't fragment
+	ip->ttl = 64;
+	ip->protocol = protocol;
+	ip->checksum = 0;
+	ip->source = source->sin_addr.s_addr;
+	ip->destination = destination->sin_addr.s_addr;
+	ip->checksum = ipChecksum((BYTE *)ip, sizeof(IP_HEADER));
+
+	if (protocol == IPPROTO_TCP)
+	{
+		TCP_HEADER *tcp = (TCP_HEADER *)(ip + 1);
+		tcp->sourcePort = source->sin_port;
+		tcp->destinationPort = destination->sin_port;
+		tcp->sequence = htonl(sequence);
+		tcp->acknowledgement = 0;
+		tcp->offset = (sizeof(TCP_HEADER) / 4) << 4;
+		tcp->flags = 0x18;			// PSH, ACK
+		tcp->window = htons(0xFFFF);
+		tcp->checksum = 0;
+		tcp->urgent = 0;
+	}
+	else {
+		UDP_HEADER *udp = (UDP_HEADER *)(ip + 1);
+		udp->sourcePort = source->sin_port;
+		udp->destinationPort = destination->sin_port;
+		udp->length = htons((WORD)(sizeof(UDP_HEADER) + length));
+		udp->checksum = 0;
+	}
+	record = (char *)(ip + 1) + transport;
+	memcpy(record, data, length);
+	record += length;
+	//pad the packet data to 32 bits and close the block
+	while ((record - (char *)block) & 3)
+	{
+		*record++ = 0;
+	}
+	*(DWORD *)record = blockLength;
+
+	capture.stats.records++;
+	capture.stats.bytes += blockLength;
+	LeaveCriticalSection(&capture.lock);
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: reserveRecord
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	char *reserveRecord(DWORD size)
+--
+--	PARAMETERS:	DWORD size - bytes needed for the block
+--
+--	RETURNS:	where to build the block, or NULL if no buffer is free
+--
+--	NOTES:
+--	Called with the capture lock held. When the current buffer cannot hold the
+--  block, it is passed to the writer thread and the next buffer is taken, but
+--  only if the writer has already emptied it.
+--
+---------------------------------------------------------------------------------*/
+char *reserveRecord(DWORD size)
+{
+	char *record;
+
+	if (capture.stopping)
+	{
+		return NULL;
+	}
+	if (capture.used[capture.current] + size > CAPTURE_BUFFER_SIZE)
+	{
+		if (WaitForSingleObject(capture.empty, 0) != WAIT_OBJECT_0)
+		{
+			return NULL;
+		}
+		ReleaseSemaphore(capture.filled, 1, NULL);
+		capture.current = (capture.current + 1) % CAPTURE_BUFFERS;
+	}
+	record = capture.buffers[capture.current] + capture.used[capture.current];
+	capture.used[capture.current] += size;
+	return record;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: captureTime
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	ULONGLONG captureTime()
+--
+--	PARAMETERS:	none
+--
+--	RETURNS:	nanoseconds since 1970
+--
+--	NOTES:
+--	Whole seconds and the remainder are scaled separately so the multiplication
+--  does not overflow however long the capture runs.
+--
+---------------------------------------------------------------------------------*/
+ULONGLONG captureTime()
+{
+	LARGE_INTEGER counter;
+	ULONGLONG ticks;
+
+	QueryPerformanceCounter(&counter);
+	ticks = counter.QuadPart - capture.startCounter.QuadPart;
+	return capture.startTime + (ticks / capture.frequency.QuadPart) * 1000000000ULL
+		+ (ticks % capture.frequency.QuadPart) * 1000000000ULL / capture.frequency.QuadPart;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: ipChecksum
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	WORD ipChecksum(BYTE *header, int length)
+--
+--	PARAMETERS:	BYTE *header - IPv4 header with its checksum field zeroed
+--				int length - header length in bytes
+--
+--	RETURNS:	the header checksum, ready to store
+--
+--	NOTES:
+--	Standard ones' complement sum over 16-bit words.
+--
+---------------------------------------------------------------------------------*/
+WORD ipChecksum(BYTE *header, int length)
+{
+	DWORD sum = 0;
+
+	for (int i = 0; i < length; i += 2)
+	{
+		sum += (header[i] << 8) | header[i + 1];
+	}
+	while (sum >> 16)
+	{
+		sum = (sum & 0xFFFF) + (sum >> 16);
+	}
+	return htons((WORD)~sum);
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: captureWriter
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	DWORD WINAPI captureWriter(LPVOID n)
+--
+--	PARAMETERS:	LPVOID n - unused
+--
+--	RETURNS:	DWORD
+--
+--	NOTES:
+--	Writes buffers in the order they were filled. After closeCapture hands over
+--  the last buffer, the thread writes it and exits.
+--
+---------------------------------------------------------------------------------*/
+DWORD WINAPI captureWriter(LPVOID n)
+{
+	int index;
+	BOOL last;
+
+	while (true)
+	{
+		WaitForSingleObject(capture.filled, INFINITE);
+		index = capture.writing;
+		last = capture.stopping && index == capture.current;
+		if (capture.used[index] > 0 && !writeDataToFile(capture.file, capture.buffers[index], capture.used[index]))
+		{
+			writeToScreen("Writing capture file failed");
+		}
+		capture.used[index] = 0;
+		capture.writing = (index + 1) % CAPTURE_BUFFERS;
+		if (last)
+		{
+			break;
+		}
+		ReleaseSemaphore(capture.empty, 1, NULL);
+	}
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,53 @@
+#pragma once
+
+#define CAPTURE_BUFFERS			8
+#define CAPTURE_BUFFER_SIZE		(1024*1024)	//bytes handed to the writer thread at a time
+#define CAPTURE_SNAPLEN			262144
+#define LINKTYPE_ETHERNET		1
+
+// Wire headers, written by the capture and read by the passive capture
+#pragma pack(push, 1)
+typedef struct _IP_HEADER {
+	BYTE versionLength;
+	BYTE tos;
+	WORD totalLength;
+	WORD id;
+	WORD fragment;
+	BYTE ttl;
+	BYTE protocol;
+	WORD checksum;
+	DWORD source;
+	DWORD destination;
+} IP_HEADER;
+
+typedef struct _UDP_HEADER {
+	WORD sourcePort;
+	WORD destinationPort;
+	WORD length;
+	WORD checksum;
+} UDP_HEADER;
+
+typedef struct _TCP_HEADER {
+	WORD sourcePort;
+	WORD destinationPort;
+	DWORD sequence;
+	DWORD acknowledgement;
+	BYTE offset;
+	BYTE flags;
+	WORD window;
+	WORD checksum;
+	WORD urgent;
+} TCP_HEADER;
+#pragma pack(pop)
+
+typedef struct _CAPTURE_STATS {
+	ULONGLONG records;			// packets written or queued for writing
+	ULONGLONG bytes;			// pcapng bytes written or queued for writing
+	LONG dropped;				// packets skipped because every buffer was waiting on the disk
+} CAPTURE_STATS;
+
+BOOL openCapture(HANDLE, PLACEMENT *);
+void captureUdp(SOCKADDR_IN *, SOCKADDR_IN *, char *, DWORD);
+void captureTcp(SOCKADDR_IN *, SOCKADDR_IN *, DWORD, char *, DWORD);
+void getCaptureStats(CAPTURE_STATS *);
+void closeCapture();
\ No newline at end of file
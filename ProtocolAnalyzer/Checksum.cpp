@@ -0,0 +1,180 @@
+/*---------------------------------------------------------------------------------
+--	SOURCE FILE:	Checksum.cpp -
+--
+--	PROGRAM:		Transport Layer Protocol Analyser
+--
+--	FUNCTIONS:
+--					void initChecksum()
+--					DWORD crc32c(DWORD crc, const char *data, DWORD length)
+--					char *checksumMethod()
+--
+--	DATE:			Oct 19, 2026
+--
+--	REVISIONS:		Oct 19, 2026
+--
+--	DESIGNER:		Gabriella Cheung
+--
+--	PROGRAMMER:		Gabriella Cheung
+--
+--	NOTES:
+--	This file contains the CRC32C used to stamp and verify messages in integrity
+--  mode. Processors with SSE4.2 compute it with the crc32 instruction; older
+--  ones use a slicing-by-8 table, which reads eight bytes per step from eight
+--  256-entry tables.
+--
+--  The crc32 instruction has a latency of three cycles and each step depends on
+--  the one before, so one stream of 8-byte steps runs at a little under three
+--  bytes per cycle. That is several GB/s on any SSE4.2 processor, well above the
+--  1.25 GB/s of a 10 Gbit/s link, so the data is not split into parallel streams.
+--
+---------------------------------------------------------------------------------*/
+#include "resource.h"
+
+static DWORD crcTable[8][256];
+static BOOL hardware = false;
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: initChecksum
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void initChecksum()
+--
+--	PARAMETERS:	none
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	Builds the tables and checks cpuid for SSE4.2. It is called once at start up,
+--  before any thread computes a checksum.
+--
+---------------------------------------------------------------------------------*/
+void initChecksum()
+{
+	int info[4];
+	DWORD crc;
+
+	for (int i = 0; i < 256; i++)
+	{
+		crc = i;
+		for (int bit = 0; bit < 8; bit++)
+		{
+			crc = crc & 1 ? (crc >> 1) ^ CRC32C_POLYNOMIAL : crc >> 1;
+		}
+		crcTable[0][i] = crc;
+	}
+	//table t advances a byte through t more zero bytes
+	for (int i = 0; i < 256; i++)
+	{
+		for (int t = 1; t < 8; t++)
+		{
+			crcTable[t][i] = (crcTable[t - 1][i] >> 8) ^ crcTable[0][crcTable[t - 1][i] & 0xFF];
+		}
+	}
+
+	__cpuid(info, 1);
+	hardware = (info[2] & (1 << 20)) != 0;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: crc32c
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	DWORD crc32c(DWORD crc, const char *data, DWORD length)
+--
+--	PARAMETERS:	DWORD crc - 0, or the result of the previous call for the same
+--						message
+--				const char *data - bytes to add
+--				DWORD length - number of bytes in data
+--
+--	RETURNS:	the CRC32C of everything passed so far
+--
+--	NOTES:
+--	A message received in pieces can be checked by passing each piece in turn.
+--  Leading bytes are handled one at a time until data is 8-byte aligned.
+--
+---------------------------------------------------------------------------------*/
+DWORD crc32c(DWORD crc, const char *data, DWORD length)
+{
+	const unsigned char *next = (const unsigned char *)data;
+	DWORD low, high;
+
+	crc = ~crc;
+	while (length > 0 && ((ULONG_PTR)next & 7) != 0)
+	{
+		crc = hardware ? _mm_crc32_u8(crc, *next) : crcTable[0][(crc ^ *next) & 0xFF] ^ (crc >> 8);
+		next++;
+		length--;
+	}
+	if (hardware)
+	{
+#ifdef _M_X64
+		ULONGLONG wide = crc;
+		for (; length >= 8; next += 8, length -= 8)
+		{
+			wide = _mm_crc32_u64(wide, *(const ULONGLONG *)next);
+		}
+		crc = (DWORD)wide;
+#else
+		for (; length >= 4; next += 4, length -= 4)
+		{
+			crc = _mm_crc32_u32(crc, *(const DWORD *)next);
+		}
+#endif
+	}
+	else {
+		for (; length >= 8; next += 8, length -= 8)
+		{
+			low = *(const DWORD *)next ^ crc;
+			high = *(const DWORD *)(next + 4);
+			crc = crcTable[7][low & 0xFF] ^ crcTable[6][(low >> 8) & 0xFF]
+				^ crcTable[5][(low >> 16) & 0xFF] ^ crcTable[4][low >> 24]
+				^ crcTable[3][high & 0xFF] ^ crcTable[2][(high >> 8) & 0xFF]
+				^ crcTable[1][(high >> 16) & 0xFF] ^ crcTable[0][high >> 24];
+		}
+	}
+	for (; length > 0; next++, length--)
+	{
+		crc = hardware ? _mm_crc32_u8(crc, *next) : crcTable[0][(crc ^ *next) & 0xFF] ^ (crc >> 8);
+	}
+	return ~crc;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: checksumMethod
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	char *checksumMethod()
+--
+--	PARAMETERS:	none
+--
+--	RETURNS:	a short name for the way crc32c is computed on this machine
+--
+--	NOTES:
+--	For the server's report.
+--
+---------------------------------------------------------------------------------*/
+char *checksumMethod()
+{
+	return hardware ? "SSE4.2" : "table";
+}
\ No newline at end of file
@@ -0,0 +1,7 @@
+#pragma once
+
+#define CRC32C_POLYNOMIAL		0x82F63B78	//Castagnoli, reflected
+
+void initChecksum();
+DWORD crc32c(DWORD, const char *, DWORD);
+char *checksumMethod();
\ No newline at end of file
@@ -4,12 +4,23 @@
 --	PROGRAM:		Transport Layer Protocol Analyser
 --
 --	FUNCTIONS:
---					void sendViaUDP(char * hostname, int port, int packetSize, int repetition, HANDLE file, HANDLE logFile)
---					void sendViaTCP(char * hostname, int port, int packetSize, int repetition, HANDLE file, HANDLE logFile)
+--					BOOL startTransfer(CLIENT_TRANSFER *transfer)
+--					DWORD WINAPI transferThread(LPVOID lpParameter)
+--					void stopTransfer()
+--					void sendViaUDP(char * hostname, int port, int packetSize, int repetition, HANDLE file, HANDLE logFile, CLIENT_OPTIONS *options)
+--					void sendViaTCP(char * hostname, int port, int packetSize, int repetition, HANDLE file, HANDLE logFile, CLIENT_OPTIONS *options)
+--					void closeSend(SOCKET sd, HANDLE file, char *buffer, TRAFFIC_PROFILE *profile, IMPAIRMENT *impair, int congestionPort, HANDLE logFile)
+--					void sendReplay(SOCKET sd, struct sockaddr_in *server, HANDLE file, int protocol, int passes, double speed, HANDLE logFile)
+--					void logSizes(STATS_COUNTERS *sizes, HANDLE logFile)
+--					void startWindow(SEND_WINDOW *window, int duration, int warmup, int cooldown)
+--					BOOL sending(SEND_WINDOW *window, int sent, int repetition)
+--					void countSend(SEND_WINDOW *window, int length)
+--					void logWindow(SEND_WINDOW *window, HANDLE logFile)
 --
 --	DATE:			Feb 14, 2016
 --
 --	REVISIONS:		Feb 14, 2016
+--					Oct 19, 2026 - transfers run on their own thread
 --
 --	DESIGNER:		Gabriella Cheung
 --
@@ -17,24 +28,190 @@
 --
 --	NOTES:
 --	This file contains the code for the client part of the application. When the user
---  starts a data transfer to a server, DialogProc (from Main.cpp) will call either
---  sendViaUDP or sendViaTCP to send data to a server.
+--  starts a data transfer to a server, DialogProc (from Main.cpp) will call
+--  startTransfer, whose thread calls either sendViaUDP or sendViaTCP to send data
+--  to a server, so the window keeps working while it runs. stopTransfer ends it
+--  early, when the program exits or becomes a server.
 --
 ---------------------------------------------------------------------------------*/
 #include "resource.h"
 
+volatile LONG transferRunning;		//a transfer thread has not finished yet
+volatile BOOL transferStopping;		//set by stopTransfer
+HANDLE transferHandle;				//latest transfer thread, NULL if none was started
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: startTransfer
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--				Oct 19, 2026 - keeps the thread's handle
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	BOOL startTransfer(CLIENT_TRANSFER *transfer)
+--
+--	PARAMETERS:	CLIENT_TRANSFER *transfer - malloc'd transfer settings
+--
+--	RETURNS:	TRUE if the transfer thread was started, and owns the transfer
+--
+--	NOTES:
+--	Only one transfer runs at a time, since they share the client log and
+--  the screen. The caller keeps the transfer, and its file, on FALSE. The
+--  thread's handle is kept for stopTransfer until the next transfer starts.
+--
+---------------------------------------------------------------------------------*/
+BOOL startTransfer(CLIENT_TRANSFER *transfer)
+{
+	if (InterlockedCompareExchange(&transferRunning, 1, 0) != 0)
+	{
+		return FALSE;
+	}
+	if (transferHandle != NULL)
+	{
+		CloseHandle(transferHandle);
+	}
+	if ((transferHandle = CreateThread(NULL, 0, transferThread, transfer, 0, NULL)) == NULL)
+	{
+		InterlockedExchange(&transferRunning, 0);
+		return FALSE;
+	}
+	return TRUE;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: transferThread
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--				Oct 19, 2026 - retires its context switches
+--				Oct 19, 2026 - named in traces, and gives its ring back
+--				Oct 19, 2026 - gives its pool cache back
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	DWORD WINAPI transferThread(LPVOID lpParameter)
+--
+--	PARAMETERS:	LPVOID lpParameter - the CLIENT_TRANSFER to run
+--
+--	RETURNS:	0
+--
+--	NOTES:
+--	Runs the simulated clients in Swarm.cpp or the matrix in Congestion.cpp when
+--  the options ask for them, which do not read the source file, and otherwise
+--  one transfer, which closes it.
+--
+---------------------------------------------------------------------------------*/
+DWORD WINAPI transferThread(LPVOID lpParameter)
+{
+	CLIENT_TRANSFER *transfer = (CLIENT_TRANSFER *)lpParameter;
+
+	TRACE_THREAD("client transfer");
+	if (transfer->options.swarm[0] != '\0' || transfer->options.matrix[0] != '\0')
+	{
+		if (transfer->options.swarm[0] != '\0')
+		{
+			runSwarm(transfer->hostname, transfer->port, transfer->packetSize, transfer->repetition, transfer->logFile, &(transfer->options));
+		}
+		else {
+			runMatrix(transfer->hostname, transfer->port, transfer->packetSize, transfer->repetition, transfer->logFile, &(transfer->options));
+		}
+		if (transfer->file != NULL)
+		{
+			closeFile(transfer->file);
+		}
+	}
+	else if (transfer->tcp)
+	{
+		sendViaTCP(transfer->hostname, transfer->port, transfer->packetSize, transfer->repetition, transfer->file, transfer->logFile, &(transfer->options));
+	}
+	else {
+		sendViaUDP(transfer->hostname, transfer->port, transfer->packetSize, transfer->repetition, transfer->file, transfer->logFile, &(transfer->options));
+	}
+	free(transfer);
+	TRACE_RELEASE();
+	releasePool();
+	retireThread();
+	InterlockedExchange(&transferRunning, 0);
+	return 0;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: stopTransfer
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void stopTransfer()
+--
+--	PARAMETERS:	none
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	Called from the window thread. Asks the transfer to stop sending and waits
+--  for its thread, which still writes its totals to the screen and the client
+--  log, so the log must stay open until this returns.
+--
+---------------------------------------------------------------------------------*/
+void stopTransfer()
+{
+	if (transferHandle == NULL)
+	{
+		return;
+	}
+	if (transferRunning != 0)
+	{
+		writeToScreen("Stopping the transfer");
+	}
+	transferStopping = TRUE;
+	waitForThread(transferHandle, INFINITE);
+	CloseHandle(transferHandle);
+	transferHandle = NULL;
+	transferStopping = FALSE;
+}
+
 /*---------------------------------------------------------------------------------
 --	FUNCTION: sendViaUDP
 --
 --	DATE:		Feb 14, 2016
 --
 --	REVISIONS:	Feb 14, 2016
+--				Oct 19, 2026 - sets SO_SNDBUF and numbers each datagram
+--				Oct 19, 2026 - replays captures
+--				Oct 19, 2026 - send sizes and timing from a traffic profile
+--				Oct 19, 2026 - integrity mode, sends the bytes getData returned
+--				Oct 19, 2026 - multicast TTL, loopback and interface
+--				Oct 19, 2026 - Timed runs and steady state send rate
+--				Oct 19, 2026 - stamps a flow id
+--				Oct 19, 2026 - impairment stage
+--				Oct 19, 2026 - reliable mode
+--				Oct 19, 2026 - CPU cost
+--				Oct 19, 2026 - trace points around each send
+--				Oct 19, 2026 - thread placement
+--				Oct 19, 2026 - stamps datagrams with the send time
+--				Oct 19, 2026 - kernel transmit timestamps
+--				Oct 19, 2026 - every failure releases through closeSend
+--				Oct 19, 2026 - checked datagrams always carry their headers
+--				Oct 19, 2026 - resolves the placement from the looked-up address
+--				Oct 19, 2026 - Check the send buffer allocation
 --
 --	DESIGNER:	Gabriella Cheung
 --
 --	PROGRAMMER:	Gabriella Cheung
 --
---	INTERFACE:	void sendViaUDP(char * hostname, int port, int packetSize, int repetition, HANDLE file, HANDLE logFile)
+--	INTERFACE:	void sendViaUDP(char * hostname, int port, int packetSize, int repetition, HANDLE file, HANDLE logFile, CLIENT_OPTIONS *options)
 --
 --	PARAMETERS:	char *hostname - hostname of server
 --				int port - port of server
@@ -42,6 +219,7 @@
 --				int repetition - number of packets to send
 --				HANDLE file - handle for file for data to read from
 --				HANDLE logFile - handle for client log file.
+--				CLIENT_OPTIONS *options - socket tuning options from the transfer dialog
 --
 --	RETURNS:	void
 --
@@ -52,8 +230,25 @@
 --  has been sent. Finally it prints out the details of the data transfer to the
 --	 screen before closing the socket.
 --
+--  Each datagram starts with a DATAGRAM_HEADER carrying a sequence number, so
+--  the server can tell how many datagrams were lost, and the run's flow id, so
+--  the server can report this run apart from other senders. A TIMESTAMP_HEADER
+--  written just before the send follows it, for the server's latency figures.
+--  One datagram in TX_TIMESTAMP_EVERY is sent with a kernel transmit
+--  timestamp, and the time from the send call to it is logged. In replay mode the file is
+--  a capture whose UDP payloads are sent unchanged, repetition times over.
+--  Otherwise the traffic profile decides each datagram's size and send time,
+--  and the sizes sent are logged for comparison with the server's.
+--  If the server address is a multicast group, the TTL, loopback and outgoing
+--  interface from the dialog are applied first. With an impairment, datagrams
+--  go through the impairment stage, which is drained before the socket closes.
+--  In reliable mode each datagram carries a RELIABLE_HEADER instead and is
+--  kept until acknowledged, see Reliable.cpp; the run ends once all of them
+--  are, and goodput and retransmissions are logged alongside the send rate.
+--  The CPU the client used while sending is logged with the totals.
+--
 ---------------------------------------------------------------------------------*/
-void sendViaUDP(char * hostname, int port, int packetSize, int repetition, HANDLE file, HANDLE logFile)
+void sendViaUDP(char * hostname, int port, int packetSize, int repetition, HANDLE file, HANDLE logFile, CLIENT_OPTIONS *options)
 {
 	int err, server_len;
 	SOCKET sd = INVALID_SOCKET;
@@ -62,19 +257,47 @@ void sendViaUDP(char * hostname, int port, int packetSize, int repetition, HANDL
 	SYSTEMTIME stStartTime, stEndTime;
 	WSADATA wsaData;
 	WORD wVersionRequested = MAKEWORD(2, 2);
-	char *sbuf;
+	char *sbuf = NULL;
 	HANDLE hFile = NULL, hLogFile;
 	char message[256];
+	DATAGRAM_HEADER *header;
+	TIMESTAMP_HEADER *stamp;
+	INTEGRITY_HEADER *check;
+	int headerSize;
+	BOOL timed, checked;
+	ULONGLONG sendTime;
+	TRAFFIC_PROFILE *profile = NULL;
+	STATS_COUNTERS sizes = { 0 };
+	SEND_WINDOW window;
+	CPU_USAGE cpuStart, cpuCost;
+	IMPAIRMENT *impair = NULL;
+	RELIABLE_SENDER *reliable = NULL;
+	char *rbuf;
+	DWORD flow;
+	ULONGLONG traceStart;
+	PLACEMENT placement;
+	DWORD_PTR previousMask;
+	TX_TIMESTAMPS tx;
 
 	int sentCount = 0;
 	hFile = file;
 	hLogFile = logFile;
 
-	sprintf(message, "Sending %d byte packets %d times to %s port %d using UDP",
-		packetSize,
-		repetition,
-		hostname,
-		port);
+	if (options->duration > 0 && !options->replay)
+	{
+		sprintf(message, "Sending %d byte packets for %d seconds to %s port %d using UDP",
+			packetSize,
+			options->duration,
+			hostname,
+			port);
+	}
+	else {
+		sprintf(message, "Sending %d byte packets %d times to %s port %d using UDP",
+			packetSize,
+			repetition,
+			hostname,
+			port);
+	}
 	writeToScreen(message);
 	strcat(message, "\r\n");
 	writeToFile(hLogFile, message);
@@ -83,6 +306,10 @@ void sendViaUDP(char * hostname, int port, int packetSize, int repetition, HANDL
 	if (err != 0) //No usable DLL
 	{
 		writeToScreen("DLL not found!");
+		if (hFile != NULL)
+		{
+			closeFile(hFile);
+		}
 		return;
 	}
 
@@ -90,10 +317,60 @@ void sendViaUDP(char * hostname, int port, int packetSize, int repetition, HANDL
 	if ((sd = socket(PF_INET, SOCK_DGRAM, 0)) == INVALID_SOCKET)
 	{
 		writeToScreen("Cannot create socket");
+		closeSend(sd, hFile, sbuf, profile, impair, 0, logFile);
 		return;
 	}
+	sprintf(message, "Send buffer: %d bytes", setSocketBuffer(sd, SO_SNDBUF, options->sendBuffer));
+	writeToScreen(message);
+	strcat(message, "\r\n");
+	writeToFile(hLogFile, message);
+
+	profile = (TRAFFIC_PROFILE *)malloc(sizeof(TRAFFIC_PROFILE));
+	if (profile == NULL || !parseProfile(options->profile, packetSize, profile))
+	{
+		writeToScreen("Invalid traffic profile");
+		closeSend(sd, hFile, sbuf, profile, impair, 0, logFile);
+		return;
+	}
+	sprintf(message, "Traffic profile: %s", profile->description);
+	writeToScreen(message);
+	strcat(message, "\r\n");
+	writeToFile(hLogFile, message);
+	if (options->impairment[0] != '\0' && !options->replay)
+	{
+		impair = (IMPAIRMENT *)malloc(sizeof(IMPAIRMENT));
+		if (impair == NULL || !parseImpairment(options->impairment, impair))
+		{
+			writeToScreen("Invalid impairment");
+			closeSend(sd, hFile, sbuf, profile, impair, 0, logFile);
+			return;
+		}
+		sprintf(message, "Impairment: %s", impair->description);
+		writeToScreen(message);
+		strcat(message, "\r\n");
+		writeToFile(hLogFile, message);
+	}
+	if (!parsePlacement(options->placement, &placement))
+	{
+		writeToScreen("Invalid placement");
+		closeSend(sd, hFile, sbuf, profile, impair, 0, logFile);
+		return;
+	}
+
+	//the server keeps separate statistics for each flow id
+	flow = (GetCurrentProcessId() << 16 ^ GetTickCount()) | 1;
+	sprintf(message, "Flow id %08lx", flow);
+	writeToScreen(message);
+	strcat(message, "\r\n");
+	writeToFile(hLogFile, message);
 
-	sbuf = (char*)malloc(packetSize);
+	if ((sbuf = (char*)malloc(profile->maxSize + MESSAGE_HEADER_ROOM + 1)) == NULL)
+	{
+		writeToScreen("Not enough memory for the send buffer");
+		closeSend(sd, hFile, sbuf, profile, impair, 0, logFile);
+		return;
+	}
+	header = (DATAGRAM_HEADER *)sbuf;
 
 	// Store server's information
 	memset((char *)&server, 0, sizeof(server));
@@ -103,36 +380,180 @@ void sendViaUDP(char * hostname, int port, int packetSize, int repetition, HANDL
 	if ((hp = gethostbyname(hostname)) == NULL) //async?
 	{
 		writeToScreen("Can't get server's IP address");
+		closeSend(sd, hFile, sbuf, profile, impair, 0, logFile);
 		return;
 	}
 
 	memcpy((char *)&server.sin_addr, hp->h_addr, hp->h_length);
+	if (IN_MULTICAST(ntohl(server.sin_addr.s_addr)))
+	{
+		if (!setMulticastOptions(sd, options->ttl, options->loopback, options->multicastInterface))
+		{
+			writeToScreen("Can't set multicast options");
+			closeSend(sd, hFile, sbuf, profile, impair, 0, logFile);
+			return;
+		}
+		sprintf(message, "Sending to multicast group %s, TTL %d, loopback %s", hostname, options->ttl, options->loopback ? "on" : "off");
+		writeToScreen(message);
+		strcat(message, "\r\n");
+		writeToFile(hLogFile, message);
+	}
+	resolvePlacement(&placement, server.sin_addr.s_addr);
+	logPlacement(&placement, hLogFile);
 
 	// transmit data
 	server_len = sizeof(server);
+	previousMask = placeThread(GetCurrentThread(), &placement, PLACE_SEND);
 	GetSystemTime(&stStartTime);
-	for (int sent = 0; sent < repetition; sent++)
+	readCpuUsage(&cpuStart);
+	if (options->replay)
+	{
+		sendReplay(sd, &server, hFile, IPPROTO_UDP, repetition, options->speed, hLogFile);
+		repetition = 0;
+	}
+	else if (impair != NULL && !startImpairment(impair, sd, &server, IPPROTO_UDP))
+	{
+		writeToScreen("Impairment unavailable, sending unimpaired");
+		free(impair);
+		impair = NULL;
+	}
+	else if (impair != NULL)
+	{
+		placeThread(impair->thread, &placement, PLACE_SEND);
+	}
+	if (options->reliable && !options->replay && !IN_MULTICAST(ntohl(server.sin_addr.s_addr)))
+	{
+		reliable = (RELIABLE_SENDER *)malloc(sizeof(RELIABLE_SENDER));
+		if (reliable == NULL || !startReliable(reliable, sd, &server, profile->maxSize, options->congestion, impair))
+		{
+			writeToScreen("Unknown congestion control or out of memory");
+			if (impair != NULL)
+			{
+				stopImpairment(impair);
+			}
+			if (previousMask != 0)
+			{
+				SetThreadAffinityMask(GetCurrentThread(), previousMask);
+			}
+			free(reliable);
+			closeSend(sd, hFile, sbuf, profile, impair, 0, logFile);
+			return;
+		}
+		sprintf(message, "Reliable UDP, %s congestion control, %lu packet window", reliable->cc->name, reliable->slots);
+		writeToScreen(message);
+		strcat(message, "\r\n");
+		writeToFile(hLogFile, message);
+	}
+	startTxTimestamps(&tx, sd);
+	startProfile(profile);
+	startWindow(&window, options->replay ? 0 : options->duration, options->warmup, options->cooldown);
+	for (int sent = 0; sending(&window, sent, repetition); sent++)
 	{
 		//get data
-		getData(hFile, sbuf, packetSize);
-		int length = strlen(sbuf);
-	    length = length > packetSize ? packetSize : length;
-		if (sendto(sd, sbuf, length, 0, (struct sockaddr *)&server, server_len) == -1)
+		packetSize = nextPacket(profile);
+		if (reliable != NULL)
+		{
+			//the reliable header takes the place of the datagram header
+			if ((rbuf = reliableBuffer(reliable)) == NULL)
+			{
+				break;
+			}
+			int length = getData(hFile, rbuf, packetSize > sizeof(RELIABLE_HEADER) ? packetSize - sizeof(RELIABLE_HEADER) : 1);
+			traceStart = TRACE_START();
+			reliableSend(reliable, length);
+			TRACE_END(TRACE_UDP_SEND, traceStart, length);
+			addMessage(&sizes, length);
+			countSend(&window, length);
+			sentCount++;
+			continue;
+		}
+		// a checked datagram always carries its headers, growing past packetSize if it must
+		checked = options->integrity;
+		headerSize = packetSize > sizeof(DATAGRAM_HEADER) || checked ? sizeof(DATAGRAM_HEADER) : 0;
+		timed = packetSize > sizeof(DATAGRAM_HEADER) + sizeof(TIMESTAMP_HEADER) + (checked ? sizeof(INTEGRITY_HEADER) : 0);
+		if (timed)
+		{
+			headerSize += sizeof(TIMESTAMP_HEADER);
+		}
+		stamp = (TIMESTAMP_HEADER *)(header + 1);
+		check = (INTEGRITY_HEADER *)(sbuf + headerSize);
+		if (checked)
+		{
+			headerSize += sizeof(INTEGRITY_HEADER);
+		}
+		if (packetSize < headerSize)
+		{
+			packetSize = headerSize;
+		}
+		int length = headerSize + getData(hFile, sbuf + headerSize, packetSize - headerSize);
+		if (headerSize > 0)
+		{
+			header->magic = htonl(timed ? (checked ? DATAGRAM_TIMED_CHECKED_MAGIC : DATAGRAM_TIMED_MAGIC)
+				: (checked ? DATAGRAM_CHECKED_MAGIC : DATAGRAM_MAGIC));
+			header->flow = htonl(flow);
+			header->sequence = htonl(sent);
+			if (checked)
+			{
+				check->length = htonl(length - headerSize);
+				check->crc = htonl(crc32c(0, sbuf + headerSize, length - headerSize));
+			}
+		}
+		if (timed)
+		{
+			sendTime = preciseFileTime();
+			stamp->high = htonl((DWORD)(sendTime >> 32));
+			stamp->low = htonl((DWORD)sendTime);
+		}
+		traceStart = TRACE_START();
+		if (impair != NULL)
+		{
+			impairSend(impair, sbuf, length);
+		}
+		else if ((tx.enabled && sent % TX_TIMESTAMP_EVERY == 0 ? sendTimestamped(&tx, sbuf, length, &server)
+			: sendto(sd, sbuf, length, 0, (struct sockaddr *)&server, server_len)) == -1)
 		{
 			sprintf(message, "error: %d", WSAGetLastError());
 			writeToScreen(message);
 		}
+		TRACE_END(TRACE_UDP_SEND, traceStart, length);
+		addMessage(&sizes, length);
+		countSend(&window, length);
 		sentCount++;
 	}
-	//close file
-	if (hFile != NULL)
+	finishTxTimestamps(&tx);
+	if (reliable != NULL)
 	{
-		closeFile(hFile);
+		finishReliable(reliable);
 	}
-	sprintf(message, "%d %d byte datagrams were sent to server", sentCount, packetSize);
-	writeToScreen(message);
-	strcat(message, "\r\n");
-	writeToFile(hLogFile, message);
+	if (impair != NULL)
+	{
+		stopImpairment(impair);
+		logImpairment(impair, hLogFile);
+	}
+	if (reliable != NULL)
+	{
+		logReliable(reliable, hLogFile);
+		stopReliable(reliable);
+	}
+	cpuSince(&cpuStart, &cpuCost);
+	if (previousMask != 0)
+	{
+		SetThreadAffinityMask(GetCurrentThread(), previousMask);
+	}
+	if (!options->replay)
+	{
+		sprintf(message, "%d datagrams (%llu bytes) were sent to server", sentCount, sizes.totalSize);
+		writeToScreen(message);
+		strcat(message, "\r\n");
+		writeToFile(hLogFile, message);
+		logSizes(&sizes, hLogFile);
+		logWindow(&window, hLogFile);
+		if (impair == NULL && reliable == NULL)
+		{
+			logTxTimestamps(&tx, hLogFile);
+		}
+	}
+	logCpuCost(&cpuCost, sizes.totalSize, sentCount, hLogFile);
 	GetSystemTime(&stEndTime);
 	sprintf(message, "Start time: %d-%02d-%02d %02d:%02d:%02d:%03d",
 		stStartTime.wYear,
@@ -156,8 +577,8 @@ void sendViaUDP(char * hostname, int port, int packetSize, int repetition, HANDL
 	writeToScreen(message);
 	strcat(message, "\r\n\r\n");
 	writeToFile(hLogFile, message);
-	closesocket(sd);
-	WSACleanup();
+	free(reliable);
+	closeSend(sd, hFile, sbuf, profile, impair, 0, logFile);
 }
 
 /*---------------------------------------------------------------------------------
@@ -166,12 +587,29 @@ void sendViaUDP(char * hostname, int port, int packetSize, int repetition, HANDL
 --	DATE:		Feb 14, 2016
 --
 --	REVISIONS:	Feb 14, 2016
+--				Oct 19, 2026 - sets SO_SNDBUF
+--				Oct 19, 2026 - optional length-prefixed framing
+--				Oct 19, 2026 - replays captures
+--				Oct 19, 2026 - send sizes and timing from a traffic profile
+--				Oct 19, 2026 - integrity mode, sends the bytes getData returned
+--				Oct 19, 2026 - Timed runs and steady state send rate
+--				Oct 19, 2026 - impairment stage
+--				Oct 19, 2026 - Unix socket and shared-memory transports
+--				Oct 19, 2026 - CPU cost
+--				Oct 19, 2026 - trace points around each send
+--				Oct 19, 2026 - thread placement
+--				Oct 19, 2026 - samples TCP_INFO during the transfer
+--				Oct 19, 2026 - selects the congestion control
+--				Oct 19, 2026 - every failure releases through closeSend
+--				Oct 19, 2026 - framed messages always carry their headers
+--				Oct 19, 2026 - resolves the placement from the looked-up address
+--				Oct 19, 2026 - Check the send buffer allocation
 --
 --	DESIGNER:	Gabriella Cheung
 --
 --	PROGRAMMER:	Gabriella Cheung
 --
---	INTERFACE:	void sendViaTCP(char * hostname, int port, int packetSize, int repetition, HANDLE file, HANDLE logFile)
+--	INTERFACE:	void sendViaTCP(char * hostname, int port, int packetSize, int repetition, HANDLE file, HANDLE logFile, CLIENT_OPTIONS *options)
 --
 --	PARAMETERS:	char *hostname - hostname of server
 --				int port - port of server
@@ -179,6 +617,7 @@ void sendViaUDP(char * hostname, int port, int packetSize, int repetition, HANDL
 --				int repetition - number of packets to send
 --				HANDLE file - handle for file for data to read from
 --				HANDLE logFile - handle for client log file.
+--				CLIENT_OPTIONS *options - socket tuning options from the transfer dialog
 --
 --	RETURNS:	void
 --
@@ -190,8 +629,25 @@ void sendViaUDP(char * hostname, int port, int packetSize, int repetition, HANDL
 --  WSASend method until all the packets to be sent has been sent. Finally it prints
 --  out the details of the data transfer to the screen before closing the socket.
 --
+--  In framed mode each packet starts with a FRAME_HEADER giving its length, so
+--  the server can count messages instead of receive completions. In replay mode
+--  the file is a capture whose TCP payloads are sent unchanged and unframed.
+--  Otherwise the traffic profile decides each message's size and send time.
+--  With an impairment, messages are delayed and rate limited by the
+--  impairment stage, which is drained before the socket closes.
+--
+--  The same stream can go over a Unix domain socket or the server's
+--  shared-memory ring instead, so the cost of the network stack can be
+--  measured with the same payloads. The ring is never impaired. The CPU the
+--  client used while sending is logged with the totals.
+--
+--  Over TCP the connection's TCP_INFO is sampled between sends, and its RTT,
+--  congestion window, retransmissions and delivery rate are logged as a
+--  series and summarized at the end. The connection can be given a congestion
+--  control algorithm, which is set before connecting and cleared afterwards.
+--
 ---------------------------------------------------------------------------------*/
-void sendViaTCP(char * hostname, int port, int packetSize, int repetition, HANDLE file, HANDLE logFile)
+void sendViaTCP(char * hostname, int port, int packetSize, int repetition, HANDLE file, HANDLE logFile, CLIENT_OPTIONS *options)
 {
 	int err, server_len;
 	SOCKET sd = INVALID_SOCKET;
@@ -200,76 +656,303 @@ void sendViaTCP(char * hostname, int port, int packetSize, int repetition, HANDL
 	SYSTEMTIME stStartTime = {0}, stEndTime = { 0 };
 	WSADATA wsaData;
 	WORD wVersionRequested = MAKEWORD(2, 2);
-	char *sbuf;
+	char *sbuf = NULL;
 	HANDLE hFile = NULL, hLogFile;
 	char message[256];
+	FRAME_HEADER *header;
+	INTEGRITY_HEADER *check;
+	int headerSize, length;
+	TRAFFIC_PROFILE *profile = NULL;
+	STATS_COUNTERS sizes = { 0 };
+	SEND_WINDOW window;
+	CPU_USAGE cpuStart, cpuCost;
+	IMPAIRMENT *impair = NULL;
+	SOCKADDR_UN local;
+	RING *ring = NULL;
+	ULONGLONG traceStart;
+	PLACEMENT placement;
+	DWORD_PTR previousMask;
+	TCP_INFO_SERIES *tcpInfo = NULL;
+	char *provider = NULL;
+	char *transport = options->transport == TRANSPORT_UNIX ? "a Unix stream socket"
+		: options->transport == TRANSPORT_RING ? "shared memory" : "TCP";
 
 	hFile = file;
 	hLogFile = logFile;
 	
-	sprintf(message, "Sending %d byte packets %d times to %s port %d using TCP",
-		packetSize,
-		repetition,
-		hostname,
-		port);
+	if (options->duration > 0 && !options->replay)
+	{
+		sprintf(message, "Sending %d byte packets for %d seconds to %s port %d using %s%s",
+			packetSize,
+			options->duration,
+			hostname,
+			port,
+			transport,
+			options->framing ? " (framed)" : "");
+	}
+	else {
+		sprintf(message, "Sending %d byte packets %d times to %s port %d using %s%s",
+			packetSize,
+			repetition,
+			hostname,
+			port,
+			transport,
+			options->framing ? " (framed)" : "");
+	}
 	writeToScreen(message);
 	err = WSAStartup(wVersionRequested, &wsaData);
 	if (err != 0) //No usable DLL
 	{
 		writeToScreen("DLL not found!");
+		if (hFile != NULL)
+		{
+			closeFile(hFile);
+		}
 		return;
 	}
 
-	// Create the socket
-	if ((sd = socket(AF_INET, SOCK_STREAM, 0)) == INVALID_SOCKET)
+	// Create the socket, shared memory attaches to the server's ring instead
+	if (options->transport != TRANSPORT_RING)
 	{
-		writeToScreen("Cannot create socket");
-		return;
+		if ((sd = socket(options->transport == TRANSPORT_UNIX ? AF_UNIX : AF_INET, SOCK_STREAM, 0)) == INVALID_SOCKET)
+		{
+			writeToScreen(options->transport == TRANSPORT_UNIX ? "Cannot create socket, Unix sockets need Windows 10 1803 or later"
+				: "Cannot create socket");
+			closeSend(sd, hFile, sbuf, profile, impair, 0, logFile);
+			return;
+		}
+		sprintf(message, "Send buffer: %d bytes", setSocketBuffer(sd, SO_SNDBUF, options->sendBuffer));
+		writeToScreen(message);
+		strcat(message, "\r\n");
+		writeToFile(hLogFile, message);
 	}
 
-	sbuf = (char*)malloc(packetSize);
-
-	// Store server's information
-	memset((char *)&server, 0, sizeof(server));
-	server.sin_family = AF_INET;
-	server.sin_port = htons(port);
-
-	if ((hp = gethostbyname(hostname)) == NULL) //async?
+	profile = (TRAFFIC_PROFILE *)malloc(sizeof(TRAFFIC_PROFILE));
+	if (profile == NULL || !parseProfile(options->profile, packetSize, profile))
 	{
-		writeToScreen("Can't get server's IP address");
+		writeToScreen("Invalid traffic profile");
+		closeSend(sd, hFile, sbuf, profile, impair, 0, logFile);
+		return;
+	}
+	sprintf(message, "Traffic profile: %s", profile->description);
+	writeToScreen(message);
+	strcat(message, "\r\n");
+	writeToFile(hLogFile, message);
+	if (options->impairment[0] != '\0' && !options->replay && options->transport != TRANSPORT_RING)
+	{
+		impair = (IMPAIRMENT *)malloc(sizeof(IMPAIRMENT));
+		if (impair == NULL || !parseImpairment(options->impairment, impair))
+		{
+			writeToScreen("Invalid impairment");
+			closeSend(sd, hFile, sbuf, profile, impair, 0, logFile);
+			return;
+		}
+		sprintf(message, "Impairment: %s (streams: only delay, jitter and rate apply)", impair->description);
+		writeToScreen(message);
+		strcat(message, "\r\n");
+		writeToFile(hLogFile, message);
+	}
+	if (!parsePlacement(options->placement, &placement))
+	{
+		writeToScreen("Invalid placement");
+		closeSend(sd, hFile, sbuf, profile, impair, 0, logFile);
 		return;
 	}
 
-	memcpy((char *)&server.sin_addr, hp->h_addr, hp->h_length);
-	if (connect(sd, (struct sockaddr *)&server, sizeof(server)) == -1)
+	if ((sbuf = (char*)malloc(profile->maxSize + MESSAGE_HEADER_ROOM + 1)) == NULL)
 	{
-		writeToScreen("Can't connect to server");
+		writeToScreen("Not enough memory for the send buffer");
+		closeSend(sd, hFile, sbuf, profile, impair, 0, logFile);
 		return;
 	}
+	header = (FRAME_HEADER *)sbuf;
+
+	// Connections made from here on use the chosen congestion control
+	if (options->tcpCongestion[0] != '\0' && options->transport == TRANSPORT_TCP)
+	{
+		provider = congestionProvider(options->tcpCongestion);
+		if (setTcpCongestion(provider, port))
+		{
+			sprintf(message, "TCP congestion control: %s", provider);
+		}
+		else {
+			sprintf(message, "Could not select %s, using the system default: netsh needs an administrator", provider);
+			provider = NULL;
+		}
+		writeToScreen(message);
+		strcat(message, "\r\n");
+		writeToFile(hLogFile, message);
+	}
+
+	// Local transports find the server from the port alone
+	if (options->transport == TRANSPORT_RING)
+	{
+		ring = (RING *)malloc(sizeof(RING));
+		if (ring == NULL || !openRing(ring, port, FALSE) || !ringConnect(ring))
+		{
+			writeToScreen("No shared-memory server on this port, or another client is using it");
+			if (ring != NULL)
+			{
+				closeRing(ring);
+			}
+			free(ring);
+			closeSend(sd, hFile, sbuf, profile, impair, 0, logFile);
+			return;
+		}
+	}
+	else if (options->transport == TRANSPORT_UNIX)
+	{
+		memset((char *)&local, 0, sizeof(local));
+		local.sun_family = AF_UNIX;
+		if (!localSocketPath(port, local.sun_path) || connect(sd, (struct sockaddr *)&local, sizeof(local)) == -1)
+		{
+			writeToScreen("Can't connect to server");
+			closeSend(sd, hFile, sbuf, profile, impair, 0, logFile);
+			return;
+		}
+	}
+	else {
+		// Store server's information
+		memset((char *)&server, 0, sizeof(server));
+		server.sin_family = AF_INET;
+		server.sin_port = htons(port);
+
+		if ((hp = gethostbyname(hostname)) == NULL) //async?
+		{
+			writeToScreen("Can't get server's IP address");
+			closeSend(sd, hFile, sbuf, profile, impair, provider != NULL ? port : 0, logFile);
+			return;
+		}
+
+		memcpy((char *)&server.sin_addr, hp->h_addr, hp->h_length);
+		if (connect(sd, (struct sockaddr *)&server, sizeof(server)) == -1)
+		{
+			writeToScreen("Can't connect to server");
+			closeSend(sd, hFile, sbuf, profile, impair, provider != NULL ? port : 0, logFile);
+			return;
+		}
+	}
+	resolvePlacement(&placement, options->transport == TRANSPORT_TCP ? server.sin_addr.s_addr : htonl(INADDR_LOOPBACK));
+	logPlacement(&placement, hLogFile);
 
 	// transmit data
 	server_len = sizeof(server);
+	if (options->transport == TRANSPORT_TCP && (tcpInfo = (TCP_INFO_SERIES *)malloc(sizeof(TCP_INFO_SERIES))) != NULL)
+	{
+		startTcpInfo(tcpInfo, sd);
+	}
+	previousMask = placeThread(GetCurrentThread(), &placement, PLACE_SEND);
 	GetSystemTime(&stStartTime);
+	readCpuUsage(&cpuStart);
 	int sent;
-	for (sent = 0; sent < repetition; sent++)
+	if (options->replay)
+	{
+		sendReplay(sd, NULL, hFile, IPPROTO_TCP, repetition, options->speed, hLogFile);
+		repetition = 0;
+	}
+	else if (impair != NULL && !startImpairment(impair, sd, NULL, IPPROTO_TCP))
+	{
+		writeToScreen("Impairment unavailable, sending unimpaired");
+		free(impair);
+		impair = NULL;
+	}
+	else if (impair != NULL)
+	{
+		placeThread(impair->thread, &placement, PLACE_SEND);
+	}
+	startProfile(profile);
+	startWindow(&window, options->replay ? 0 : options->duration, options->warmup, options->cooldown);
+	for (sent = 0; sending(&window, sent, repetition); sent++)
 	{
 		//get data
 		if (stStartTime.wYear == 0)
 		{
 			GetSystemTime(&stStartTime);
 		}
-		getData(hFile, sbuf, packetSize);
-		if (send(sd, sbuf, strlen(sbuf), 0) == -1)
+		packetSize = nextPacket(profile);
+		// a framed stream can't carry one unframed message, so a small one grows to fit its headers
+		headerSize = options->framing || options->integrity ? sizeof(FRAME_HEADER) : 0;
+		if (options->integrity)
+		{
+			headerSize += sizeof(INTEGRITY_HEADER);
+		}
+		if (packetSize < headerSize)
+		{
+			packetSize = headerSize;
+		}
+		length = headerSize + getData(hFile, sbuf + headerSize, packetSize - headerSize);
+		if (headerSize > 0)
+		{
+			header->magic = htonl(headerSize > sizeof(FRAME_HEADER) ? FRAME_CHECKED_MAGIC : FRAME_MAGIC);
+			header->length = htonl(length - sizeof(FRAME_HEADER));
+		}
+		if (headerSize > sizeof(FRAME_HEADER))
+		{
+			check = (INTEGRITY_HEADER *)(header + 1);
+			check->length = htonl(length - headerSize);
+			check->crc = htonl(crc32c(0, sbuf + headerSize, length - headerSize));
+		}
+		traceStart = TRACE_START();
+		if (ring != NULL)
+		{
+			if (!ringWrite(ring, sbuf, length))
+			{
+				writeToScreen("Shared-memory server stopped");
+				break;
+			}
+		}
+		else if (impair != NULL)
+		{
+			impairSend(impair, sbuf, length);
+		}
+		else if (send(sd, sbuf, length, 0) == -1)
 		{
 			sprintf(message, "error: %d", WSAGetLastError());
 			writeToScreen(message);
 		}
+		TRACE_END(TRACE_TCP_SEND, traceStart, length);
+		addMessage(&sizes, length);
+		countSend(&window, length);
+		if (tcpInfo != NULL)
+		{
+			sampleTcpInfo(tcpInfo);
+		}
+	}
+	if (impair != NULL)
+	{
+		stopImpairment(impair);
+		logImpairment(impair, hLogFile);
+	}
+	if (tcpInfo != NULL)
+	{
+		finishTcpInfo(tcpInfo);
+	}
+	if (ring != NULL)
+	{
+		ringDisconnect(ring);
+		closeRing(ring);
+		free(ring);
+	}
+	cpuSince(&cpuStart, &cpuCost);
+	if (previousMask != 0)
+	{
+		SetThreadAffinityMask(GetCurrentThread(), previousMask);
 	}
 	GetSystemTime(&stEndTime);
-	sprintf(message, "%d %d byte datagrams were sent to server", sent, packetSize);
-	writeToScreen(message);
-	strcat(message, "\r\n");
-	writeToFile(hLogFile, message);
+	if (!options->replay)
+	{
+		sprintf(message, "%d messages (%llu bytes) were sent to server", sent, sizes.totalSize);
+		writeToScreen(message);
+		strcat(message, "\r\n");
+		writeToFile(hLogFile, message);
+		logSizes(&sizes, hLogFile);
+		logWindow(&window, hLogFile);
+	}
+	logCpuCost(&cpuCost, sizes.totalSize, sent, hLogFile);
+	if (tcpInfo != NULL)
+	{
+		logTcpInfo(tcpInfo, "client", hLogFile);
+	}
 	sprintf(message, "Start time: %d-%02d-%02d %02d:%02d:%02d:%03d",
 		stStartTime.wYear,
 		stStartTime.wMonth,
@@ -292,11 +975,340 @@ void sendViaTCP(char * hostname, int port, int packetSize, int repetition, HANDL
 	writeToScreen(message);
 	strcat(message, "\r\n\r\n");
 	writeToFile(hLogFile, message);
-	//close file
-	if (hFile != NULL)
+	free(tcpInfo);
+	closeSend(sd, hFile, sbuf, profile, impair, provider != NULL ? port : 0, logFile);
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: closeSend
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--				Oct 19, 2026 - logs the congestion control restore
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void closeSend(SOCKET sd, HANDLE file, char *buffer, TRAFFIC_PROFILE *profile,
+--					IMPAIRMENT *impair, int congestionPort, HANDLE logFile)
+--
+--	PARAMETERS:	SOCKET sd - the transfer's socket, INVALID_SOCKET if it has none
+--				HANDLE file - source file, NULL for generated data
+--				char *buffer - send buffer, may be NULL
+--				TRAFFIC_PROFILE *profile - may be NULL
+--				IMPAIRMENT *impair - stopped impairment stage, may be NULL
+--				int congestionPort - port whose TCP congestion control was set, 0 for none
+--				HANDLE logFile - handle for the client log file
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	Releases what sendViaUDP and sendViaTCP hold once WSAStartup has succeeded,
+--  on every way out of them, so a failed transfer leaves no file handle or
+--  Winsock reference behind.
+--
+---------------------------------------------------------------------------------*/
+void closeSend(SOCKET sd, HANDLE file, char *buffer, TRAFFIC_PROFILE *profile, IMPAIRMENT *impair, int congestionPort, HANDLE logFile)
+{
+	if (file != NULL)
+	{
+		closeFile(file);
+	}
+	free(buffer);
+	free(profile);
+	free(impair);
+	if (sd != INVALID_SOCKET)
 	{
-		closeFile(hFile);
+		closesocket(sd);
+	}
+	if (congestionPort != 0)
+	{
+		clearTcpCongestion(congestionPort, logFile);
 	}
-	closesocket(sd);
 	WSACleanup();
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: sendReplay
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--				Oct 19, 2026 - Report the port replayed to and the payloads left out
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void sendReplay(SOCKET sd, struct sockaddr_in *server, HANDLE file, int protocol,
+--					int passes, double speed, HANDLE logFile)
+--
+--	PARAMETERS:	SOCKET sd - socket to send on
+--				struct sockaddr_in *server - server address for UDP, NULL for TCP
+--				HANDLE file - pcap or pcapng capture
+--				int protocol - IPPROTO_UDP or IPPROTO_TCP
+--				int passes - number of times to replay the capture
+--				double speed - timing multiplier, 0 for as fast as possible
+--				HANDLE logFile - handle for client log file
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	Replays the capture with replayCapture and prints how closely the sends
+--  followed the capture's schedule.
+--
+---------------------------------------------------------------------------------*/
+void sendReplay(SOCKET sd, struct sockaddr_in *server, HANDLE file, int protocol, int passes, double speed, HANDLE logFile)
+{
+	REPLAY replay;
+	REPLAY_RESULT result;
+	char message[256];
+
+	if (!openReplay(file, protocol, &replay))
+	{
+		return;
+	}
+	sprintf(message, "Replaying %lu packets to port %u %d times at %s (%lu skipped, %lu truncated, %lu replies and %lu retransmits left out)",
+		replay.count, replay.serverPort, passes, speed > 0 ? "capture timing" : "maximum rate", replay.skipped, replay.truncated,
+		replay.replies, replay.retransmitted);
+	writeToScreen(message);
+	strcat(message, "\r\n");
+	writeToFile(logFile, message);
+
+	replayCapture(&replay, sd, server, speed, passes, &result);
+
+	sprintf(message, "%llu packets (%llu bytes) were sent to server, %d sends failed",
+		result.packets, result.bytes, result.errors);
+	writeToScreen(message);
+	strcat(message, "\r\n");
+	writeToFile(logFile, message);
+	sprintf(message, "Capture schedule: %llu ms at %gx, replay took %llu ms",
+		result.schedule / 1000000, speed > 0 ? speed : 1.0, result.elapsed / 1000000);
+	writeToScreen(message);
+	strcat(message, "\r\n");
+	writeToFile(logFile, message);
+	if (speed > 0 && result.packets > 0)
+	{
+		sprintf(message, "Timing error: mean %llu us, max %llu us, %llu sends more than %d ms late",
+			result.totalError / (result.packets + result.errors) / 1000, result.maxError / 1000,
+			result.late, REPLAY_LATE_NS / 1000000);
+		writeToScreen(message);
+		strcat(message, "\r\n");
+		writeToFile(logFile, message);
+	}
+	closeReplay(&replay);
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: logSizes
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void logSizes(STATS_COUNTERS *sizes, HANDLE logFile)
+--
+--	PARAMETERS:	STATS_COUNTERS *sizes - messages counted with addMessage
+--				HANDLE logFile - handle for client log file
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	Prints the sizes sent in the same buckets the server reports, so the two
+--  distributions can be compared line by line.
+--
+---------------------------------------------------------------------------------*/
+void logSizes(STATS_COUNTERS *sizes, HANDLE logFile)
+{
+	char message[256];
+
+	for (int i = 0; i < MESSAGE_SIZE_BUCKETS; i++)
+	{
+		if (sizes->messageSizes[i] == 0)
+		{
+			continue;
+		}
+		if (i == MESSAGE_SIZE_BUCKETS - 1)
+		{
+			sprintf(message, "    %lu+ bytes: %llu", messageSizeLimit(i), sizes->messageSizes[i]);
+		}
+		else {
+			sprintf(message, "    %lu-%lu bytes: %llu", messageSizeLimit(i), messageSizeLimit(i + 1) - 1, sizes->messageSizes[i]);
+		}
+		writeToScreen(message);
+		strcat(message, "\r\n");
+		writeToFile(logFile, message);
+	}
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: startWindow
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void startWindow(SEND_WINDOW *window, int duration, int warmup, int cooldown)
+--
+--	PARAMETERS:	SEND_WINDOW *window - receives the run's bounds
+--				int duration - seconds to send for, 0 for a counted run
+--				int warmup - seconds left out of the steady state at the start
+--				int cooldown - seconds left out of the steady state at the end
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	Called right before the first send. A counted run has no known end, so only
+--  its warmup is left out.
+--
+---------------------------------------------------------------------------------*/
+void startWindow(SEND_WINDOW *window, int duration, int warmup, int cooldown)
+{
+	LARGE_INTEGER frequency, now;
+
+	ZeroMemory(window, sizeof(SEND_WINDOW));
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&now);
+	window->frequency = frequency.QuadPart;
+	window->start = now.QuadPart;
+	window->last = now.QuadPart;
+	window->warmup = warmup;
+	window->steadyStart = now.QuadPart + warmup * frequency.QuadPart;
+	window->steadyEnd = MAXLONGLONG;
+	if (duration > 0)
+	{
+		window->end = now.QuadPart + duration * frequency.QuadPart;
+		window->cooldown = cooldown;
+		window->steadyEnd = window->end - cooldown * frequency.QuadPart;
+	}
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: sending
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--				Oct 19, 2026 - stops with the transfer
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	BOOL sending(SEND_WINDOW *window, int sent, int repetition)
+--
+--	PARAMETERS:	SEND_WINDOW *window - the run
+--				int sent - messages sent so far
+--				int repetition - messages to send in a counted run
+--
+--	RETURNS:	TRUE while the run should continue
+--
+--	NOTES:
+--	A timed run ends with the first send that finishes past its end. Any run
+--  ends once stopTransfer has been called.
+--
+---------------------------------------------------------------------------------*/
+BOOL sending(SEND_WINDOW *window, int sent, int repetition)
+{
+	if (transferStopping)
+	{
+		return FALSE;
+	}
+	return window->end > 0 ? window->last < window->end : sent < repetition;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: countSend
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void countSend(SEND_WINDOW *window, int length)
+--
+--	PARAMETERS:	SEND_WINDOW *window - the run
+--				int length - bytes just sent
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	Called after each send. The send counts toward the steady state if it
+--  finished inside the window.
+--
+---------------------------------------------------------------------------------*/
+void countSend(SEND_WINDOW *window, int length)
+{
+	LARGE_INTEGER now;
+
+	QueryPerformanceCounter(&now);
+	window->last = now.QuadPart;
+	window->bytes += length;
+	window->messages++;
+	if (now.QuadPart >= window->steadyStart && now.QuadPart < window->steadyEnd)
+	{
+		window->steadyBytes += length;
+		window->steadyMessages++;
+	}
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: logWindow
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void logWindow(SEND_WINDOW *window, HANDLE logFile)
+--
+--	PARAMETERS:	SEND_WINDOW *window - the finished run
+--				HANDLE logFile - handle for client log file
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	Prints the send rate over the whole run and over the steady state, in the
+--  same units the server reports.
+--
+---------------------------------------------------------------------------------*/
+void logWindow(SEND_WINDOW *window, HANDLE logFile)
+{
+	char message[256];
+	double elapsed = (double)(window->last - window->start) / window->frequency;
+	double steady = (double)((window->last < window->steadyEnd ? window->last : window->steadyEnd) - window->steadyStart) / window->frequency;
+
+	sprintf(message, "Whole run: %llu bytes in %.3f s, %.2f Mbit/s, %.0f messages/s", window->bytes, elapsed,
+		elapsed > 0 ? window->bytes * 8 / elapsed / 1000000 : 0.0, elapsed > 0 ? window->messages / elapsed : 0.0);
+	writeToScreen(message);
+	strcat(message, "\r\n");
+	writeToFile(logFile, message);
+	if (steady > 0)
+	{
+		sprintf(message, "Steady state (%d s warmup, %d s cooldown left out): %llu bytes in %.3f s, %.2f Mbit/s, %.0f messages/s",
+			window->warmup, window->cooldown, window->steadyBytes, steady,
+			window->steadyBytes * 8 / steady / 1000000, window->steadyMessages / steady);
+	}
+	else {
+		sprintf(message, "Steady state: run shorter than the %d s warmup and %d s cooldown", window->warmup, window->cooldown);
+	}
+	writeToScreen(message);
+	strcat(message, "\r\n");
+	writeToFile(logFile, message);
 }
\ No newline at end of file
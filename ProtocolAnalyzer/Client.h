@@ -1,4 +1,67 @@
 #pragma once
 
-void sendViaUDP(char *, int, int, int, HANDLE, HANDLE);
-void sendViaTCP(char *, int, int, int, HANDLE, HANDLE);
\ No newline at end of file
+typedef struct _CLIENT_OPTIONS {
+	int sendBuffer;			//SO_SNDBUF, 0 for system default
+	BOOL framing;			//prefix each TCP message with a FRAME_HEADER
+	BOOL integrity;			//stamp each message with a CRC32C, implies framing for TCP
+	int ttl;				//IP_MULTICAST_TTL when the server address is a group
+	BOOL loopback;			//IP_MULTICAST_LOOP, needed for receivers on this host
+	char multicastInterface[ADDRESS_LENGTH];	//local address to send multicast from, empty for any
+	BOOL replay;			//send the payloads of a pcap or pcapng file instead of its bytes
+	double speed;			//replay timing multiplier, 0 for as fast as possible
+	char profile[PROFILE_SPEC_LENGTH];	//traffic profile settings, see Profile.cpp
+	int duration;			//seconds to send for, 0 to send repetition messages
+	int warmup;				//seconds at the start left out of the steady state
+	int cooldown;			//seconds at the end left out of the steady state, timed runs only
+	char impairment[IMPAIR_SPEC_LENGTH];	//loss, delay and rate settings, see Impair.cpp
+	int transport;			//TRANSPORT_TCP, TRANSPORT_UNIX or TRANSPORT_RING for stream sends
+	BOOL reliable;			//number, acknowledge and retransmit datagrams, see Reliable.cpp
+	char congestion[RELIABLE_NAME_LENGTH];	//reliable UDP congestion control: reno, cubic or fixed
+	char placement[PLACEMENT_SPEC_LENGTH];	//CPUs and NUMA node for the sending threads, see Placement.cpp
+	char tcpCongestion[CONGESTION_NAME_LENGTH];	//TCP congestion control, empty for the system default, see Congestion.cpp
+	char matrix[MATRIX_SPEC_LENGTH];	//algorithms and stream counts to compare instead of one transfer
+	char swarm[SWARM_SPEC_LENGTH];	//simulated clients to run instead of one transfer, see Swarm.cpp
+} CLIENT_OPTIONS;
+
+// A transfer started from the dialog, run by transferThread, which frees it.
+typedef struct _CLIENT_TRANSFER {
+	char hostname[256];
+	int port;
+	int packetSize;
+	int repetition;
+	BOOL tcp;					// TCP or a local stream transport, otherwise UDP
+	HANDLE file;				// source file, NULL for generated data
+	HANDLE logFile;
+	CLIENT_OPTIONS options;
+} CLIENT_TRANSFER;
+
+// Bounds of a run and what was sent in it, in QueryPerformanceCounter ticks.
+typedef struct _SEND_WINDOW {
+	LONGLONG frequency;
+	LONGLONG start;
+	LONGLONG end;				// 0 for a run bounded by the repetition count
+	LONGLONG steadyStart;
+	LONGLONG steadyEnd;
+	LONGLONG last;				// time of the latest send
+	int warmup;					// seconds, as applied
+	int cooldown;
+	ULONGLONG bytes;
+	ULONGLONG messages;
+	ULONGLONG steadyBytes;
+	ULONGLONG steadyMessages;
+} SEND_WINDOW;
+
+extern volatile BOOL transferStopping;	//read by the send loops, set by stopTransfer
+
+BOOL startTransfer(CLIENT_TRANSFER *);
+DWORD WINAPI transferThread(LPVOID);
+void stopTransfer();
+void sendViaUDP(char *, int, int, int, HANDLE, HANDLE, CLIENT_OPTIONS *);
+void sendViaTCP(char *, int, int, int, HANDLE, HANDLE, CLIENT_OPTIONS *);
+void closeSend(SOCKET, HANDLE, char *, TRAFFIC_PROFILE *, IMPAIRMENT *, int, HANDLE);
+void sendReplay(SOCKET, struct sockaddr_in *, HANDLE, int, int, double, HANDLE);
+void logSizes(STATS_COUNTERS *, HANDLE);
+void startWindow(SEND_WINDOW *, int, int, int);
+BOOL sending(SEND_WINDOW *, int, int);
+void countSend(SEND_WINDOW *, int);
+void logWindow(SEND_WINDOW *, HANDLE);
\ No newline at end of file
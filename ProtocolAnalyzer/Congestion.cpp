@@ -0,0 +1,792 @@
+/*---------------------------------------------------------------------------------
+--	SOURCE FILE:	Congestion.cpp -
+--
+--	PROGRAM:		Transport Layer Protocol Analyser
+--
+--	FUNCTIONS:
+--					char *congestionProvider(char *name)
+--					BOOL setTcpCongestion(char *provider, int port)
+--					void clearTcpCongestion(int port, HANDLE logFile)
+--					BOOL parseMatrix(char *spec, MATRIX_SPEC *matrix)
+--					void runMatrix(char *hostname, int port, int packetSize, int repetition,
+--						HANDLE logFile, CLIENT_OPTIONS *options)
+--					BOOL runCommand(char *command, char *output, DWORD size)
+--					BOOL readTcpCongestion(char *provider)
+--					void runMatrixCell(SOCKADDR_IN *server, MATRIX_STREAM *streams, int count,
+--						int packetSize, int repetition, CLIENT_OPTIONS *options, MATRIX_RESULT *result,
+--						HANDLE logFile)
+--					DWORD WINAPI matrixStream(LPVOID lpParameter)
+--					void logMatrix(MATRIX_RESULT *results, int count, ULONG baseRtt, HANDLE logFile)
+--
+--	DATE:			Oct 19, 2026
+--
+--	REVISIONS:		Oct 19, 2026
+--
+--	DESIGNER:		Gabriella Cheung
+--
+--	PROGRAMMER:		Gabriella Cheung
+--
+--	NOTES:
+--	This file contains the choice of TCP congestion control for the client's
+--  connections, and a matrix that repeats one transfer over several
+--  algorithms and stream counts and compares them.
+--
+--  Windows has no per-socket TCP_CONGESTION option. The algorithm, which
+--  Windows calls a congestion provider, is a setting of a TCP template, and
+--  supplemental filters pick the template for connections to a given remote
+--  port. The client therefore sets the provider of CONGESTION_TEMPLATE and
+--  files the server's port onto it with netsh, so only connections to the
+--  server are affected, and removes the filter when it is done. The template is
+--  shared by the whole system, so the provider it had is read first and put
+--  back with the filter. This needs an administrator; without one netsh fails
+--  and the system default is used.
+--  Which providers exist depends on the Windows version: ctcp, cubic, newreno
+--  and dctcp are long-standing, bbr2 arrived with Windows 11. reno and bbr are
+--  taken as newreno and bbr2.
+--
+--  A matrix run sends generated messages of the packet size, without
+--  profile, impairment or framing, so the algorithms are all that differs. Its
+--  streams connect first and then start together. Each stream's time runs
+--  from its first send until the server closes the connection, so goodput only
+--  counts data that arrived. The RTT inflation is each run's mean RTT over the
+--  lowest RTT seen anywhere in the matrix, which stands for the path's base
+--  RTT.
+--
+---------------------------------------------------------------------------------*/
+#include "resource.h"
+
+BOOL runCommand(char *, char *, DWORD);
+BOOL readTcpCongestion(char *);
+void runMatrixCell(SOCKADDR_IN *, MATRIX_STREAM *, int, int, int, CLIENT_OPTIONS *, MATRIX_RESULT *, HANDLE);
+DWORD WINAPI matrixStream(LPVOID);
+void logMatrix(MATRIX_RESULT *, int, ULONG, HANDLE);
+
+static char savedProvider[CONGESTION_NAME_LENGTH];	// provider CONGESTION_TEMPLATE had before setTcpCongestion
+
+static char *providers[][2] = {
+	{ "default", "default" },
+	{ "ctcp", "ctcp" },
+	{ "cubic", "cubic" },
+	{ "newreno", "newreno" },
+	{ "reno", "newreno" },
+	{ "dctcp", "dctcp" },
+	{ "bbr2", "bbr2" },
+	{ "bbr", "bbr2" },
+};
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: congestionProvider
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	char *congestionProvider(char *name)
+--
+--	PARAMETERS:	char *name - algorithm name as the user gave it
+--
+--	RETURNS:	the Windows congestion provider name, or NULL if it is unknown
+--
+---------------------------------------------------------------------------------*/
+char *congestionProvider(char *name)
+{
+	for (int i = 0; i < sizeof(providers) / sizeof(providers[0]); i++)
+	{
+		if (_stricmp(name, providers[i][0]) == 0)
+		{
+			return providers[i][1];
+		}
+	}
+	return NULL;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: setTcpCongestion
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--				Oct 19, 2026 - saves the template's provider first
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	BOOL setTcpCongestion(char *provider, int port)
+--
+--	PARAMETERS:	char *provider - name from congestionProvider
+--				int port - server port whose connections should use it
+--
+--	RETURNS:	TRUE if netsh applied the setting
+--
+--	NOTES:
+--	Takes effect for connections made after it returns. A filter left by an
+--  earlier run is replaced.
+--
+--  The template's own provider is saved the first time, so a matrix that
+--  sets several in turn still restores the one the system had. If it can't be
+--  read the template is left alone, since it could not be put back.
+--
+---------------------------------------------------------------------------------*/
+BOOL setTcpCongestion(char *provider, int port)
+{
+	char command[CONGESTION_COMMAND_LENGTH];
+
+	sprintf(command, "netsh interface tcp delete supplementalfilter remoteport=%d", port);
+	runCommand(command, NULL, 0);
+	if (savedProvider[0] == '\0' && !readTcpCongestion(savedProvider))
+	{
+		return FALSE;
+	}
+	sprintf(command, "netsh interface tcp set supplemental template=%s congestionprovider=%s", CONGESTION_TEMPLATE, provider);
+	if (!runCommand(command, NULL, 0))
+	{
+		return FALSE;
+	}
+	sprintf(command, "netsh interface tcp add supplementalfilter remoteport=%d template=%s", port, CONGESTION_TEMPLATE);
+	return runCommand(command, NULL, 0);
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: clearTcpCongestion
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--				Oct 19, 2026 - restores the template's provider
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void clearTcpCongestion(int port, HANDLE logFile)
+--
+--	PARAMETERS:	int port - server port given to setTcpCongestion
+--				HANDLE logFile - handle for the client log file
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	Removes the filter, so connections to the port use the system default
+--  again, and gives CONGESTION_TEMPLATE back the provider it had before
+--  setTcpCongestion. Nothing happens if there is no filter.
+--
+---------------------------------------------------------------------------------*/
+void clearTcpCongestion(int port, HANDLE logFile)
+{
+	char command[CONGESTION_COMMAND_LENGTH];
+	char message[256];
+
+	sprintf(command, "netsh interface tcp delete supplementalfilter remoteport=%d", port);
+	runCommand(command, NULL, 0);
+	if (savedProvider[0] == '\0')
+	{
+		return;
+	}
+	sprintf(command, "netsh interface tcp set supplemental template=%s congestionprovider=%s", CONGESTION_TEMPLATE, savedProvider);
+	if (runCommand(command, NULL, 0))
+	{
+		sprintf(message, "TCP congestion control of the %s template restored to %s", CONGESTION_TEMPLATE, savedProvider);
+	}
+	else {
+		sprintf(message, "Could not restore the %s template to %s; set it back with netsh", CONGESTION_TEMPLATE, savedProvider);
+	}
+	writeToScreen(message);
+	strcat(message, "\r\n");
+	writeToFile(logFile, message);
+	savedProvider[0] = '\0';
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: parseMatrix
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	BOOL parseMatrix(char *spec, MATRIX_SPEC *matrix)
+--
+--	PARAMETERS:	char *spec - settings from the transfer dialog
+--				MATRIX_SPEC *matrix - receives the runs
+--
+--	RETURNS:	TRUE if the spec is valid
+--
+--	NOTES:
+--	algorithms is a comma-separated list of congestion providers and is
+--  required; streams is a list of parallel stream counts, 1 if it is left out.
+--
+---------------------------------------------------------------------------------*/
+BOOL parseMatrix(char *spec, MATRIX_SPEC *matrix)
+{
+	char settings[MATRIX_SPEC_LENGTH];
+	char *setting, *value, *entry, *provider, *context = NULL, *listContext = NULL;
+	char *text = matrix->description;
+	int streams;
+
+	ZeroMemory(matrix, sizeof(MATRIX_SPEC));
+	strncpy(settings, spec, sizeof(settings) - 1);
+	settings[sizeof(settings) - 1] = '\0';
+	for (setting = strtok_s(settings, "; ", &context); setting != NULL; setting = strtok_s(NULL, "; ", &context))
+	{
+		if ((value = strchr(setting, '=')) == NULL)
+		{
+			return FALSE;
+		}
+		*value++ = '\0';
+		if (strcmp(setting, "algorithms") == 0)
+		{
+			for (entry = strtok_s(value, ",", &listContext); entry != NULL; entry = strtok_s(NULL, ",", &listContext))
+			{
+				if (matrix->algorithms == MATRIX_ALGORITHMS || (provider = congestionProvider(entry)) == NULL)
+				{
+					return FALSE;
+				}
+				strcpy(matrix->algorithm[matrix->algorithms++], provider);
+			}
+		}
+		else if (strcmp(setting, "streams") == 0)
+		{
+			for (entry = strtok_s(value, ",", &listContext); entry != NULL; entry = strtok_s(NULL, ",", &listContext))
+			{
+				streams = atoi(entry);
+				if (matrix->streamCounts == MATRIX_STREAM_COUNTS || streams <= 0 || streams > MATRIX_MAX_STREAMS)
+				{
+					return FALSE;
+				}
+				matrix->streams[matrix->streamCounts++] = streams;
+			}
+		}
+		else {
+			return FALSE;
+		}
+	}
+	if (matrix->algorithms == 0)
+	{
+		return FALSE;
+	}
+	if (matrix->streamCounts == 0)
+	{
+		matrix->streams[matrix->streamCounts++] = 1;
+	}
+
+	for (int i = 0; i < matrix->algorithms; i++)
+	{
+		text += sprintf(text, "%s%s", i > 0 ? ", " : "", matrix->algorithm[i]);
+	}
+	text += sprintf(text, " with");
+	for (int i = 0; i < matrix->streamCounts; i++)
+	{
+		text += sprintf(text, "%s %d", i > 0 ? "," : "", matrix->streams[i]);
+	}
+	sprintf(text, " stream%s", matrix->streamCounts == 1 && matrix->streams[0] == 1 ? "" : "s");
+	return TRUE;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: runMatrix
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--				Oct 19, 2026 - stops with the transfer
+--				Oct 19, 2026 - Resolve host names as well as addresses
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void runMatrix(char *hostname, int port, int packetSize, int repetition,
+--					HANDLE logFile, CLIENT_OPTIONS *options)
+--
+--	PARAMETERS:	char *hostname - IP address of the server
+--				int port - TCP port of the server
+--				int packetSize - size of each message
+--				int repetition - messages per stream when there is no duration
+--				HANDLE logFile - handle for the client log file
+--				CLIENT_OPTIONS *options - transfer settings, with the matrix spec
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	Runs the transfer once for each algorithm and stream count, pausing
+--  between runs, then prints the comparison table. An algorithm netsh refuses
+--  is still run, with the system default, and marked in the table.
+--
+---------------------------------------------------------------------------------*/
+void runMatrix(char *hostname, int port, int packetSize, int repetition, HANDLE logFile, CLIENT_OPTIONS *options)
+{
+	WSADATA wsaData;
+	SOCKADDR_IN server;
+	MATRIX_SPEC matrix;
+	MATRIX_STREAM *streams;
+	MATRIX_RESULT results[MATRIX_ALGORITHMS * MATRIX_STREAM_COUNTS];
+	struct hostent *hp;
+	char message[256];
+	BOOL applied;
+	ULONG baseRtt = 0;
+	int count = 0;
+
+	if (!parseMatrix(options->matrix, &matrix))
+	{
+		writeToScreen("Invalid congestion control matrix");
+		return;
+	}
+	if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0)
+	{
+		writeToScreen("DLL not found!");
+		return;
+	}
+	memset((char *)&server, 0, sizeof(server));
+	server.sin_family = AF_INET;
+	server.sin_port = htons(port);
+	if ((hp = gethostbyname(hostname)) == NULL)
+	{
+		writeToScreen("Can't get server's IP address");
+		WSACleanup();
+		return;
+	}
+	memcpy((char *)&server.sin_addr, hp->h_addr, hp->h_length);
+	if ((streams = (MATRIX_STREAM *)malloc(MATRIX_MAX_STREAMS * sizeof(MATRIX_STREAM))) == NULL)
+	{
+		writeToScreen("Not enough memory for the matrix streams");
+		WSACleanup();
+		return;
+	}
+
+	if (options->duration > 0)
+	{
+		sprintf(message, "Congestion control matrix: %s; %d byte messages for %d seconds to %s port %d",
+			matrix.description, packetSize, options->duration, hostname, port);
+	}
+	else {
+		sprintf(message, "Congestion control matrix: %s; %d byte messages %d times per stream to %s port %d",
+			matrix.description, packetSize, repetition, hostname, port);
+	}
+	writeToScreen(message);
+	strcat(message, "\r\n");
+	writeToFile(logFile, message);
+	for (int a = 0; a < matrix.algorithms && !transferStopping; a++)
+	{
+		if (!(applied = setTcpCongestion(matrix.algorithm[a], port)))
+		{
+			sprintf(message, "Could not select %s: netsh needs an administrator and a Windows version with that provider", matrix.algorithm[a]);
+			writeToScreen(message);
+			strcat(message, "\r\n");
+			writeToFile(logFile, message);
+		}
+		for (int s = 0; s < matrix.streamCounts && !transferStopping; s++)
+		{
+			results[count].algorithm = matrix.algorithm[a];
+			results[count].applied = applied;
+			runMatrixCell(&server, streams, matrix.streams[s], packetSize, repetition, options, &results[count], logFile);
+			if (results[count].minRtt > 0 && (baseRtt == 0 || results[count].minRtt < baseRtt))
+			{
+				baseRtt = results[count].minRtt;
+			}
+			count++;
+			Sleep(MATRIX_PAUSE);
+		}
+	}
+	clearTcpCongestion(port, logFile);
+	logMatrix(results, count, baseRtt, logFile);
+	free(streams);
+	WSACleanup();
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: runCommand
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--				Oct 19, 2026 - can return the output
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	BOOL runCommand(char *command, char *output, DWORD size)
+--
+--	PARAMETERS:	char *command - command line to run without a console window
+--				char *output - receives what the command printed, NULL to discard it
+--				DWORD size - size of output
+--
+--	RETURNS:	TRUE if the command ran and exited with 0
+--
+--	NOTES:
+--	The output pipe is made as large as output, so the command never blocks
+--  writing to it and can be read after it exits.
+--
+---------------------------------------------------------------------------------*/
+BOOL runCommand(char *command, char *output, DWORD size)
+{
+	STARTUPINFO startup = { 0 };
+	PROCESS_INFORMATION process;
+	SECURITY_ATTRIBUTES inherit = { sizeof(SECURITY_ATTRIBUTES), NULL, TRUE };
+	HANDLE readPipe = NULL, writePipe = NULL;
+	char line[CONGESTION_COMMAND_LENGTH];
+	DWORD exitCode = 1, length = 0, bytes;
+
+	// CreateProcess may write to the command line it is given
+	strncpy(line, command, sizeof(line) - 1);
+	line[sizeof(line) - 1] = '\0';
+	startup.cb = sizeof(startup);
+	if (output != NULL)
+	{
+		if (!CreatePipe(&readPipe, &writePipe, &inherit, size))
+		{
+			return FALSE;
+		}
+		SetHandleInformation(readPipe, HANDLE_FLAG_INHERIT, 0);
+		startup.dwFlags = STARTF_USESTDHANDLES;
+		startup.hStdOutput = writePipe;
+		startup.hStdError = writePipe;
+	}
+	if (!CreateProcess(NULL, line, NULL, NULL, output != NULL, CREATE_NO_WINDOW, NULL, NULL, &startup, &process))
+	{
+		if (output != NULL)
+		{
+			CloseHandle(readPipe);
+			CloseHandle(writePipe);
+		}
+		return FALSE;
+	}
+	if (WaitForSingleObject(process.hProcess, CONGESTION_COMMAND_TIMEOUT) == WAIT_OBJECT_0)
+	{
+		GetExitCodeProcess(process.hProcess, &exitCode);
+	}
+	CloseHandle(process.hThread);
+	CloseHandle(process.hProcess);
+	if (output != NULL)
+	{
+		// with the only write end closed, reads stop once the pipe is empty
+		CloseHandle(writePipe);
+		while (exitCode == 0 && length < size - 1 && ReadFile(readPipe, output + length, size - 1 - length, &bytes, NULL) && bytes > 0)
+		{
+			length += bytes;
+		}
+		output[length] = '\0';
+		CloseHandle(readPipe);
+	}
+	return exitCode == 0;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: readTcpCongestion
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	BOOL readTcpCongestion(char *provider)
+--
+--	PARAMETERS:	char *provider - receives the provider, CONGESTION_NAME_LENGTH bytes
+--
+--	RETURNS:	TRUE if CONGESTION_TEMPLATE's provider was found
+--
+--	NOTES:
+--	netsh prints its labels in the system's language, so the provider is
+--  taken as the first value that is a known provider name rather than by
+--  its label.
+--
+---------------------------------------------------------------------------------*/
+BOOL readTcpCongestion(char *provider)
+{
+	char command[CONGESTION_COMMAND_LENGTH];
+	char output[CONGESTION_OUTPUT_LENGTH];
+	char *value;
+
+	sprintf(command, "netsh interface tcp show supplemental template=%s", CONGESTION_TEMPLATE);
+	if (!runCommand(command, output, sizeof(output)))
+	{
+		return FALSE;
+	}
+	for (char *line = strtok(output, "\r\n"); line != NULL; line = strtok(NULL, "\r\n"))
+	{
+		if ((value = strrchr(line, ':')) == NULL)
+		{
+			continue;
+		}
+		value += strspn(value + 1, " \t") + 1;
+		value[strcspn(value, " \t")] = '\0';
+		for (int i = 0; i < sizeof(providers) / sizeof(providers[0]); i++)
+		{
+			if (_stricmp(value, providers[i][1]) == 0)
+			{
+				strcpy(provider, providers[i][1]);
+				return TRUE;
+			}
+		}
+	}
+	return FALSE;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: runMatrixCell
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void runMatrixCell(SOCKADDR_IN *server, MATRIX_STREAM *streams, int count,
+--					int packetSize, int repetition, CLIENT_OPTIONS *options, MATRIX_RESULT *result,
+--					HANDLE logFile)
+--
+--	PARAMETERS:	SOCKADDR_IN *server - server address
+--				MATRIX_STREAM *streams - room for MATRIX_MAX_STREAMS streams
+--				int count - parallel streams to run
+--				int packetSize - size of each message
+--				int repetition - messages per stream when there is no duration
+--				CLIENT_OPTIONS *options - send buffer and duration
+--				MATRIX_RESULT *result - receives the run's figures; algorithm and
+--					applied are set by the caller
+--				HANDLE logFile - handle for the client log file
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	Connects every stream, starts their threads and releases them together.
+--  Each stream's own figures go to the log file.
+--
+---------------------------------------------------------------------------------*/
+void runMatrixCell(SOCKADDR_IN *server, MATRIX_STREAM *streams, int count, int packetSize, int repetition,
+	CLIENT_OPTIONS *options, MATRIX_RESULT *result, HANDLE logFile)
+{
+	HANDLE threads[MATRIX_MAX_STREAMS];
+	HANDLE start;
+	MATRIX_STREAM *stream;
+	LATENCY_SPREAD rtt = { 0 };
+	char message[256];
+	double rate, total = 0, squares = 0;
+	ULONGLONG bytes = 0, sent = 0, retransmitted = 0;
+	LONGLONG begin = MAXLONGLONG, end = 0;
+	int connected = 0;
+
+	result->streams = 0;
+	result->goodput = result->fairness = result->retransmitted = result->rtt = 0;
+	result->minRtt = 0;
+	if ((start = CreateEvent(NULL, TRUE, FALSE, NULL)) == NULL)
+	{
+		writeToScreen("CreateEvent() failed");
+		return;
+	}
+	for (int i = 0; i < count; i++)
+	{
+		stream = &streams[connected];
+		if ((stream->sd = socket(AF_INET, SOCK_STREAM, 0)) == INVALID_SOCKET)
+		{
+			break;
+		}
+		setSocketBuffer(stream->sd, SO_SNDBUF, options->sendBuffer);
+		if (connect(stream->sd, (struct sockaddr *)server, sizeof(SOCKADDR_IN)) == SOCKET_ERROR)
+		{
+			closesocket(stream->sd);
+			break;
+		}
+		stream->packetSize = packetSize;
+		stream->repetition = repetition;
+		stream->duration = options->duration;
+		stream->start = start;
+		if ((threads[connected] = CreateThread(NULL, 0, matrixStream, (LPVOID)stream, 0, NULL)) == NULL)
+		{
+			closesocket(stream->sd);
+			break;
+		}
+		connected++;
+	}
+	if (connected < count)
+	{
+		sprintf(message, "Only %d of %d streams connected", connected, count);
+		writeToScreen(message);
+	}
+	SetEvent(start);
+	if (connected > 0)
+	{
+		WaitForMultipleObjects(connected, threads, TRUE, INFINITE);
+	}
+	for (int i = 0; i < connected; i++)
+	{
+		CloseHandle(threads[i]);
+	}
+	CloseHandle(start);
+
+	for (int i = 0; i < connected; i++)
+	{
+		stream = &streams[i];
+		rate = stream->end > stream->begin ? stream->bytes * 8.0 * stream->frequency / (stream->end - stream->begin) / 1000000.0 : 0;
+		total += rate;
+		squares += rate * rate;
+		bytes += stream->bytes;
+		if (stream->end > 0 && stream->begin < begin)
+		{
+			begin = stream->begin;
+		}
+		if (stream->end > end)
+		{
+			end = stream->end;
+		}
+		if (stream->tcpInfo.version != TCP_INFO_NONE)
+		{
+			sent += stream->tcpInfo.latest.BytesOut;
+			retransmitted += stream->tcpInfo.latest.BytesRetrans;
+			rtt.count += stream->tcpInfo.rtt.count;
+			rtt.total += stream->tcpInfo.rtt.total;
+			if (stream->tcpInfo.latest.MinRttUs > 0 && (result->minRtt == 0 || stream->tcpInfo.latest.MinRttUs < result->minRtt))
+			{
+				result->minRtt = stream->tcpInfo.latest.MinRttUs;
+			}
+		}
+		sprintf(message, "%s, %d streams, stream %d: %.1f Mbps, %lu bytes retransmitted, RTT %.0f us%s\r\n",
+			result->algorithm, count, i + 1, rate, stream->tcpInfo.latest.BytesRetrans,
+			spreadMean(&(stream->tcpInfo.rtt)), stream->drained ? "" : ", server did not close");
+		writeToFile(logFile, message);
+	}
+	result->streams = connected;
+	if (connected > 0 && end > begin)
+	{
+		result->goodput = bytes * 8.0 * streams[0].frequency / (end - begin) / 1000000.0;
+		result->fairness = squares > 0 ? total * total / (connected * squares) : 0;
+	}
+	result->retransmitted = sent > 0 ? 100.0 * retransmitted / sent : 0;
+	result->rtt = spreadMean(&rtt);
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: matrixStream
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--				Oct 19, 2026 - retires its context switches
+--				Oct 19, 2026 - skips the drain when the transfer stops
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	DWORD WINAPI matrixStream(LPVOID lpParameter)
+--
+--	PARAMETERS:	LPVOID lpParameter - the connected MATRIX_STREAM
+--
+--	RETURNS:	DWORD
+--
+--	NOTES:
+--	Waits for the start event, sends until the run ends, sampling TCP_INFO
+--  between sends, then shuts down its side and waits for the server to close
+--  before taking the end time. The socket is closed here.
+--
+---------------------------------------------------------------------------------*/
+DWORD WINAPI matrixStream(LPVOID lpParameter)
+{
+	MATRIX_STREAM *stream = (MATRIX_STREAM *)lpParameter;
+	SEND_WINDOW window;
+	LARGE_INTEGER now;
+	DWORD timeout = MATRIX_DRAIN_TIMEOUT;
+	char *buffer, drain[64];
+
+	if ((buffer = (char *)malloc(stream->packetSize + 1)) == NULL)
+	{
+		closesocket(stream->sd);
+		ZeroMemory(&(stream->tcpInfo), sizeof(TCP_INFO_SERIES));
+		stream->tcpInfo.version = TCP_INFO_NONE;
+		stream->bytes = 0;
+		stream->begin = stream->end = 0;
+		stream->drained = FALSE;
+		retireThread();
+		return 0;
+	}
+	getData(NULL, buffer, stream->packetSize);
+	startTcpInfo(&(stream->tcpInfo), stream->sd);
+	WaitForSingleObject(stream->start, INFINITE);
+
+	startWindow(&window, stream->duration, 0, 0);
+	for (int sent = 0; sending(&window, sent, stream->repetition); sent++)
+	{
+		if (send(stream->sd, buffer, stream->packetSize, 0) == SOCKET_ERROR)
+		{
+			break;
+		}
+		countSend(&window, stream->packetSize);
+		sampleTcpInfo(&(stream->tcpInfo));
+	}
+
+	shutdown(stream->sd, SD_SEND);
+	setsockopt(stream->sd, SOL_SOCKET, SO_RCVTIMEO, (char *)&timeout, sizeof(timeout));
+	stream->drained = !transferStopping && recv(stream->sd, drain, sizeof(drain), 0) == 0;
+	QueryPerformanceCounter(&now);
+	finishTcpInfo(&(stream->tcpInfo));
+	stream->frequency = window.frequency;
+	stream->begin = window.start;
+	stream->end = now.QuadPart;
+	stream->bytes = window.bytes;
+	closesocket(stream->sd);
+	free(buffer);
+	retireThread();
+	return 0;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: logMatrix
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void logMatrix(MATRIX_RESULT *results, int count, ULONG baseRtt, HANDLE logFile)
+--
+--	PARAMETERS:	MATRIX_RESULT *results - one per run
+--				int count - number of runs
+--				ULONG baseRtt - lowest RTT of the matrix in us, 0 if none was read
+--				HANDLE logFile - handle for the client log file
+--
+--	RETURNS:	void
+--
+---------------------------------------------------------------------------------*/
+void logMatrix(MATRIX_RESULT *results, int count, ULONG baseRtt, HANDLE logFile)
+{
+	char message[256];
+	MATRIX_RESULT *result;
+
+	sprintf(message, "%-10s %7s %12s %13s %9s %13s %8s", "Algorithm", "Streams", "Goodput Mbps", "Retransmitted",
+		"RTT us", "RTT inflation", "Fairness");
+	writeToScreen(message);
+	strcat(message, "\r\n");
+	writeToFile(logFile, message);
+	for (int i = 0; i < count; i++)
+	{
+		result = &results[i];
+		sprintf(message, "%-10s %7d %12.1f %12.2f%% %9.0f %12.2fx %8.3f%s", result->algorithm, result->streams,
+			result->goodput, result->retransmitted, result->rtt, baseRtt > 0 ? result->rtt / baseRtt : 0.0,
+			result->fairness, result->applied ? "" : "  (system default)");
+		writeToScreen(message);
+		strcat(message, "\r\n");
+		writeToFile(logFile, message);
+	}
+	if (baseRtt > 0)
+	{
+		sprintf(message, "RTT inflation is over the lowest RTT seen, %lu us", baseRtt);
+		writeToScreen(message);
+		strcat(message, "\r\n");
+		writeToFile(logFile, message);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,57 @@
+#pragma once
+
+#define CONGESTION_NAME_LENGTH	16
+#define CONGESTION_TEMPLATE		"internetcustom"	//supplemental template the client's connections are filtered onto
+#define CONGESTION_COMMAND_LENGTH	256
+#define CONGESTION_COMMAND_TIMEOUT	10000	//ms netsh gets to apply a setting
+#define CONGESTION_OUTPUT_LENGTH	4096	//bytes of netsh output read back
+#define MATRIX_SPEC_LENGTH		128
+#define MATRIX_ALGORITHMS		8
+#define MATRIX_STREAM_COUNTS	4
+#define MATRIX_MAX_STREAMS		MAXIMUM_WAIT_OBJECTS
+#define MATRIX_PAUSE			2000	//ms between runs so queues left by the previous one drain
+#define MATRIX_DRAIN_TIMEOUT	30000	//ms a stream waits for the server to close after its last send
+
+// Runs of a congestion control matrix, parsed from a spec such as
+// "algorithms=cubic,newreno,bbr2; streams=1,4". Every algorithm is run with
+// every stream count.
+typedef struct _MATRIX_SPEC {
+	int algorithms;
+	char algorithm[MATRIX_ALGORITHMS][CONGESTION_NAME_LENGTH];	// Windows congestion provider names
+	int streamCounts;
+	int streams[MATRIX_STREAM_COUNTS];
+	char description[MATRIX_SPEC_LENGTH + 32];
+} MATRIX_SPEC;
+
+// One connection of a matrix run, owned by its thread until the run ends.
+typedef struct _MATRIX_STREAM {
+	SOCKET sd;
+	int packetSize;
+	int repetition;
+	int duration;
+	HANDLE start;				// manual-reset event set once every stream is connected
+	LONGLONG frequency;
+	LONGLONG begin;				// QueryPerformanceCounter at the first send
+	LONGLONG end;				// when the server closed, so every byte was delivered
+	ULONGLONG bytes;
+	BOOL drained;				// the server closed before MATRIX_DRAIN_TIMEOUT
+	TCP_INFO_SERIES tcpInfo;
+} MATRIX_STREAM;
+
+// Figures for one algorithm and stream count.
+typedef struct _MATRIX_RESULT {
+	char *algorithm;
+	int streams;				// connections that were made
+	BOOL applied;				// netsh accepted the algorithm
+	double goodput;				// Mbps over all streams
+	double fairness;			// Jain's index of the streams' goodput, 1 when equal
+	double retransmitted;		// % of the bytes sent
+	double rtt;					// us, mean over every stream's samples
+	ULONG minRtt;				// us, lowest any stream saw
+} MATRIX_RESULT;
+
+char *congestionProvider(char *);
+BOOL setTcpCongestion(char *, int);
+void clearTcpCongestion(int, HANDLE);
+BOOL parseMatrix(char *, MATRIX_SPEC *);
+void runMatrix(char *, int, int, int, HANDLE, struct _CLIENT_OPTIONS *);
\ No newline at end of file
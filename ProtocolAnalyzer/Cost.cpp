@@ -0,0 +1,393 @@
+/*---------------------------------------------------------------------------------
+--	SOURCE FILE:	Cost.cpp -
+--
+--	PROGRAM:		Transport Layer Protocol Analyser
+--
+--	FUNCTIONS:
+--					void readCpuUsage(CPU_USAGE *usage)
+--					void cpuSince(CPU_USAGE *start, CPU_USAGE *cost)
+--					void logCpuCost(CPU_USAGE *cost, ULONGLONG bytes, ULONGLONG packets, HANDLE logFile)
+--					void retireThread()
+--					BOOL countContextSwitches(ULONGLONG *switches, DWORD onlyThread, CPU_USAGE *usage)
+--					BOOL threadsLost(CPU_USAGE *start, CPU_USAGE *now)
+--
+--	DATE:			Oct 19, 2026
+--
+--	REVISIONS:		Oct 19, 2026
+--
+--	DESIGNER:		Gabriella Cheung
+--
+--	PROGRAMMER:		Gabriella Cheung
+--
+--	NOTES:
+--	This file contains the CPU accounting reported next to throughput, so that
+--  two builds moving the same Gbit/s can be told apart by what they burn. Each
+--  figure is process-wide: user and system time from GetProcessTimes, cycles
+--  from QueryProcessCycleTime, I/O requests from GetProcessIoCounters and
+--  context switches from the thread list NtQuerySystemInformation returns.
+--
+--  Windows keeps no count of system calls, so the I/O requests stand in for
+--  them: every Winsock send and receive is one. Nor does it split voluntary
+--  from involuntary context switches, so only the total is reported.
+--  Instruction and cache-miss counters need a kernel profiling session and
+--  administrator rights, so they are left out.
+--
+--  A thread's context switches are only listed while it runs, so threads that
+--  end inside a transfer hand theirs over with retireThread as they finish.
+--  A thread that ends without it, such as a server thread at shutdown, makes
+--  the count partial, and the report says so.
+--
+---------------------------------------------------------------------------------*/
+#include "resource.h"
+
+BOOL countContextSwitches(ULONGLONG *, DWORD, CPU_USAGE *);
+BOOL threadsLost(CPU_USAGE *, CPU_USAGE *);
+
+static QUERY_SYSTEM_INFORMATION querySystemInformation;
+static ULONG processBufferSize = COST_PROCESS_BUFFER;
+static volatile LONG64 retiredSwitches;		//context switches of threads that have retired
+static volatile LONG retiredThreads;
+static DWORD retiredIds[COST_RETIRED];		//ring of the latest retired thread ids
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: readCpuUsage
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--				Oct 19, 2026 - adds retired threads and keeps the thread ids
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void readCpuUsage(CPU_USAGE *usage)
+--
+--	PARAMETERS:	CPU_USAGE *usage - receives the process's usage so far
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	Counting context switches lists every process on the system, which takes
+--  in the order of a millisecond, so this is only called at the edges of a
+--  transfer.
+--
+---------------------------------------------------------------------------------*/
+void readCpuUsage(CPU_USAGE *usage)
+{
+	HANDLE process = GetCurrentProcess();
+	FILETIME created, exited, kernel, user;
+	IO_COUNTERS io;
+	ULONG64 cycles;
+	ULONGLONG retired;
+
+	ZeroMemory(usage, sizeof(CPU_USAGE));
+	usage->wallTime = currentFileTime();
+	if (GetProcessTimes(process, &created, &exited, &kernel, &user))
+	{
+		usage->kernelTime = ((ULONGLONG)kernel.dwHighDateTime << 32) | kernel.dwLowDateTime;
+		usage->userTime = ((ULONGLONG)user.dwHighDateTime << 32) | user.dwLowDateTime;
+	}
+	if (QueryProcessCycleTime(process, &cycles))
+	{
+		usage->cycles = cycles;
+	}
+	if (GetProcessIoCounters(process, &io))
+	{
+		usage->ioCalls = io.ReadOperationCount + io.WriteOperationCount + io.OtherOperationCount;
+	}
+	// read before the thread list, so a thread retiring meanwhile is counted once
+	usage->retired = retiredThreads;
+	retired = retiredSwitches;
+	usage->switchesCounted = countContextSwitches(&(usage->contextSwitches), 0, usage);
+	usage->contextSwitches += retired;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: cpuSince
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--				Oct 19, 2026 - clamps the switch count and flags it partial
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void cpuSince(CPU_USAGE *start, CPU_USAGE *cost)
+--
+--	PARAMETERS:	CPU_USAGE *start - usage read at the start of a transfer
+--				CPU_USAGE *cost - receives the usage since then
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	The context switches are partial if a thread listed at the start has
+--  gone without retiring. A count that went backwards is taken as 0.
+--
+---------------------------------------------------------------------------------*/
+void cpuSince(CPU_USAGE *start, CPU_USAGE *cost)
+{
+	CPU_USAGE now;
+
+	readCpuUsage(&now);
+	cost->wallTime = now.wallTime - start->wallTime;
+	cost->userTime = now.userTime - start->userTime;
+	cost->kernelTime = now.kernelTime - start->kernelTime;
+	cost->cycles = now.cycles - start->cycles;
+	cost->ioCalls = now.ioCalls - start->ioCalls;
+	cost->switchesCounted = now.switchesCounted && start->switchesCounted;
+	cost->switchesPartial = cost->switchesCounted && (now.contextSwitches < start->contextSwitches || threadsLost(start, &now));
+	cost->contextSwitches = cost->switchesCounted && now.contextSwitches > start->contextSwitches
+		? now.contextSwitches - start->contextSwitches : 0;
+	cost->retired = now.retired - start->retired;
+	cost->threadCount = 0;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: logCpuCost
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--				Oct 19, 2026 - says when the switch count is partial
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void logCpuCost(CPU_USAGE *cost, ULONGLONG bytes, ULONGLONG packets, HANDLE logFile)
+--
+--	PARAMETERS:	CPU_USAGE *cost - usage over a transfer, from cpuSince
+--				ULONGLONG bytes - bytes the transfer moved
+--				ULONGLONG packets - datagrams, segments or messages it moved
+--				HANDLE logFile - handle for the client or server log file
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	CPU time includes every thread, so a transfer that kept more than one
+--  core busy shows over 100%.
+--
+---------------------------------------------------------------------------------*/
+void logCpuCost(CPU_USAGE *cost, ULONGLONG bytes, ULONGLONG packets, HANDLE logFile)
+{
+	char message[256];
+	double cpuNs = (cost->userTime + cost->kernelTime) * 100.0;
+
+	if (cost->switchesCounted)
+	{
+		sprintf(message, "CPU: %.1f ms user, %.1f ms system (%.0f%% of a core), %llu cycles, %llu I/O calls, %llu context switches%s",
+			cost->userTime / 10000.0, cost->kernelTime / 10000.0,
+			cost->wallTime > 0 ? cpuNs / (cost->wallTime * 100.0) * 100 : 0.0,
+			cost->cycles, cost->ioCalls, cost->contextSwitches,
+			cost->switchesPartial ? " (partial: a thread exited with its count)" : "");
+	}
+	else {
+		sprintf(message, "CPU: %.1f ms user, %.1f ms system (%.0f%% of a core), %llu cycles, %llu I/O calls",
+			cost->userTime / 10000.0, cost->kernelTime / 10000.0,
+			cost->wallTime > 0 ? cpuNs / (cost->wallTime * 100.0) * 100 : 0.0,
+			cost->cycles, cost->ioCalls);
+	}
+	writeToScreen(message);
+	strcat(message, "\r\n");
+	writeToFile(logFile, message);
+	if (bytes == 0 || packets == 0)
+	{
+		return;
+	}
+	if (cost->switchesCounted && !cost->switchesPartial)
+	{
+		sprintf(message, "CPU cost: %.3f ns/byte, %.0f ns/packet, %.2f cycles/byte, %.2f I/O calls/packet, %.3f context switches/packet",
+			cpuNs / bytes, cpuNs / packets, (double)cost->cycles / bytes,
+			(double)cost->ioCalls / packets, (double)cost->contextSwitches / packets);
+	}
+	else {
+		sprintf(message, "CPU cost: %.3f ns/byte, %.0f ns/packet, %.2f cycles/byte, %.2f I/O calls/packet",
+			cpuNs / bytes, cpuNs / packets, (double)cost->cycles / bytes, (double)cost->ioCalls / packets);
+	}
+	writeToScreen(message);
+	strcat(message, "\r\n");
+	writeToFile(logFile, message);
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: retireThread
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void retireThread()
+--
+--	PARAMETERS:	none
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	Called by a thread as the last thing before it returns, so its context
+--  switches stay in the process's count once it is gone. Until it has exited
+--  a reading can count it twice, so callers wait for such threads before
+--  their closing readCpuUsage.
+--
+---------------------------------------------------------------------------------*/
+void retireThread()
+{
+	ULONGLONG switches;
+
+	if (countContextSwitches(&switches, GetCurrentThreadId(), NULL))
+	{
+		InterlockedExchangeAdd64(&retiredSwitches, (LONG64)switches);
+		retiredIds[(InterlockedIncrement(&retiredThreads) - 1) % COST_RETIRED] = GetCurrentThreadId();
+	}
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: countContextSwitches
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--				Oct 19, 2026 - one thread, and the ids of all of them
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	BOOL countContextSwitches(ULONGLONG *switches, DWORD onlyThread, CPU_USAGE *usage)
+--
+--	PARAMETERS:	ULONGLONG *switches - receives the context switches of this
+--								process's live threads
+--				DWORD onlyThread - count just this thread, 0 for all of them
+--				CPU_USAGE *usage - receives the ids of the threads, may be NULL
+--
+--	RETURNS:	FALSE if the process list could not be read
+--
+--	NOTES:
+--	Each SYSTEM_PROCESS_INFORMATION is followed by its threads, and winternl.h
+--  names a thread's context switch count Reserved3. Threads that have exited
+--  take their count with them, so the ids are kept for threadsLost to check.
+--
+---------------------------------------------------------------------------------*/
+BOOL countContextSwitches(ULONGLONG *switches, DWORD onlyThread, CPU_USAGE *usage)
+{
+	HANDLE self = (HANDLE)(ULONG_PTR)GetCurrentProcessId();
+	SYSTEM_PROCESS_INFORMATION *process;
+	SYSTEM_THREAD_INFORMATION *thread;
+	ULONG size = processBufferSize, needed = 0;
+	LONG status = COST_LENGTH_MISMATCH;
+	char *buffer = NULL;
+
+	*switches = 0;
+	if (querySystemInformation == NULL)
+	{
+		querySystemInformation = (QUERY_SYSTEM_INFORMATION)GetProcAddress(GetModuleHandle("ntdll.dll"), "NtQuerySystemInformation");
+		if (querySystemInformation == NULL)
+		{
+			return FALSE;
+		}
+	}
+	// the list grows between the call that sizes it and the next
+	for (int tries = 0; tries < 4 && status == COST_LENGTH_MISMATCH; tries++)
+	{
+		free(buffer);
+		if ((buffer = (char *)malloc(size)) == NULL)
+		{
+			return FALSE;
+		}
+		status = querySystemInformation(SystemProcessInformation, buffer, size, &needed);
+		if (status == COST_LENGTH_MISMATCH)
+		{
+			size = needed > size ? needed + needed / 4 : size * 2;
+		}
+	}
+	processBufferSize = size;
+	if (status < 0)
+	{
+		free(buffer);
+		return FALSE;
+	}
+	for (process = (SYSTEM_PROCESS_INFORMATION *)buffer; ; process = (SYSTEM_PROCESS_INFORMATION *)((char *)process + process->NextEntryOffset))
+	{
+		if (process->UniqueProcessId == self)
+		{
+			thread = (SYSTEM_THREAD_INFORMATION *)(process + 1);
+			for (ULONG i = 0; i < process->NumberOfThreads; i++)
+			{
+				if (onlyThread != 0 && (DWORD)(ULONG_PTR)thread[i].ClientId.UniqueThread != onlyThread)
+				{
+					continue;
+				}
+				*switches += thread[i].Reserved3;
+				if (usage != NULL && usage->threadCount < COST_THREADS)
+				{
+					usage->threadIds[usage->threadCount] = (DWORD)(ULONG_PTR)thread[i].ClientId.UniqueThread;
+				}
+				if (usage != NULL && usage->threadCount <= COST_THREADS)
+				{
+					usage->threadCount++;
+				}
+			}
+			free(buffer);
+			return TRUE;
+		}
+		if (process->NextEntryOffset == 0)
+		{
+			break;
+		}
+	}
+	free(buffer);
+	return FALSE;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: threadsLost
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	BOOL threadsLost(CPU_USAGE *start, CPU_USAGE *now)
+--
+--	PARAMETERS:	CPU_USAGE *start - earlier reading
+--				CPU_USAGE *now - later reading
+--
+--	RETURNS:	TRUE if a thread listed in start is neither listed in now nor
+--				retired since, or if either list was too long to tell
+--
+---------------------------------------------------------------------------------*/
+BOOL threadsLost(CPU_USAGE *start, CPU_USAGE *now)
+{
+	BOOL found;
+
+	if (start->threadCount > COST_THREADS || now->threadCount > COST_THREADS || now->retired - start->retired > COST_RETIRED)
+	{
+		return TRUE;
+	}
+	for (int i = 0; i < start->threadCount; i++)
+	{
+		found = FALSE;
+		for (int j = 0; j < now->threadCount && !found; j++)
+		{
+			found = now->threadIds[j] == start->threadIds[i];
+		}
+		for (LONG j = start->retired; j < now->retired && !found; j++)
+		{
+			found = retiredIds[j % COST_RETIRED] == start->threadIds[i];
+		}
+		if (!found)
+		{
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
\ No newline at end of file
@@ -0,0 +1,28 @@
+#pragma once
+
+#define COST_PROCESS_BUFFER		(256 * 1024)	//first guess at the system process list size
+#define COST_THREADS			256		//thread ids a reading keeps, more leaves the switch count partial
+#define COST_RETIRED			256		//threads retireThread remembers
+#define COST_LENGTH_MISMATCH	((LONG)0xC0000004)	//STATUS_INFO_LENGTH_MISMATCH, ntstatus.h clashes with winnt.h
+
+typedef LONG (WINAPI *QUERY_SYSTEM_INFORMATION)(SYSTEM_INFORMATION_CLASS, PVOID, ULONG, PULONG);
+
+// Process-wide CPU usage at one point in time, or the difference between two.
+typedef struct _CPU_USAGE {
+	ULONGLONG wallTime;			// FILETIME
+	ULONGLONG userTime;			// 100 ns units
+	ULONGLONG kernelTime;
+	ULONGLONG cycles;			// QueryProcessCycleTime, every thread since it started
+	ULONGLONG ioCalls;			// read, write and other I/O requests, socket calls among them
+	ULONGLONG contextSwitches;	// summed over the process's threads
+	BOOL switchesCounted;		// FALSE if ntdll would not list the threads
+	BOOL switchesPartial;		// a thread left without retireThread, taking its switches with it
+	LONG retired;				// retireThread calls before the reading
+	int threadCount;			// threads listed, COST_THREADS + 1 if there were more
+	DWORD threadIds[COST_THREADS];
+} CPU_USAGE;
+
+void readCpuUsage(CPU_USAGE *);
+void cpuSince(CPU_USAGE *, CPU_USAGE *);
+void logCpuCost(CPU_USAGE *, ULONGLONG, ULONGLONG, HANDLE);
+void retireThread();
\ No newline at end of file
@@ -0,0 +1,712 @@
+/*---------------------------------------------------------------------------------
+--	SOURCE FILE:	Dissect.cpp -
+--
+--	PROGRAM:		Transport Layer Protocol Analyser
+--
+--	FUNCTIONS:
+--					void dissectBatch(PACKET_BATCH *batch)
+--					BOOL initConversations(CONVERSATION_TABLE *table)
+--					void freeConversations(CONVERSATION_TABLE *table)
+--					void addConversations(CONVERSATION_TABLE *table, PACKET_BATCH *batch)
+--					int topConversations(CONVERSATION_TABLE *table, int protocol, CONVERSATION **top, int count)
+--					char *formatEndpoint(IN6_ADDR *address, USHORT port, char *text)
+--					DWORD WINAPI benchmarkDissector(LPVOID)
+--					DWORD endpointHash(IN6_ADDR *address, USHORT port)
+--					void trackSequence(CONVERSATION *conversation, int side, DWORD sequence, DWORD span)
+--					void buildBenchPackets(BYTE *packets, DWORD *lengths)
+--
+--	DATE:			Oct 19, 2026
+--
+--	REVISIONS:		Oct 19, 2026
+--
+--	DESIGNER:		Gabriella Cheung
+--
+--	PROGRAMMER:		Gabriella Cheung
+--
+--	NOTES:
+--	This file decodes captured IP packets and groups them into conversations,
+--  both directions of one TCP connection or UDP exchange.
+--
+--  Packets are dissected DISSECT_BATCH at a time into a PACKET_BATCH, which
+--  keeps each field in an array of its own. The headers of the packets a few
+--  places ahead are prefetched while one is parsed. Where IPv4 and IPv6, or
+--  TCP and UDP, keep a field in different places, both places are inside
+--  bytes already known to be there and the field is picked with a select, so
+--  the only branches left are the ones that throw a packet away and the
+--  address copy.
+--
+--  The conversation table is open-addressed like the UDP server's flow table
+--  (see Flow.cpp), with slots holding the hash. The hash of a conversation is
+--  the sum of the hashes of its two ends, so both directions land in the same
+--  slot without sorting the ends first. A whole batch is hashed, and its slots
+--  prefetched, before any of it is looked up. Conversations are kept until the
+--  table is cleared, so their durations cover the whole transfer.
+--
+--  TCP retransmissions are judged from sequence numbers alone: a segment that
+--  ends at or before the furthest one seen from its side was sent before, and
+--  one that starts past it means something before it is missing. Keepalives
+--  count as retransmissions.
+--
+---------------------------------------------------------------------------------*/
+#include "resource.h"
+
+DWORD endpointHash(IN6_ADDR *, USHORT);
+void trackSequence(CONVERSATION *, int, DWORD, DWORD);
+void buildBenchPackets(BYTE *, DWORD *);
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: dissectBatch
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void dissectBatch(PACKET_BATCH *batch)
+--
+--	PARAMETERS:	PACKET_BATCH *batch - packets to dissect
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	IPv4 or IPv6 packets carrying TCP or UDP directly are dissected; anything
+--  else, later IPv4 fragments and IPv6 extension headers included, is left
+--  with protocol 0. The UDP length trims any padding after a datagram.
+--
+---------------------------------------------------------------------------------*/
+void dissectBatch(PACKET_BATCH *batch)
+{
+	BYTE *ip, *transport, next;
+	DWORD captured, ipLength, header, transportLength, total, end, udpEnd, i;
+	DWORD *mapped;
+	BOOL v6, tcp, valid;
+
+	for (i = 0; i < batch->count && i < DISSECT_PREFETCH; i++)
+	{
+		_mm_prefetch((char *)batch->data[i], _MM_HINT_T0);
+	}
+	for (i = 0; i < batch->count; i++)
+	{
+		if (i + DISSECT_PREFETCH < batch->count)
+		{
+			_mm_prefetch((char *)batch->data[i + DISSECT_PREFETCH], _MM_HINT_T0);
+		}
+		ip = batch->data[i];
+		captured = batch->captured[i];
+		batch->protocol[i] = 0;
+		if (captured < sizeof(IP_HEADER))
+		{
+			continue;
+		}
+
+		//every field read here lies in the first 20 bytes of either version
+		v6 = (ip[0] >> 4) == 6;
+		ipLength = v6 ? IPV6_HEADER_LENGTH : (ip[0] & 0x0F) * 4;
+		next = v6 ? ip[6] : ((IP_HEADER *)ip)->protocol;
+		total = v6 ? IPV6_HEADER_LENGTH + ntohs(*(WORD *)(ip + 4)) : ntohs(((IP_HEADER *)ip)->totalLength);
+		tcp = next == IPPROTO_TCP;
+		header = ipLength + (tcp ? sizeof(TCP_HEADER) : sizeof(UDP_HEADER));
+		valid = (v6 | ((ip[0] >> 4) == 4)) & (ipLength >= sizeof(IP_HEADER)) & (tcp | (next == IPPROTO_UDP))
+			& (v6 | ((ntohs(((IP_HEADER *)ip)->fragment) & IP_FRAGMENT_OFFSET) == 0))
+			& (captured >= header) & (total >= header);
+		if (!valid)
+		{
+			continue;
+		}
+
+		//the ports and the UDP length share their places with the TCP header's first eight bytes
+		transport = ip + ipLength;
+		transportLength = tcp ? (((TCP_HEADER *)transport)->offset >> 4) * 4 : sizeof(UDP_HEADER);
+		end = total < captured ? total : captured;
+		udpEnd = ipLength + ntohs(((UDP_HEADER *)transport)->length);
+		end = !tcp && udpEnd >= header && udpEnd < end ? udpEnd : end;
+		if (transportLength < header - ipLength || ipLength + transportLength > end)
+		{
+			continue;
+		}
+
+		batch->protocol[i] = next;
+		batch->version[i] = v6 ? 6 : 4;
+		batch->flags[i] = tcp ? ((TCP_HEADER *)transport)->flags : 0;
+		batch->sequence[i] = tcp ? ntohl(((TCP_HEADER *)transport)->sequence) : 0;
+		batch->sourcePort[i] = ((UDP_HEADER *)transport)->sourcePort;
+		batch->destinationPort[i] = ((UDP_HEADER *)transport)->destinationPort;
+		batch->payload[i] = ipLength + transportLength;
+		batch->length[i] = end - batch->payload[i];
+		batch->truncated[i] = (total > captured) | (!tcp & (udpEnd > end));
+		if (v6)
+		{
+			memcpy(&(batch->source[i]), ip + 8, sizeof(IN6_ADDR));
+			memcpy(&(batch->destination[i]), ip + 24, sizeof(IN6_ADDR));
+		}
+		else {
+			mapped = (DWORD *)&(batch->source[i]);
+			mapped[0] = 0;
+			mapped[1] = 0;
+			mapped[2] = htonl(0xFFFF);
+			mapped[3] = ((IP_HEADER *)ip)->source;
+			mapped = (DWORD *)&(batch->destination[i]);
+			mapped[0] = 0;
+			mapped[1] = 0;
+			mapped[2] = htonl(0xFFFF);
+			mapped[3] = ((IP_HEADER *)ip)->destination;
+		}
+	}
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: initConversations
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	BOOL initConversations(CONVERSATION_TABLE *table)
+--
+--	PARAMETERS:	CONVERSATION_TABLE *table - table to set up or clear
+--
+--	RETURNS:	FALSE if the table could not be allocated
+--
+--	NOTES:
+--	Like initFlows, the memory is kept and only cleared here, and comes from
+--  the placement's NUMA node.
+--
+---------------------------------------------------------------------------------*/
+BOOL initConversations(CONVERSATION_TABLE *table)
+{
+	if (table->slots == NULL)
+	{
+		table->slots = (FLOW_SLOT *)nodeAlloc(sizeof(FLOW_SLOT) * CONVERSATION_SLOTS);
+		table->conversations = (CONVERSATION *)nodeAlloc(sizeof(CONVERSATION) * CONVERSATION_MAX);
+		if (table->slots == NULL || table->conversations == NULL)
+		{
+			freeConversations(table);
+			return FALSE;
+		}
+	}
+	memset(table->slots, 0xFF, sizeof(FLOW_SLOT) * CONVERSATION_SLOTS);
+	table->used = 0;
+	table->untracked = 0;
+	return TRUE;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: freeConversations
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void freeConversations(CONVERSATION_TABLE *table)
+--
+--	PARAMETERS:	CONVERSATION_TABLE *table - table to release
+--
+--	RETURNS:	void
+--
+---------------------------------------------------------------------------------*/
+void freeConversations(CONVERSATION_TABLE *table)
+{
+	if (table->slots != NULL)
+	{
+		VirtualFree(table->slots, 0, MEM_RELEASE);
+		table->slots = NULL;
+	}
+	if (table->conversations != NULL)
+	{
+		VirtualFree(table->conversations, 0, MEM_RELEASE);
+		table->conversations = NULL;
+	}
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: addConversations
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void addConversations(CONVERSATION_TABLE *table, PACKET_BATCH *batch)
+--
+--	PARAMETERS:	CONVERSATION_TABLE *table - conversations seen so far
+--				PACKET_BATCH *batch - dissected packets
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	Finds each packet's conversation, starting one with the packet's sender
+--  as side 0 if there is none, and adds the packet to its side. When every
+--  conversation is in use the packet is only counted as untracked.
+--
+---------------------------------------------------------------------------------*/
+void addConversations(CONVERSATION_TABLE *table, PACKET_BATCH *batch)
+{
+	DWORD hashes[DISSECT_BATCH];
+	DWORD i, s, span;
+	FLOW_SLOT *slot;
+	CONVERSATION *conversation;
+	LONG index;
+	int side = 0;
+
+	if (table->slots == NULL)
+	{
+		return;
+	}
+	for (i = 0; i < batch->count; i++)
+	{
+		if (batch->protocol[i] == 0)
+		{
+			continue;
+		}
+		hashes[i] = endpointHash(&(batch->source[i]), batch->sourcePort[i])
+			+ endpointHash(&(batch->destination[i]), batch->destinationPort[i]) + batch->protocol[i];
+		_mm_prefetch((char *)&(table->slots[hashes[i] & (CONVERSATION_SLOTS - 1)]), _MM_HINT_T0);
+	}
+
+	for (i = 0; i < batch->count; i++)
+	{
+		if (batch->protocol[i] == 0)
+		{
+			continue;
+		}
+		conversation = NULL;
+		for (s = hashes[i] & (CONVERSATION_SLOTS - 1); (slot = &(table->slots[s]))->flow != FLOW_NONE; s = (s + 1) & (CONVERSATION_SLOTS - 1))
+		{
+			if (slot->hash != hashes[i] || table->conversations[slot->flow].protocol != batch->protocol[i])
+			{
+				continue;
+			}
+			conversation = &(table->conversations[slot->flow]);
+			if (conversation->port[0] == batch->sourcePort[i] && conversation->port[1] == batch->destinationPort[i]
+				&& memcmp(&(conversation->address[0]), &(batch->source[i]), sizeof(IN6_ADDR)) == 0
+				&& memcmp(&(conversation->address[1]), &(batch->destination[i]), sizeof(IN6_ADDR)) == 0)
+			{
+				side = 0;
+				break;
+			}
+			if (conversation->port[1] == batch->sourcePort[i] && conversation->port[0] == batch->destinationPort[i]
+				&& memcmp(&(conversation->address[1]), &(batch->source[i]), sizeof(IN6_ADDR)) == 0
+				&& memcmp(&(conversation->address[0]), &(batch->destination[i]), sizeof(IN6_ADDR)) == 0)
+			{
+				side = 1;
+				break;
+			}
+			conversation = NULL;
+		}
+
+		if (conversation == NULL)
+		{
+			//slot is the empty slot that ended the probe
+			if (table->used >= CONVERSATION_MAX)
+			{
+				table->untracked++;
+				continue;
+			}
+			index = table->used++;
+			conversation = &(table->conversations[index]);
+			ZeroMemory(conversation, sizeof(CONVERSATION));
+			conversation->address[0] = batch->source[i];
+			conversation->address[1] = batch->destination[i];
+			conversation->port[0] = batch->sourcePort[i];
+			conversation->port[1] = batch->destinationPort[i];
+			conversation->protocol = batch->protocol[i];
+			conversation->firstTime = batch->time[i];
+			slot->hash = hashes[i];
+			slot->flow = index;
+			side = 0;
+		}
+
+		conversation->lastTime = batch->time[i];
+		conversation->packets[side]++;
+		conversation->bytes[side] += batch->length[i];
+		if (batch->protocol[i] == IPPROTO_TCP)
+		{
+			conversation->flags[side] |= batch->flags[i];
+			//SYN and FIN take a sequence number each
+			span = batch->length[i] + ((batch->flags[i] & TCP_SYN) != 0) + ((batch->flags[i] & TCP_FIN) != 0);
+			if (span > 0)
+			{
+				trackSequence(conversation, side, batch->sequence[i], span);
+			}
+		}
+	}
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: topConversations
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	int topConversations(CONVERSATION_TABLE *table, int protocol,
+--					CONVERSATION **top, int count)
+--
+--	PARAMETERS:	CONVERSATION_TABLE *table - conversations seen so far
+--				int protocol - IPPROTO_TCP or IPPROTO_UDP
+--				CONVERSATION **top - receives the largest conversations
+--				int count - room in top
+--
+--	RETURNS:	the number of conversations put in top
+--
+--	NOTES:
+--	Largest first, by the bytes of both sides. An insertion into a short
+--  sorted list, since only the report asks.
+--
+---------------------------------------------------------------------------------*/
+int topConversations(CONVERSATION_TABLE *table, int protocol, CONVERSATION **top, int count)
+{
+	int found = 0, j;
+	CONVERSATION *conversation;
+	ULONGLONG bytes;
+
+	for (LONG i = 0; i < table->used; i++)
+	{
+		conversation = &(table->conversations[i]);
+		if (conversation->protocol != protocol)
+		{
+			continue;
+		}
+		bytes = conversation->bytes[0] + conversation->bytes[1];
+		for (j = found < count ? found : count; j > 0 && top[j - 1]->bytes[0] + top[j - 1]->bytes[1] < bytes; j--)
+		{
+			if (j < count)
+			{
+				top[j] = top[j - 1];
+			}
+		}
+		if (j < count)
+		{
+			top[j] = conversation;
+			if (found < count)
+			{
+				found++;
+			}
+		}
+	}
+	return found;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: formatEndpoint
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	char *formatEndpoint(IN6_ADDR *address, USHORT port, char *text)
+--
+--	PARAMETERS:	IN6_ADDR *address - address of one end
+--				USHORT port - its port, network order
+--				char *text - receives the end, ENDPOINT_LENGTH bytes
+--
+--	RETURNS:	text
+--
+--	NOTES:
+--	IPv4-mapped addresses are written as plain IPv4.
+--
+---------------------------------------------------------------------------------*/
+char *formatEndpoint(IN6_ADDR *address, USHORT port, char *text)
+{
+	DWORD *words = (DWORD *)address;
+	struct in_addr ipv4;
+	char ipv6[INET6_ADDRSTRLEN];
+
+	if (words[0] == 0 && words[1] == 0 && words[2] == htonl(0xFFFF))
+	{
+		ipv4.s_addr = words[3];
+		sprintf(text, "%s:%d", inet_ntoa(ipv4), ntohs(port));
+	}
+	else if (inet_ntop(AF_INET6, address, ipv6, sizeof(ipv6)) != NULL)
+	{
+		sprintf(text, "[%s]:%d", ipv6, ntohs(port));
+	}
+	else {
+		sprintf(text, "[?]:%d", ntohs(port));
+	}
+	return text;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: benchmarkDissector
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	DWORD WINAPI benchmarkDissector(LPVOID n)
+--
+--	PARAMETERS:	LPVOID n - unused
+--
+--	RETURNS:	DWORD
+--
+--	NOTES:
+--	Runs on its own thread, pinned to the CPU it started on, so the result is
+--  the rate of one core. DISSECT_BENCH_PACKETS packets of DISSECT_BENCH_FLOWS
+--  conversations, a mix of IPv4 and IPv6 and of TCP and UDP in both
+--  directions, are dissected DISSECT_BENCH_ROUNDS times, once on their own and
+--  once with the conversation table. The packets stay in the cache, so this is
+--  the cost of the code rather than of fetching packets from memory.
+--
+---------------------------------------------------------------------------------*/
+DWORD WINAPI benchmarkDissector(LPVOID n)
+{
+	BYTE *packets;
+	DWORD *lengths;
+	PACKET_BATCH batch;
+	CONVERSATION_TABLE table = { 0 };
+	LARGE_INTEGER frequency, start, end;
+	ULONGLONG total = (ULONGLONG)DISSECT_BENCH_PACKETS * DISSECT_BENCH_ROUNDS, understood = 0;
+	double seconds[2];
+	char message[256];
+
+	TRACE_THREAD("dissector benchmark");
+	SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << GetCurrentProcessorNumber());
+	packets = (BYTE *)VirtualAlloc(NULL, DISSECT_BENCH_PACKETS * (DISSECT_BENCH_STRIDE + sizeof(DWORD)), MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+	if (packets == NULL || !initConversations(&table))
+	{
+		writeToScreen("Dissector benchmark could not allocate its packets");
+		if (packets != NULL)
+		{
+			VirtualFree(packets, 0, MEM_RELEASE);
+		}
+		return 0;
+	}
+	lengths = (DWORD *)(packets + DISSECT_BENCH_PACKETS * DISSECT_BENCH_STRIDE);
+	buildBenchPackets(packets, lengths);
+	writeToScreen("Dissector benchmark running");
+
+	QueryPerformanceFrequency(&frequency);
+	for (int pass = 0; pass < 2; pass++)
+	{
+		QueryPerformanceCounter(&start);
+		for (int round = 0; round < DISSECT_BENCH_ROUNDS; round++)
+		{
+			for (DWORD first = 0; first < DISSECT_BENCH_PACKETS; first += DISSECT_BATCH)
+			{
+				batch.count = DISSECT_BATCH;
+				for (DWORD i = 0; i < DISSECT_BATCH; i++)
+				{
+					batch.data[i] = packets + (first + i) * DISSECT_BENCH_STRIDE;
+					batch.captured[i] = lengths[first + i];
+					batch.time[i] = round;
+				}
+				dissectBatch(&batch);
+				if (pass == 1)
+				{
+					addConversations(&table, &batch);
+				}
+				else {
+					for (DWORD i = 0; i < DISSECT_BATCH; i++)
+					{
+						understood += batch.protocol[i] != 0;
+					}
+				}
+			}
+		}
+		QueryPerformanceCounter(&end);
+		seconds[pass] = (double)(end.QuadPart - start.QuadPart) / frequency.QuadPart;
+	}
+
+	sprintf(message, "Dissector: %llu packets (%llu understood), %.2f million packets/s per core, %.1f ns each",
+		total, understood, total / seconds[0] / 1000000, seconds[0] * 1000000000 / total);
+	writeToScreen(message);
+	sprintf(message, "Dissector and conversation table: %.2f million packets/s per core, %.1f ns each, %ld conversations",
+		total / seconds[1] / 1000000, seconds[1] * 1000000000 / total, table.used);
+	writeToScreen(message);
+	freeConversations(&table);
+	VirtualFree(packets, 0, MEM_RELEASE);
+	return 0;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: endpointHash
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	DWORD endpointHash(IN6_ADDR *address, USHORT port)
+--
+--	PARAMETERS:	IN6_ADDR *address - address of one end
+--				USHORT port - its port
+--
+--	RETURNS:	the hash of the end
+--
+--	NOTES:
+--	Folded to 64 bits and mixed with flowHash's finalizer.
+--
+---------------------------------------------------------------------------------*/
+DWORD endpointHash(IN6_ADDR *address, USHORT port)
+{
+	DWORD *words = (DWORD *)address;
+	ULONGLONG key = ((ULONGLONG)(words[0] ^ words[1]) << 32 | (words[2] ^ port)) ^ (words[3] * 0x9E3779B97F4A7C15ULL);
+
+	key ^= key >> 33;
+	key *= 0xFF51AFD7ED558CCDULL;
+	key ^= key >> 33;
+	key *= 0xC4CEB9FE1A85EC53ULL;
+	key ^= key >> 33;
+	return (DWORD)key;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: trackSequence
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void trackSequence(CONVERSATION *conversation, int side, DWORD sequence, DWORD span)
+--
+--	PARAMETERS:	CONVERSATION *conversation - a TCP conversation
+--				int side - side that sent the segment
+--				DWORD sequence - the segment's sequence number
+--				DWORD span - sequence numbers it takes
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	Sequence numbers are compared as distances, so they may wrap. A segment
+--  that overlaps the furthest one seen and carries new data past it counts
+--  as a retransmission and moves the end on.
+--
+---------------------------------------------------------------------------------*/
+void trackSequence(CONVERSATION *conversation, int side, DWORD sequence, DWORD span)
+{
+	DWORD next = conversation->nextSequence[side];
+
+	if (!conversation->sequenced[side])
+	{
+		conversation->sequenced[side] = TRUE;
+		conversation->nextSequence[side] = sequence + span;
+		return;
+	}
+	if ((LONG)(sequence + span - next) <= 0)
+	{
+		conversation->retransmitted[side]++;
+		return;
+	}
+	if ((LONG)(sequence - next) > 0)
+	{
+		conversation->outOfOrder[side]++;
+	}
+	else if ((LONG)(sequence - next) < 0)
+	{
+		conversation->retransmitted[side]++;
+	}
+	conversation->nextSequence[side] = sequence + span;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: buildBenchPackets
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void buildBenchPackets(BYTE *packets, DWORD *lengths)
+--
+--	PARAMETERS:	BYTE *packets - DISSECT_BENCH_PACKETS slots of DISSECT_BENCH_STRIDE bytes
+--				DWORD *lengths - receives each packet's length
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	Conversation k % DISSECT_BENCH_FLOWS gets packet k; its low two bits pick
+--  IPv4 or IPv6 and TCP or UDP. Every other pass over the conversations is
+--  sent by the other end. Each packet carries 32 bytes of payload and each
+--  side's TCP sequence numbers run on without gaps.
+--
+---------------------------------------------------------------------------------*/
+void buildBenchPackets(BYTE *packets, DWORD *lengths)
+{
+	BYTE *ip, *transport;
+	DWORD flow, ipLength, transportLength, payload = 32;
+	BOOL v6, tcp, reply;
+	BYTE client[16] = { 0xFD }, server[16] = { 0xFD, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1 };
+
+	ZeroMemory(packets, DISSECT_BENCH_PACKETS * DISSECT_BENCH_STRIDE);
+	for (DWORD k = 0; k < DISSECT_BENCH_PACKETS; k++)
+	{
+		ip = packets + k * DISSECT_BENCH_STRIDE;
+		flow = k % DISSECT_BENCH_FLOWS;
+		v6 = (flow & 2) != 0;
+		tcp = (flow & 1) != 0;
+		reply = ((k / DISSECT_BENCH_FLOWS) & 1) != 0;
+		ipLength = v6 ? IPV6_HEADER_LENGTH : sizeof(IP_HEADER);
+		transportLength = tcp ? sizeof(TCP_HEADER) : sizeof(UDP_HEADER);
+		lengths[k] = ipLength + transportLength + payload;
+		client[14] = (BYTE)(flow >> 8);
+		client[15] = (BYTE)flow;
+
+		if (v6)
+		{
+			ip[0] = 0x60;
+			*(WORD *)(ip + 4) = htons((WORD)(transportLength + payload));
+			ip[6] = tcp ? IPPROTO_TCP : IPPROTO_UDP;
+			ip[7] = 64;
+			memcpy(ip + 8, reply ? server : client, 16);
+			memcpy(ip + 24, reply ? client : server, 16);
+		}
+		else {
+			((IP_HEADER *)ip)->versionLength = 0x45;
+			((IP_HEADER *)ip)->totalLength = htons((WORD)lengths[k]);
+			((IP_HEADER *)ip)->ttl = 64;
+			((IP_HEADER *)ip)->protocol = tcp ? IPPROTO_TCP : IPPROTO_UDP;
+			((IP_HEADER *)ip)->source = htonl(reply ? 0x0A000001 : 0x0A010000 + flow);
+			((IP_HEADER *)ip)->destination = htonl(reply ? 0x0A010000 + flow : 0x0A000001);
+		}
+
+		transport = ip + ipLength;
+		((UDP_HEADER *)transport)->sourcePort = htons((WORD)(reply ? UDPSERVPORT : 40000 + flow));
+		((UDP_HEADER *)transport)->destinationPort = htons((WORD)(reply ? 40000 + flow : UDPSERVPORT));
+		if (tcp)
+		{
+			((TCP_HEADER *)transport)->sequence = htonl(k / DISSECT_BENCH_FLOWS / 2 * payload);
+			((TCP_HEADER *)transport)->offset = 0x50;
+			((TCP_HEADER *)transport)->flags = TCP_ACK | TCP_PSH;
+		}
+		else {
+			((UDP_HEADER *)transport)->length = htons((WORD)(transportLength + payload));
+		}
+	}
+}
\ No newline at end of file
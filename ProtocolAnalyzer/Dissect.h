@@ -0,0 +1,75 @@
+#pragma once
+
+#define DISSECT_BATCH			64		//packets dissected at a time
+#define DISSECT_PREFETCH		4		//packets ahead whose headers are fetched while one is parsed
+#define IPV6_HEADER_LENGTH		40
+#define IP_FRAGMENT_OFFSET		0x1FFF	//fragment offset bits of the IP header, in 8 byte units
+#define TCP_FIN					0x01
+#define TCP_SYN					0x02
+#define TCP_RST					0x04
+#define TCP_PSH					0x08
+#define TCP_ACK					0x10
+
+#define CONVERSATION_MAX		65536	//conversations tracked until the table is cleared, the rest only count
+#define CONVERSATION_SLOTS		131072	//hash slots, a power of two at twice the conversations
+#define CONVERSATION_TOP		10		//conversations listed in a report, by bytes
+#define ENDPOINT_LENGTH			56		//"[IPv6 address]:port" and terminator
+
+#define DISSECT_BENCH_PACKETS	4096	//distinct packets the benchmark cycles through
+#define DISSECT_BENCH_FLOWS		1024
+#define DISSECT_BENCH_ROUNDS	2048	//passes over them, 8M packets
+#define DISSECT_BENCH_STRIDE	128		//bytes between the benchmark's packets
+
+// A batch of IP packets and their dissection, one array per field so a pass
+// over a field only touches that field's cache lines. The caller fills count,
+// data, captured and time; dissectBatch fills the rest.
+typedef struct _PACKET_BATCH {
+	DWORD count;
+	BYTE *data[DISSECT_BATCH];			// start of the IP header
+	DWORD captured[DISSECT_BATCH];		// bytes of the packet available
+	ULONGLONG time[DISSECT_BATCH];		// FILETIME the packet was seen
+	BYTE protocol[DISSECT_BATCH];		// IPPROTO_TCP or IPPROTO_UDP, 0 if the packet is neither
+	BYTE version[DISSECT_BATCH];		// 4 or 6
+	BYTE flags[DISSECT_BATCH];			// TCP flags, 0 for UDP
+	BYTE truncated[DISSECT_BATCH];		// the headers give more than was captured
+	IN6_ADDR source[DISSECT_BATCH];		// IPv4 as an IPv4-mapped IPv6 address
+	IN6_ADDR destination[DISSECT_BATCH];
+	USHORT sourcePort[DISSECT_BATCH];	// network order
+	USHORT destinationPort[DISSECT_BATCH];
+	DWORD sequence[DISSECT_BATCH];		// TCP sequence number, host order
+	DWORD payload[DISSECT_BATCH];		// offset of the payload from data
+	DWORD length[DISSECT_BATCH];		// payload bytes captured
+} PACKET_BATCH;
+
+// Both directions of a TCP or UDP conversation. Side 0 is the end that sent
+// the first packet seen.
+typedef struct _CONVERSATION {
+	IN6_ADDR address[2];
+	USHORT port[2];				// network order
+	BYTE protocol;
+	BYTE flags[2];				// TCP flags seen from each side
+	ULONGLONG firstTime;		// FILETIME of the first packet
+	ULONGLONG lastTime;
+	ULONGLONG packets[2];
+	ULONGLONG bytes[2];			// payload bytes
+	BOOL sequenced[2];			// nextSequence holds the end of a segment
+	DWORD nextSequence[2];		// TCP: end of the furthest segment from each side
+	ULONGLONG retransmitted[2];	// TCP segments that end at or before nextSequence
+	ULONGLONG outOfOrder[2];	// TCP segments that start past nextSequence
+} CONVERSATION;
+
+// Only the thread that adds packets may use the table.
+typedef struct _CONVERSATION_TABLE {
+	FLOW_SLOT *slots;
+	CONVERSATION *conversations;
+	LONG used;
+	ULONGLONG untracked;		// packets that arrived while the table was full
+} CONVERSATION_TABLE;
+
+void dissectBatch(PACKET_BATCH *);
+BOOL initConversations(CONVERSATION_TABLE *);
+void freeConversations(CONVERSATION_TABLE *);
+void addConversations(CONVERSATION_TABLE *, PACKET_BATCH *);
+int topConversations(CONVERSATION_TABLE *, int, CONVERSATION **, int);
+char *formatEndpoint(IN6_ADDR *, USHORT, char *);
+DWORD WINAPI benchmarkDissector(LPVOID);
\ No newline at end of file
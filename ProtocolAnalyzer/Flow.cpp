@@ -0,0 +1,442 @@
+/*---------------------------------------------------------------------------------
+--	SOURCE FILE:	Flow.cpp -
+--
+--	PROGRAM:		Transport Layer Protocol Analyser
+--
+--	FUNCTIONS:
+--					BOOL initFlows(FLOW_TABLE *table)
+--					void freeFlows(FLOW_TABLE *table)
+--					void recordFlow(FLOW_TABLE *table, SOCKADDR_IN *peer, DWORD id, DWORD bytes,
+--						LONG sequence, STATS_COUNTERS *messages, ULONGLONG now)
+--					void expireFlows(FLOW_TABLE *table, ULONGLONG now, FLOW_HANDLER report)
+--					DWORD flowHash(ULONG address, USHORT port, DWORD id)
+--					void scheduleFlow(FLOW_TABLE *table, LONG index, ULONGLONG expires)
+--					void removeFlow(FLOW_TABLE *table, LONG index)
+--
+--	DATE:			Oct 19, 2026
+--
+--	REVISIONS:		Oct 19, 2026
+--
+--	DESIGNER:		Gabriella Cheung
+--
+--	PROGRAMMER:		Gabriella Cheung
+--
+--	NOTES:
+--	This file contains the UDP server's per-flow statistics. A flow is the
+--  datagrams from one source address and port carrying one flow id, so two
+--  clients sending at once are reported apart, and so are two runs that happen
+--  to reuse a port.
+--
+--  Flows are found through an open-addressed hash table with linear probing.
+--  It is kept at most half full, so a lookup usually reads one slot. Removals
+--  shift the following entries back instead of leaving tombstones, which keeps
+--  probe runs short however many flows come and go.
+--
+--  Idle flows are found with a hierarchical timer wheel of FLOW_WHEEL_LEVELS
+--  levels of FLOW_WHEEL_SLOTS lists. A flow's timer is set once, when it is
+--  created. A datagram only updates the flow's last time; when the timer goes
+--  off, a flow that has seen traffic since is set again from its last datagram
+--  instead of being reported. Each flow therefore costs at most one timer per
+--  idle timeout, however fast its datagrams arrive.
+--
+---------------------------------------------------------------------------------*/
+#include "resource.h"
+
+DWORD flowHash(ULONG, USHORT, DWORD);
+void scheduleFlow(FLOW_TABLE *, LONG, ULONGLONG);
+void removeFlow(FLOW_TABLE *, LONG);
+
+#define FLOW_TICK_UNITS		((ULONGLONG)FLOW_TICK * 10000)		//FILETIME units per tick
+#define FLOW_IDLE_UNITS		((ULONGLONG)FLOW_IDLE_TIMEOUT * 10000)
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: initFlows
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--				Oct 19, 2026 - allocates from the placement's NUMA node
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	BOOL initFlows(FLOW_TABLE *table)
+--
+--	PARAMETERS:	FLOW_TABLE *table - table to set up
+--
+--	RETURNS:	FALSE if the table could not be allocated
+--
+--	NOTES:
+--	The memory is kept across server restarts and only cleared here. Flows are
+--  handed out in order, so the pages of flows never used are never touched.
+--  All bits set is FLOW_NONE in every slot and wheel list. The memory comes
+--  from the NUMA node of the first server's placement.
+--
+---------------------------------------------------------------------------------*/
+BOOL initFlows(FLOW_TABLE *table)
+{
+	if (table->slots == NULL)
+	{
+		table->slots = (FLOW_SLOT *)nodeAlloc(sizeof(FLOW_SLOT) * FLOW_TABLE_SLOTS);
+		table->flows = (FLOW *)nodeAlloc(sizeof(FLOW) * FLOW_MAX_FLOWS);
+		if (table->slots == NULL || table->flows == NULL)
+		{
+			freeFlows(table);
+			return FALSE;
+		}
+	}
+	memset(table->slots, 0xFF, sizeof(FLOW_SLOT) * FLOW_TABLE_SLOTS);
+	memset(table->wheel, 0xFF, sizeof(table->wheel));
+	table->used = 0;
+	table->freeFlow = FLOW_NONE;
+	table->active = 0;
+	table->highWater = 0;
+	table->untracked = 0;
+	table->tick = currentFileTime() / FLOW_TICK_UNITS;
+	return TRUE;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: freeFlows
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void freeFlows(FLOW_TABLE *table)
+--
+--	PARAMETERS:	FLOW_TABLE *table - table to release
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	Flows still being tracked are dropped without a report.
+--
+---------------------------------------------------------------------------------*/
+void freeFlows(FLOW_TABLE *table)
+{
+	if (table->slots != NULL)
+	{
+		VirtualFree(table->slots, 0, MEM_RELEASE);
+		table->slots = NULL;
+	}
+	if (table->flows != NULL)
+	{
+		VirtualFree(table->flows, 0, MEM_RELEASE);
+		table->flows = NULL;
+	}
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: recordFlow
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void recordFlow(FLOW_TABLE *table, SOCKADDR_IN *peer, DWORD id, DWORD bytes,
+--					LONG sequence, STATS_COUNTERS *messages, ULONGLONG now)
+--
+--	PARAMETERS:	FLOW_TABLE *table - flows of the UDP server
+--				SOCKADDR_IN *peer - sender of the datagram
+--				DWORD id - flow id from the datagram, 0 if it had none
+--				DWORD bytes - size of the datagram
+--				LONG sequence - sequence number, or NO_SEQUENCE
+--				STATS_COUNTERS *messages - integrity results for the datagram
+--				ULONGLONG now - FILETIME the datagram was received
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	Finds the datagram's flow, creating it and setting its timer if this is
+--  the first datagram, and adds the datagram to it. When every flow is in use
+--  the datagram is only counted as untracked.
+--
+---------------------------------------------------------------------------------*/
+void recordFlow(FLOW_TABLE *table, SOCKADDR_IN *peer, DWORD id, DWORD bytes, LONG sequence, STATS_COUNTERS *messages, ULONGLONG now)
+{
+	ULONG address = peer->sin_addr.s_addr;
+	USHORT port = peer->sin_port;
+	DWORD hash = flowHash(address, port, id);
+	DWORD i;
+	FLOW_SLOT *slot;
+	FLOW *flow = NULL;
+	LONG index;
+
+	if (table->slots == NULL)
+	{
+		return;
+	}
+	for (i = hash & (FLOW_TABLE_SLOTS - 1); (slot = &(table->slots[i]))->flow != FLOW_NONE; i = (i + 1) & (FLOW_TABLE_SLOTS - 1))
+	{
+		if (slot->hash == hash)
+		{
+			flow = &(table->flows[slot->flow]);
+			if (flow->address == address && flow->port == port && flow->id == id)
+			{
+				break;
+			}
+			flow = NULL;
+		}
+	}
+
+	if (flow == NULL)
+	{
+		//slot is the empty slot that ended the probe
+		if (table->freeFlow != FLOW_NONE)
+		{
+			index = table->freeFlow;
+			table->freeFlow = table->flows[index].next;
+		}
+		else if (table->used < FLOW_MAX_FLOWS)
+		{
+			index = table->used++;
+		}
+		else {
+			table->untracked++;
+			return;
+		}
+		flow = &(table->flows[index]);
+		ZeroMemory(flow, sizeof(FLOW));
+		flow->address = address;
+		flow->port = port;
+		flow->id = id;
+		flow->highSequence = NO_SEQUENCE;
+		flow->firstTime = now;
+		slot->hash = hash;
+		slot->flow = index;
+		scheduleFlow(table, index, (now + FLOW_IDLE_UNITS) / FLOW_TICK_UNITS + 1);
+		if (++table->active > table->highWater)
+		{
+			table->highWater = table->active;
+		}
+	}
+
+	flow->lastTime = now;
+	flow->packets++;
+	flow->bytes += bytes;
+	if (sequence != NO_SEQUENCE)
+	{
+		flow->sequenced++;
+		if (sequence > flow->highSequence)
+		{
+			flow->highSequence = sequence;
+		}
+	}
+	flow->verified += messages->verified;
+	flow->corrupted += messages->corrupted;
+	flow->truncated += messages->truncated;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: expireFlows
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void expireFlows(FLOW_TABLE *table, ULONGLONG now, FLOW_HANDLER report)
+--
+--	PARAMETERS:	FLOW_TABLE *table - flows of the UDP server
+--				ULONGLONG now - current FILETIME
+--				FLOW_HANDLER report - called with each flow that went idle
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	Runs the wheel up to now. Each time a level wraps, the next level's list
+--  for the coming span is cascaded down, so a flow is only looked at again
+--  when its timer is close. Cheap enough to call after every datagram; it
+--  returns at once if no tick has passed.
+--
+---------------------------------------------------------------------------------*/
+void expireFlows(FLOW_TABLE *table, ULONGLONG now, FLOW_HANDLER report)
+{
+	ULONGLONG target = now / FLOW_TICK_UNITS;
+	DWORD slot, level, cascaded;
+	LONG index, next;
+	FLOW *flow;
+
+	if (table->slots == NULL)
+	{
+		return;
+	}
+	while (table->tick <= target)
+	{
+		slot = (DWORD)(table->tick & (FLOW_WHEEL_SLOTS - 1));
+		for (level = 1, cascaded = slot; cascaded == 0 && level < FLOW_WHEEL_LEVELS; level++)
+		{
+			cascaded = (DWORD)(table->tick >> (level * FLOW_WHEEL_BITS)) & (FLOW_WHEEL_SLOTS - 1);
+			index = table->wheel[level][cascaded];
+			table->wheel[level][cascaded] = FLOW_NONE;
+			for (; index != FLOW_NONE; index = next)
+			{
+				next = table->flows[index].next;
+				scheduleFlow(table, index, table->flows[index].expires);
+			}
+		}
+
+		index = table->wheel[0][slot];
+		table->wheel[0][slot] = FLOW_NONE;
+		table->tick++;
+		for (; index != FLOW_NONE; index = next)
+		{
+			flow = &(table->flows[index]);
+			next = flow->next;
+			if (now - flow->lastTime >= FLOW_IDLE_UNITS)
+			{
+				report(flow);
+				removeFlow(table, index);
+			}
+			else {
+				scheduleFlow(table, index, (flow->lastTime + FLOW_IDLE_UNITS) / FLOW_TICK_UNITS + 1);
+			}
+		}
+	}
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: flowHash
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	DWORD flowHash(ULONG address, USHORT port, DWORD id)
+--
+--	PARAMETERS:	ULONG address - sender address
+--				USHORT port - sender port
+--				DWORD id - flow id
+--
+--	RETURNS:	the hash of the flow's key
+--
+--	NOTES:
+--	The 64-bit finalizer from MurmurHash3. Clients on one host differ only in
+--  a few port bits, so the key is mixed until every bit reaches the slot index.
+--
+---------------------------------------------------------------------------------*/
+DWORD flowHash(ULONG address, USHORT port, DWORD id)
+{
+	ULONGLONG key = ((ULONGLONG)address << 32 | (ULONGLONG)port << 16) ^ (id * 0x9E3779B97F4A7C15ULL);
+
+	key ^= key >> 33;
+	key *= 0xFF51AFD7ED558CCDULL;
+	key ^= key >> 33;
+	key *= 0xC4CEB9FE1A85EC53ULL;
+	key ^= key >> 33;
+	return (DWORD)key;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: scheduleFlow
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void scheduleFlow(FLOW_TABLE *table, LONG index, ULONGLONG expires)
+--
+--	PARAMETERS:	FLOW_TABLE *table - flows of the UDP server
+--				LONG index - flow whose timer is set
+--				ULONGLONG expires - wheel tick the timer goes off at
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	The level is picked by how far off the timer is, and the list within it by
+--  that level's bits of the expiry tick. A timer already due goes off with the
+--  next tick; one past the end of the wheel waits at its far end.
+--
+---------------------------------------------------------------------------------*/
+void scheduleFlow(FLOW_TABLE *table, LONG index, ULONGLONG expires)
+{
+	FLOW *flow = &(table->flows[index]);
+	ULONGLONG span = 1ULL << (FLOW_WHEEL_LEVELS * FLOW_WHEEL_BITS);
+	DWORD level;
+	LONG *list;
+
+	if (expires < table->tick)
+	{
+		expires = table->tick;
+	}
+	else if (expires - table->tick >= span)
+	{
+		expires = table->tick + span - 1;
+	}
+	for (level = 0; expires - table->tick >= 1ULL << ((level + 1) * FLOW_WHEEL_BITS); level++);
+	list = &(table->wheel[level][(expires >> (level * FLOW_WHEEL_BITS)) & (FLOW_WHEEL_SLOTS - 1)]);
+	flow->expires = expires;
+	flow->next = *list;
+	*list = index;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: removeFlow
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void removeFlow(FLOW_TABLE *table, LONG index)
+--
+--	PARAMETERS:	FLOW_TABLE *table - flows of the UDP server
+--				LONG index - flow to remove, already off the wheel
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	Empties the flow's slot, then moves back each following entry of the probe
+--  run whose home slot is not between the hole and the entry, so every
+--  remaining flow is still reachable from its home slot.
+--
+---------------------------------------------------------------------------------*/
+void removeFlow(FLOW_TABLE *table, LONG index)
+{
+	FLOW *flow = &(table->flows[index]);
+	DWORD hole = flowHash(flow->address, flow->port, flow->id) & (FLOW_TABLE_SLOTS - 1);
+	DWORD next, home;
+
+	while (table->slots[hole].flow != index)
+	{
+		hole = (hole + 1) & (FLOW_TABLE_SLOTS - 1);
+	}
+	for (next = (hole + 1) & (FLOW_TABLE_SLOTS - 1); table->slots[next].flow != FLOW_NONE; next = (next + 1) & (FLOW_TABLE_SLOTS - 1))
+	{
+		home = table->slots[next].hash & (FLOW_TABLE_SLOTS - 1);
+		//distance from home to entry is at least the distance from hole to entry
+		if (((next - home) & (FLOW_TABLE_SLOTS - 1)) >= ((next - hole) & (FLOW_TABLE_SLOTS - 1)))
+		{
+			table->slots[hole] = table->slots[next];
+			hole = next;
+		}
+	}
+	table->slots[hole].flow = FLOW_NONE;
+	flow->next = table->freeFlow;
+	table->freeFlow = index;
+	table->active--;
+}
\ No newline at end of file
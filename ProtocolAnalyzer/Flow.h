@@ -0,0 +1,57 @@
+#pragma once
+
+#define FLOW_MAX_FLOWS			131072	//concurrent flows tracked, the rest only count server-wide
+#define FLOW_TABLE_SLOTS		262144	//hash slots, a power of two at twice the flows
+#define FLOW_IDLE_TIMEOUT		1000	//ms without a datagram before a flow is reported
+#define FLOW_TICK				10		//ms per timer wheel tick
+#define FLOW_WHEEL_LEVELS		4
+#define FLOW_WHEEL_BITS			6		//64 slots per level, the wheel spans 2^24 ticks
+#define FLOW_WHEEL_SLOTS		(1 << FLOW_WHEEL_BITS)
+#define FLOW_NONE				-1		//empty hash slot or end of a list
+
+// One sender's datagrams. Flows live in a fixed array and are linked into the
+// timer wheel by index, so the hash table can move its slots freely.
+typedef struct _FLOW {
+	ULONG address;				// sender, network order
+	USHORT port;				// network order
+	DWORD id;					// flow id from the DATAGRAM_HEADER, 0 if it had none
+	LONG next;					// timer wheel list, or the free list
+	ULONGLONG expires;			// wheel tick the flow's timer is set for
+	ULONGLONG firstTime;		// FILETIME of the first datagram
+	ULONGLONG lastTime;			// FILETIME of the most recent datagram
+	LONG highSequence;
+	ULONGLONG packets;
+	ULONGLONG bytes;
+	ULONGLONG sequenced;
+	ULONGLONG verified;
+	ULONGLONG corrupted;
+	ULONGLONG truncated;
+} FLOW;
+
+// Slot of the open-addressed table. hash is kept so probes and deletions
+// rarely have to touch the flow itself.
+typedef struct _FLOW_SLOT {
+	DWORD hash;
+	LONG flow;
+} FLOW_SLOT;
+
+// Only the thread that receives the datagrams may use the table; the flow
+// counts are read by the reporter.
+typedef struct _FLOW_TABLE {
+	FLOW_SLOT *slots;
+	FLOW *flows;
+	LONG used;					// flows handed out at least once, so untouched pages stay unbacked
+	LONG freeFlow;				// head of the expired flows
+	volatile LONG active;		// flows being tracked, read by the reporter
+	volatile LONG highWater;
+	ULONGLONG untracked;		// datagrams that arrived while the table was full
+	ULONGLONG tick;				// next wheel tick to run
+	LONG wheel[FLOW_WHEEL_LEVELS][FLOW_WHEEL_SLOTS];
+} FLOW_TABLE;
+
+typedef void (*FLOW_HANDLER)(FLOW *);
+
+BOOL initFlows(FLOW_TABLE *);
+void freeFlows(FLOW_TABLE *);
+void recordFlow(FLOW_TABLE *, SOCKADDR_IN *, DWORD, DWORD, LONG, STATS_COUNTERS *, ULONGLONG);
+void expireFlows(FLOW_TABLE *, ULONGLONG, FLOW_HANDLER);
\ No newline at end of file
@@ -0,0 +1,602 @@
+/*---------------------------------------------------------------------------------
+--	SOURCE FILE:	Impair.cpp -
+--
+--	PROGRAM:		Transport Layer Protocol Analyser
+--
+--	FUNCTIONS:
+--					BOOL parseImpairment(char *spec, IMPAIRMENT *impair)
+--					BOOL startImpairment(IMPAIRMENT *impair, SOCKET sd, SOCKADDR_IN *to, int protocol)
+--					void impairSend(IMPAIRMENT *impair, char *data, DWORD length)
+--					void stopImpairment(IMPAIRMENT *impair)
+--					void logImpairment(IMPAIRMENT *impair, HANDLE logFile)
+--					DWORD WINAPI impairThread(LPVOID param)
+--					BOOL parsePercent(char *value, double *threshold)
+--					BOOL impairChance(IMPAIRMENT *impair, double threshold)
+--					double impairNow(IMPAIRMENT *impair)
+--
+--	DATE:			Oct 19, 2026
+--
+--	REVISIONS:		Oct 19, 2026
+--
+--	DESIGNER:		Gabriella Cheung
+--
+--	PROGRAMMER:		Gabriella Cheung
+--
+--	NOTES:
+--	This file contains the client's network impairment stage, so the analyzer
+--  can be run over loopback as if over a lossy, slow or distant link. The send
+--  loops hand each message to impairSend instead of the socket. An impairment
+--  is written as semicolon separated settings, for example
+--
+--		loss=1;delay=40;jitter=5;reorder=2;duplicate=0.5;rate=20000
+--
+--	loss		percent of datagrams dropped, independently of each other
+--	gilbert		p,r[,h] Gilbert-Elliott loss: percent chance per datagram of
+--				moving from the good to the bad state, and back, and the loss
+--				in the bad state (100 if not given). loss= is the loss in the
+--				good state.
+--	delay		ms added to every message
+--	jitter		ms either side of the delay, spread evenly
+--	reorder		percent of datagrams sent without the delay, so they pass
+--				the ones queued before them
+--	duplicate	percent of datagrams sent twice
+--	rate		link speed in kbit/s; messages queue behind each other
+--
+--  A TCP socket delivers its bytes reliably and in order whatever happens
+--  above it, so for TCP only the delay, jitter and rate apply, and jitter
+--  never reorders the stream.
+--
+--  Messages wait in a wheel of 1 ms slots, one list per slot, which a delivery
+--  thread empties as each millisecond passes. Queueing and delivering are a
+--  list append and a list walk however many messages are waiting, so the
+--  stage keeps up at high packet rates. UDP datagrams arriving at a full queue
+--  are dropped, like at a router; a TCP sender waits for room instead.
+--
+---------------------------------------------------------------------------------*/
+#include "resource.h"
+
+DWORD WINAPI impairThread(LPVOID);
+BOOL parsePercent(char *, double *);
+BOOL impairChance(IMPAIRMENT *, double);
+double impairNow(IMPAIRMENT *);
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: parseImpairment
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	BOOL parseImpairment(char *spec, IMPAIRMENT *impair)
+--
+--	PARAMETERS:	char *spec - impairment settings
+--				IMPAIRMENT *impair - receives the settings and a description
+--
+--	RETURNS:	TRUE if every setting was understood
+--
+--	NOTES:
+--	Delay and jitter together must fit in the wheel.
+--
+---------------------------------------------------------------------------------*/
+BOOL parseImpairment(char *spec, IMPAIRMENT *impair)
+{
+	char settings[IMPAIR_SPEC_LENGTH];
+	char *setting, *value, *context = NULL;
+	double toBad, toGood, badLoss = 100;
+
+	ZeroMemory(impair, sizeof(IMPAIRMENT));
+	strncpy(settings, spec, sizeof(settings) - 1);
+	settings[sizeof(settings) - 1] = '\0';
+	for (setting = strtok_s(settings, "; ", &context); setting != NULL; setting = strtok_s(NULL, "; ", &context))
+	{
+		if ((value = strchr(setting, '=')) == NULL)
+		{
+			return FALSE;
+		}
+		*value++ = '\0';
+		if (strcmp(setting, "loss") == 0)
+		{
+			if (!parsePercent(value, &impair->loss))
+			{
+				return FALSE;
+			}
+		}
+		else if (strcmp(setting, "gilbert") == 0)
+		{
+			if (sscanf(value, "%lf,%lf,%lf", &toBad, &toGood, &badLoss) < 2
+				|| toBad < 0 || toBad > 100 || toGood <= 0 || toGood > 100 || badLoss < 0 || badLoss > 100)
+			{
+				return FALSE;
+			}
+			impair->gilbert = true;
+			impair->toBad = toBad / 100 * 4294967296.0;
+			impair->toGood = toGood / 100 * 4294967296.0;
+			impair->badLoss = badLoss / 100 * 4294967296.0;
+		}
+		else if (strcmp(setting, "delay") == 0)
+		{
+			impair->delay = atoi(value);
+		}
+		else if (strcmp(setting, "jitter") == 0)
+		{
+			impair->jitter = atoi(value);
+		}
+		else if (strcmp(setting, "reorder") == 0)
+		{
+			if (!parsePercent(value, &impair->reorder))
+			{
+				return FALSE;
+			}
+		}
+		else if (strcmp(setting, "duplicate") == 0)
+		{
+			if (!parsePercent(value, &impair->duplicate))
+			{
+				return FALSE;
+			}
+		}
+		else if (strcmp(setting, "rate") == 0)
+		{
+			//kbit/s is bits per ms
+			impair->rate = atof(value);
+		}
+		else {
+			return FALSE;
+		}
+	}
+	if (impair->delay < 0 || impair->jitter < 0 || impair->delay + impair->jitter >= IMPAIR_WHEEL_SLOTS - 1 || impair->rate < 0)
+	{
+		return FALSE;
+	}
+
+	sprintf(impair->description, "loss %.2f%%", impair->loss * 100 / 4294967296.0);
+	if (impair->gilbert)
+	{
+		//long-run share of datagrams sent in the bad state is p / (p + r)
+		sprintf(impair->description + strlen(impair->description), " (Gilbert-Elliott %.2f%%/%.2f%%, %.0f%% when bad, about %.2f%% overall)",
+			toBad, toGood, badLoss, (toBad * badLoss + toGood * impair->loss * 100 / 4294967296.0) / (toBad + toGood));
+	}
+	sprintf(impair->description + strlen(impair->description), ", delay %lld ms +/- %lld ms, reorder %.2f%%, duplicate %.2f%%",
+		impair->delay, impair->jitter, impair->reorder * 100 / 4294967296.0, impair->duplicate * 100 / 4294967296.0);
+	if (impair->rate > 0)
+	{
+		sprintf(impair->description + strlen(impair->description), ", %.0f kbit/s", impair->rate);
+	}
+	return TRUE;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: startImpairment
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	BOOL startImpairment(IMPAIRMENT *impair, SOCKET sd, SOCKADDR_IN *to, int protocol)
+--
+--	PARAMETERS:	IMPAIRMENT *impair - parsed impairment
+--				SOCKET sd - socket the messages are finally sent on
+--				SOCKADDR_IN *to - destination for UDP, NULL for a connected TCP socket
+--				int protocol - IPPROTO_UDP or IPPROTO_TCP
+--
+--	RETURNS:	FALSE if the delivery thread could not be started
+--
+--	NOTES:
+--	Called right before the first send; the wheel's clock starts now.
+--
+---------------------------------------------------------------------------------*/
+BOOL startImpairment(IMPAIRMENT *impair, SOCKET sd, SOCKADDR_IN *to, int protocol)
+{
+	LARGE_INTEGER frequency, now;
+	DWORD threadId;
+
+	impair->sd = sd;
+	if (to != NULL)
+	{
+		impair->to = *to;
+	}
+	impair->protocol = protocol;
+	impair->seed = 0x2545F491;
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&now);
+	impair->frequency = frequency.QuadPart;
+	impair->start = now.QuadPart;
+	InitializeCriticalSection(&impair->lock);
+	if ((impair->space = CreateSemaphore(NULL, IMPAIR_QUEUE_LIMIT, IMPAIR_QUEUE_LIMIT, NULL)) == NULL)
+	{
+		DeleteCriticalSection(&impair->lock);
+		return FALSE;
+	}
+	impair->running = true;
+	if ((impair->thread = CreateThread(NULL, 0, impairThread, (LPVOID)impair, 0, &threadId)) == NULL)
+	{
+		CloseHandle(impair->space);
+		DeleteCriticalSection(&impair->lock);
+		return FALSE;
+	}
+	return TRUE;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: impairSend
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void impairSend(IMPAIRMENT *impair, char *data, DWORD length)
+--
+--	PARAMETERS:	IMPAIRMENT *impair - started impairment
+--				char *data - message to send
+--				DWORD length - size of the message
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	Decides the message's fate and queues a copy for the millisecond it is due.
+--  Loss is decided before duplication, so a duplicate is never sent alone.
+--  With a rate cap a message is due once the link has finished the ones ahead
+--  of it; a datagram that would wait longer than the wheel spans is dropped
+--  as a queue overflow, and a TCP sender sleeps until it fits. Only the
+--  sending thread calls this, so the link and random state need no lock.
+--
+---------------------------------------------------------------------------------*/
+void impairSend(IMPAIRMENT *impair, char *data, DWORD length)
+{
+	IMPAIR_PACKET *packet;
+	IMPAIR_SLOT *slot;
+	BOOL udp = impair->protocol == IPPROTO_UDP;
+	int copies = 1;
+	double now, due;
+	LONGLONG tick;
+	LONG queued;
+
+	impair->offered++;
+	if (udp)
+	{
+		if (impair->gilbert)
+		{
+			impair->bad = impair->bad ? !impairChance(impair, impair->toGood) : impairChance(impair, impair->toBad);
+		}
+		if (impairChance(impair, impair->bad ? impair->badLoss : impair->loss))
+		{
+			impair->lost++;
+			return;
+		}
+		if (impairChance(impair, impair->duplicate))
+		{
+			impair->duplicated++;
+			copies = 2;
+		}
+	}
+
+	for (; copies > 0; copies--)
+	{
+		now = impairNow(impair);
+		due = now + impair->delay;
+		if (impair->jitter > 0)
+		{
+			due += ((double)profileRandom(&impair->seed) / 4294967296.0 * 2 - 1) * impair->jitter;
+		}
+		if (udp && impairChance(impair, impair->reorder))
+		{
+			impair->reordered++;
+			due = now;
+		}
+		if (!udp && due < impair->lastDue)
+		{
+			due = impair->lastDue;
+		}
+		if (impair->rate > 0)
+		{
+			due = (due > impair->linkFree ? due : impair->linkFree) + length * 8 / impair->rate;
+		}
+		if (due - now >= IMPAIR_WHEEL_SLOTS - 1)
+		{
+			if (udp)
+			{
+				impair->overflowed++;
+				continue;
+			}
+			Sleep((DWORD)(due - now) - (IMPAIR_WHEEL_SLOTS - 2));
+		}
+
+		if (WaitForSingleObject(impair->space, udp ? 0 : INFINITE) != WAIT_OBJECT_0)
+		{
+			impair->overflowed++;
+			continue;
+		}
+		while ((packet = (IMPAIR_PACKET *)poolAlloc(sizeof(IMPAIR_PACKET) + length)) == NULL && !udp)
+		{
+			Sleep(1);
+		}
+		if (packet == NULL)
+		{
+			ReleaseSemaphore(impair->space, 1, NULL);
+			impair->overflowed++;
+			continue;
+		}
+		packet->next = NULL;
+		packet->length = length;
+		memcpy(packet + 1, data, length);
+		if (impair->rate > 0)
+		{
+			impair->linkFree = due;
+		}
+		impair->lastDue = due;
+
+		EnterCriticalSection(&impair->lock);
+		tick = (LONGLONG)ceil(due);
+		if (tick < impair->tick)
+		{
+			tick = impair->tick;
+		}
+		else if (tick - impair->tick >= IMPAIR_WHEEL_SLOTS)
+		{
+			//the delivery thread has fallen behind; send a little early rather than a lap late
+			tick = impair->tick + IMPAIR_WHEEL_SLOTS - 1;
+		}
+		slot = &(impair->wheel[tick & (IMPAIR_WHEEL_SLOTS - 1)]);
+		if (slot->tail == NULL)
+		{
+			slot->head = packet;
+		}
+		else {
+			slot->tail->next = packet;
+		}
+		slot->tail = packet;
+		LeaveCriticalSection(&impair->lock);
+
+		if ((queued = InterlockedIncrement(&impair->queued)) > impair->maxQueued)
+		{
+			impair->maxQueued = queued;
+		}
+	}
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: stopImpairment
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void stopImpairment(IMPAIRMENT *impair)
+--
+--	PARAMETERS:	IMPAIRMENT *impair - started impairment
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	Waits for every queued message to be delivered, so the socket can be
+--  closed afterwards. Takes at most the longest delay plus the queue at the
+--  capped rate.
+--
+---------------------------------------------------------------------------------*/
+void stopImpairment(IMPAIRMENT *impair)
+{
+	impair->running = false;
+	WaitForSingleObject(impair->thread, INFINITE);
+	CloseHandle(impair->thread);
+	CloseHandle(impair->space);
+	DeleteCriticalSection(&impair->lock);
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: logImpairment
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void logImpairment(IMPAIRMENT *impair, HANDLE logFile)
+--
+--	PARAMETERS:	IMPAIRMENT *impair - stopped impairment
+--				HANDLE logFile - handle for client log file
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	Prints what the impairment did to the run, so the server's loss figures
+--  can be checked against what was injected.
+--
+---------------------------------------------------------------------------------*/
+void logImpairment(IMPAIRMENT *impair, HANDLE logFile)
+{
+	char message[256];
+
+	sprintf(message, "Impairment: %llu offered, %llu lost (%.2f%%), %llu overflowed, %llu duplicated, %llu reordered",
+		impair->offered, impair->lost, impair->offered > 0 ? impair->lost * 100.0 / impair->offered : 0.0,
+		impair->overflowed, impair->duplicated, impair->reordered);
+	writeToScreen(message);
+	strcat(message, "\r\n");
+	writeToFile(logFile, message);
+	sprintf(message, "Impairment: %llu delivered, %llu send errors, at most %ld queued",
+		impair->delivered, impair->sendErrors, impair->maxQueued);
+	writeToScreen(message);
+	strcat(message, "\r\n");
+	writeToFile(logFile, message);
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: impairThread
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--				Oct 19, 2026 - retires its context switches
+--				Oct 19, 2026 - gives its pool cache back
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	DWORD WINAPI impairThread(LPVOID param)
+--
+--	PARAMETERS:	LPVOID param - the IMPAIRMENT
+--
+--	RETURNS:	DWORD
+--
+--	NOTES:
+--	Sends the messages of every slot whose millisecond has passed, in the order
+--  they were queued, then sleeps. The system timer is set to 1 ms while the
+--  thread runs, otherwise Sleep would only wake every 15.6 ms and delays would
+--  come out in steps of that size. The slot is unlinked under the lock and
+--  sent outside it, so the sender is never held up by a send.
+--
+---------------------------------------------------------------------------------*/
+DWORD WINAPI impairThread(LPVOID param)
+{
+	IMPAIRMENT *impair = (IMPAIRMENT *)param;
+	IMPAIR_SLOT *slot;
+	IMPAIR_PACKET *packet, *next;
+	LONGLONG now;
+	int result;
+
+	timeBeginPeriod(1);
+	while (impair->running || impair->queued > 0)
+	{
+		now = (LONGLONG)impairNow(impair);
+		while (impair->tick <= now)
+		{
+			EnterCriticalSection(&impair->lock);
+			slot = &(impair->wheel[impair->tick & (IMPAIR_WHEEL_SLOTS - 1)]);
+			packet = slot->head;
+			slot->head = slot->tail = NULL;
+			impair->tick++;
+			LeaveCriticalSection(&impair->lock);
+
+			for (; packet != NULL; packet = next)
+			{
+				next = packet->next;
+				if (impair->protocol == IPPROTO_UDP)
+				{
+					result = sendto(impair->sd, (char *)(packet + 1), packet->length, 0, (struct sockaddr *)&(impair->to), sizeof(impair->to));
+				}
+				else {
+					result = send(impair->sd, (char *)(packet + 1), packet->length, 0);
+				}
+				if (result == SOCKET_ERROR)
+				{
+					impair->sendErrors++;
+				}
+				else {
+					impair->delivered++;
+				}
+				poolFree(packet);
+				InterlockedDecrement(&impair->queued);
+				ReleaseSemaphore(impair->space, 1, NULL);
+			}
+		}
+		Sleep(1);
+	}
+	timeEndPeriod(1);
+	releasePool();
+	retireThread();
+	return 0;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: parsePercent
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	BOOL parsePercent(char *value, double *threshold)
+--
+--	PARAMETERS:	char *value - percentage from 0 to 100
+--				double *threshold - receives it as a threshold out of 2^32
+--
+--	RETURNS:	TRUE if the percentage is in range
+--
+---------------------------------------------------------------------------------*/
+BOOL parsePercent(char *value, double *threshold)
+{
+	double percent = atof(value);
+
+	if (percent < 0 || percent > 100)
+	{
+		return FALSE;
+	}
+	*threshold = percent / 100 * 4294967296.0;
+	return TRUE;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: impairChance
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	BOOL impairChance(IMPAIRMENT *impair, double threshold)
+--
+--	PARAMETERS:	IMPAIRMENT *impair - impairment whose generator is used
+--				double threshold - probability out of 2^32
+--
+--	RETURNS:	TRUE with the given probability
+--
+--	NOTES:
+--	A zero threshold draws no number, so settings left out cost nothing and do
+--  not change the sequence the others see.
+--
+---------------------------------------------------------------------------------*/
+BOOL impairChance(IMPAIRMENT *impair, double threshold)
+{
+	return threshold > 0 && profileRandom(&impair->seed) < threshold;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: impairNow
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	double impairNow(IMPAIRMENT *impair)
+--
+--	PARAMETERS:	IMPAIRMENT *impair - started impairment
+--
+--	RETURNS:	milliseconds since the impairment started
+--
+---------------------------------------------------------------------------------*/
+double impairNow(IMPAIRMENT *impair)
+{
+	LARGE_INTEGER now;
+
+	QueryPerformanceCounter(&now);
+	return (double)(now.QuadPart - impair->start) * 1000 / impair->frequency;
+}
\ No newline at end of file
@@ -0,0 +1,65 @@
+#pragma once
+
+#define IMPAIR_SPEC_LENGTH		256
+#define IMPAIR_WHEEL_SLOTS		4096	//1 ms slots, a power of two; bounds delay plus jitter
+#define IMPAIR_QUEUE_LIMIT		16384	//packets held at once before UDP drops or TCP blocks
+
+// A packet waiting in the wheel. The data follows the header in the same pool block.
+typedef struct _IMPAIR_PACKET {
+	struct _IMPAIR_PACKET *next;
+	DWORD length;
+} IMPAIR_PACKET;
+
+typedef struct _IMPAIR_SLOT {
+	IMPAIR_PACKET *head;		// packets due in this millisecond, in the order they were queued
+	IMPAIR_PACKET *tail;
+} IMPAIR_SLOT;
+
+typedef struct _IMPAIRMENT {
+	// settings, thresholds are out of 2^32
+	double loss;				// Bernoulli loss, or loss in the good state with gilbert
+	BOOL gilbert;				// Gilbert-Elliott two-state loss
+	double toBad;				// good to bad transition per packet
+	double toGood;				// bad to good transition per packet
+	double badLoss;				// loss in the bad state
+	double duplicate;
+	double reorder;				// packets that skip the delay
+	LONGLONG delay;				// ms
+	LONGLONG jitter;			// ms either side of the delay, uniform
+	double rate;				// bits per ms, 0 for no cap
+	char description[160];
+
+	// state
+	SOCKET sd;
+	SOCKADDR_IN to;				// destination for UDP, unused for a connected TCP socket
+	int protocol;
+	DWORD seed;
+	BOOL bad;					// Gilbert-Elliott state
+	double linkFree;			// ms at which the capped link has sent everything queued
+	LONGLONG lastDue;			// keeps TCP segments in order
+	LONGLONG frequency;
+	LONGLONG start;				// QueryPerformanceCounter at tick 0
+	volatile LONGLONG tick;		// next wheel tick to deliver
+	CRITICAL_SECTION lock;		// wheel, shared by the sender and the delivery thread
+	HANDLE space;				// semaphore counting free queue places
+	HANDLE thread;
+	volatile BOOL running;
+	IMPAIR_SLOT wheel[IMPAIR_WHEEL_SLOTS];
+
+	// counters
+	ULONGLONG offered;
+	ULONGLONG lost;
+	ULONGLONG overflowed;		// UDP packets dropped because the queue was full
+	ULONGLONG duplicated;
+	ULONGLONG reordered;
+	volatile LONG queued;
+	LONG maxQueued;
+	ULONGLONG delivered;
+	ULONGLONG sendErrors;
+} IMPAIRMENT;
+
+BOOL parseImpairment(char *, IMPAIRMENT *);
+BOOL startImpairment(IMPAIRMENT *, SOCKET, SOCKADDR_IN *, int);
+void impairSend(IMPAIRMENT *, char *, DWORD);
+void stopImpairment(IMPAIRMENT *);
+void logImpairment(IMPAIRMENT *, HANDLE);
\ No newline at end of file
@@ -0,0 +1,409 @@
+/*---------------------------------------------------------------------------------
+--	SOURCE FILE:	Local.cpp -
+--
+--	PROGRAM:		Transport Layer Protocol Analyser
+--
+--	FUNCTIONS:
+--					BOOL localSocketPath(int port, char *path)
+--					BOOL openRing(RING *ring, int port, BOOL reader)
+--					void closeRing(RING *ring)
+--					BOOL ringConnect(RING *ring)
+--					BOOL ringWrite(RING *ring, char *data, DWORD length)
+--					void ringDisconnect(RING *ring)
+--					int ringRead(RING *ring, char *buffer, DWORD size)
+--					void ringCopy(RING *ring, DWORD offset, char *data, DWORD length, BOOL in)
+--
+--	DATE:			Oct 19, 2026
+--
+--	REVISIONS:		Oct 19, 2026
+--
+--	DESIGNER:		Gabriella Cheung
+--
+--	PROGRAMMER:		Gabriella Cheung
+--
+--	NOTES:
+--	This file contains the local transports that are measured against TCP and
+--  UDP: an AF_UNIX stream socket, which still goes through the kernel but not
+--  the network stack, and a ring in shared memory, which needs no kernel call
+--  at all while both sides keep up. Both are found from the TCP port, so the
+--  client and server dialogs need no new fields.
+--
+--  Windows only has stream AF_UNIX sockets, so there is no datagram variant.
+--
+--  The ring has one writer and one reader. Each owns its index and only reads
+--  the other's, so no locks or interlocked operations are needed on the data
+--  path; volatile accesses are ordered as acquire and release by this
+--  compiler, which is what publishing a message needs. A side with nothing to
+--  do raises its waiting flag and sleeps on an event, and the other side only
+--  sets the event when it sees the flag. The full barrier between raising the
+--  flag and looking again closes the window where both would otherwise miss
+--  each other. Sleeps still time out, so a side whose peer has gone away
+--  notices.
+--
+---------------------------------------------------------------------------------*/
+#include "resource.h"
+
+void ringCopy(RING *, DWORD, char *, DWORD, BOOL);
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: localSocketPath
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	BOOL localSocketPath(int port, char *path)
+--
+--	PARAMETERS:	int port - TCP port the path stands in for
+--				char *path - receives up to UNIX_PATH_MAX characters
+--
+--	RETURNS:	FALSE if the temporary directory's path is too long
+--
+--	NOTES:
+--	The socket lives in the user's temporary directory, which the client and
+--  server share when run by the same user.
+--
+---------------------------------------------------------------------------------*/
+BOOL localSocketPath(int port, char *path)
+{
+	char directory[MAX_PATH];
+	DWORD length = GetTempPath(MAX_PATH, directory);
+
+	if (length == 0 || length > MAX_PATH || length + 32 > UNIX_PATH_MAX)
+	{
+		return FALSE;
+	}
+	sprintf(path, "%sProtocolAnalyzer-%d.sock", directory, port);
+	return TRUE;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: openRing
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	BOOL openRing(RING *ring, int port, BOOL reader)
+--
+--	PARAMETERS:	RING *ring - receives the mapping and events
+--				int port - TCP port the ring stands in for
+--				BOOL reader - TRUE for the server, which creates the ring
+--
+--	RETURNS:	FALSE if the ring could not be created, or has no reader yet
+--
+--	NOTES:
+--	The server creates the ring and clears it, which also recovers a ring left
+--  open by a client that exited without closing it.
+--
+---------------------------------------------------------------------------------*/
+BOOL openRing(RING *ring, int port, BOOL reader)
+{
+	char name[64];
+
+	ZeroMemory(ring, sizeof(RING));
+	ring->reader = reader;
+	sprintf(name, "Local\\ProtocolAnalyzerRing-%d", port);
+	ring->mapping = reader ? CreateFileMapping(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 0, sizeof(RING_HEADER) + RING_SIZE, name)
+		: OpenFileMapping(FILE_MAP_ALL_ACCESS, FALSE, name);
+	sprintf(name, "Local\\ProtocolAnalyzerData-%d", port);
+	ring->dataReady = reader ? CreateEvent(NULL, FALSE, FALSE, name) : OpenEvent(EVENT_MODIFY_STATE | SYNCHRONIZE, FALSE, name);
+	sprintf(name, "Local\\ProtocolAnalyzerSpace-%d", port);
+	ring->spaceReady = reader ? CreateEvent(NULL, FALSE, FALSE, name) : OpenEvent(EVENT_MODIFY_STATE | SYNCHRONIZE, FALSE, name);
+	if (ring->mapping == NULL || ring->dataReady == NULL || ring->spaceReady == NULL
+		|| (ring->header = (RING_HEADER *)MapViewOfFile(ring->mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0)) == NULL)
+	{
+		closeRing(ring);
+		return FALSE;
+	}
+	ring->data = (char *)(ring->header + 1);
+	if (reader)
+	{
+		ZeroMemory(ring->header, sizeof(RING_HEADER));
+	}
+	return TRUE;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: closeRing
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void closeRing(RING *ring)
+--
+--	PARAMETERS:	RING *ring - ring opened by openRing, possibly only in part
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	A reader marks the ring as gone first, so a writer blocked on a full ring
+--  gives up instead of waiting forever.
+--
+---------------------------------------------------------------------------------*/
+void closeRing(RING *ring)
+{
+	if (ring->header != NULL)
+	{
+		if (ring->reader)
+		{
+			ring->header->state = RING_GONE;
+			SetEvent(ring->spaceReady);
+		}
+		UnmapViewOfFile(ring->header);
+		ring->header = NULL;
+	}
+	if (ring->mapping != NULL)
+	{
+		CloseHandle(ring->mapping);
+		ring->mapping = NULL;
+	}
+	if (ring->dataReady != NULL)
+	{
+		CloseHandle(ring->dataReady);
+		ring->dataReady = NULL;
+	}
+	if (ring->spaceReady != NULL)
+	{
+		CloseHandle(ring->spaceReady);
+		ring->spaceReady = NULL;
+	}
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: ringConnect
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	BOOL ringConnect(RING *ring)
+--
+--	PARAMETERS:	RING *ring - ring opened by a writer
+--
+--	RETURNS:	FALSE if another writer has the ring or the reader is draining it
+--
+---------------------------------------------------------------------------------*/
+BOOL ringConnect(RING *ring)
+{
+	return InterlockedCompareExchange(&(ring->header->state), RING_OPEN, RING_IDLE) == RING_IDLE;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: ringWrite
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	BOOL ringWrite(RING *ring, char *data, DWORD length)
+--
+--	PARAMETERS:	RING *ring - connected ring
+--				char *data - message to send
+--				DWORD length - size of the message, at most DATA_BUFSIZE
+--
+--	RETURNS:	FALSE if the reader has gone away
+--
+--	NOTES:
+--	Waits while the ring is too full for the message. The message is copied in
+--  before head moves past it, so the reader never sees a partial message.
+--
+---------------------------------------------------------------------------------*/
+BOOL ringWrite(RING *ring, char *data, DWORD length)
+{
+	RING_HEADER *header = ring->header;
+	DWORD head = header->head;
+	DWORD need = sizeof(DWORD) + length;
+
+	while (RING_SIZE - (head - (DWORD)header->tail) < need)
+	{
+		if (header->state == RING_GONE)
+		{
+			return FALSE;
+		}
+		header->writerWaiting = 1;
+		MemoryBarrier();
+		if (RING_SIZE - (head - (DWORD)header->tail) < need)
+		{
+			WaitForSingleObject(ring->spaceReady, RING_WAIT);
+		}
+		header->writerWaiting = 0;
+	}
+	ringCopy(ring, head, (char *)&length, sizeof(DWORD), TRUE);
+	ringCopy(ring, head + sizeof(DWORD), data, length, TRUE);
+	header->head = head + need;
+
+	MemoryBarrier();
+	if (header->readerWaiting)
+	{
+		SetEvent(ring->dataReady);
+	}
+	return TRUE;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: ringDisconnect
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void ringDisconnect(RING *ring)
+--
+--	PARAMETERS:	RING *ring - connected ring
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	Tells the reader the transfer is over once it has read what is left.
+--
+---------------------------------------------------------------------------------*/
+void ringDisconnect(RING *ring)
+{
+	InterlockedCompareExchange(&(ring->header->state), RING_CLOSED, RING_OPEN);
+	if (ring->header->readerWaiting)
+	{
+		SetEvent(ring->dataReady);
+	}
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: ringRead
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	int ringRead(RING *ring, char *buffer, DWORD size)
+--
+--	PARAMETERS:	RING *ring - ring opened by the reader
+--				char *buffer - receives the next message
+--				DWORD size - size of buffer
+--
+--	RETURNS:	the size of the message, 0 when the writer has closed and every
+--				message has been read, or -1 after RING_WAIT with nothing to read
+--
+--	NOTES:
+--	Polls for RING_SPIN rounds before sleeping, so a writer that is keeping up
+--  never has to make a kernel call to wake the reader. The state is read
+--  before head, so a ring seen as both closed and empty really is finished.
+--  Reading the close makes the ring free for the next writer.
+--
+---------------------------------------------------------------------------------*/
+int ringRead(RING *ring, char *buffer, DWORD size)
+{
+	RING_HEADER *header = ring->header;
+	DWORD tail = header->tail;
+	DWORD length;
+	LONG state;
+
+	for (int spins = 0; ; spins++)
+	{
+		state = header->state;
+		if ((DWORD)header->head != tail)
+		{
+			break;
+		}
+		if (state == RING_CLOSED)
+		{
+			header->state = RING_IDLE;
+			return 0;
+		}
+		if (spins < RING_SPIN)
+		{
+			YieldProcessor();
+			continue;
+		}
+		header->readerWaiting = 1;
+		MemoryBarrier();
+		if ((DWORD)header->head == tail && header->state != RING_CLOSED
+			&& WaitForSingleObject(ring->dataReady, RING_WAIT) == WAIT_TIMEOUT)
+		{
+			header->readerWaiting = 0;
+			return -1;
+		}
+		header->readerWaiting = 0;
+		spins = 0;
+	}
+
+	ringCopy(ring, tail, (char *)&length, sizeof(DWORD), FALSE);
+	ringCopy(ring, tail + sizeof(DWORD), buffer, length < size ? length : size, FALSE);
+	header->tail = tail + sizeof(DWORD) + length;
+
+	MemoryBarrier();
+	if (header->writerWaiting)
+	{
+		SetEvent(ring->spaceReady);
+	}
+	return length < size ? length : size;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: ringCopy
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void ringCopy(RING *ring, DWORD offset, char *data, DWORD length, BOOL in)
+--
+--	PARAMETERS:	RING *ring - ring to copy to or from
+--				DWORD offset - free-running position in the ring
+--				char *data - bytes to copy in, or buffer to copy out to
+--				DWORD length - number of bytes
+--				BOOL in - TRUE to copy into the ring
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	Splits the copy in two where it wraps past the end of the data.
+--
+---------------------------------------------------------------------------------*/
+void ringCopy(RING *ring, DWORD offset, char *data, DWORD length, BOOL in)
+{
+	DWORD start = offset & (RING_SIZE - 1);
+	DWORD first = RING_SIZE - start < length ? RING_SIZE - start : length;
+
+	if (in)
+	{
+		memcpy(ring->data + start, data, first);
+		memcpy(ring->data, data + first, length - first);
+	}
+	else {
+		memcpy(data, ring->data + start, first);
+		memcpy(data + first, ring->data, length - first);
+	}
+}
\ No newline at end of file
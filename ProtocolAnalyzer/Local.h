@@ -0,0 +1,54 @@
+#pragma once
+
+#define TRANSPORT_TCP			0
+#define TRANSPORT_UNIX			1		//AF_UNIX stream socket, Windows 10 1803 and later
+#define TRANSPORT_RING			2		//shared-memory ring
+
+#ifndef UNIX_PATH_MAX
+#define UNIX_PATH_MAX			108
+// afunix.h only ships with Windows 10 SDKs from 17063 on
+typedef struct sockaddr_un {
+	ADDRESS_FAMILY sun_family;
+	char sun_path[UNIX_PATH_MAX];
+} SOCKADDR_UN, *PSOCKADDR_UN;
+#endif
+
+#define RING_SIZE				(4 * 1024 * 1024)	//data bytes, a power of two
+#define RING_SPIN				4000	//empty polls before the reader sleeps
+#define RING_WAIT				100		//ms a sleeping side waits before looking again
+#define RING_IDLE				0		//no writer attached
+#define RING_OPEN				1
+#define RING_CLOSED				2		//writer finished, reader drains the rest
+#define RING_GONE				3		//reader stopped
+
+// Start of the shared mapping. The writer's and reader's fields are on
+// separate cache lines, so the two sides only share a line to wake each other.
+typedef struct _RING_HEADER {
+	volatile LONG head;			// bytes written, free running
+	volatile LONG writerWaiting;
+	char writerPad[CACHE_LINE_SIZE - 2 * sizeof(LONG)];
+	volatile LONG tail;			// bytes read, free running
+	volatile LONG readerWaiting;
+	char readerPad[CACHE_LINE_SIZE - 2 * sizeof(LONG)];
+	volatile LONG state;
+	char statePad[CACHE_LINE_SIZE - sizeof(LONG)];
+} RING_HEADER;
+
+// One side's view of a ring. Messages are stored as a DWORD length and the
+// bytes, wrapping around the end of the data.
+typedef struct _RING {
+	HANDLE mapping;
+	RING_HEADER *header;
+	char *data;					// RING_SIZE bytes following the header
+	HANDLE dataReady;			// set by the writer when the reader sleeps
+	HANDLE spaceReady;			// set by the reader when the writer sleeps
+	BOOL reader;
+} RING;
+
+BOOL localSocketPath(int, char *);
+BOOL openRing(RING *, int, BOOL);
+void closeRing(RING *);
+BOOL ringConnect(RING *);
+BOOL ringWrite(RING *, char *, DWORD);
+void ringDisconnect(RING *);
+int ringRead(RING *, char *, DWORD);
\ No newline at end of file
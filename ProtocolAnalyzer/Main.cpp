@@ -29,7 +29,7 @@
 #include "resource.h"
 
 TCHAR Name[] = TEXT("Transport Layer Protocol Analyzer");
-char help[1024] = "Choose to be in client or server mode.\nIn client mode, click on Transfer->Transfer Data to send data to a server.\nIn server mode, enter the ports for UDP and TCP.";
+char help[1024] = "Choose to be in client or server mode.\nIn client mode, click on Transfer->Transfer Data to send data to a server.\nIn server mode, enter the ports for UDP and TCP.\nFile->Trace records the send, receive, statistics and file write paths, and File->Dump trace writes them to trace.json for chrome://tracing or the Perfetto UI. Starting with -trace traces from the start; the trace is also written on exit.\nFile->Benchmark dissector measures how many captured packets one core can decode.\nIn the transfer dialog, TCP congestion picks the algorithm for TCP sends, and a Matrix such as algorithms=cubic,newreno; streams=1,4 repeats the transfer with each and compares them. Both need an administrator. Clients such as clients=50000; threads=4; rate=5000 simulates that many TCP connections, each sending the profile.";
 HWND hwnd, hwndList, hTransfer, hServerSetup;
 HMENU hMenu;
 BOOL clientMode = TRUE;
@@ -49,6 +49,9 @@ void openFileDialog(HWND hDlg, char * fileName);
 --	DATE:		Oct 3, 2015
 --
 --	REVISIONS:	Feb 13, 2016
+--				Oct 19, 2026 - initialises the buffer pool
+--				Oct 19, 2026 - builds the checksum tables
+--				Oct 19, 2026 - starts tracing when run with -trace and writes the trace on exit
 --
 --	DESIGNER:	Microsoft
 --
@@ -105,12 +108,26 @@ int WINAPI WinMain(HINSTANCE hInst, HINSTANCE hprevInstance,
 	EnableMenuItem(hMenu, IDM_TRANS, MF_CHECKED);
 	CheckMenuRadioItem(hMenu, IDM_CLIENT, IDM_SERVER, IDM_CLIENT, MF_CHECKED);
 	clientLogFile = openFile("clientLog.txt", false);
+	initPool();
+	initChecksum();
+	TRACE_THREAD("GUI");
+#if TRACE_POINTS
+	if (strstr(lspszCmdParam, "-trace") != NULL)
+	{
+		startTracing();
+		CheckMenuItem(hMenu, IDM_TRACE, MF_CHECKED);
+	}
+#else
+	EnableMenuItem(hMenu, IDM_TRACE, MF_GRAYED);
+	EnableMenuItem(hMenu, IDM_DUMPTRACE, MF_GRAYED);
+#endif
 
 	while (GetMessage(&Msg, NULL, 0, 0))
 	{
 		TranslateMessage(&Msg);
 		DispatchMessage(&Msg);
 	}
+	dumpTrace(TRACE_FILE);
 	return Msg.wParam;
 }
 
@@ -120,6 +137,9 @@ int WINAPI WinMain(HINSTANCE hInst, HINSTANCE hprevInstance,
 --	DATE:		Oct 3, 2015
 --
 --	REVISIONS:	Feb 6, 2016 - added code to handle custom messages
+--				Oct 19, 2026 - tracing menu items
+--				Oct 19, 2026 - dissector benchmark menu item
+--				Oct 19, 2026 - waits for the transfer before closing the client log
 --
 --	DESIGNER:	Microsoft
 --
@@ -151,6 +171,10 @@ int WINAPI WinMain(HINSTANCE hInst, HINSTANCE hprevInstance,
 LRESULT CALLBACK WndProc(HWND hwnd, UINT Message,
 	WPARAM wParam, LPARAM lParam)
 {
+	char message[256];
+	LONG traced;
+	HANDLE benchmark;
+
 	switch (Message)
 	{
 	case WM_CREATE:
@@ -180,12 +204,49 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT Message,
 		case IDM_HELP:
 			MessageBox(hwnd, TEXT(help), TEXT("Help"), MB_OK);
 			break;
+		case IDM_TRACE:
+			if (traceEnabled)
+			{
+				stopTracing();
+				CheckMenuItem(hMenu, IDM_TRACE, MF_UNCHECKED);
+				writeToScreen("Tracing stopped");
+			}
+			else {
+				startTracing();
+				CheckMenuItem(hMenu, IDM_TRACE, MF_CHECKED);
+				writeToScreen("Tracing started");
+			}
+			break;
+		case IDM_DUMPTRACE:
+			if ((traced = dumpTrace(TRACE_FILE)) > 0)
+			{
+				sprintf(message, "%ld trace events written to %s", traced, TRACE_FILE);
+				writeToScreen(message);
+			}
+			else if (traced == 0)
+			{
+				writeToScreen("No trace events recorded");
+			}
+			else {
+				writeToScreen("Unable to write the trace");
+			}
+			break;
+		case IDM_BENCHMARK:
+			if ((benchmark = CreateThread(NULL, 0, benchmarkDissector, NULL, 0, NULL)) == NULL)
+			{
+				writeToScreen("Dissector benchmark could not start");
+			}
+			else {
+				CloseHandle(benchmark);
+			}
+			break;
 		case IDM_EXIT:
 			//Terminate program
 			if (!clientMode)
 			{
 				cleanUpServer();
 			}
+			stopTransfer();
 			closeFile(clientLogFile);
 			PostQuitMessage(0);
 			break;
@@ -196,6 +257,7 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT Message,
 		{
 			cleanUpServer();
 		}
+		stopTransfer();
 		PostQuitMessage(0);
 		break;
 	default:
@@ -236,6 +298,23 @@ void writeToScreen(LPCSTR data)
 --	DATE:		Jan 16, 2016
 --
 --	REVISIONS:	Feb 6, 2016 - modified to work with client and server dialogs
+--				Oct 19, 2026 - reads socket buffer options
+--				Oct 19, 2026 - reads framing option
+--				Oct 19, 2026 - reads pcapng option
+--				Oct 19, 2026 - reads replay options
+--				Oct 19, 2026 - read the traffic profile
+--				Oct 19, 2026 - reads integrity option
+--				Oct 19, 2026 - reads multicast options
+--				Oct 19, 2026 - Run duration, warmup and cooldown
+--				Oct 19, 2026 - impairment settings
+--				Oct 19, 2026 - Unix socket and shared-memory transports
+--				Oct 19, 2026 - reliable UDP and congestion control
+--				Oct 19, 2026 - placement field
+--				Oct 19, 2026 - busy-poll options
+--				Oct 19, 2026 - passive capture interface and filter
+--				Oct 19, 2026 - TCP congestion control and matrix
+--				Oct 19, 2026 - transfers run on their own thread, simulated clients
+--				Oct 19, 2026 - stops the transfer before starting the server
 --
 --	DESIGNER:	Gabriella Cheung
 --
@@ -254,7 +333,9 @@ void writeToScreen(LPCSTR data)
 --	This function handles messages from the client ("Transfer Data") and server
 --	("Server Setup") dialogs.
 --  If the dialog is Transfer Data, it checks all the data entered first before
---  calling the sendViaUDP or sendViaTCP method in Client.cpp.
+--  handing the transfer to startTransfer in Client.cpp, whose thread calls
+--  sendViaUDP or sendViaTCP, runMatrix in Congestion.cpp when a matrix is given
+--  or runSwarm in Swarm.cpp when there are simulated clients.
 --  If the dialog is Server Setup, it checks the data entered before calling the
 --  startServer method in Server.cpp.
 --
@@ -279,6 +360,16 @@ INT_PTR CALLBACK DialogProc(HWND hDlg, UINT uMSG, WPARAM wParam, LPARAM lParam)
 		SetDlgItemText(hDlg, IDC_UDPPORTEDIT, portStr);
 		sprintf(portStr, "%d", TCPSERVPORT);
 		SetDlgItemText(hDlg, IDC_TCPPORTEDIT, portStr);
+		SetDlgItemText(hDlg, IDC_SNDBUFEDIT, "0");
+		SetDlgItemText(hDlg, IDC_SPEEDEDIT, "1");
+		SetDlgItemText(hDlg, IDC_RCVBUFEDIT, "0");
+		CheckDlgButton(hDlg, IDC_AUTOTUNECHECK, BST_CHECKED);
+		SetDlgItemText(hDlg, IDC_TTLEDIT, "1");
+		CheckDlgButton(hDlg, IDC_LOOPBACKCHECK, BST_CHECKED);
+		SetDlgItemText(hDlg, IDC_DURATIONEDIT, "0");
+		SetDlgItemText(hDlg, IDC_WARMUPEDIT, "0");
+		SetDlgItemText(hDlg, IDC_COOLDOWNEDIT, "0");
+		SetDlgItemText(hDlg, IDC_CONGESTIONEDIT, "reno");
 		break;
 	case WM_CLOSE:
 		DestroyWindow(hDlg);
@@ -296,6 +387,9 @@ INT_PTR CALLBACK DialogProc(HWND hDlg, UINT uMSG, WPARAM wParam, LPARAM lParam)
 				char size[16] = { 0 };
 				char rep[16] = { 0 };
 				char file[256] = { 0 };
+				char buffer[16] = { 0 };
+				CLIENT_OPTIONS options = { 0 };
+				CLIENT_TRANSFER *transfer;
 
 				//get server ip
 				GetDlgItemText(hDlg, IDC_HOSTEDIT, hostname, 256);
@@ -329,11 +423,93 @@ INT_PTR CALLBACK DialogProc(HWND hDlg, UINT uMSG, WPARAM wParam, LPARAM lParam)
 					MessageBox(hDlg, TEXT("Please enter number of packets to send"), TEXT("Error"), MB_OK);
 					break;
 				}
-				//get protocol
+				//get send buffer size, 0 keeps the system default
+				GetDlgItemText(hDlg, IDC_SNDBUFEDIT, buffer, 16);
+				if (buffer[0] != NULL && !isdigit(*buffer))
+				{
+					MessageBox(hDlg, TEXT("Please enter send buffer size in bytes"), TEXT("Error"), MB_OK);
+					break;
+				}
+				options.sendBuffer = atoi(buffer);
+				options.framing = IsDlgButtonChecked(hDlg, IDC_FRAMECHECK) == BST_CHECKED;
+				options.integrity = IsDlgButtonChecked(hDlg, IDC_INTEGRITYCHECK) == BST_CHECKED;
+				GetDlgItemText(hDlg, IDC_TTLEDIT, buffer, 16);
+				options.ttl = atoi(buffer);
+				options.loopback = IsDlgButtonChecked(hDlg, IDC_LOOPBACKCHECK) == BST_CHECKED;
+				GetDlgItemText(hDlg, IDC_MCASTIFEDIT, options.multicastInterface, ADDRESS_LENGTH);
+				if (options.ttl < 0 || options.ttl > 255)
+				{
+					MessageBox(hDlg, TEXT("Multicast TTL must be between 0 and 255"), TEXT("Error"), MB_OK);
+					break;
+				}
+				GetDlgItemText(hDlg, IDC_PROFILEEDIT, options.profile, PROFILE_SPEC_LENGTH);
+				GetDlgItemText(hDlg, IDC_IMPAIREDIT, options.impairment, IMPAIR_SPEC_LENGTH);
+				GetDlgItemText(hDlg, IDC_PLACEMENTEDIT, options.placement, PLACEMENT_SPEC_LENGTH);
+				//get run length, 0 sends the repetition count instead
+				GetDlgItemText(hDlg, IDC_DURATIONEDIT, buffer, 16);
+				options.duration = atoi(buffer);
+				GetDlgItemText(hDlg, IDC_WARMUPEDIT, buffer, 16);
+				options.warmup = atoi(buffer);
+				GetDlgItemText(hDlg, IDC_COOLDOWNEDIT, buffer, 16);
+				options.cooldown = atoi(buffer);
+				if (options.duration < 0 || options.warmup < 0 || options.cooldown < 0)
+				{
+					MessageBox(hDlg, TEXT("Duration, warmup and cooldown must be 0 or more seconds"), TEXT("Error"), MB_OK);
+					break;
+				}
+				options.replay = IsDlgButtonChecked(hDlg, IDC_REPLAYCHECK) == BST_CHECKED;
+				GetDlgItemText(hDlg, IDC_SPEEDEDIT, buffer, 16);
+				options.speed = atof(buffer);
+				if (options.replay && (IsDlgButtonChecked(hDlg, IDC_RANDRADIO) == BST_CHECKED || options.speed < 0))
+				{
+					MessageBox(hDlg, TEXT("Replay needs a capture file and a speed of 0 or more"), TEXT("Error"), MB_OK);
+					break;
+				}
+				//get protocol, the local transports send the same stream as TCP
 				if (IsDlgButtonChecked(hDlg, IDC_TCPRADIO) == BST_CHECKED)
 				{
 					tcp = true;
 				}
+				else if (IsDlgButtonChecked(hDlg, IDC_UNIXRADIO) == BST_CHECKED)
+				{
+					tcp = true;
+					options.transport = TRANSPORT_UNIX;
+				}
+				else if (IsDlgButtonChecked(hDlg, IDC_RINGRADIO) == BST_CHECKED)
+				{
+					tcp = true;
+					options.transport = TRANSPORT_RING;
+				}
+				if (options.transport == TRANSPORT_RING && options.replay)
+				{
+					MessageBox(hDlg, TEXT("Replay is not available over shared memory"), TEXT("Error"), MB_OK);
+					break;
+				}
+				options.reliable = !tcp && IsDlgButtonChecked(hDlg, IDC_RELIABLECHECK) == BST_CHECKED;
+				GetDlgItemText(hDlg, IDC_CONGESTIONEDIT, options.congestion, RELIABLE_NAME_LENGTH);
+				if (options.reliable && options.replay)
+				{
+					MessageBox(hDlg, TEXT("Replay sends captured datagrams unchanged, so it cannot be reliable"), TEXT("Error"), MB_OK);
+					break;
+				}
+				GetDlgItemText(hDlg, IDC_TCPCCEDIT, options.tcpCongestion, CONGESTION_NAME_LENGTH);
+				if (options.tcpCongestion[0] != '\0' && congestionProvider(options.tcpCongestion) == NULL)
+				{
+					MessageBox(hDlg, TEXT("TCP congestion control must be default, ctcp, cubic, newreno, dctcp or bbr2"), TEXT("Error"), MB_OK);
+					break;
+				}
+				GetDlgItemText(hDlg, IDC_MATRIXEDIT, options.matrix, MATRIX_SPEC_LENGTH);
+				if (options.matrix[0] != '\0' && (!tcp || options.transport != TRANSPORT_TCP || options.replay))
+				{
+					MessageBox(hDlg, TEXT("The congestion control matrix needs TCP and generated data"), TEXT("Error"), MB_OK);
+					break;
+				}
+				GetDlgItemText(hDlg, IDC_SWARMEDIT, options.swarm, SWARM_SPEC_LENGTH);
+				if (options.swarm[0] != '\0' && (!tcp || options.transport != TRANSPORT_TCP || options.replay || options.matrix[0] != '\0'))
+				{
+					MessageBox(hDlg, TEXT("Simulated clients need TCP and generated data, without a matrix"), TEXT("Error"), MB_OK);
+					break;
+				}
 
 				//get source
 				if (!IsDlgButtonChecked(hDlg, IDC_RANDRADIO) == BST_CHECKED)
@@ -349,15 +525,35 @@ INT_PTR CALLBACK DialogProc(HWND hDlg, UINT uMSG, WPARAM wParam, LPARAM lParam)
 						hReadFile = openFile(file, true);
 					}
 				}
-				SendMessage(hDlg, WM_CLOSE, 0, 0);
-				//call client function that takes in hostname, port, packet size, repetition, source
-				if (tcp)
+				//the transfer runs on its own thread, which frees it, so the window stays responsive
+				if ((transfer = (CLIENT_TRANSFER *)malloc(sizeof(CLIENT_TRANSFER))) == NULL)
 				{
-					sendViaTCP(hostname, atoi(port), atoi(size), atoi(rep), hReadFile, clientLogFile);
+					MessageBox(hDlg, TEXT("Not enough memory to start the transfer"), TEXT("Error"), MB_OK);
+					if (hReadFile != NULL)
+					{
+						closeFile(hReadFile);
+					}
+					break;
 				}
-				else {
-					sendViaUDP(hostname, atoi(port), atoi(size), atoi(rep), hReadFile, clientLogFile);
+				strcpy(transfer->hostname, hostname);
+				transfer->port = atoi(port);
+				transfer->packetSize = atoi(size);
+				transfer->repetition = atoi(rep);
+				transfer->tcp = tcp;
+				transfer->file = hReadFile;
+				transfer->logFile = clientLogFile;
+				transfer->options = options;
+				if (!startTransfer(transfer))
+				{
+					MessageBox(hDlg, TEXT("A transfer is already running"), TEXT("Error"), MB_OK);
+					if (hReadFile != NULL)
+					{
+						closeFile(hReadFile);
+					}
+					free(transfer);
+					break;
 				}
+				SendMessage(hDlg, WM_CLOSE, 0, 0);
 			}
 			else if (hDlg == hServerSetup)
 			{
@@ -366,6 +562,8 @@ INT_PTR CALLBACK DialogProc(HWND hDlg, UINT uMSG, WPARAM wParam, LPARAM lParam)
 				int uPort = 7000;
 				int tPort = 8000;
 				char file[256] = { 0 };
+				char buffer[16] = { 0 };
+				SERVER_OPTIONS options = { 0 };
 				GetDlgItemText(hDlg, IDC_UDPPORTEDIT, udp, 64);
 				if (udp[0] != NULL || isdigit(*udp))
 				{
@@ -381,14 +579,36 @@ INT_PTR CALLBACK DialogProc(HWND hDlg, UINT uMSG, WPARAM wParam, LPARAM lParam)
 					MessageBox(hDlg, TEXT("UDP and TCP Ports cannot be the same"), TEXT("Error"), MB_OK);
 					break;
 				}
+				GetDlgItemText(hDlg, IDC_RCVBUFEDIT, buffer, 16);
+				if (buffer[0] != NULL && !isdigit(*buffer))
+				{
+					MessageBox(hDlg, TEXT("Please enter receive buffer size in bytes"), TEXT("Error"), MB_OK);
+					break;
+				}
+				options.receiveBuffer = atoi(buffer);
+				options.autotune = IsDlgButtonChecked(hDlg, IDC_AUTOTUNECHECK) == BST_CHECKED;
+				options.pcapng = IsDlgButtonChecked(hDlg, IDC_PCAPNGCHECK) == BST_CHECKED;
+				GetDlgItemText(hDlg, IDC_GROUPSEDIT, options.groups, MULTICAST_SPEC_LENGTH);
+				GetDlgItemText(hDlg, IDC_MCASTIFEDIT, options.multicastInterface, ADDRESS_LENGTH);
+				GetDlgItemText(hDlg, IDC_PLACEMENTEDIT, options.placement, PLACEMENT_SPEC_LENGTH);
+				GetDlgItemText(hDlg, IDC_WARMUPEDIT, buffer, 16);
+				options.warmup = atoi(buffer) > 0 ? atoi(buffer) : 0;
+				GetDlgItemText(hDlg, IDC_COOLDOWNEDIT, buffer, 16);
+				options.cooldown = atoi(buffer) > 0 ? atoi(buffer) : 0;
+				options.busyPoll = IsDlgButtonChecked(hDlg, IDC_BUSYPOLLCHECK) == BST_CHECKED;
+				GetDlgItemText(hDlg, IDC_SPINEDIT, buffer, 16);
+				options.spin = buffer[0] == '\0' ? BUSY_POLL_SPIN : atoi(buffer) > 0 ? atoi(buffer) : 0;
+				GetDlgItemText(hDlg, IDC_PASSIVEEDIT, options.passiveInterface, ADDRESS_LENGTH);
+				GetDlgItemText(hDlg, IDC_FILTEREDIT, options.passiveFilter, PASSIVE_FILTER_LENGTH);
 				GetDlgItemText(hDlg, IDC_SAVEFILEEDIT, file, 256);
 				if (file[0] != NULL) // if file name is entered
 				{
 					hWriteFile = openFile(file, false);
 				}
 				SendMessage(hDlg, WM_CLOSE, 0, 0);
+				stopTransfer();
 				cleanUpServer();
-				startServer(uPort,tPort, hWriteFile);
+				startServer(uPort,tPort, hWriteFile, &options);
 				CheckMenuRadioItem(hMenu, IDM_CLIENT, IDM_SERVER, IDM_SERVER, MF_CHECKED);
 				EnableMenuItem(hMenu, IDM_TRANS, MF_GRAYED);
 				clientMode = FALSE;
@@ -0,0 +1,336 @@
+/*---------------------------------------------------------------------------------
+--	SOURCE FILE:	Message.cpp -
+--
+--	PROGRAM:		Transport Layer Protocol Analyser
+--
+--	FUNCTIONS:
+--					void parseFrames(FRAME_PARSER *parser, char *data, DWORD length,
+--						STATS_COUNTERS *messages, PAYLOAD_HANDLER handler)
+--					void endFrames(FRAME_PARSER *parser, STATS_COUNTERS *messages)
+--					char *parseDatagram(char *data, DWORD length, BOOL truncated,
+--						LONG *sequence, DWORD *flow, ULONGLONG *sent, STATS_COUNTERS *messages)
+--					void finishFrame(FRAME_PARSER *parser, STATS_COUNTERS *messages)
+--
+--	DATE:			Oct 19, 2026
+--
+--	REVISIONS:		Oct 19, 2026
+--
+--	DESIGNER:		Gabriella Cheung
+--
+--	PROGRAMMER:		Gabriella Cheung
+--
+--	NOTES:
+--	This file contains the code that turns the TCP byte stream back into the
+--  messages the client sent, and the code that reads the headers the client puts
+--  on datagrams. The wire formats are declared in Message.h.
+--
+--  In integrity mode each message carries the CRC32C of its payload, which is
+--  checked as the payload arrives. A message is counted as verified, corrupted
+--  or truncated.
+--
+---------------------------------------------------------------------------------*/
+#include "resource.h"
+
+void finishFrame(FRAME_PARSER *, STATS_COUNTERS *);
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: parseFrames
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--				Oct 19, 2026 - verifies checked frames
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void parseFrames(FRAME_PARSER *parser, char *data, DWORD length,
+--					STATS_COUNTERS *messages, PAYLOAD_HANDLER handler)
+--
+--	PARAMETERS:	FRAME_PARSER *parser - parser state of the connection
+--				char *data - bytes from one receive
+--				DWORD length - number of bytes in data
+--				STATS_COUNTERS *messages - frames completed in this receive
+--				PAYLOAD_HANDLER handler - called with each run of payload bytes,
+--								or NULL
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	This function is called for every receive on a TCP connection and carries
+--  its state over to the next call, so a frame may be split anywhere, including
+--  inside its header.
+--
+--  The first header of a connection decides the mode. If it does not start with
+--  FRAME_MAGIC, the client is not framing and the whole stream is passed through
+--  as payload. If a later header is bad the stream can't be resynchronised, so a
+--  framing error is counted and the rest of the connection is passed through.
+--
+--  A frame with FRAME_CHECKED_MAGIC starts its payload with an INTEGRITY_HEADER,
+--  which is staged like a split frame header and not passed to the handler.
+--
+---------------------------------------------------------------------------------*/
+void parseFrames(FRAME_PARSER *parser, char *data, DWORD length, STATS_COUNTERS *messages, PAYLOAD_HANDLER handler)
+{
+	FRAME_HEADER *header;
+	DWORD count;
+
+	while (length > 0)
+	{
+		if (parser->mode == FRAMING_OFF)
+		{
+			if (handler != NULL)
+			{
+				handler(data, length);
+			}
+			return;
+		}
+
+		if (parser->remaining > 0) //inside a payload
+		{
+			count = parser->remaining < length ? parser->remaining : length;
+			if (parser->checked && parser->checkBytes < sizeof(INTEGRITY_HEADER))
+			{
+				count = sizeof(INTEGRITY_HEADER) - parser->checkBytes < count ? sizeof(INTEGRITY_HEADER) - parser->checkBytes : count;
+				memcpy(parser->check + parser->checkBytes, data, count);
+				parser->checkBytes += count;
+			}
+			else {
+				if (parser->checked)
+				{
+					parser->crc = crc32c(parser->crc, data, count);
+				}
+				if (handler != NULL)
+				{
+					handler(data, count);
+				}
+			}
+			data += count;
+			length -= count;
+			parser->remaining -= count;
+			if (parser->remaining == 0)
+			{
+				finishFrame(parser, messages);
+			}
+			continue;
+		}
+
+		if (parser->headerBytes == 0 && length >= sizeof(FRAME_HEADER))
+		{
+			//whole header in this buffer, read it in place
+			header = (FRAME_HEADER *)data;
+			data += sizeof(FRAME_HEADER);
+			length -= sizeof(FRAME_HEADER);
+		}
+		else {
+			count = sizeof(FRAME_HEADER) - parser->headerBytes;
+			count = count < length ? count : length;
+			memcpy(parser->header + parser->headerBytes, data, count);
+			parser->headerBytes += count;
+			data += count;
+			length -= count;
+			if (parser->headerBytes < sizeof(FRAME_HEADER))
+			{
+				return;
+			}
+			header = (FRAME_HEADER *)parser->header;
+			parser->headerBytes = 0;
+		}
+
+		if (ntohl(header->magic) != FRAME_MAGIC && ntohl(header->magic) != FRAME_CHECKED_MAGIC)
+		{
+			if (parser->mode == FRAMING_ON)
+			{
+				messages->framingErrors++;
+			}
+			parser->mode = FRAMING_OFF;
+			if (handler != NULL)
+			{
+				handler((char *)header, sizeof(FRAME_HEADER));
+			}
+			continue;
+		}
+		parser->mode = FRAMING_ON;
+		parser->checked = ntohl(header->magic) == FRAME_CHECKED_MAGIC;
+		parser->checkBytes = 0;
+		parser->crc = 0;
+		parser->remaining = ntohl(header->length);
+		parser->frameSize = sizeof(FRAME_HEADER) + parser->remaining;
+		if (parser->remaining == 0)
+		{
+			finishFrame(parser, messages);
+		}
+	}
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: endFrames
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void endFrames(FRAME_PARSER *parser, STATS_COUNTERS *messages)
+--
+--	PARAMETERS:	FRAME_PARSER *parser - parser state of the connection
+--				STATS_COUNTERS *messages - receives the truncated frame, if any
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	Called when the peer closes the connection. A checked frame that was still
+--  waiting for payload was cut short by the sender.
+--
+---------------------------------------------------------------------------------*/
+void endFrames(FRAME_PARSER *parser, STATS_COUNTERS *messages)
+{
+	if (parser->mode == FRAMING_ON && parser->checked && parser->remaining > 0)
+	{
+		messages->truncated++;
+		parser->remaining = 0;
+	}
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: parseDatagram
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--				Oct 19, 2026 - returns the flow id
+--				Oct 19, 2026 - reads the send time of timed datagrams
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	char *parseDatagram(char *data, DWORD length, BOOL truncated,
+--					LONG *sequence, DWORD *flow, ULONGLONG *sent, STATS_COUNTERS *messages)
+--
+--	PARAMETERS:	char *data - one received datagram
+--				DWORD length - number of bytes received
+--				BOOL truncated - the datagram did not fit the receive buffer
+--				LONG *sequence - receives the sequence number, or NO_SEQUENCE
+--				DWORD *flow - receives the flow id, or 0
+--				ULONGLONG *sent - receives the sender's FILETIME, or 0
+--				STATS_COUNTERS *messages - receives the message and its
+--								integrity result
+--
+--	RETURNS:	the start of the payload, after any headers
+--
+--	NOTES:
+--	A datagram with DATAGRAM_CHECKED_MAGIC is verified against its
+--  INTEGRITY_HEADER. Fewer payload bytes than the header gives means the
+--  datagram was cut short; any other difference in length or CRC is corruption.
+--  A timed datagram carries the time it was sent between the two headers.
+--
+---------------------------------------------------------------------------------*/
+char *parseDatagram(char *data, DWORD length, BOOL truncated, LONG *sequence, DWORD *flow, ULONGLONG *sent, STATS_COUNTERS *messages)
+{
+	DATAGRAM_HEADER *header = (DATAGRAM_HEADER *)data;
+	TIMESTAMP_HEADER *stamp;
+	INTEGRITY_HEADER *check;
+	DWORD magic;
+
+	*sequence = NO_SEQUENCE;
+	*flow = 0;
+	*sent = 0;
+	addMessage(messages, length);
+	if (length < sizeof(DATAGRAM_HEADER))
+	{
+		return data;
+	}
+	magic = ntohl(header->magic);
+	if (magic != DATAGRAM_MAGIC && magic != DATAGRAM_CHECKED_MAGIC
+		&& magic != DATAGRAM_TIMED_MAGIC && magic != DATAGRAM_TIMED_CHECKED_MAGIC)
+	{
+		return data;
+	}
+	*sequence = (LONG)ntohl(header->sequence);
+	*flow = ntohl(header->flow);
+	data += sizeof(DATAGRAM_HEADER);
+	length -= sizeof(DATAGRAM_HEADER);
+	if ((magic == DATAGRAM_TIMED_MAGIC || magic == DATAGRAM_TIMED_CHECKED_MAGIC) && length >= sizeof(TIMESTAMP_HEADER))
+	{
+		stamp = (TIMESTAMP_HEADER *)data;
+		*sent = (ULONGLONG)ntohl(stamp->high) << 32 | ntohl(stamp->low);
+		data += sizeof(TIMESTAMP_HEADER);
+		length -= sizeof(TIMESTAMP_HEADER);
+	}
+	if (magic == DATAGRAM_MAGIC || magic == DATAGRAM_TIMED_MAGIC)
+	{
+		return data;
+	}
+
+	if (length < sizeof(INTEGRITY_HEADER))
+	{
+		messages->truncated++;
+		return data + length;
+	}
+	check = (INTEGRITY_HEADER *)data;
+	data += sizeof(INTEGRITY_HEADER);
+	length -= sizeof(INTEGRITY_HEADER);
+	if (truncated || length < ntohl(check->length))
+	{
+		messages->truncated++;
+	}
+	else if (length == ntohl(check->length) && crc32c(0, data, length) == ntohl(check->crc))
+	{
+		messages->verified++;
+	}
+	else {
+		messages->corrupted++;
+	}
+	return data;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: finishFrame
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void finishFrame(FRAME_PARSER *parser, STATS_COUNTERS *messages)
+--
+--	PARAMETERS:	FRAME_PARSER *parser - parser that just read a whole frame
+--				STATS_COUNTERS *messages - frames completed in this receive
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	Counts the frame and, for a checked frame, compares the CRC32C computed
+--  while its payload arrived with the one the client sent.
+--
+---------------------------------------------------------------------------------*/
+void finishFrame(FRAME_PARSER *parser, STATS_COUNTERS *messages)
+{
+	INTEGRITY_HEADER *check = (INTEGRITY_HEADER *)parser->check;
+	DWORD length = parser->frameSize - sizeof(FRAME_HEADER) - parser->checkBytes;
+
+	addMessage(messages, parser->frameSize);
+	if (!parser->checked)
+	{
+		return;
+	}
+	if (parser->checkBytes < sizeof(INTEGRITY_HEADER) || length < ntohl(check->length))
+	{
+		messages->truncated++;
+	}
+	else if (length == ntohl(check->length) && parser->crc == ntohl(check->crc))
+	{
+		messages->verified++;
+	}
+	else {
+		messages->corrupted++;
+	}
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#define DATAGRAM_MAGIC			0x50414447	//"PADG"
+#define DATAGRAM_CHECKED_MAGIC	0x50414443	//"PADC", followed by an INTEGRITY_HEADER
+#define DATAGRAM_TIMED_MAGIC	0x50414454	//"PADT", followed by a TIMESTAMP_HEADER
+#define DATAGRAM_TIMED_CHECKED_MAGIC	0x50414456	//"PADV", a TIMESTAMP_HEADER and then an INTEGRITY_HEADER
+
+// Prepended to every datagram sent by sendViaUDP. The sequence number lets the
+// server count datagrams that never arrived, and the flow id tells apart runs
+// that reuse a source port. All fields are in network order.
+typedef struct _DATAGRAM_HEADER {
+	DWORD magic;
+	DWORD flow;				// picked by the client for each run, never 0
+	DWORD sequence;
+} DATAGRAM_HEADER;
+
+#define FRAME_MAGIC				0x50414652	//"PAFR"
+#define FRAME_CHECKED_MAGIC		0x50414643	//"PAFC", payload starts with an INTEGRITY_HEADER
+
+#define FRAMING_UNKNOWN			0	//not enough bytes yet to tell
+#define FRAMING_ON				1
+#define FRAMING_OFF				2
+
+// Prepended to every message sendViaTCP sends in framed mode. length is the
+// number of payload bytes that follow the header. Both fields are in network order.
+typedef struct _FRAME_HEADER {
+	DWORD magic;
+	DWORD length;
+} FRAME_HEADER;
+
+// Sent in integrity mode after the DATAGRAM_HEADER, or as the first bytes of a
+// frame's payload. crc is the CRC32C of the length bytes that follow. Both
+// fields are in network order.
+typedef struct _INTEGRITY_HEADER {
+	DWORD length;
+	DWORD crc;
+} INTEGRITY_HEADER;
+
+// Sent after the DATAGRAM_HEADER of a timed datagram. The two halves of the
+// sender's precise FILETIME just before the send, so the receiver can tell how
+// long the datagram took to reach it. Only meaningful when both clocks agree,
+// as they do on one host. Both fields are in network order.
+typedef struct _TIMESTAMP_HEADER {
+	DWORD high;
+	DWORD low;
+} TIMESTAMP_HEADER;
+
+// Most header bytes the client puts in front of one message's payload.
+#define MESSAGE_HEADER_ROOM		(sizeof(DATAGRAM_HEADER) + sizeof(TIMESTAMP_HEADER) + sizeof(INTEGRITY_HEADER))
+
+typedef void (*PAYLOAD_HANDLER)(char *, DWORD);
+
+// Per-connection state for parseFrames. Only a header that straddles two
+// receives is copied; payload bytes are handed on where they lie in the buffer.
+typedef struct _FRAME_PARSER {
+	int mode;
+	DWORD headerBytes;			// bytes of a split header staged in header
+	char header[sizeof(FRAME_HEADER)];
+	DWORD remaining;			// payload bytes still to come for the current frame
+	DWORD frameSize;			// header plus payload of the current frame
+	BOOL checked;				// current frame carries an INTEGRITY_HEADER
+	DWORD checkBytes;			// bytes of it staged in check
+	char check[sizeof(INTEGRITY_HEADER)];
+	DWORD crc;					// CRC32C of the payload so far
+} FRAME_PARSER;
+
+void parseFrames(FRAME_PARSER *, char *, DWORD, STATS_COUNTERS *, PAYLOAD_HANDLER);
+void endFrames(FRAME_PARSER *, STATS_COUNTERS *);
+char *parseDatagram(char *, DWORD, BOOL, LONG *, DWORD *, ULONGLONG *, STATS_COUNTERS *);
@@ -0,0 +1,225 @@
+/*---------------------------------------------------------------------------------
+--	SOURCE FILE:	Multicast.cpp -
+--
+--	PROGRAM:		Transport Layer Protocol Analyser
+--
+--	FUNCTIONS:
+--					int joinGroups(SOCKET sd, char *groups, char *interfaceAddress,
+--						MULTICAST_GROUP *joined)
+--					MULTICAST_GROUP *findGroup(MULTICAST_GROUP *groups, int count,
+--						struct in_addr address)
+--					BOOL setMulticastOptions(SOCKET sd, int ttl, BOOL loopback,
+--						char *interfaceAddress)
+--					BOOL parseInterface(char *interfaceAddress, struct in_addr *address)
+--
+--	DATE:			Oct 19, 2026
+--
+--	REVISIONS:		Oct 19, 2026
+--
+--	DESIGNER:		Gabriella Cheung
+--
+--	PROGRAMMER:		Gabriella Cheung
+--
+--	NOTES:
+--	This file contains the socket setup for IPv4 multicast. The client sends to
+--  a group address like any other host, after setting the TTL, loopback and
+--  outgoing interface. The server joins each group on its UDP socket, which
+--  sends the IGMP membership report, and learns the group a datagram was sent
+--  to from IP_PKTINFO.
+--
+---------------------------------------------------------------------------------*/
+#include "resource.h"
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: joinGroups
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	int joinGroups(SOCKET sd, char *groups, char *interfaceAddress,
+--					MULTICAST_GROUP *joined)
+--
+--	PARAMETERS:	SOCKET sd - bound UDP socket
+--				char *groups - comma separated group addresses
+--				char *interfaceAddress - local address to join on, empty for
+--								the interface the routing table picks
+--				MULTICAST_GROUP *joined - receives up to MULTICAST_MAX_GROUPS groups
+--
+--	RETURNS:	the number of groups joined
+--
+--	NOTES:
+--	Each group is reported on the screen. A group that can't be joined is left
+--  out rather than stopping the server.
+--
+---------------------------------------------------------------------------------*/
+int joinGroups(SOCKET sd, char *groups, char *interfaceAddress, MULTICAST_GROUP *joined)
+{
+	char list[MULTICAST_SPEC_LENGTH];
+	char *group, *context = NULL;
+	struct ip_mreq request;
+	char message[256];
+	int count = 0;
+
+	if (!parseInterface(interfaceAddress, &request.imr_interface))
+	{
+		writeToScreen("Invalid multicast interface address");
+		return 0;
+	}
+	strncpy(list, groups, sizeof(list) - 1);
+	list[sizeof(list) - 1] = '\0';
+	for (group = strtok_s(list, ", ", &context); group != NULL; group = strtok_s(NULL, ", ", &context))
+	{
+		if (count == MULTICAST_MAX_GROUPS)
+		{
+			writeToScreen("Too many multicast groups");
+			break;
+		}
+		request.imr_multiaddr.s_addr = inet_addr(group);
+		if (!IN_MULTICAST(ntohl(request.imr_multiaddr.s_addr)))
+		{
+			sprintf(message, "%s is not a multicast group", group);
+			writeToScreen(message);
+			continue;
+		}
+		if (setsockopt(sd, IPPROTO_IP, IP_ADD_MEMBERSHIP, (char *)&request, sizeof(request)) == SOCKET_ERROR)
+		{
+			sprintf(message, "Joining %s failed with error %d", group, WSAGetLastError());
+			writeToScreen(message);
+			continue;
+		}
+		joined[count].address = request.imr_multiaddr;
+		initStats(&(joined[count].stats), "UDP multicast");
+		count++;
+		sprintf(message, "Joined multicast group %s", group);
+		writeToScreen(message);
+	}
+	return count;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: findGroup
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	MULTICAST_GROUP *findGroup(MULTICAST_GROUP *groups, int count,
+--					struct in_addr address)
+--
+--	PARAMETERS:	MULTICAST_GROUP *groups - groups joined by joinGroups
+--				int count - number of groups
+--				struct in_addr address - destination of a received datagram
+--
+--	RETURNS:	the group, or NULL for a unicast datagram or unknown group
+--
+--	NOTES:
+--	A linear search; there are at most MULTICAST_MAX_GROUPS groups.
+--
+---------------------------------------------------------------------------------*/
+MULTICAST_GROUP *findGroup(MULTICAST_GROUP *groups, int count, struct in_addr address)
+{
+	for (int i = 0; i < count; i++)
+	{
+		if (groups[i].address.s_addr == address.s_addr)
+		{
+			return &groups[i];
+		}
+	}
+	return NULL;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: setMulticastOptions
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	BOOL setMulticastOptions(SOCKET sd, int ttl, BOOL loopback,
+--					char *interfaceAddress)
+--
+--	PARAMETERS:	SOCKET sd - UDP socket the client sends from
+--				int ttl - hops the datagrams may take, 1 keeps them on the subnet
+--				BOOL loopback - deliver a copy to receivers on this host
+--				char *interfaceAddress - local address to send from, empty for
+--								the interface the routing table picks
+--
+--	RETURNS:	TRUE if every option was applied
+--
+--	NOTES:
+--	Loopback must be on for receivers running on the sending host.
+--
+---------------------------------------------------------------------------------*/
+BOOL setMulticastOptions(SOCKET sd, int ttl, BOOL loopback, char *interfaceAddress)
+{
+	struct in_addr address;
+	DWORD value;
+
+	if (!parseInterface(interfaceAddress, &address))
+	{
+		return FALSE;
+	}
+	value = ttl;
+	if (setsockopt(sd, IPPROTO_IP, IP_MULTICAST_TTL, (char *)&value, sizeof(value)) == SOCKET_ERROR)
+	{
+		return FALSE;
+	}
+	value = loopback ? 1 : 0;
+	if (setsockopt(sd, IPPROTO_IP, IP_MULTICAST_LOOP, (char *)&value, sizeof(value)) == SOCKET_ERROR)
+	{
+		return FALSE;
+	}
+	if (address.s_addr != htonl(INADDR_ANY)
+		&& setsockopt(sd, IPPROTO_IP, IP_MULTICAST_IF, (char *)&address, sizeof(address)) == SOCKET_ERROR)
+	{
+		return FALSE;
+	}
+	return TRUE;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: parseInterface
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	BOOL parseInterface(char *interfaceAddress, struct in_addr *address)
+--
+--	PARAMETERS:	char *interfaceAddress - dotted local address, may be empty
+--				struct in_addr *address - receives the address, INADDR_ANY if empty
+--
+--	RETURNS:	TRUE if the address is empty or valid
+--
+--	NOTES:
+--	Interfaces are named by one of their IPv4 addresses, which is what
+--  IP_MULTICAST_IF and ip_mreq take.
+--
+---------------------------------------------------------------------------------*/
+BOOL parseInterface(char *interfaceAddress, struct in_addr *address)
+{
+	address->s_addr = htonl(INADDR_ANY);
+	if (interfaceAddress[0] == '\0')
+	{
+		return TRUE;
+	}
+	address->s_addr = inet_addr(interfaceAddress);
+	return address->s_addr != INADDR_NONE;
+}
\ No newline at end of file
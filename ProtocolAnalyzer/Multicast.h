@@ -0,0 +1,17 @@
+#pragma once
+
+#define MULTICAST_MAX_GROUPS	16
+#define MULTICAST_SPEC_LENGTH	256
+#define ADDRESS_LENGTH			16		//dotted IPv4 address and terminator
+
+// A group the UDP server joined. Datagrams sent to it are counted here as well
+// as in the server-wide UDP statistics.
+typedef struct _MULTICAST_GROUP {
+	struct in_addr address;
+	TRANSFER_STATS stats;
+} MULTICAST_GROUP;
+
+int joinGroups(SOCKET, char *, char *, MULTICAST_GROUP *);
+MULTICAST_GROUP *findGroup(MULTICAST_GROUP *, int, struct in_addr);
+BOOL setMulticastOptions(SOCKET, int, BOOL, char *);
+BOOL parseInterface(char *, struct in_addr *);
\ No newline at end of file
@@ -0,0 +1,415 @@
+/*---------------------------------------------------------------------------------
+--	SOURCE FILE:	Passive.cpp -
+--
+--	PROGRAM:		Transport Layer Protocol Analyser
+--
+--	FUNCTIONS:
+--					BOOL parsePassiveFilter(char *spec, PASSIVE_FILTER *filter)
+--					BOOL openPassive(PASSIVE_CAPTURE *capture, char *address, PASSIVE_FILTER *filter)
+--					int readPassive(PASSIVE_CAPTURE *capture, PASSIVE_HANDLER handler)
+--					void closePassive(PASSIVE_CAPTURE *capture)
+--					BOOL postPassive(PASSIVE_CAPTURE *capture, PASSIVE_SLOT *slot)
+--					void filterBatch(PASSIVE_CAPTURE *capture)
+--
+--	DATE:			Oct 19, 2026
+--
+--	REVISIONS:		Oct 19, 2026
+--					Oct 19, 2026 - packets dissected a batch at a time by Dissect.cpp
+--
+--	DESIGNER:		Gabriella Cheung
+--
+--	PROGRAMMER:		Gabriella Cheung
+--
+--	NOTES:
+--	This file watches the TCP and UDP traffic passing through one of the host's
+--  interfaces without being an end of it. A raw IPv4 socket bound to the
+--  interface's address is switched to SIO_RCVALL, so the stack hands it a copy
+--  of every IP packet the interface sends or receives. This needs
+--  administrator rights. Loopback traffic only reaches raw sockets on systems
+--  that route it through a loopback adapter.
+--
+--  PASSIVE_SLOTS receives are kept posted into one block of memory, each slot
+--  large enough for any IPv4 packet. Their completions go to a completion port
+--  and are taken PASSIVE_BATCH at a time with GetQueuedCompletionStatusEx, so
+--  a burst of packets costs one wait. Each batch is dissected where it landed
+--  (see Dissect.cpp) and handed on as pointers into the slots; nothing is
+--  copied, and the slots are posted again once the batch has been handled.
+--
+--  Winsock has no packet filter to push into the kernel, so the filter is a
+--  protocol, host and port compared against the headers before the handler
+--  runs.
+--
+---------------------------------------------------------------------------------*/
+#include "resource.h"
+
+BOOL postPassive(PASSIVE_CAPTURE *, PASSIVE_SLOT *);
+void filterBatch(PASSIVE_CAPTURE *);
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: parsePassiveFilter
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	BOOL parsePassiveFilter(char *spec, PASSIVE_FILTER *filter)
+--
+--	PARAMETERS:	char *spec - filter settings, empty to keep every TCP and UDP packet
+--				PASSIVE_FILTER *filter - receives the settings and a description
+--
+--	RETURNS:	TRUE if every setting was understood
+--
+--	NOTES:
+--	proto is tcp or udp; host and port match either end of the packet.
+--
+---------------------------------------------------------------------------------*/
+BOOL parsePassiveFilter(char *spec, PASSIVE_FILTER *filter)
+{
+	char settings[PASSIVE_FILTER_LENGTH];
+	char *setting, *value, *context = NULL;
+	char *text = filter->description;
+	struct in_addr host;
+
+	ZeroMemory(filter, sizeof(PASSIVE_FILTER));
+	strncpy(settings, spec, sizeof(settings) - 1);
+	settings[sizeof(settings) - 1] = '\0';
+	for (setting = strtok_s(settings, "; ", &context); setting != NULL; setting = strtok_s(NULL, "; ", &context))
+	{
+		if ((value = strchr(setting, '=')) == NULL)
+		{
+			return FALSE;
+		}
+		*value++ = '\0';
+		if (strcmp(setting, "proto") == 0)
+		{
+			if (strcmp(value, "tcp") == 0)
+			{
+				filter->protocol = IPPROTO_TCP;
+			}
+			else if (strcmp(value, "udp") == 0)
+			{
+				filter->protocol = IPPROTO_UDP;
+			}
+			else {
+				return FALSE;
+			}
+		}
+		else if (strcmp(setting, "host") == 0)
+		{
+			if ((filter->host = inet_addr(value)) == INADDR_NONE)
+			{
+				return FALSE;
+			}
+		}
+		else if (strcmp(setting, "port") == 0)
+		{
+			if (atoi(value) <= 0 || atoi(value) > 65535)
+			{
+				return FALSE;
+			}
+			filter->port = htons((USHORT)atoi(value));
+		}
+		else {
+			return FALSE;
+		}
+	}
+
+	text += sprintf(text, "%s", filter->protocol == IPPROTO_TCP ? "TCP" : filter->protocol == IPPROTO_UDP ? "UDP" : "TCP and UDP");
+	if (filter->host != 0)
+	{
+		host.s_addr = filter->host;
+		text += sprintf(text, " to or from %s", inet_ntoa(host));
+	}
+	if (filter->port != 0)
+	{
+		text += sprintf(text, " on port %d", ntohs(filter->port));
+	}
+	return TRUE;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: openPassive
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	BOOL openPassive(PASSIVE_CAPTURE *capture, char *address, PASSIVE_FILTER *filter)
+--
+--	PARAMETERS:	PASSIVE_CAPTURE *capture - capture to set up
+--				char *address - local IPv4 address of the interface to watch
+--				PASSIVE_FILTER *filter - packets to keep
+--
+--	RETURNS:	FALSE if the capture could not start, with the Winsock error set
+--
+--	NOTES:
+--	WSAEACCES from the socket or the ioctl means the process is not running
+--  as administrator. The slots come from the receive threads' NUMA node.
+--
+---------------------------------------------------------------------------------*/
+BOOL openPassive(PASSIVE_CAPTURE *capture, char *address, PASSIVE_FILTER *filter)
+{
+	SOCKADDR_IN local;
+	DWORD option = RCVALL_ON, bytes;
+	int size = PASSIVE_RCVBUF;
+	int error;
+
+	ZeroMemory(capture, sizeof(PASSIVE_CAPTURE));
+	capture->filter = *filter;
+	ZeroMemory(&local, sizeof(local));
+	local.sin_family = AF_INET;
+	if ((local.sin_addr.s_addr = inet_addr(address)) == INADDR_NONE || local.sin_addr.s_addr == INADDR_ANY)
+	{
+		WSASetLastError(WSAEADDRNOTAVAIL);
+		return FALSE;
+	}
+	if ((capture->sd = WSASocket(AF_INET, SOCK_RAW, IPPROTO_IP, NULL, 0, WSA_FLAG_OVERLAPPED)) == INVALID_SOCKET)
+	{
+		return FALSE;
+	}
+	if (bind(capture->sd, (struct sockaddr *)&local, sizeof(local)) == SOCKET_ERROR
+		|| WSAIoctl(capture->sd, SIO_RCVALL, &option, sizeof(option), NULL, 0, &bytes, NULL, NULL) == SOCKET_ERROR)
+	{
+		error = WSAGetLastError();
+		closePassive(capture);
+		WSASetLastError(error);
+		return FALSE;
+	}
+	setsockopt(capture->sd, SOL_SOCKET, SO_RCVBUF, (char *)&size, sizeof(size));
+
+	if ((capture->buffers = (char *)nodeAlloc((SIZE_T)PASSIVE_SLOTS * PASSIVE_SLOT_SIZE)) == NULL
+		|| (capture->port = CreateIoCompletionPort((HANDLE)capture->sd, NULL, 0, 1)) == NULL)
+	{
+		closePassive(capture);
+		WSASetLastError(WSA_NOT_ENOUGH_MEMORY);
+		return FALSE;
+	}
+	for (int i = 0; i < PASSIVE_SLOTS; i++)
+	{
+		capture->slots[i].buffer.buf = capture->buffers + (SIZE_T)i * PASSIVE_SLOT_SIZE;
+		capture->slots[i].buffer.len = PASSIVE_SLOT_SIZE;
+		if (!postPassive(capture, &(capture->slots[i])))
+		{
+			error = WSAGetLastError();
+			closePassive(capture);
+			WSASetLastError(error);
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: readPassive
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--				Oct 19, 2026 - dissects the whole batch
+--				Oct 19, 2026 - stamps the batch when it arrives
+--				Oct 19, 2026 - skips failed receives
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	int readPassive(PASSIVE_CAPTURE *capture, PASSIVE_HANDLER handler)
+--
+--	PARAMETERS:	PASSIVE_CAPTURE *capture - an open capture
+--				PASSIVE_HANDLER handler - called for each packet that passes the filter
+--
+--	RETURNS:	packets taken, 0 if none came within PASSIVE_WAIT, -1 once no
+--				receive is left posted
+--
+--	NOTES:
+--	Takes one batch of completed receives, dissects and filters it, and posts
+--  the slots again once the handler is done with them. A failed receive
+--  is left out of the batch, since its buffer holds whatever was there
+--  before, and is posted again like any other.
+--
+---------------------------------------------------------------------------------*/
+int readPassive(PASSIVE_CAPTURE *capture, PASSIVE_HANDLER handler)
+{
+	OVERLAPPED_ENTRY entries[DISSECT_BATCH];
+	ULONG count = 0;
+	PACKET_BATCH *batch = &(capture->batch);
+	ULONGLONG now;
+	LARGE_INTEGER start, end;
+
+	if (!GetQueuedCompletionStatusEx(capture->port, entries, DISSECT_BATCH, &count, PASSIVE_WAIT, FALSE))
+	{
+		return GetLastError() == WAIT_TIMEOUT && capture->posted > 0 ? 0 : -1;
+	}
+	now = currentFileTime();
+	capture->batches++;
+	capture->posted -= count;
+
+	QueryPerformanceCounter(&start);
+	batch->count = 0;
+	for (ULONG i = 0; i < count; i++)
+	{
+		// Internal holds the receive's status
+		if (entries[i].Internal != 0)
+		{
+			capture->failed++;
+			continue;
+		}
+		batch->data[batch->count] = (BYTE *)((PASSIVE_SLOT *)entries[i].lpOverlapped)->buffer.buf;
+		batch->captured[batch->count] = entries[i].dwNumberOfBytesTransferred;
+		batch->time[batch->count] = now;
+		batch->count++;
+	}
+	capture->packets += batch->count;
+	dissectBatch(batch);
+	filterBatch(capture);
+	QueryPerformanceCounter(&end);
+	capture->dissectTime += end.QuadPart - start.QuadPart;
+	handler(batch);
+
+	for (ULONG i = 0; i < count; i++)
+	{
+		postPassive(capture, (PASSIVE_SLOT *)entries[i].lpOverlapped);
+	}
+	return capture->posted > 0 ? (int)batch->count : -1;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: closePassive
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void closePassive(PASSIVE_CAPTURE *capture)
+--
+--	PARAMETERS:	PASSIVE_CAPTURE *capture - capture opened by openPassive
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	The posted receives own their slots until the port has their
+--  cancellations, so those are collected before the slots are released.
+--
+---------------------------------------------------------------------------------*/
+void closePassive(PASSIVE_CAPTURE *capture)
+{
+	OVERLAPPED_ENTRY entries[DISSECT_BATCH];
+	ULONG count;
+
+	if (capture->sd != INVALID_SOCKET)
+	{
+		CancelIoEx((HANDLE)capture->sd, NULL);
+		while (capture->posted > 0 && capture->port != NULL
+			&& GetQueuedCompletionStatusEx(capture->port, entries, DISSECT_BATCH, &count, COMM_TIMEOUT, FALSE))
+		{
+			capture->posted -= count;
+		}
+		closesocket(capture->sd);
+		capture->sd = INVALID_SOCKET;
+	}
+	if (capture->port != NULL)
+	{
+		CloseHandle(capture->port);
+		capture->port = NULL;
+	}
+	if (capture->buffers != NULL && capture->posted == 0)
+	{
+		VirtualFree(capture->buffers, 0, MEM_RELEASE);
+	}
+	capture->buffers = NULL;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: postPassive
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	BOOL postPassive(PASSIVE_CAPTURE *capture, PASSIVE_SLOT *slot)
+--
+--	PARAMETERS:	PASSIVE_CAPTURE *capture - an open capture
+--				PASSIVE_SLOT *slot - slot whose packet has been handled
+--
+--	RETURNS:	FALSE if the receive could not be posted
+--
+--	NOTES:
+--	A receive that completes at once still queues its completion, so every
+--  packet is taken from the port the same way.
+--
+---------------------------------------------------------------------------------*/
+BOOL postPassive(PASSIVE_CAPTURE *capture, PASSIVE_SLOT *slot)
+{
+	DWORD bytes;
+
+	ZeroMemory(&(slot->overlapped), sizeof(OVERLAPPED));
+	slot->flags = 0;
+	if (WSARecv(capture->sd, &(slot->buffer), 1, &bytes, &(slot->flags), &(slot->overlapped), NULL) == SOCKET_ERROR
+		&& WSAGetLastError() != WSA_IO_PENDING)
+	{
+		return FALSE;
+	}
+	capture->posted++;
+	return TRUE;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: filterBatch
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void filterBatch(PASSIVE_CAPTURE *capture)
+--
+--	PARAMETERS:	PASSIVE_CAPTURE *capture - capture whose batch was just dissected
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	Packets the filter drops get protocol 0, like those that were not TCP or
+--  UDP. A raw IPv4 socket only sees IPv4, so the host is the last word of
+--  the mapped addresses.
+--
+---------------------------------------------------------------------------------*/
+void filterBatch(PASSIVE_CAPTURE *capture)
+{
+	PACKET_BATCH *batch = &(capture->batch);
+	PASSIVE_FILTER *filter = &(capture->filter);
+	BOOL keep;
+
+	for (DWORD i = 0; i < batch->count; i++)
+	{
+		if (batch->protocol[i] == 0)
+		{
+			capture->other++;
+			continue;
+		}
+		keep = (filter->protocol == 0 || batch->protocol[i] == filter->protocol)
+			& (filter->host == 0 || ((DWORD *)&(batch->source[i]))[3] == filter->host
+				|| ((DWORD *)&(batch->destination[i]))[3] == filter->host)
+			& (filter->port == 0 || batch->sourcePort[i] == filter->port || batch->destinationPort[i] == filter->port);
+		batch->protocol[i] = keep ? batch->protocol[i] : 0;
+		capture->matched += keep;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,49 @@
+#pragma once
+
+#define PASSIVE_SLOTS			128		//receives kept posted on the raw socket
+#define PASSIVE_SLOT_SIZE		65536	//largest IPv4 packet
+#define PASSIVE_WAIT			100		//ms a batch waits before the thread looks at its timers
+#define PASSIVE_RCVBUF			(8 * 1024 * 1024)	//raw socket buffer for bursts between batches
+#define PASSIVE_FILTER_LENGTH	128
+
+// Packets a passive capture keeps, parsed from a spec such as
+// "proto=udp; host=10.0.0.2; port=7000". A zero field matches anything.
+typedef struct _PASSIVE_FILTER {
+	int protocol;				// IPPROTO_TCP or IPPROTO_UDP
+	ULONG host;					// source or destination, network order
+	USHORT port;				// source or destination, network order
+	char description[PASSIVE_FILTER_LENGTH + 32];
+} PASSIVE_FILTER;
+
+// Called with each batch of packets. The packets are still in their receive
+// slots and are only valid until the handler returns; those the filter
+// dropped have protocol 0.
+typedef void (*PASSIVE_HANDLER)(PACKET_BATCH *);
+
+typedef struct _PASSIVE_SLOT {
+	OVERLAPPED overlapped;
+	WSABUF buffer;
+	DWORD flags;
+} PASSIVE_SLOT;
+
+// Only the thread that reads the capture may use it.
+typedef struct _PASSIVE_CAPTURE {
+	SOCKET sd;
+	HANDLE port;
+	char *buffers;				// PASSIVE_SLOTS * PASSIVE_SLOT_SIZE bytes from the receive node
+	PASSIVE_SLOT slots[PASSIVE_SLOTS];
+	LONG posted;				// slots with a receive outstanding
+	PASSIVE_FILTER filter;
+	PACKET_BATCH batch;
+	ULONGLONG packets;			// IP packets received
+	ULONGLONG matched;			// TCP and UDP packets that passed the filter
+	ULONGLONG other;			// other protocols, later fragments and malformed headers
+	ULONGLONG failed;			// receives that completed with an error
+	ULONGLONG batches;			// waits that returned packets
+	ULONGLONG dissectTime;		// QueryPerformanceCounter ticks spent dissecting and filtering
+} PASSIVE_CAPTURE;
+
+BOOL parsePassiveFilter(char *, PASSIVE_FILTER *);
+BOOL openPassive(PASSIVE_CAPTURE *, char *, PASSIVE_FILTER *);
+int readPassive(PASSIVE_CAPTURE *, PASSIVE_HANDLER);
+void closePassive(PASSIVE_CAPTURE *);
\ No newline at end of file
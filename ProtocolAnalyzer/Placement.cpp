@@ -0,0 +1,557 @@
+/*---------------------------------------------------------------------------------
+--	SOURCE FILE:	Placement.cpp -
+--
+--	PROGRAM:		Transport Layer Protocol Analyser
+--
+--	FUNCTIONS:
+--					BOOL parsePlacement(char *spec, PLACEMENT *placement)
+--					void resolvePlacement(PLACEMENT *placement, DWORD address)
+--					DWORD_PTR placeThread(HANDLE thread, PLACEMENT *placement, int role)
+--					void *nodeAlloc(SIZE_T size)
+--					BOOL nodeCommit(void *address, SIZE_T size)
+--					void logPlacement(PLACEMENT *placement, HANDLE logFile)
+--					BOOL parseCpus(char *value, DWORD_PTR *mask)
+--					void formatCpus(DWORD_PTR mask, char *text)
+--					int adapterNode(DWORD address, char *adapter)
+--
+--	DATE:			Oct 19, 2026
+--
+--	REVISIONS:		Oct 19, 2026
+--
+--	DESIGNER:		Gabriella Cheung
+--
+--	PROGRAMMER:		Gabriella Cheung
+--
+--	NOTES:
+--	This file contains the thread and memory placement controls, so that runs
+--  on hosts with more than one NUMA node can be repeated. A placement is
+--  written as semicolon separated settings, for example
+--
+--		receive=2-3;accept=0;writer=4,6;node=auto
+--
+--	accept		CPUs for the threads that accept connections and report
+--	receive		CPUs for the receive threads
+--	writer		CPUs for the pcapng writer and the statistics sampler
+--	send		CPUs for the client's sending thread and impairment thread
+--	node		NUMA node the buffers come from, whose CPUs any role not
+--				given is pinned to; auto for the node of the network adapter
+--				the traffic goes through
+--
+--  Each thread pins itself with SetThreadAffinityMask when it starts, so the
+--  masks are in the processor group the process started in: CPUs 0 to 63, or
+--  0 to 31 in a 32-bit build. Buffers allocated after resolvePlacement come
+--  from the node through VirtualAllocExNuma; pool blocks committed before it
+--  stay where they are. The node is kept per thread, by the thread that
+--  resolved the placement and by each thread that places itself, so a client
+--  and a server in one process each allocate from their own node.
+--
+--  Windows has no sysfs numa_node file, so node=auto reads the adapter's
+--  DEVPKEY_Device_Numa_Node property through SetupAPI instead. Adapters on
+--  hosts with a single node usually have none, and the node is then left to
+--  the scheduler.
+--
+---------------------------------------------------------------------------------*/
+#include "resource.h"
+
+BOOL parseCpus(char *, DWORD_PTR *);
+void formatCpus(DWORD_PTR, char *);
+int adapterNode(DWORD, char *);
+
+static __declspec(thread) int allocationNode = PLACEMENT_NO_NODE;	// node of the placement this thread resolved or was placed with
+static const char *roleNames[PLACE_ROLES] = { "accept", "receive", "writer", "send" };
+// GUID_DEVCLASS_NET and DEVPKEY_Device_Numa_Node, defined here so no file needs initguid.h
+static const GUID netClass = { 0x4d36e972, 0xe325, 0x11ce, { 0xbf, 0xc1, 0x08, 0x00, 0x2b, 0xe1, 0x03, 0x18 } };
+static const DEVPROPKEY numaNodeKey = { { 0x540b947e, 0x8b40, 0x45bc, { 0xa8, 0xa2, 0x6a, 0x0b, 0x89, 0x4c, 0xbd, 0xa2 } }, 3 };
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: parsePlacement
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	BOOL parsePlacement(char *spec, PLACEMENT *placement)
+--
+--	PARAMETERS:	char *spec - placement settings, empty for none
+--				PLACEMENT *placement - receives the settings
+--
+--	RETURNS:	TRUE if every setting was understood
+--
+---------------------------------------------------------------------------------*/
+BOOL parsePlacement(char *spec, PLACEMENT *placement)
+{
+	char settings[PLACEMENT_SPEC_LENGTH];
+	char *setting, *value, *context = NULL;
+	int role;
+
+	ZeroMemory(placement, sizeof(PLACEMENT));
+	placement->node = PLACEMENT_NO_NODE;
+	strncpy(settings, spec, sizeof(settings) - 1);
+	settings[sizeof(settings) - 1] = '\0';
+	for (setting = strtok_s(settings, "; ", &context); setting != NULL; setting = strtok_s(NULL, "; ", &context))
+	{
+		if ((value = strchr(setting, '=')) == NULL)
+		{
+			return FALSE;
+		}
+		*value++ = '\0';
+		for (role = 0; role < PLACE_ROLES && strcmp(setting, roleNames[role]) != 0; role++);
+		if (role < PLACE_ROLES)
+		{
+			if (!parseCpus(value, &(placement->cpus[role])))
+			{
+				return FALSE;
+			}
+		}
+		else if (strcmp(setting, "node") == 0)
+		{
+			ULONG highest;
+
+			if (strcmp(value, "auto") == 0)
+			{
+				placement->autoNode = true;
+				continue;
+			}
+			placement->node = atoi(value);
+			if (value[0] < '0' || value[0] > '9' || !GetNumaHighestNodeNumber(&highest) || (ULONG)placement->node > highest)
+			{
+				return FALSE;
+			}
+		}
+		else {
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: resolvePlacement
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--				Oct 19, 2026 - the allocation node is per thread
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void resolvePlacement(PLACEMENT *placement, DWORD address)
+--
+--	PARAMETERS:	PLACEMENT *placement - settings from parsePlacement
+--				DWORD address - IPv4 address in network order the traffic is
+--								sent to or received on, INADDR_ANY for the
+--								adapter of the default route
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	Finds the node for node=auto, gives every role without CPUs of its own the
+--  node's CPUs, and makes nodeAlloc and nodeCommit on the calling thread
+--  allocate from the node.
+--  The description of the result goes into the placement for the reports.
+--  Called before any thread is placed.
+--
+---------------------------------------------------------------------------------*/
+void resolvePlacement(PLACEMENT *placement, DWORD address)
+{
+	ULONGLONG nodeMask;
+	DWORD_PTR processMask, systemMask;
+	char cpus[128];
+	char *text = placement->description;
+
+	if (placement->autoNode)
+	{
+		placement->node = adapterNode(address, placement->adapter);
+	}
+	allocationNode = placement->node;
+	if (placement->node != PLACEMENT_NO_NODE && GetNumaNodeProcessorMask((UCHAR)placement->node, &nodeMask)
+		&& GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask))
+	{
+		for (int i = 0; i < PLACE_ROLES; i++)
+		{
+			if (placement->cpus[i] == 0)
+			{
+				placement->cpus[i] = (DWORD_PTR)nodeMask & processMask;
+			}
+		}
+	}
+
+	text[0] = '\0';
+	for (int i = 0; i < PLACE_ROLES; i++)
+	{
+		if (placement->cpus[i] != 0)
+		{
+			formatCpus(placement->cpus[i], cpus);
+			text += sprintf(text, "%s%s on CPUs %s", text == placement->description ? "" : ", ", roleNames[i], cpus);
+		}
+	}
+	if (placement->node != PLACEMENT_NO_NODE)
+	{
+		text += sprintf(text, "%sbuffers on node %d", text == placement->description ? "" : ", ", placement->node);
+	}
+	if (text == placement->description)
+	{
+		text += sprintf(text, "left to the scheduler");
+	}
+	if (placement->autoNode && placement->adapter[0] == '\0')
+	{
+		sprintf(text, " (adapter not found)");
+	}
+	else if (placement->autoNode && placement->node == PLACEMENT_NO_NODE)
+	{
+		sprintf(text, " (%.64s reports no NUMA node)", placement->adapter);
+	}
+	else if (placement->autoNode)
+	{
+		sprintf(text, " (the node of %.64s)", placement->adapter);
+	}
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: placeThread
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--				Oct 19, 2026 - sets the calling thread's allocation node
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	DWORD_PTR placeThread(HANDLE thread, PLACEMENT *placement, int role)
+--
+--	PARAMETERS:	HANDLE thread - thread to pin, GetCurrentThread() for the caller
+--				PLACEMENT *placement - resolved placement
+--				int role - PLACE_ constant of the thread's role
+--
+--	RETURNS:	the thread's previous affinity mask, or 0 if it was left alone
+--
+--	NOTES:
+--	A thread that only runs for a while, like the client's sending thread,
+--  puts the previous mask back when it is done. A thread that places itself
+--  also takes the placement's node for its own allocations.
+--
+---------------------------------------------------------------------------------*/
+DWORD_PTR placeThread(HANDLE thread, PLACEMENT *placement, int role)
+{
+	DWORD_PTR previous;
+	char cpus[128];
+	char message[256];
+
+	if (GetThreadId(thread) == GetCurrentThreadId())
+	{
+		allocationNode = placement->node;
+	}
+	if (placement->cpus[role] == 0)
+	{
+		return 0;
+	}
+	if ((previous = SetThreadAffinityMask(thread, placement->cpus[role])) == 0)
+	{
+		formatCpus(placement->cpus[role], cpus);
+		sprintf(message, "Pinning a %s thread to CPUs %s failed with error %d", roleNames[role], cpus, GetLastError());
+		writeToScreen(message);
+	}
+	return previous;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: nodeAlloc
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void *nodeAlloc(SIZE_T size)
+--
+--	PARAMETERS:	SIZE_T size - bytes to reserve and commit
+--
+--	RETURNS:	the memory, to be released with VirtualFree, or NULL
+--
+--	NOTES:
+--	VirtualAlloc from the placement's node, if it has one.
+--
+---------------------------------------------------------------------------------*/
+void *nodeAlloc(SIZE_T size)
+{
+	if (allocationNode == PLACEMENT_NO_NODE)
+	{
+		return VirtualAlloc(NULL, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+	}
+	return VirtualAllocExNuma(GetCurrentProcess(), NULL, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE, allocationNode);
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: nodeCommit
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	BOOL nodeCommit(void *address, SIZE_T size)
+--
+--	PARAMETERS:	void *address - start of pages already reserved
+--				SIZE_T size - bytes to commit
+--
+--	RETURNS:	FALSE if the pages could not be committed
+--
+--	NOTES:
+--	The node is a preference: pages are taken from it when they are first
+--  touched, and from another node if it has none free.
+--
+---------------------------------------------------------------------------------*/
+BOOL nodeCommit(void *address, SIZE_T size)
+{
+	if (allocationNode == PLACEMENT_NO_NODE)
+	{
+		return VirtualAlloc(address, size, MEM_COMMIT, PAGE_READWRITE) != NULL;
+	}
+	return VirtualAllocExNuma(GetCurrentProcess(), address, size, MEM_COMMIT, PAGE_READWRITE, allocationNode) != NULL;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: logPlacement
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void logPlacement(PLACEMENT *placement, HANDLE logFile)
+--
+--	PARAMETERS:	PLACEMENT *placement - resolved placement
+--				HANDLE logFile - handle for the client or server log file
+--
+--	RETURNS:	void
+--
+---------------------------------------------------------------------------------*/
+void logPlacement(PLACEMENT *placement, HANDLE logFile)
+{
+	char message[768];
+
+	sprintf(message, "Placement: %s", placement->description);
+	writeToScreen(message);
+	strcat(message, "\r\n");
+	writeToFile(logFile, message);
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: parseCpus
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	BOOL parseCpus(char *value, DWORD_PTR *mask)
+--
+--	PARAMETERS:	char *value - CPUs and ranges of CPUs separated by commas
+--				DWORD_PTR *mask - receives the affinity mask
+--
+--	RETURNS:	TRUE if the list names at least one CPU an affinity mask can hold
+--
+---------------------------------------------------------------------------------*/
+BOOL parseCpus(char *value, DWORD_PTR *mask)
+{
+	char *end;
+	unsigned long first, last;
+
+	*mask = 0;
+	while (*value != '\0')
+	{
+		first = last = strtoul(value, &end, 10);
+		if (end == value)
+		{
+			return FALSE;
+		}
+		if (*end == '-')
+		{
+			value = end + 1;
+			last = strtoul(value, &end, 10);
+			if (end == value)
+			{
+				return FALSE;
+			}
+		}
+		if (last < first || last >= sizeof(DWORD_PTR) * 8)
+		{
+			return FALSE;
+		}
+		for (unsigned long cpu = first; cpu <= last; cpu++)
+		{
+			*mask |= (DWORD_PTR)1 << cpu;
+		}
+		if (*end == ',')
+		{
+			end++;
+		}
+		else if (*end != '\0')
+		{
+			return FALSE;
+		}
+		value = end;
+	}
+	return *mask != 0;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: formatCpus
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void formatCpus(DWORD_PTR mask, char *text)
+--
+--	PARAMETERS:	DWORD_PTR mask - affinity mask
+--				char *text - receives the CPUs in the form parseCpus reads,
+--							 128 bytes is always enough
+--
+--	RETURNS:	void
+--
+---------------------------------------------------------------------------------*/
+void formatCpus(DWORD_PTR mask, char *text)
+{
+	int bits = sizeof(DWORD_PTR) * 8, last;
+	char *start = text;
+
+	text[0] = '\0';
+	for (int cpu = 0; cpu < bits; cpu++)
+	{
+		if (!(mask & ((DWORD_PTR)1 << cpu)))
+		{
+			continue;
+		}
+		for (last = cpu; last + 1 < bits && (mask & ((DWORD_PTR)1 << (last + 1))); last++);
+		if (text != start)
+		{
+			*text++ = ',';
+		}
+		text += last > cpu ? sprintf(text, "%d-%d", cpu, last) : sprintf(text, "%d", cpu);
+		cpu = last;
+	}
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: adapterNode
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	int adapterNode(DWORD address, char *adapter)
+--
+--	PARAMETERS:	DWORD address - IPv4 address in network order, see resolvePlacement
+--				char *adapter - receives the adapter's name, empty if none was
+--								found, PLACEMENT_NAME_LENGTH bytes
+--
+--	RETURNS:	the NUMA node the adapter is attached to, or PLACEMENT_NO_NODE
+--
+--	NOTES:
+--	The route to the address gives the interface, GetAdaptersAddresses its
+--  adapter GUID, and the network class device whose NetCfgInstanceId is that
+--  GUID carries the node.
+--
+---------------------------------------------------------------------------------*/
+int adapterNode(DWORD address, char *adapter)
+{
+	IP_ADAPTER_ADDRESSES *addresses = NULL, *current;
+	ULONG size = PLACEMENT_ADAPTER_BUFFER, result = ERROR_BUFFER_OVERFLOW;
+	DWORD index, length, type;
+	char adapterName[PLACEMENT_NAME_LENGTH] = { 0 };
+	char instance[PLACEMENT_NAME_LENGTH];
+	HDEVINFO devices;
+	SP_DEVINFO_DATA device;
+	DEVPROPTYPE propertyType;
+	HKEY key;
+	ULONG node;
+	int found = PLACEMENT_NO_NODE;
+
+	adapter[0] = '\0';
+	if (GetBestInterface(address, &index) != NO_ERROR)
+	{
+		return PLACEMENT_NO_NODE;
+	}
+	for (int tries = 0; tries < 3 && result == ERROR_BUFFER_OVERFLOW; tries++)
+	{
+		free(addresses);
+		if ((addresses = (IP_ADAPTER_ADDRESSES *)malloc(size)) == NULL)
+		{
+			return PLACEMENT_NO_NODE;
+		}
+		result = GetAdaptersAddresses(AF_INET, GAA_FLAG_SKIP_ANYCAST | GAA_FLAG_SKIP_MULTICAST | GAA_FLAG_SKIP_DNS_SERVER, NULL, addresses, &size);
+	}
+	for (current = result == NO_ERROR ? addresses : NULL; current != NULL; current = current->Next)
+	{
+		if (current->IfIndex == index)
+		{
+			strncpy(adapterName, current->AdapterName, PLACEMENT_NAME_LENGTH - 1);
+			WideCharToMultiByte(CP_ACP, 0, current->FriendlyName, -1, adapter, PLACEMENT_NAME_LENGTH, NULL, NULL);
+			adapter[PLACEMENT_NAME_LENGTH - 1] = '\0';
+			break;
+		}
+	}
+	free(addresses);
+	if (adapterName[0] == '\0')
+	{
+		return PLACEMENT_NO_NODE;
+	}
+
+	if ((devices = SetupDiGetClassDevs(&netClass, NULL, NULL, DIGCF_PRESENT)) == INVALID_HANDLE_VALUE)
+	{
+		return PLACEMENT_NO_NODE;
+	}
+	device.cbSize = sizeof(SP_DEVINFO_DATA);
+	for (DWORD i = 0; SetupDiEnumDeviceInfo(devices, i, &device); i++)
+	{
+		if ((key = SetupDiOpenDevRegKey(devices, &device, DICS_FLAG_GLOBAL, 0, DIREG_DRV, KEY_READ)) == INVALID_HANDLE_VALUE)
+		{
+			continue;
+		}
+		ZeroMemory(instance, sizeof(instance));
+		length = sizeof(instance) - 1;
+		if (RegQueryValueEx(key, "NetCfgInstanceId", NULL, &type, (BYTE *)instance, &length) == ERROR_SUCCESS
+			&& type == REG_SZ && _stricmp(instance, adapterName) == 0)
+		{
+			if (SetupDiGetDevicePropertyW(devices, &device, &numaNodeKey, &propertyType, (PBYTE)&node, sizeof(node), NULL, 0)
+				&& propertyType == DEVPROP_TYPE_UINT32)
+			{
+				found = (int)node;
+			}
+			RegCloseKey(key);
+			break;
+		}
+		RegCloseKey(key);
+	}
+	SetupDiDestroyDeviceInfoList(devices);
+	return found;
+}
\ No newline at end of file
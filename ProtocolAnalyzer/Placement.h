@@ -0,0 +1,28 @@
+#pragma once
+
+#define PLACEMENT_SPEC_LENGTH	128
+#define PLACEMENT_NO_NODE		-1
+#define PLACEMENT_ADAPTER_BUFFER	(16 * 1024)	//first guess at the GetAdaptersAddresses size
+#define PLACEMENT_NAME_LENGTH	64
+
+// thread roles, each pinned to its own set of CPUs
+#define PLACE_ACCEPT			0		//threads that accept connections and report
+#define PLACE_RECEIVE			1		//threads that receive
+#define PLACE_WRITER			2		//pcapng writer and statistics sampler
+#define PLACE_SEND				3		//client sending and impairment threads
+#define PLACE_ROLES				4
+
+typedef struct _PLACEMENT {
+	DWORD_PTR cpus[PLACE_ROLES];	// affinity mask of each role, 0 to leave it to the scheduler
+	int node;					// NUMA node buffers come from, PLACEMENT_NO_NODE for any
+	BOOL autoNode;				// node=auto: the node of the adapter the traffic goes through
+	char adapter[PLACEMENT_NAME_LENGTH];	// that adapter, empty if it was not found
+	char description[640];
+} PLACEMENT;
+
+BOOL parsePlacement(char *, PLACEMENT *);
+void resolvePlacement(PLACEMENT *, DWORD);
+DWORD_PTR placeThread(HANDLE, PLACEMENT *, int);
+void *nodeAlloc(SIZE_T);
+BOOL nodeCommit(void *, SIZE_T);
+void logPlacement(PLACEMENT *, HANDLE);
\ No newline at end of file
@@ -0,0 +1,350 @@
+/*---------------------------------------------------------------------------------
+--	SOURCE FILE:	Pool.cpp -
+--
+--	PROGRAM:		Transport Layer Protocol Analyser
+--
+--	FUNCTIONS:
+--					void initPool()
+--					void *poolAlloc(DWORD size)
+--					void poolFree(void *block)
+--					void getPoolStats(int sizeClass, POOL_STATS *stats)
+--					void releasePool()
+--					int findClass(void *block)
+--
+--	DATE:			Oct 19, 2026
+--
+--	REVISIONS:		Oct 19, 2026
+--
+--	DESIGNER:		Gabriella Cheung
+--
+--	PROGRAMMER:		Gabriella Cheung
+--
+--	NOTES:
+--	This file contains the allocator for per-operation contexts and receive
+--  buffers. Each size class owns one region of address space that is reserved
+--  up front for a fixed number of blocks. Pages are committed the first time a
+--  block is handed out, so memory grows to the high-water mark and stays there
+--  instead of growing for as long as the server runs.
+--
+--  Freed blocks go onto a small list owned by the freeing thread, so the common
+--  case of a completion routine releasing what its own thread allocated needs
+--  no interlocked operation. When a thread's list is full, blocks go back to the
+--  class's shared lock-free SLIST. Blocks are not cleared when reused. A
+--  thread gives its cached blocks back with releasePool before it ends.
+--
+--  When a class has handed out every block, or the request is larger than
+--  any class, the block comes from the heap instead, so a burst never fails
+--  an allocation the pool was only meant to speed up. poolFree tells the two
+--  apart by address.
+--
+---------------------------------------------------------------------------------*/
+#include "resource.h"
+
+typedef struct _POOL_CLASS {
+	SLIST_HEADER freeList;		// blocks returned by threads with full caches
+	char *base;					// reserved region of capacity * blockSize bytes
+	DWORD blockSize;
+	LONG capacity;
+	volatile LONG next;			// blocks handed out from the region so far
+	volatile LONG inUse;
+	volatile LONG highWater;
+	volatile LONG overflowed;	// blocks taken from the heap because the class was full
+} POOL_CLASS;
+
+typedef struct _POOL_CACHE {
+	void *head;					// free blocks linked through their first bytes
+	int count;
+} POOL_CACHE;
+
+int findClass(void *);
+
+static POOL_CLASS poolClasses[POOL_CLASSES];
+static const DWORD classSizes[POOL_CLASSES] = { 256, 2048, 16384, 65536 };
+static const LONG classCapacity[POOL_CLASSES] = { 131072, 16384, 4096, 1024 };
+static __declspec(thread) POOL_CACHE threadCache[POOL_CLASSES];
+static BOOL poolReady = false;
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: initPool
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void initPool()
+--
+--	PARAMETERS:	none
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	This function reserves the address space for every size class. It is called
+--  once at start up, before any thread allocates.
+--
+---------------------------------------------------------------------------------*/
+void initPool()
+{
+	char message[256];
+
+	if (poolReady)
+	{
+		return;
+	}
+	for (int i = 0; i < POOL_CLASSES; i++)
+	{
+		InitializeSListHead(&poolClasses[i].freeList);
+		poolClasses[i].blockSize = classSizes[i];
+		poolClasses[i].capacity = classCapacity[i];
+		poolClasses[i].base = (char *)VirtualAlloc(NULL, (SIZE_T)classSizes[i] * classCapacity[i], MEM_RESERVE, PAGE_READWRITE);
+		if (poolClasses[i].base == NULL)
+		{
+			sprintf(message, "Reserving %lu byte pool blocks failed with error %d", classSizes[i], GetLastError());
+			writeToScreen(message);
+			poolClasses[i].capacity = 0;
+		}
+	}
+	poolReady = true;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: poolAlloc
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--				Oct 19, 2026 - commits on the placement's NUMA node
+--				Oct 19, 2026 - falls back to the heap
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void *poolAlloc(DWORD size)
+--
+--	PARAMETERS:	DWORD size - number of bytes needed
+--
+--	RETURNS:	a block of at least size bytes, or NULL if the heap is exhausted too
+--
+--	NOTES:
+--	This function takes a block from the smallest class that fits. It tries the
+--  calling thread's cache first, then the shared free list, and only then
+--  carves a new block from the class's region, committing it on the NUMA node
+--  of the latest placement. If the region is used up the block is malloc'd.
+--  The block is not zeroed.
+--
+---------------------------------------------------------------------------------*/
+void *poolAlloc(DWORD size)
+{
+	POOL_CLASS *poolClass;
+	POOL_CACHE *cache;
+	void *block;
+	LONG index, inUse, highWater;
+	int i;
+
+	for (i = 0; i < POOL_CLASSES && classSizes[i] < size; i++);
+	if (i == POOL_CLASSES)
+	{
+		return malloc(size);
+	}
+	poolClass = &poolClasses[i];
+	cache = &threadCache[i];
+
+	if (cache->head != NULL)
+	{
+		block = cache->head;
+		cache->head = *(void **)block;
+		cache->count--;
+	}
+	else if ((block = InterlockedPopEntrySList(&poolClass->freeList)) == NULL)
+	{
+		index = InterlockedIncrement(&poolClass->next) - 1;
+		if (index >= poolClass->capacity)
+		{
+			InterlockedDecrement(&poolClass->next);
+			InterlockedIncrement(&poolClass->overflowed);
+			return malloc(size);
+		}
+		block = poolClass->base + (SIZE_T)index * poolClass->blockSize;
+		if (!nodeCommit(block, poolClass->blockSize))
+		{
+			InterlockedIncrement(&poolClass->overflowed);
+			return malloc(size);
+		}
+	}
+
+	inUse = InterlockedIncrement(&poolClass->inUse);
+	while (inUse > (highWater = poolClass->highWater))
+	{
+		if (InterlockedCompareExchange(&poolClass->highWater, inUse, highWater) == highWater)
+		{
+			break;
+		}
+	}
+	return block;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: poolFree
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--				Oct 19, 2026 - frees heap blocks
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void poolFree(void *block)
+--
+--	PARAMETERS:	void *block - block returned by poolAlloc, or NULL
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	This function puts a block on the calling thread's cache, or on the class's
+--  shared free list if the cache already holds POOL_CACHE_LIMIT blocks. A
+--  block from outside every region came from the heap and is freed.
+--
+---------------------------------------------------------------------------------*/
+void poolFree(void *block)
+{
+	POOL_CACHE *cache;
+	int i;
+
+	if (block == NULL)
+	{
+		return;
+	}
+	if ((i = findClass(block)) < 0)
+	{
+		free(block);
+		return;
+	}
+	InterlockedDecrement(&poolClasses[i].inUse);
+
+	cache = &threadCache[i];
+	if (cache->count < POOL_CACHE_LIMIT)
+	{
+		*(void **)block = cache->head;
+		cache->head = block;
+		cache->count++;
+	}
+	else {
+		InterlockedPushEntrySList(&poolClasses[i].freeList, (PSLIST_ENTRY)block);
+	}
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: findClass
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	int findClass(void *block)
+--
+--	PARAMETERS:	void *block - block returned by poolAlloc
+--
+--	RETURNS:	the size class the block belongs to, or -1
+--
+--	NOTES:
+--	Blocks carry no header. The class is found from the region that contains
+--  the block's address.
+--
+---------------------------------------------------------------------------------*/
+int findClass(void *block)
+{
+	char *address = (char *)block;
+
+	for (int i = 0; i < POOL_CLASSES; i++)
+	{
+		if (address >= poolClasses[i].base &&
+			address < poolClasses[i].base + (SIZE_T)poolClasses[i].blockSize * poolClasses[i].capacity)
+		{
+			return i;
+		}
+	}
+	return -1;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: getPoolStats
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--				Oct 19, 2026 - heap fallbacks
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void getPoolStats(int sizeClass, POOL_STATS *stats)
+--
+--	PARAMETERS:	int sizeClass - index of the size class, 0 to POOL_CLASSES - 1
+--				POOL_STATS *stats - receives the class's counters
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	Used by the server report to show how many blocks are in use and the most
+--  that have been in use at once.
+--
+---------------------------------------------------------------------------------*/
+void getPoolStats(int sizeClass, POOL_STATS *stats)
+{
+	stats->blockSize = poolClasses[sizeClass].blockSize;
+	stats->capacity = poolClasses[sizeClass].capacity;
+	stats->inUse = poolClasses[sizeClass].inUse;
+	stats->highWater = poolClasses[sizeClass].highWater;
+	stats->overflowed = poolClasses[sizeClass].overflowed;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: releasePool
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void releasePool()
+--
+--	PARAMETERS:	none
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	Called by a thread that frees pool blocks just before it ends. Its cached
+--  blocks go back on the shared free lists, where they would otherwise be
+--  lost with the thread's cache.
+--
+---------------------------------------------------------------------------------*/
+void releasePool()
+{
+	POOL_CACHE *cache;
+	void *block;
+
+	for (int i = 0; i < POOL_CLASSES; i++)
+	{
+		cache = &threadCache[i];
+		while ((block = cache->head) != NULL)
+		{
+			cache->head = *(void **)block;
+			InterlockedPushEntrySList(&poolClasses[i].freeList, (PSLIST_ENTRY)block);
+		}
+		cache->count = 0;
+	}
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#define POOL_CLASSES			4
+#define POOL_CACHE_LIMIT		64		//free blocks a thread keeps before returning them
+
+typedef struct _POOL_STATS {
+	DWORD blockSize;
+	LONG capacity;
+	LONG inUse;
+	LONG highWater;
+	LONG overflowed;			// blocks taken from the heap once the class was full
+} POOL_STATS;
+
+void initPool();
+void *poolAlloc(DWORD);
+void poolFree(void *);
+void getPoolStats(int, POOL_STATS *);
+void releasePool();
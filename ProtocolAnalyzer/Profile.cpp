@@ -0,0 +1,424 @@
+/*---------------------------------------------------------------------------------
+--	SOURCE FILE:	Profile.cpp -
+--
+--	PROGRAM:		Transport Layer Protocol Analyser
+--
+--	FUNCTIONS:
+--					BOOL parseProfile(char *spec, int packetSize, TRAFFIC_PROFILE *profile)
+--					void startProfile(TRAFFIC_PROFILE *profile)
+--					DWORD nextPacket(TRAFFIC_PROFILE *profile)
+--					void startCursor(PROFILE_CURSOR *cursor, LONGLONG start, DWORD first)
+--					DWORD scheduleNext(TRAFFIC_PROFILE *profile, PROFILE_CURSOR *cursor, LONGLONG now, LONGLONG *due)
+--					BOOL parseSizes(char *value, DWORD *sizes, DWORD *weights, int *count)
+--					DWORD profileRandom(DWORD *state)
+--
+--	DATE:			Oct 19, 2026
+--
+--	REVISIONS:		Oct 19, 2026
+--
+--	DESIGNER:		Gabriella Cheung
+--
+--	PROGRAMMER:		Gabriella Cheung
+--
+--	NOTES:
+--	This file contains the traffic profiles the client sends with. A profile is
+--  written as semicolon separated settings, for example
+--
+--		sizes=imix;rate=20000;gap=poisson;on=50;off=200
+--
+--	sizes	imix (64:7,576:4,1500:1) or a list of size:weight pairs. Without it
+--			every message has the packet size from the dialog.
+--	rate	messages per second, 0 or missing for as fast as possible
+--	gap		constant or poisson spacing between messages
+--	on/off	burst and silence lengths in milliseconds
+--
+--  The size and gap sequences are computed when the profile is parsed, so the
+--  send loop only reads the next entry of each table. Both tables repeat every
+--  PROFILE_TABLE_SIZE messages and come from a fixed seed, so every run of a
+--  profile sends the same sequence.
+--
+---------------------------------------------------------------------------------*/
+#include "resource.h"
+
+BOOL parseSizes(char *, DWORD *, DWORD *, int *);
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: parseProfile
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	BOOL parseProfile(char *spec, int packetSize, TRAFFIC_PROFILE *profile)
+--
+--	PARAMETERS:	char *spec - profile settings, may be empty
+--				int packetSize - message size when the profile gives none
+--				TRAFFIC_PROFILE *profile - receives the precomputed tables
+--
+--	RETURNS:	TRUE if every setting was understood
+--
+--	NOTES:
+--	Sizes are spread over the table in proportion to their weights, then
+--  shuffled so the mix holds over short stretches as well as the whole table.
+--
+---------------------------------------------------------------------------------*/
+BOOL parseProfile(char *spec, int packetSize, TRAFFIC_PROFILE *profile)
+{
+	char settings[PROFILE_SPEC_LENGTH];
+	char *setting, *value, *context = NULL;
+	DWORD sizes[PROFILE_MAX_SIZES] = { (DWORD)packetSize };
+	DWORD weights[PROFILE_MAX_SIZES] = { 1 };
+	int count = 1, filled = 0;
+	DWORD totalWeight = 0, seed = 0x9E3779B9, swap;
+	double rate = 0, onMs = 0, offMs = 0;
+	BOOL poisson = false;
+	LARGE_INTEGER frequency;
+
+	ZeroMemory(profile, sizeof(TRAFFIC_PROFILE));
+	strncpy(settings, spec, sizeof(settings) - 1);
+	settings[sizeof(settings) - 1] = '\0';
+	for (setting = strtok_s(settings, "; ", &context); setting != NULL; setting = strtok_s(NULL, "; ", &context))
+	{
+		if ((value = strchr(setting, '=')) == NULL)
+		{
+			return FALSE;
+		}
+		*value++ = '\0';
+		if (strcmp(setting, "sizes") == 0)
+		{
+			if (!parseSizes(value, sizes, weights, &count))
+			{
+				return FALSE;
+			}
+		}
+		else if (strcmp(setting, "rate") == 0)
+		{
+			rate = atof(value);
+		}
+		else if (strcmp(setting, "gap") == 0)
+		{
+			if (strcmp(value, "poisson") == 0)
+			{
+				poisson = true;
+			}
+			else if (strcmp(value, "constant") != 0)
+			{
+				return FALSE;
+			}
+		}
+		else if (strcmp(setting, "on") == 0)
+		{
+			onMs = atof(value);
+		}
+		else if (strcmp(setting, "off") == 0)
+		{
+			offMs = atof(value);
+		}
+		else {
+			return FALSE;
+		}
+	}
+
+	//sizes in proportion to their weights, the last size takes the rounding
+	for (int i = 0; i < count; i++)
+	{
+		totalWeight += weights[i];
+		if (sizes[i] > profile->maxSize)
+		{
+			profile->maxSize = sizes[i];
+		}
+	}
+	for (int i = 0; i < count; i++)
+	{
+		int share = i == count - 1 ? PROFILE_TABLE_SIZE - filled
+			: (int)((ULONGLONG)weights[i] * PROFILE_TABLE_SIZE / totalWeight);
+		for (int j = 0; j < share; j++)
+		{
+			profile->sizes[filled++] = sizes[i];
+		}
+	}
+	for (int i = PROFILE_TABLE_SIZE - 1; i > 0; i--)
+	{
+		int j = profileRandom(&seed) % (i + 1);
+		swap = profile->sizes[i];
+		profile->sizes[i] = profile->sizes[j];
+		profile->sizes[j] = swap;
+	}
+
+	QueryPerformanceFrequency(&frequency);
+	profile->frequency = frequency.QuadPart;
+	profile->paced = rate > 0;
+	for (int i = 0; profile->paced && i < PROFILE_TABLE_SIZE; i++)
+	{
+		double gap = 1.0 / rate;
+		if (poisson)
+		{
+			//exponential interarrival times give a Poisson arrival process
+			gap *= -log((profileRandom(&seed) + 1.0) / 4294967297.0);
+		}
+		profile->gaps[i] = (LONGLONG)(gap * frequency.QuadPart);
+	}
+	if (onMs > 0 && offMs > 0)
+	{
+		profile->onTicks = (LONGLONG)(onMs * frequency.QuadPart / 1000);
+		profile->offTicks = (LONGLONG)(offMs * frequency.QuadPart / 1000);
+	}
+
+	sprintf(profile->description, "%d size%s up to %lu bytes, %s%s",
+		count, count == 1 ? "" : "s", profile->maxSize,
+		profile->paced ? (poisson ? "Poisson gaps" : "constant gaps") : "unpaced",
+		profile->onTicks > 0 ? ", bursts" : "");
+	return TRUE;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: startProfile
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--				Oct 19, 2026 - starts the profile's cursor
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void startProfile(TRAFFIC_PROFILE *profile)
+--
+--	PARAMETERS:	TRAFFIC_PROFILE *profile - parsed profile
+--
+--	RETURNS:	none
+--
+--	NOTES:
+--	Called right before the first send; the schedule starts now.
+--
+---------------------------------------------------------------------------------*/
+void startProfile(TRAFFIC_PROFILE *profile)
+{
+	LARGE_INTEGER now;
+
+	QueryPerformanceCounter(&now);
+	startCursor(&(profile->cursor), now.QuadPart, 0);
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: nextPacket
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--				Oct 19, 2026 - schedule taken from scheduleNext
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	DWORD nextPacket(TRAFFIC_PROFILE *profile)
+--
+--	PARAMETERS:	TRAFFIC_PROFILE *profile - profile being sent
+--
+--	RETURNS:	the size of the next message
+--
+--	NOTES:
+--	Waits until the next message is due, as scheduleNext gives it. An unpaced
+--  profile without bursts never waits, so it does not read the clock.
+--
+---------------------------------------------------------------------------------*/
+DWORD nextPacket(TRAFFIC_PROFILE *profile)
+{
+	LARGE_INTEGER now = { 0 };
+	LONGLONG due;
+	DWORD size;
+
+	if (!profile->paced && profile->onTicks == 0)
+	{
+		return scheduleNext(profile, &(profile->cursor), 0, &due);
+	}
+	QueryPerformanceCounter(&now);
+	size = scheduleNext(profile, &(profile->cursor), now.QuadPart, &due);
+	while (now.QuadPart < due)
+	{
+		//Sleep can overshoot by a scheduler tick, so only sleep when far off
+		if ((due - now.QuadPart) * 1000 / profile->frequency > 20)
+		{
+			Sleep((DWORD)((due - now.QuadPart) * 1000 / profile->frequency) - 20);
+		}
+		else {
+			YieldProcessor();
+		}
+		QueryPerformanceCounter(&now);
+	}
+	return size;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: startCursor
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void startCursor(PROFILE_CURSOR *cursor, LONGLONG start, DWORD first)
+--
+--	PARAMETERS:	PROFILE_CURSOR *cursor - cursor to start
+--				LONGLONG start - QueryPerformanceCounter the schedule starts at
+--				DWORD first - table entry to start from, so senders sharing a
+--					profile need not send the same sizes at the same time
+--
+--	RETURNS:	none
+--
+---------------------------------------------------------------------------------*/
+void startCursor(PROFILE_CURSOR *cursor, LONGLONG start, DWORD first)
+{
+	cursor->next = first;
+	cursor->nextSend = start;
+	cursor->burstStart = start;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: scheduleNext
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	DWORD scheduleNext(TRAFFIC_PROFILE *profile, PROFILE_CURSOR *cursor, LONGLONG now, LONGLONG *due)
+--
+--	PARAMETERS:	TRAFFIC_PROFILE *profile - profile being sent
+--				PROFILE_CURSOR *cursor - the sender's place in it
+--				LONGLONG now - QueryPerformanceCounter
+--				LONGLONG *due - receives when the message should be sent
+--
+--	RETURNS:	the size of the next message
+--
+--	NOTES:
+--	Sends are scheduled from the previous due time rather than from when the
+--  previous send finished, so a slow send is caught up instead of stretching
+--  the run. A message that would fall past the end of a burst moves to the
+--  start of the next one. An unpaced message is due now, or at the start of
+--  the next burst.
+--
+---------------------------------------------------------------------------------*/
+DWORD scheduleNext(TRAFFIC_PROFILE *profile, PROFILE_CURSOR *cursor, LONGLONG now, LONGLONG *due)
+{
+	DWORD index = cursor->next++ & (PROFILE_TABLE_SIZE - 1);
+
+	if (profile->onTicks > 0)
+	{
+		while (cursor->nextSend - cursor->burstStart >= profile->onTicks)
+		{
+			cursor->burstStart += profile->onTicks + profile->offTicks;
+		}
+		if (cursor->nextSend < cursor->burstStart)
+		{
+			cursor->nextSend = cursor->burstStart;
+		}
+	}
+	*due = cursor->nextSend;
+	if (!profile->paced)
+	{
+		if (*due < now)
+		{
+			*due = now;
+		}
+		cursor->nextSend = *due;
+	}
+	cursor->nextSend += profile->gaps[index];
+	return profile->sizes[index];
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: parseSizes
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	BOOL parseSizes(char *value, DWORD *sizes, DWORD *weights, int *count)
+--
+--	PARAMETERS:	char *value - "imix" or comma separated size:weight pairs
+--				DWORD *sizes - receives up to PROFILE_MAX_SIZES sizes
+--				DWORD *weights - receives the weight of each size
+--				int *count - receives the number of sizes
+--
+--	RETURNS:	TRUE if the list is valid
+--
+--	NOTES:
+--	A size without a weight has weight 1. Sizes must fit in a datagram, which
+--  is also the client's buffer limit.
+--
+---------------------------------------------------------------------------------*/
+BOOL parseSizes(char *value, DWORD *sizes, DWORD *weights, int *count)
+{
+	char imix[] = "64:7,576:4,1500:1";
+	char *entry, *context = NULL;
+	int size, weight;
+
+	if (strcmp(value, "imix") == 0)
+	{
+		value = imix;
+	}
+	*count = 0;
+	for (entry = strtok_s(value, ",", &context); entry != NULL; entry = strtok_s(NULL, ",", &context))
+	{
+		weight = 1;
+		if (*count == PROFILE_MAX_SIZES || sscanf(entry, "%d:%d", &size, &weight) < 1
+			|| size <= 0 || size > MAXLEN || weight <= 0)
+		{
+			return FALSE;
+		}
+		sizes[*count] = size;
+		weights[*count] = weight;
+		(*count)++;
+	}
+	return *count > 0;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: profileRandom
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--				Oct 19, 2026 - shared with the impairment stage
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	DWORD profileRandom(DWORD *state)
+--
+--	PARAMETERS:	DWORD *state - generator state, never zero
+--
+--	RETURNS:	the next 32-bit random number
+--
+--	NOTES:
+--	xorshift32. rand() only gives 15 bits on this compiler and getData reseeds
+--  it, so the profile keeps its own generator. The impairment stage uses it too.
+--
+---------------------------------------------------------------------------------*/
+DWORD profileRandom(DWORD *state)
+{
+	DWORD x = *state;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	*state = x;
+	return x;
+}
\ No newline at end of file
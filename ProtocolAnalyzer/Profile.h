@@ -0,0 +1,32 @@
+#pragma once
+
+#define PROFILE_TABLE_SIZE		4096	//entries in the size and gap tables, a power of two
+#define PROFILE_MAX_SIZES		16
+#define PROFILE_SPEC_LENGTH		256
+
+// Where one sender is in a profile's schedule. A profile is not changed while
+// it is sent, so many senders can share one, each with its own cursor.
+typedef struct _PROFILE_CURSOR {
+	DWORD next;							// index of the next table entry
+	LONGLONG nextSend;					// counter value the next send is due at
+	LONGLONG burstStart;
+} PROFILE_CURSOR;
+
+typedef struct _TRAFFIC_PROFILE {
+	DWORD sizes[PROFILE_TABLE_SIZE];	// message sizes in shuffled order
+	LONGLONG gaps[PROFILE_TABLE_SIZE];	// QueryPerformanceCounter ticks between sends
+	DWORD maxSize;
+	BOOL paced;							// FALSE sends as fast as the socket allows
+	LONGLONG onTicks;					// length of a burst, 0 for continuous sending
+	LONGLONG offTicks;					// silence between bursts
+	PROFILE_CURSOR cursor;				// schedule of the thread calling nextPacket
+	LONGLONG frequency;					// QueryPerformanceCounter ticks per second
+	char description[128];
+} TRAFFIC_PROFILE;
+
+BOOL parseProfile(char *, int, TRAFFIC_PROFILE *);
+void startProfile(TRAFFIC_PROFILE *);
+DWORD nextPacket(TRAFFIC_PROFILE *);
+void startCursor(PROFILE_CURSOR *, LONGLONG, DWORD);
+DWORD scheduleNext(TRAFFIC_PROFILE *, PROFILE_CURSOR *, LONGLONG, LONGLONG *);
+DWORD profileRandom(DWORD *);
\ No newline at end of file
@@ -0,0 +1,1574 @@
+/*---------------------------------------------------------------------------------
+--	SOURCE FILE:	Reliable.cpp -
+--
+--	PROGRAM:		Transport Layer Protocol Analyser
+--
+--	FUNCTIONS:
+--					BOOL startReliable(RELIABLE_SENDER *sender, SOCKET sd, SOCKADDR_IN *server,
+--						DWORD packetSize, char *congestion, IMPAIRMENT *impair)
+--					char *reliableBuffer(RELIABLE_SENDER *sender)
+--					void reliableSend(RELIABLE_SENDER *sender, DWORD length)
+--					BOOL finishReliable(RELIABLE_SENDER *sender)
+--					void stopReliable(RELIABLE_SENDER *sender)
+--					void logReliable(RELIABLE_SENDER *sender, HANDLE logFile)
+--					BOOL isReliable(char *data, DWORD length)
+--					BOOL reliableReceive(RELIABLE_RECEIVER *receiver, SOCKET sd, char *data, DWORD length,
+--						SOCKADDR_IN *from, TRANSFER_STATS *stats, PAYLOAD_HANDLER save)
+--					BOOL reliableTick(RELIABLE_RECEIVER *receiver, SOCKET sd, ULONGLONG now)
+--					BOOL reliableSupersedes(RELIABLE_RECEIVER *receiver, char *data)
+--					void logReceiver(RELIABLE_RECEIVER *receiver, HANDLE logFile)
+--					void resetReceiver(RELIABLE_RECEIVER *receiver)
+--					void pumpReliable(RELIABLE_SENDER *sender, BOOL wait)
+--					BOOL transmit(RELIABLE_SENDER *sender, DWORD sequence)
+--					void processAck(RELIABLE_SENDER *sender, char *data, int length)
+--					DWORD markDone(RELIABLE_SENDER *sender, DWORD sequence)
+--					void detectLosses(RELIABLE_SENDER *sender)
+--					void checkTimers(RELIABLE_SENDER *sender, LONGLONG now)
+--					void updateRtt(RELIABLE_SENDER *sender, double sample)
+--					DWORD reliableClock(RELIABLE_SENDER *sender, LONGLONG now)
+--					void sendAck(RELIABLE_RECEIVER *receiver, SOCKET sd, DWORD type)
+--					void fixedStart(RELIABLE_SENDER *sender)
+--					void fixedAcked(RELIABLE_SENDER *sender, DWORD packets)
+--					void fixedLost(RELIABLE_SENDER *sender)
+--					void renoStart(RELIABLE_SENDER *sender)
+--					void renoAcked(RELIABLE_SENDER *sender, DWORD packets)
+--					void renoLost(RELIABLE_SENDER *sender)
+--					void renoTimedOut(RELIABLE_SENDER *sender)
+--					void cubicAcked(RELIABLE_SENDER *sender, DWORD packets)
+--					void cubicLost(RELIABLE_SENDER *sender)
+--					void cubicTimedOut(RELIABLE_SENDER *sender)
+--
+--	DATE:			Oct 19, 2026
+--
+--	REVISIONS:		Oct 19, 2026
+--
+--	DESIGNER:		Gabriella Cheung
+--
+--	PROGRAMMER:		Gabriella Cheung
+--
+--	NOTES:
+--	This file contains a reliable transport over UDP, for measuring against
+--  TCP with the same payloads. Packets are numbered and kept by the sender
+--  until acknowledged. The receiver acknowledges every second packet in
+--  order, and every packet at once while there are gaps, giving the point
+--  everything has arrived up to and up to RELIABLE_SACK_BLOCKS ranges that
+--  arrived beyond it. A packet is taken as lost once RELIABLE_DUPTHRESH later
+--  packets have been selectively acknowledged, or when the retransmission
+--  timer runs out, which presumes everything in flight lost as TCP does.
+--
+--  Round trips come from the sender's timestamp echoed in each ack, so
+--  retransmitted packets give valid samples too. The timer follows RFC 6298
+--  with a lower floor, since the analyser runs on fast local networks.
+--
+--  Congestion control is picked by name from congestionControls: reno, cubic
+--  (RFC 8312, with its TCP-friendly region) or fixed, which keeps the window
+--  at its largest to measure the protocol without any. Each only adjusts
+--  cwnd; loss detection and recovery are the same for all of them.
+--
+--  The sender runs on the thread that calls it: acks are read without
+--  blocking whenever a packet is queued, and the sender only waits, in
+--  select, when its window is full.
+--
+---------------------------------------------------------------------------------*/
+#include "resource.h"
+
+void pumpReliable(RELIABLE_SENDER *, BOOL);
+BOOL transmit(RELIABLE_SENDER *, DWORD);
+void processAck(RELIABLE_SENDER *, char *, int);
+DWORD markDone(RELIABLE_SENDER *, DWORD);
+void detectLosses(RELIABLE_SENDER *);
+void checkTimers(RELIABLE_SENDER *, LONGLONG);
+void updateRtt(RELIABLE_SENDER *, double);
+DWORD reliableClock(RELIABLE_SENDER *, LONGLONG);
+void sendAck(RELIABLE_RECEIVER *, SOCKET, DWORD);
+void fixedStart(RELIABLE_SENDER *);
+void fixedAcked(RELIABLE_SENDER *, DWORD);
+void fixedLost(RELIABLE_SENDER *);
+void renoStart(RELIABLE_SENDER *);
+void renoAcked(RELIABLE_SENDER *, DWORD);
+void renoLost(RELIABLE_SENDER *);
+void renoTimedOut(RELIABLE_SENDER *);
+void cubicAcked(RELIABLE_SENDER *, DWORD);
+void cubicLost(RELIABLE_SENDER *);
+void cubicTimedOut(RELIABLE_SENDER *);
+
+static CONGESTION_CONTROL congestionControls[] = {
+	{ "reno", renoStart, renoAcked, renoLost, renoTimedOut },
+	{ "cubic", renoStart, cubicAcked, cubicLost, cubicTimedOut },
+	{ "fixed", fixedStart, fixedAcked, fixedLost, fixedLost },
+};
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: startReliable
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--				Oct 19, 2026 - allocates from the placement's NUMA node
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	BOOL startReliable(RELIABLE_SENDER *sender, SOCKET sd, SOCKADDR_IN *server,
+--					DWORD packetSize, char *congestion, IMPAIRMENT *impair)
+--
+--	PARAMETERS:	RELIABLE_SENDER *sender - state to set up
+--				SOCKET sd - UDP socket to send on, made non-blocking
+--				SOCKADDR_IN *server - server address
+--				DWORD packetSize - largest datagram, header included
+--				char *congestion - congestion control name, empty for reno
+--				IMPAIRMENT *impair - started impairment stage, or NULL
+--
+--	RETURNS:	FALSE for an unknown congestion control or if out of memory
+--
+--	NOTES:
+--	The window is RELIABLE_WINDOW packets, halved until its buffers fit in
+--  RELIABLE_MEMORY, so large datagrams get a smaller window.
+--
+---------------------------------------------------------------------------------*/
+BOOL startReliable(RELIABLE_SENDER *sender, SOCKET sd, SOCKADDR_IN *server, DWORD packetSize, char *congestion, IMPAIRMENT *impair)
+{
+	ULONG nonBlocking = 1;
+
+	ZeroMemory(sender, sizeof(RELIABLE_SENDER));
+	for (int i = 0; i < sizeof(congestionControls) / sizeof(congestionControls[0]); i++)
+	{
+		if (congestion[0] == '\0' || _stricmp(congestion, congestionControls[i].name) == 0)
+		{
+			sender->cc = &congestionControls[i];
+			break;
+		}
+	}
+	if (sender->cc == NULL)
+	{
+		return FALSE;
+	}
+	sender->sd = sd;
+	sender->server = *server;
+	sender->impair = impair;
+	sender->payloadSize = packetSize > sizeof(RELIABLE_HEADER) ? packetSize - sizeof(RELIABLE_HEADER) : 1;
+	sender->slotSize = sizeof(RELIABLE_HEADER) + sender->payloadSize;
+	for (sender->slots = RELIABLE_WINDOW; sender->slots > RELIABLE_MIN_SLOTS
+		&& (SIZE_T)sender->slots * sender->slotSize > RELIABLE_MEMORY; sender->slots /= 2);
+	sender->buffers = (char *)nodeAlloc((SIZE_T)sender->slots * sender->slotSize);
+	sender->slot = (RELIABLE_SLOT *)calloc(sender->slots, sizeof(RELIABLE_SLOT));
+	sender->queue = (DWORD *)malloc(sender->slots * sizeof(DWORD));
+	if (sender->buffers == NULL || sender->slot == NULL || sender->queue == NULL)
+	{
+		stopReliable(sender);
+		return FALSE;
+	}
+	ioctlsocket(sd, FIONBIO, &nonBlocking);
+
+	sender->connection = (GetCurrentProcessId() << 16 ^ GetTickCount()) | 1;
+	sender->peerWindow = RELIABLE_WINDOW;
+	sender->rto = RELIABLE_INITIAL_RTO;
+	QueryPerformanceFrequency((LARGE_INTEGER *)&(sender->frequency));
+	QueryPerformanceCounter((LARGE_INTEGER *)&(sender->start));
+	sender->lastProgress = sender->start;
+	sender->nextTimerCheck = sender->start;
+	sender->cc->start(sender);
+	sender->maxCwnd = sender->cwnd;
+	return TRUE;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: reliableBuffer
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	char *reliableBuffer(RELIABLE_SENDER *sender)
+--
+--	PARAMETERS:	RELIABLE_SENDER *sender - started sender
+--
+--	RETURNS:	where to put the next packet's payload, up to payloadSize
+--				bytes, or NULL if the transfer has failed
+--
+--	NOTES:
+--	Waits, running the protocol, until the oldest packet is acknowledged if
+--  every slot holds one.
+--
+---------------------------------------------------------------------------------*/
+char *reliableBuffer(RELIABLE_SENDER *sender)
+{
+	while (sender->next - sender->base >= sender->slots && !sender->failed)
+	{
+		pumpReliable(sender, TRUE);
+	}
+	if (sender->failed)
+	{
+		return NULL;
+	}
+	return sender->buffers + (SIZE_T)(sender->next & (sender->slots - 1)) * sender->slotSize + sizeof(RELIABLE_HEADER);
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: reliableSend
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void reliableSend(RELIABLE_SENDER *sender, DWORD length)
+--
+--	PARAMETERS:	RELIABLE_SENDER *sender - started sender
+--				DWORD length - payload bytes written to the reliableBuffer
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	Numbers the packet and sends it if the window allows; otherwise it goes
+--  out as acks open the window.
+--
+---------------------------------------------------------------------------------*/
+void reliableSend(RELIABLE_SENDER *sender, DWORD length)
+{
+	RELIABLE_SLOT *slot = &(sender->slot[sender->next & (sender->slots - 1)]);
+	RELIABLE_HEADER *header = (RELIABLE_HEADER *)(sender->buffers + (SIZE_T)(sender->next & (sender->slots - 1)) * sender->slotSize);
+
+	header->magic = htonl(RELIABLE_MAGIC);
+	header->type = htonl(RELIABLE_DATA);
+	header->connection = htonl(sender->connection);
+	header->sequence = htonl(sender->next);
+	header->window = 0;
+	header->blocks = 0;
+	slot->length = length;
+	slot->state = SLOT_QUEUED;
+	slot->retransmitted = FALSE;
+	sender->next++;
+	pumpReliable(sender, FALSE);
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: finishReliable
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	BOOL finishReliable(RELIABLE_SENDER *sender)
+--
+--	PARAMETERS:	RELIABLE_SENDER *sender - started sender
+--
+--	RETURNS:	TRUE if every packet was acknowledged and the server confirmed
+--				the end of the transfer
+--
+--	NOTES:
+--	Runs the protocol until every packet is acknowledged, then sends a FIN
+--  carrying the packet count until the server answers, backing off like the
+--  retransmission timer. The FIN skips the impairment stage.
+--
+---------------------------------------------------------------------------------*/
+BOOL finishReliable(RELIABLE_SENDER *sender)
+{
+	RELIABLE_HEADER fin = { 0 };
+	LONGLONG sentAt, now;
+	double wait = sender->rto;
+
+	while (sender->base != sender->next && !sender->failed)
+	{
+		pumpReliable(sender, TRUE);
+	}
+	if (sender->failed)
+	{
+		return FALSE;
+	}
+	fin.magic = htonl(RELIABLE_MAGIC);
+	fin.type = htonl(RELIABLE_FIN);
+	fin.connection = htonl(sender->connection);
+	fin.sequence = htonl(sender->next);
+	for (int tries = 0; tries < RELIABLE_FIN_TRIES && !sender->finAcked; tries++)
+	{
+		sendto(sender->sd, (char *)&fin, sizeof(fin), 0, (struct sockaddr *)&(sender->server), sizeof(SOCKADDR_IN));
+		QueryPerformanceCounter((LARGE_INTEGER *)&sentAt);
+		do
+		{
+			pumpReliable(sender, TRUE);
+			QueryPerformanceCounter((LARGE_INTEGER *)&now);
+		} while (!sender->finAcked && (now - sentAt) * 1000.0 / sender->frequency < wait);
+		wait = wait * 2 < RELIABLE_MAX_RTO ? wait * 2 : RELIABLE_MAX_RTO;
+	}
+	return sender->finAcked;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: stopReliable
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void stopReliable(RELIABLE_SENDER *sender)
+--
+--	PARAMETERS:	RELIABLE_SENDER *sender - sender to release, its counters are kept
+--
+--	RETURNS:	void
+--
+---------------------------------------------------------------------------------*/
+void stopReliable(RELIABLE_SENDER *sender)
+{
+	if (sender->buffers != NULL)
+	{
+		VirtualFree(sender->buffers, 0, MEM_RELEASE);
+		sender->buffers = NULL;
+	}
+	free(sender->slot);
+	sender->slot = NULL;
+	free(sender->queue);
+	sender->queue = NULL;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: logReliable
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void logReliable(RELIABLE_SENDER *sender, HANDLE logFile)
+--
+--	PARAMETERS:	RELIABLE_SENDER *sender - finished sender
+--				HANDLE logFile - handle for client log file
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	The completion time runs from the start to the ack for the last packet,
+--  and goodput counts each payload byte once however often it was sent, so
+--  both compare directly with a TCP transfer of the same data.
+--
+---------------------------------------------------------------------------------*/
+void logReliable(RELIABLE_SENDER *sender, HANDLE logFile)
+{
+	char message[256];
+	double elapsed = (sender->lastProgress - sender->start) * 1000.0 / sender->frequency;
+
+	if (sender->failed)
+	{
+		sprintf(message, "Reliable UDP gave up after %d s without an acknowledgement", RELIABLE_GIVE_UP / 1000);
+		writeToScreen(message);
+		strcat(message, "\r\n");
+		writeToFile(logFile, message);
+	}
+	sprintf(message, "Reliable UDP (%s): %lu packets, %llu bytes acknowledged in %.1f ms, goodput %.2f Mbit/s%s",
+		sender->cc->name, sender->base, sender->bytes, elapsed,
+		elapsed > 0 ? sender->bytes * 8.0 / elapsed / 1000 : 0.0,
+		sender->finAcked ? "" : ", end not confirmed");
+	writeToScreen(message);
+	strcat(message, "\r\n");
+	writeToFile(logFile, message);
+	sprintf(message, "Transmissions: %llu, retransmitted %llu (%.2f%%): %llu found by SACK, %llu timeouts, %llu loss events, %llu send errors",
+		sender->packets, sender->retransmits, sender->packets > 0 ? sender->retransmits * 100.0 / sender->packets : 0.0,
+		sender->fastRetransmits, sender->timeouts, sender->lossEvents, sender->sendErrors);
+	writeToScreen(message);
+	strcat(message, "\r\n");
+	writeToFile(logFile, message);
+	sprintf(message, "Round trip %.3f ms (minimum %.3f), RTO %.0f ms, %llu acks, window %lu packets, cwnd %.0f (peak %.0f)",
+		sender->srtt, sender->minRtt, sender->rto, sender->acks, sender->slots, sender->cwnd, sender->maxCwnd);
+	writeToScreen(message);
+	strcat(message, "\r\n");
+	writeToFile(logFile, message);
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: isReliable
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	BOOL isReliable(char *data, DWORD length)
+--
+--	PARAMETERS:	char *data - received datagram
+--				DWORD length - its size
+--
+--	RETURNS:	TRUE if the datagram belongs to a reliable transfer
+--
+---------------------------------------------------------------------------------*/
+BOOL isReliable(char *data, DWORD length)
+{
+	return length >= sizeof(RELIABLE_HEADER) && ntohl(((RELIABLE_HEADER *)data)->magic) == RELIABLE_MAGIC;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: reliableReceive
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--				Oct 19, 2026 - Count payload bytes
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	BOOL reliableReceive(RELIABLE_RECEIVER *receiver, SOCKET sd, char *data, DWORD length,
+--					SOCKADDR_IN *from, TRANSFER_STATS *stats, PAYLOAD_HANDLER save)
+--
+--	PARAMETERS:	RELIABLE_RECEIVER *receiver - receiving side of the transfer
+--				SOCKET sd - socket to send acks on
+--				char *data - datagram accepted by isReliable
+--				DWORD length - its size
+--				SOCKADDR_IN *from - sender
+--				TRANSFER_STATS *stats - counts each packet's payload the first time
+--				PAYLOAD_HANDLER save - gets the payload in order, or NULL
+--
+--	RETURNS:	TRUE when the FIN completes the transfer
+--
+--	NOTES:
+--	A new connection id starts a new transfer; the caller reports one it
+--  interrupts first, see reliableSupersedes. Duplicates are acknowledged at
+--  once but not counted in the statistics, so they show goodput. When saving,
+--  packets that arrive early are copied into pool blocks until the gap before
+--  them fills; past RELIABLE_HELD_LIMIT they are refused and come again.
+--
+---------------------------------------------------------------------------------*/
+BOOL reliableReceive(RELIABLE_RECEIVER *receiver, SOCKET sd, char *data, DWORD length,
+	SOCKADDR_IN *from, TRANSFER_STATS *stats, PAYLOAD_HANDLER save)
+{
+	RELIABLE_HEADER *header = (RELIABLE_HEADER *)data;
+	DWORD type = ntohl(header->type);
+	DWORD connection = ntohl(header->connection);
+	DWORD sequence = ntohl(header->sequence);
+	DWORD offset, index;
+	char *payload = data + sizeof(RELIABLE_HEADER);
+	DWORD payloadLength = length - sizeof(RELIABLE_HEADER);
+	STATS_COUNTERS messages = { 0 };
+
+	if ((type != RELIABLE_DATA && type != RELIABLE_FIN) || connection == 0)
+	{
+		return FALSE;
+	}
+	if (connection != receiver->connection)
+	{
+		resetReceiver(receiver);
+		receiver->connection = connection;
+		receiver->peer = *from;
+		receiver->saving = save != NULL;
+	}
+	receiver->lastArrival = currentFileTime();
+	if (receiver->complete)
+	{
+		// the FIN_ACK was lost; answer again without reporting twice
+		if (type == RELIABLE_FIN && !receiver->abandoned)
+		{
+			sendAck(receiver, sd, RELIABLE_FIN_ACK);
+		}
+		return FALSE;
+	}
+	if (type == RELIABLE_FIN)
+	{
+		receiver->total = sequence;
+		receiver->closing = TRUE;
+		receiver->complete = receiver->next == receiver->total;
+		sendAck(receiver, sd, receiver->complete ? RELIABLE_FIN_ACK : RELIABLE_ACK);
+		return receiver->complete;
+	}
+
+	receiver->echo = ntohl(header->timestamp);
+	offset = sequence - receiver->next;
+	index = sequence & (RELIABLE_WINDOW - 1);
+	if ((LONG)offset < 0 || (offset < RELIABLE_WINDOW && (receiver->received[index / 64] & (1ULL << (index % 64))) != 0))
+	{
+		receiver->duplicates++;
+		sendAck(receiver, sd, RELIABLE_ACK);
+		return FALSE;
+	}
+	if (offset >= RELIABLE_WINDOW)
+	{
+		receiver->refused++;
+		return FALSE;
+	}
+	if (offset > 0 && save != NULL)
+	{
+		if (receiver->heldCount >= RELIABLE_HELD_LIMIT
+			|| (receiver->held[index] = (char *)poolAlloc(payloadLength > 0 ? payloadLength : 1)) == NULL)
+		{
+			receiver->refused++;
+			return FALSE;
+		}
+		memcpy(receiver->held[index], payload, payloadLength);
+		receiver->heldLength[index] = payloadLength;
+		receiver->heldCount++;
+	}
+	receiver->received[index / 64] |= 1ULL << (index % 64);
+	receiver->packets++;
+	receiver->bytes += payloadLength;
+	if ((LONG)(sequence + 1 - receiver->high) > 0)
+	{
+		receiver->high = sequence + 1;
+	}
+	addMessage(&messages, payloadLength);
+	recordPacket(stats, payloadLength, NO_SEQUENCE, &messages);
+
+	if (offset > 0)
+	{
+		receiver->outOfOrder++;
+		sendAck(receiver, sd, RELIABLE_ACK);
+		return FALSE;
+	}
+	if (save != NULL)
+	{
+		save(payload, payloadLength);
+	}
+	// move past this packet and any that arrived early behind it
+	do
+	{
+		index = receiver->next & (RELIABLE_WINDOW - 1);
+		receiver->received[index / 64] &= ~(1ULL << (index % 64));
+		if (receiver->held[index] != NULL)
+		{
+			save(receiver->held[index], receiver->heldLength[index]);
+			poolFree(receiver->held[index]);
+			receiver->held[index] = NULL;
+			receiver->heldCount--;
+		}
+		receiver->next++;
+		index = receiver->next & (RELIABLE_WINDOW - 1);
+	} while (receiver->next != receiver->high && (receiver->received[index / 64] & (1ULL << (index % 64))) != 0);
+
+	if (++receiver->unacked >= RELIABLE_ACK_EVERY || receiver->next != receiver->high)
+	{
+		sendAck(receiver, sd, RELIABLE_ACK);
+	}
+	return FALSE;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: reliableTick
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	BOOL reliableTick(RELIABLE_RECEIVER *receiver, SOCKET sd, ULONGLONG now)
+--
+--	PARAMETERS:	RELIABLE_RECEIVER *receiver - receiving side of the transfer
+--				SOCKET sd - socket to send acks on
+--				ULONGLONG now - current FILETIME
+--
+--	RETURNS:	TRUE if the transfer has just been abandoned
+--
+--	NOTES:
+--	Called regularly by the receiving thread. Sends an ack held back for a
+--  second packet once RELIABLE_ACK_DELAY has passed without one, and gives
+--  up on a sender silent for RELIABLE_GIVE_UP.
+--
+---------------------------------------------------------------------------------*/
+BOOL reliableTick(RELIABLE_RECEIVER *receiver, SOCKET sd, ULONGLONG now)
+{
+	if (receiver->connection == 0 || receiver->complete)
+	{
+		return FALSE;
+	}
+	if (receiver->unacked > 0 && now - receiver->lastArrival >= RELIABLE_ACK_DELAY * 10000ULL)
+	{
+		// held back, so it is no use as a round-trip sample
+		receiver->echo = 0;
+		sendAck(receiver, sd, RELIABLE_ACK);
+	}
+	if (now - receiver->lastArrival > RELIABLE_GIVE_UP * 10000ULL)
+	{
+		receiver->complete = TRUE;
+		receiver->abandoned = TRUE;
+		return TRUE;
+	}
+	return FALSE;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: reliableSupersedes
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	BOOL reliableSupersedes(RELIABLE_RECEIVER *receiver, char *data)
+--
+--	PARAMETERS:	RELIABLE_RECEIVER *receiver - receiving side of the transfer
+--				char *data - datagram accepted by isReliable, not yet received
+--
+--	RETURNS:	TRUE if the transfer under way has just been abandoned
+--
+--	NOTES:
+--	Called before reliableReceive. A packet of another connection while the
+--  current transfer is unfinished means its sender has given up on it or
+--  started over; the transfer is marked abandoned so it can be reported
+--  before reliableReceive clears it.
+--
+---------------------------------------------------------------------------------*/
+BOOL reliableSupersedes(RELIABLE_RECEIVER *receiver, char *data)
+{
+	RELIABLE_HEADER *header = (RELIABLE_HEADER *)data;
+	DWORD type = ntohl(header->type);
+	DWORD connection = ntohl(header->connection);
+
+	if ((type != RELIABLE_DATA && type != RELIABLE_FIN) || connection == 0
+		|| receiver->connection == 0 || connection == receiver->connection || receiver->complete)
+	{
+		return FALSE;
+	}
+	receiver->complete = TRUE;
+	receiver->abandoned = TRUE;
+	return TRUE;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: logReceiver
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--				Oct 19, 2026 - Report what an abandoned transfer is missing
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void logReceiver(RELIABLE_RECEIVER *receiver, HANDLE logFile)
+--
+--	PARAMETERS:	RELIABLE_RECEIVER *receiver - receiving side of a finished transfer
+--				HANDLE logFile - handle for server log file
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	An abandoned transfer also gets the bytes that made it and the first
+--  RELIABLE_SACK_BLOCKS ranges of packets that never did.
+--
+---------------------------------------------------------------------------------*/
+void logReceiver(RELIABLE_RECEIVER *receiver, HANDLE logFile)
+{
+	char message[384];
+	char *end;
+	DWORD sequence, first, index;
+	int ranges = 0;
+
+	sprintf(message, "Reliable UDP connection %08lx from %s:%d: %llu packets, %llu duplicates (%.2f%%), %llu out of order, %llu refused, %llu acks%s",
+		receiver->connection, inet_ntoa(receiver->peer.sin_addr), ntohs(receiver->peer.sin_port),
+		receiver->packets, receiver->duplicates,
+		receiver->packets > 0 ? receiver->duplicates * 100.0 / receiver->packets : 0.0,
+		receiver->outOfOrder, receiver->refused, receiver->acks,
+		receiver->abandoned ? ", abandoned by the sender" : "");
+	writeToScreen(message);
+	strcat(message, "\r\n");
+	writeToFile(logFile, message);
+	if (!receiver->abandoned)
+	{
+		return;
+	}
+
+	end = message + sprintf(message, "Abandoned after %llu bytes, %lu packets in order; missing", receiver->bytes, receiver->next);
+	sequence = receiver->next;
+	while ((LONG)(sequence - receiver->high) < 0 && ranges < RELIABLE_SACK_BLOCKS)
+	{
+		// the packets at next and past high are missing, those between are in the bitmap
+		first = sequence;
+		do
+		{
+			sequence++;
+			index = sequence & (RELIABLE_WINDOW - 1);
+		} while (sequence != receiver->high && (receiver->received[index / 64] & (1ULL << (index % 64))) == 0);
+		end += sprintf(end, sequence - first > 1 ? " %lu-%lu" : " %lu", first, sequence - 1);
+		ranges++;
+		while (sequence != receiver->high && (receiver->received[index / 64] & (1ULL << (index % 64))) != 0)
+		{
+			sequence++;
+			index = sequence & (RELIABLE_WINDOW - 1);
+		}
+	}
+	if (sequence != receiver->high)
+	{
+		strcpy(end, " and more");
+	}
+	else if (receiver->closing && receiver->total != receiver->high)
+	{
+		sprintf(end, receiver->total - receiver->high > 1 ? " %lu-%lu" : " %lu", receiver->high, receiver->total - 1);
+	}
+	else if (!receiver->closing)
+	{
+		sprintf(end, " %lu onwards, the sender never sent its count", receiver->high);
+	}
+	writeToScreen(message);
+	strcat(message, "\r\n");
+	writeToFile(logFile, message);
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: resetReceiver
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void resetReceiver(RELIABLE_RECEIVER *receiver)
+--
+--	PARAMETERS:	RELIABLE_RECEIVER *receiver - receiver to clear
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	Returns any payloads still held to the pool.
+--
+---------------------------------------------------------------------------------*/
+void resetReceiver(RELIABLE_RECEIVER *receiver)
+{
+	for (int i = 0; i < RELIABLE_WINDOW && receiver->heldCount > 0; i++)
+	{
+		if (receiver->held[i] != NULL)
+		{
+			poolFree(receiver->held[i]);
+			receiver->heldCount--;
+		}
+	}
+	ZeroMemory(receiver, sizeof(RELIABLE_RECEIVER));
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: pumpReliable
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void pumpReliable(RELIABLE_SENDER *sender, BOOL wait)
+--
+--	PARAMETERS:	RELIABLE_SENDER *sender - started sender
+--				BOOL wait - wait up to a millisecond for an ack first
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	Reads every ack waiting, checks the retransmission timer, then sends as
+--  much as the congestion window allows: lost packets first, then new ones
+--  while the receive window has room. Retransmissions fill gaps the
+--  receiver already has room for, so only new packets wait on its window,
+--  and one may always be in flight so a closed window is probed rather
+--  than waited on forever.
+--
+---------------------------------------------------------------------------------*/
+void pumpReliable(RELIABLE_SENDER *sender, BOOL wait)
+{
+	char ack[sizeof(RELIABLE_HEADER) + RELIABLE_SACK_BLOCKS * sizeof(SACK_BLOCK)];
+	SOCKADDR_IN from;
+	int fromSize, received, error;
+	fd_set readable, writable;
+	struct timeval tv;
+	LONGLONG now;
+	DWORD sequence;
+
+	if (wait)
+	{
+		FD_ZERO(&readable);
+		FD_SET(sender->sd, &readable);
+		FD_ZERO(&writable);
+		FD_SET(sender->sd, &writable);
+		tv.tv_sec = 0;
+		tv.tv_usec = 1000;
+		select(0, &readable, sender->blocked ? &writable : NULL, NULL, &tv);
+	}
+	sender->blocked = FALSE;
+	while (true)
+	{
+		fromSize = sizeof(from);
+		if ((received = recvfrom(sender->sd, ack, sizeof(ack), 0, (struct sockaddr *)&from, &fromSize)) == SOCKET_ERROR)
+		{
+			// an ICMP port unreachable is reported on the next receive
+			if ((error = WSAGetLastError()) == WSAECONNRESET || error == WSAEMSGSIZE)
+			{
+				continue;
+			}
+			break;
+		}
+		if (from.sin_addr.s_addr == sender->server.sin_addr.s_addr && from.sin_port == sender->server.sin_port)
+		{
+			processAck(sender, ack, received);
+		}
+	}
+
+	QueryPerformanceCounter((LARGE_INTEGER *)&now);
+	if (now >= sender->nextTimerCheck)
+	{
+		checkTimers(sender, now);
+	}
+	while (sender->inFlight < (DWORD)sender->cwnd)
+	{
+		if (sender->queueHead != sender->queueTail)
+		{
+			sequence = sender->queue[sender->queueHead & (sender->slots - 1)];
+			if (sender->slot[sequence & (sender->slots - 1)].state == SLOT_LOST)
+			{
+				if (!transmit(sender, sequence))
+				{
+					break;
+				}
+				sender->retransmits++;
+				sender->slot[sequence & (sender->slots - 1)].retransmitted = TRUE;
+			}
+			sender->queueHead++;
+		}
+		else if (sender->sendNext != sender->next && (sender->inFlight < sender->peerWindow || sender->inFlight == 0))
+		{
+			if (!transmit(sender, sender->sendNext))
+			{
+				break;
+			}
+			sender->sendNext++;
+		}
+		else {
+			break;
+		}
+	}
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: transmit
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	BOOL transmit(RELIABLE_SENDER *sender, DWORD sequence)
+--
+--	PARAMETERS:	RELIABLE_SENDER *sender - started sender
+--				DWORD sequence - packet to send
+--
+--	RETURNS:	FALSE if the socket's send buffer is full
+--
+--	NOTES:
+--	Stamps the packet with the time it leaves. Any other send error is
+--  treated as a loss and recovered the same way.
+--
+---------------------------------------------------------------------------------*/
+BOOL transmit(RELIABLE_SENDER *sender, DWORD sequence)
+{
+	char *packet = sender->buffers + (SIZE_T)(sequence & (sender->slots - 1)) * sender->slotSize;
+	RELIABLE_SLOT *slot = &(sender->slot[sequence & (sender->slots - 1)]);
+	DWORD length = sizeof(RELIABLE_HEADER) + slot->length;
+	LONGLONG now;
+
+	QueryPerformanceCounter((LARGE_INTEGER *)&now);
+	((RELIABLE_HEADER *)packet)->timestamp = htonl(reliableClock(sender, now));
+	if (sender->impair != NULL)
+	{
+		impairSend(sender->impair, packet, length);
+	}
+	else if (sendto(sender->sd, packet, length, 0, (struct sockaddr *)&(sender->server), sizeof(SOCKADDR_IN)) == SOCKET_ERROR)
+	{
+		if (WSAGetLastError() == WSAEWOULDBLOCK)
+		{
+			sender->blocked = TRUE;
+			return FALSE;
+		}
+		sender->sendErrors++;
+	}
+	slot->sent = now;
+	slot->state = SLOT_IN_FLIGHT;
+	sender->inFlight++;
+	sender->packets++;
+	return TRUE;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: processAck
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void processAck(RELIABLE_SENDER *sender, char *data, int length)
+--
+--	PARAMETERS:	RELIABLE_SENDER *sender - started sender
+--				char *data - datagram from the server
+--				int length - its size
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	Marks the packets the ack covers, takes a round-trip sample from the
+--  echoed timestamp, grows the window unless recovering from a loss, and
+--  looks for packets the SACK blocks show to be lost.
+--
+---------------------------------------------------------------------------------*/
+void processAck(RELIABLE_SENDER *sender, char *data, int length)
+{
+	RELIABLE_HEADER *header = (RELIABLE_HEADER *)data;
+	SACK_BLOCK *block = (SACK_BLOCK *)(header + 1);
+	DWORD ack, blocks, start, end, newly = 0;
+	LONGLONG now;
+
+	if (length < sizeof(RELIABLE_HEADER) || ntohl(header->magic) != RELIABLE_MAGIC || ntohl(header->connection) != sender->connection)
+	{
+		return;
+	}
+	if (ntohl(header->type) == RELIABLE_FIN_ACK)
+	{
+		sender->finAcked = TRUE;
+		return;
+	}
+	ack = ntohl(header->sequence);
+	if (ntohl(header->type) != RELIABLE_ACK || (LONG)(ack - sender->sendNext) > 0)
+	{
+		return;
+	}
+	blocks = ntohl(header->blocks);
+	if (blocks > (length - sizeof(RELIABLE_HEADER)) / sizeof(SACK_BLOCK))
+	{
+		blocks = (length - sizeof(RELIABLE_HEADER)) / sizeof(SACK_BLOCK);
+	}
+	sender->acks++;
+	QueryPerformanceCounter((LARGE_INTEGER *)&now);
+
+	while ((LONG)(ack - sender->base) > 0)
+	{
+		newly += markDone(sender, sender->base);
+		sender->base++;
+	}
+	for (DWORD i = 0; i < blocks; i++)
+	{
+		start = ntohl(block[i].start);
+		end = ntohl(block[i].end);
+		if ((LONG)(end - sender->sendNext) > 0 || (LONG)(end - start) <= 0)
+		{
+			continue;
+		}
+		for (DWORD sequence = (LONG)(start - sender->base) > 0 ? start : sender->base; (LONG)(end - sequence) > 0; sequence++)
+		{
+			newly += markDone(sender, sequence);
+		}
+		if ((LONG)(end - sender->highSacked) > 0)
+		{
+			sender->highSacked = end;
+		}
+	}
+	if ((LONG)(sender->base - sender->highSacked) > 0)
+	{
+		sender->highSacked = sender->base;
+	}
+	sender->peerWindow = ntohl(header->window);
+	if (header->timestamp != 0)
+	{
+		updateRtt(sender, (reliableClock(sender, now) - ntohl(header->timestamp)) / 1000.0);
+	}
+	if (newly > 0)
+	{
+		sender->lastProgress = now;
+		if (sender->recovery && (LONG)(sender->base - sender->recoveryPoint) >= 0)
+		{
+			sender->recovery = FALSE;
+		}
+		if (!sender->recovery)
+		{
+			sender->cc->acked(sender, newly);
+		}
+	}
+	detectLosses(sender);
+
+	if (sender->cwnd > sender->slots)
+	{
+		sender->cwnd = sender->slots;
+	}
+	if (sender->cwnd < 1)
+	{
+		sender->cwnd = 1;
+	}
+	if (sender->cwnd > sender->maxCwnd)
+	{
+		sender->maxCwnd = sender->cwnd;
+	}
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: markDone
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	DWORD markDone(RELIABLE_SENDER *sender, DWORD sequence)
+--
+--	PARAMETERS:	RELIABLE_SENDER *sender - started sender
+--				DWORD sequence - packet an ack covers
+--
+--	RETURNS:	1 if the packet had not been acknowledged before, otherwise 0
+--
+--	NOTES:
+--	A packet waiting for retransmission is skipped when the queue reaches it.
+--
+---------------------------------------------------------------------------------*/
+DWORD markDone(RELIABLE_SENDER *sender, DWORD sequence)
+{
+	RELIABLE_SLOT *slot = &(sender->slot[sequence & (sender->slots - 1)]);
+
+	if (slot->state == SLOT_DONE || slot->state == SLOT_QUEUED)
+	{
+		return 0;
+	}
+	if (slot->state == SLOT_IN_FLIGHT)
+	{
+		sender->inFlight--;
+	}
+	slot->state = SLOT_DONE;
+	sender->bytes += slot->length;
+	return 1;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: detectLosses
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void detectLosses(RELIABLE_SENDER *sender)
+--
+--	PARAMETERS:	RELIABLE_SENDER *sender - started sender
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	Queues every packet still in flight that RELIABLE_DUPTHRESH later packets
+--  have overtaken. Each packet is looked at once, so a retransmission that
+--  is lost again is left to the timer. The congestion control hears of the
+--  first loss in each window only.
+--
+---------------------------------------------------------------------------------*/
+void detectLosses(RELIABLE_SENDER *sender)
+{
+	DWORD limit = sender->highSacked - RELIABLE_DUPTHRESH;
+	RELIABLE_SLOT *slot;
+	BOOL found = FALSE;
+
+	if ((LONG)(sender->scanFrom - sender->base) < 0)
+	{
+		sender->scanFrom = sender->base;
+	}
+	for (; (LONG)(limit - sender->scanFrom) > 0; sender->scanFrom++)
+	{
+		slot = &(sender->slot[sender->scanFrom & (sender->slots - 1)]);
+		if (slot->state != SLOT_IN_FLIGHT)
+		{
+			continue;
+		}
+		if (sender->queueTail - sender->queueHead == sender->slots)
+		{
+			break;
+		}
+		slot->state = SLOT_LOST;
+		sender->inFlight--;
+		sender->queue[sender->queueTail++ & (sender->slots - 1)] = sender->scanFrom;
+		sender->fastRetransmits++;
+		found = TRUE;
+	}
+	if (found && !sender->recovery)
+	{
+		sender->recovery = TRUE;
+		sender->recoveryPoint = sender->sendNext;
+		sender->lossEvents++;
+		sender->cc->lost(sender);
+	}
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: checkTimers
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void checkTimers(RELIABLE_SENDER *sender, LONGLONG now)
+--
+--	PARAMETERS:	RELIABLE_SENDER *sender - started sender
+--				LONGLONG now - QueryPerformanceCounter
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	Runs every quarter RTO. If any packet has been in flight longer than the
+--  RTO, everything in flight is queued again, the congestion control is told
+--  of the timeout and the RTO doubles until the next round-trip sample.
+--
+---------------------------------------------------------------------------------*/
+void checkTimers(RELIABLE_SENDER *sender, LONGLONG now)
+{
+	LONGLONG expiry = (LONGLONG)(sender->rto * sender->frequency / 1000);
+	RELIABLE_SLOT *slot;
+	BOOL expired = FALSE;
+
+	sender->nextTimerCheck = now + (expiry / 4 > sender->frequency / 1000 ? expiry / 4 : sender->frequency / 1000);
+	if ((now - sender->lastProgress) * 1000 / sender->frequency > RELIABLE_GIVE_UP)
+	{
+		sender->failed = TRUE;
+		return;
+	}
+	for (DWORD sequence = sender->base; sequence != sender->sendNext && !expired; sequence++)
+	{
+		slot = &(sender->slot[sequence & (sender->slots - 1)]);
+		expired = slot->state == SLOT_IN_FLIGHT && now - slot->sent >= expiry;
+	}
+	if (!expired)
+	{
+		return;
+	}
+	for (DWORD sequence = sender->base; sequence != sender->sendNext; sequence++)
+	{
+		slot = &(sender->slot[sequence & (sender->slots - 1)]);
+		if (slot->state == SLOT_IN_FLIGHT && sender->queueTail - sender->queueHead < sender->slots)
+		{
+			slot->state = SLOT_LOST;
+			sender->inFlight--;
+			sender->queue[sender->queueTail++ & (sender->slots - 1)] = sequence;
+		}
+	}
+	sender->timeouts++;
+	sender->rto = sender->rto * 2 < RELIABLE_MAX_RTO ? sender->rto * 2 : RELIABLE_MAX_RTO;
+	sender->recovery = TRUE;
+	sender->recoveryPoint = sender->sendNext;
+	sender->cc->timedOut(sender);
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: updateRtt
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void updateRtt(RELIABLE_SENDER *sender, double sample)
+--
+--	PARAMETERS:	RELIABLE_SENDER *sender - started sender
+--				double sample - round trip in milliseconds
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	The smoothed round trip and its variation as in RFC 6298, with the RTO
+--  kept between RELIABLE_MIN_RTO and RELIABLE_MAX_RTO.
+--
+---------------------------------------------------------------------------------*/
+void updateRtt(RELIABLE_SENDER *sender, double sample)
+{
+	if (sample < 0 || sample > RELIABLE_GIVE_UP)
+	{
+		return;
+	}
+	if (sender->srtt == 0)
+	{
+		sender->srtt = sample;
+		sender->rttvar = sample / 2;
+	}
+	else {
+		sender->rttvar = 0.75 * sender->rttvar + 0.25 * fabs(sender->srtt - sample);
+		sender->srtt = 0.875 * sender->srtt + 0.125 * sample;
+	}
+	if (sender->minRtt == 0 || sample < sender->minRtt)
+	{
+		sender->minRtt = sample;
+	}
+	sender->rto = sender->srtt + (4 * sender->rttvar > 1 ? 4 * sender->rttvar : 1);
+	if (sender->rto < RELIABLE_MIN_RTO)
+	{
+		sender->rto = RELIABLE_MIN_RTO;
+	}
+	if (sender->rto > RELIABLE_MAX_RTO)
+	{
+		sender->rto = RELIABLE_MAX_RTO;
+	}
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: reliableClock
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	DWORD reliableClock(RELIABLE_SENDER *sender, LONGLONG now)
+--
+--	PARAMETERS:	RELIABLE_SENDER *sender - started sender
+--				LONGLONG now - QueryPerformanceCounter
+--
+--	RETURNS:	microseconds since the sender started, never 0
+--
+---------------------------------------------------------------------------------*/
+DWORD reliableClock(RELIABLE_SENDER *sender, LONGLONG now)
+{
+	DWORD micros = (DWORD)((now - sender->start) * 1000000 / sender->frequency);
+
+	return micros != 0 ? micros : 1;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: sendAck
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void sendAck(RELIABLE_RECEIVER *receiver, SOCKET sd, DWORD type)
+--
+--	PARAMETERS:	RELIABLE_RECEIVER *receiver - receiving side of the transfer
+--				SOCKET sd - socket to send on
+--				DWORD type - RELIABLE_ACK or RELIABLE_FIN_ACK
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	The SACK blocks are the lowest ranges past the gap, which are the ones the
+--  sender needs to repair first. When saving, the window is also limited by
+--  the room left to hold early packets.
+--
+---------------------------------------------------------------------------------*/
+void sendAck(RELIABLE_RECEIVER *receiver, SOCKET sd, DWORD type)
+{
+	char packet[sizeof(RELIABLE_HEADER) + RELIABLE_SACK_BLOCKS * sizeof(SACK_BLOCK)];
+	RELIABLE_HEADER *header = (RELIABLE_HEADER *)packet;
+	SACK_BLOCK *block = (SACK_BLOCK *)(header + 1);
+	DWORD blocks = 0, sequence = receiver->next, start, index;
+	DWORD window = RELIABLE_WINDOW - (receiver->high - receiver->next);
+
+	if (receiver->saving && RELIABLE_HELD_LIMIT - receiver->heldCount < window)
+	{
+		window = RELIABLE_HELD_LIMIT - receiver->heldCount;
+	}
+	while ((LONG)(receiver->high - sequence) > 0 && blocks < RELIABLE_SACK_BLOCKS)
+	{
+		index = sequence & (RELIABLE_WINDOW - 1);
+		if ((receiver->received[index / 64] & (1ULL << (index % 64))) == 0)
+		{
+			sequence++;
+			continue;
+		}
+		start = sequence;
+		do
+		{
+			sequence++;
+			index = sequence & (RELIABLE_WINDOW - 1);
+		} while ((LONG)(receiver->high - sequence) > 0 && (receiver->received[index / 64] & (1ULL << (index % 64))) != 0);
+		block[blocks].start = htonl(start);
+		block[blocks].end = htonl(sequence);
+		blocks++;
+	}
+	header->magic = htonl(RELIABLE_MAGIC);
+	header->type = htonl(type);
+	header->connection = htonl(receiver->connection);
+	header->sequence = htonl(receiver->next);
+	header->timestamp = htonl(receiver->echo);
+	header->window = htonl(window);
+	header->blocks = htonl(blocks);
+	sendto(sd, packet, sizeof(RELIABLE_HEADER) + blocks * sizeof(SACK_BLOCK), 0, (struct sockaddr *)&(receiver->peer), sizeof(SOCKADDR_IN));
+	receiver->acks++;
+	receiver->unacked = 0;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: fixedStart
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void fixedStart(RELIABLE_SENDER *sender)
+--
+--	PARAMETERS:	RELIABLE_SENDER *sender - started sender
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	No congestion control: the window is every slot from the start, and
+--  fixedAcked and fixedLost leave it there.
+--
+---------------------------------------------------------------------------------*/
+void fixedStart(RELIABLE_SENDER *sender)
+{
+	sender->cwnd = sender->slots;
+	sender->ssthresh = sender->slots;
+}
+
+void fixedAcked(RELIABLE_SENDER *sender, DWORD packets)
+{
+}
+
+void fixedLost(RELIABLE_SENDER *sender)
+{
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: renoStart
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void renoStart(RELIABLE_SENDER *sender)
+--
+--	PARAMETERS:	RELIABLE_SENDER *sender - started sender
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	Ten packets, as TCP starts with, and slow start until the first loss.
+--  Cubic starts the same way.
+--
+---------------------------------------------------------------------------------*/
+void renoStart(RELIABLE_SENDER *sender)
+{
+	sender->cwnd = 10;
+	sender->ssthresh = sender->slots;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: renoAcked
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void renoAcked(RELIABLE_SENDER *sender, DWORD packets)
+--
+--	PARAMETERS:	RELIABLE_SENDER *sender - started sender
+--				DWORD packets - packets newly acknowledged
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	One packet per packet acknowledged in slow start, one per window after.
+--
+---------------------------------------------------------------------------------*/
+void renoAcked(RELIABLE_SENDER *sender, DWORD packets)
+{
+	if (sender->cwnd < sender->ssthresh)
+	{
+		sender->cwnd += packets;
+	}
+	else {
+		sender->cwnd += packets / sender->cwnd;
+	}
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: renoLost
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void renoLost(RELIABLE_SENDER *sender)
+--
+--	PARAMETERS:	RELIABLE_SENDER *sender - started sender
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	Halves the window; renoTimedOut also drops it to one packet.
+--
+---------------------------------------------------------------------------------*/
+void renoLost(RELIABLE_SENDER *sender)
+{
+	sender->ssthresh = sender->cwnd / 2 > 2 ? sender->cwnd / 2 : 2;
+	sender->cwnd = sender->ssthresh;
+}
+
+void renoTimedOut(RELIABLE_SENDER *sender)
+{
+	renoLost(sender);
+	sender->cwnd = 1;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: cubicAcked
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void cubicAcked(RELIABLE_SENDER *sender, DWORD packets)
+--
+--	PARAMETERS:	RELIABLE_SENDER *sender - started sender
+--				DWORD packets - packets newly acknowledged
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	Grows towards the cubic curve through the window before the last loss,
+--  one round trip ahead, but never slower than Reno would and never by more
+--  than half the window per round trip.
+--
+---------------------------------------------------------------------------------*/
+void cubicAcked(RELIABLE_SENDER *sender, DWORD packets)
+{
+	LONGLONG now;
+	double t, target, reno;
+
+	if (sender->cwnd < sender->ssthresh)
+	{
+		sender->cwnd += packets;
+		return;
+	}
+	QueryPerformanceCounter((LARGE_INTEGER *)&now);
+	if (sender->epoch == 0)
+	{
+		sender->epoch = now;
+		if (sender->cwnd < sender->wMax)
+		{
+			sender->k = cbrt((sender->wMax - sender->cwnd) / CUBIC_C);
+		}
+		else {
+			sender->k = 0;
+			sender->wMax = sender->cwnd;
+		}
+	}
+	t = (double)(now - sender->epoch) / sender->frequency;
+	target = CUBIC_C * pow(t + sender->srtt / 1000 - sender->k, 3) + sender->wMax;
+	if (sender->srtt > 0)
+	{
+		reno = sender->wMax * CUBIC_BETA + 3 * (1 - CUBIC_BETA) / (1 + CUBIC_BETA) * t / (sender->srtt / 1000);
+		if (reno > target)
+		{
+			target = reno;
+		}
+	}
+	if (target > 1.5 * sender->cwnd)
+	{
+		target = 1.5 * sender->cwnd;
+	}
+	if (target > sender->cwnd)
+	{
+		sender->cwnd += (target - sender->cwnd) / sender->cwnd * packets;
+	}
+	else {
+		sender->cwnd += 0.01 * packets / sender->cwnd;
+	}
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: cubicLost
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void cubicLost(RELIABLE_SENDER *sender)
+--
+--	PARAMETERS:	RELIABLE_SENDER *sender - started sender
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	Reduces the window by CUBIC_BETA. A loss before the window regained its
+--  previous peak lowers the peak further, so that competing flows converge.
+--  cubicTimedOut also drops the window to one packet.
+--
+---------------------------------------------------------------------------------*/
+void cubicLost(RELIABLE_SENDER *sender)
+{
+	sender->epoch = 0;
+	sender->wMax = sender->cwnd < sender->wMax ? sender->cwnd * (1 + CUBIC_BETA) / 2 : sender->cwnd;
+	sender->cwnd = sender->cwnd * CUBIC_BETA > 2 ? sender->cwnd * CUBIC_BETA : 2;
+	sender->ssthresh = sender->cwnd;
+}
+
+void cubicTimedOut(RELIABLE_SENDER *sender)
+{
+	cubicLost(sender);
+	sender->cwnd = 1;
+}
\ No newline at end of file
@@ -0,0 +1,159 @@
+#pragma once
+
+#define RELIABLE_MAGIC			0x50415255	//"PARU"
+#define RELIABLE_DATA			1
+#define RELIABLE_ACK			2
+#define RELIABLE_FIN			3		//sequence is the number of packets sent
+#define RELIABLE_FIN_ACK		4
+
+#define RELIABLE_WINDOW			8192	//most packets outstanding, a power of two
+#define RELIABLE_MIN_SLOTS		16
+#define RELIABLE_MEMORY			(64 * 1024 * 1024)	//cap on the sender's retransmission buffers
+#define RELIABLE_HELD_LIMIT		512		//out-of-order packets the receiver keeps for saving in order
+#define RELIABLE_SACK_BLOCKS	8
+#define RELIABLE_DUPTHRESH		3		//later packets selectively acked before one is taken as lost
+#define RELIABLE_ACK_EVERY		2		//in-order packets per ack
+#define RELIABLE_ACK_DELAY		2		//ms a held-back ack waits for a second packet
+#define RELIABLE_INITIAL_RTO	200		//ms
+#define RELIABLE_MIN_RTO		30		//above the receiver's ack delay plus the server's timer tick
+#define RELIABLE_MAX_RTO		2000
+#define RELIABLE_GIVE_UP		10000	//ms without progress before either side abandons a transfer
+#define RELIABLE_FIN_TRIES		10
+#define RELIABLE_NAME_LENGTH	16
+#define CUBIC_C					0.4
+#define CUBIC_BETA				0.7
+
+#define SLOT_QUEUED				0		//stored, not sent yet
+#define SLOT_IN_FLIGHT			1
+#define SLOT_LOST				2		//waiting in the retransmission queue
+#define SLOT_DONE				3		//acknowledged, cumulatively or selectively
+
+// Starts every reliable datagram. All fields are in network order.
+typedef struct _RELIABLE_HEADER {
+	DWORD magic;
+	DWORD type;
+	DWORD connection;			// picked by the sender for each run, never 0
+	DWORD sequence;				// data: packet number; ack: every packet before it has arrived
+	DWORD timestamp;			// data: sender's clock in microseconds, never 0; ack: echoed
+	DWORD window;				// ack: packets past the gap the receiver can still take
+	DWORD blocks;				// ack: SACK_BLOCKs that follow
+} RELIABLE_HEADER;
+
+// Packets from start up to but not including end have arrived.
+typedef struct _SACK_BLOCK {
+	DWORD start;
+	DWORD end;
+} SACK_BLOCK;
+
+typedef struct _RELIABLE_SLOT {
+	LONGLONG sent;				// QueryPerformanceCounter at the latest transmission
+	DWORD length;				// payload bytes
+	int state;
+	BOOL retransmitted;
+} RELIABLE_SLOT;
+
+// Congestion control, picked by name. Each function adjusts the sender's cwnd.
+typedef struct _CONGESTION_CONTROL {
+	char *name;
+	void (*start)(struct _RELIABLE_SENDER *);
+	void (*acked)(struct _RELIABLE_SENDER *, DWORD);	// packets newly acknowledged
+	void (*lost)(struct _RELIABLE_SENDER *);			// first loss in a window
+	void (*timedOut)(struct _RELIABLE_SENDER *);
+} CONGESTION_CONTROL;
+
+typedef struct _RELIABLE_SENDER {
+	SOCKET sd;
+	SOCKADDR_IN server;
+	DWORD connection;
+	IMPAIRMENT *impair;			// sends go through the impairment stage when set
+	char *buffers;				// slots * slotSize, header and payload of each packet
+	DWORD slotSize;
+	DWORD slots;				// a power of two
+	DWORD payloadSize;
+	RELIABLE_SLOT *slot;
+	DWORD *queue;				// sequence numbers waiting to be retransmitted
+	DWORD queueHead;
+	DWORD queueTail;
+
+	DWORD base;					// oldest packet not acknowledged
+	DWORD sendNext;				// next packet to send for the first time
+	DWORD next;					// next packet to store
+	DWORD highSacked;			// one past the highest packet acknowledged
+	DWORD scanFrom;				// first packet not yet checked for loss
+	DWORD recoveryPoint;		// losses before this belong to the current window
+	BOOL recovery;
+	DWORD inFlight;
+	DWORD peerWindow;
+	BOOL blocked;				// the socket's send buffer was full
+
+	// congestion control, in packets
+	CONGESTION_CONTROL *cc;
+	double cwnd;
+	double ssthresh;
+	double wMax;				// cubic: window before the last reduction
+	double k;					// cubic: seconds to grow back to wMax
+	LONGLONG epoch;				// cubic: start of the current growth period, 0 for none
+
+	// round trip, in milliseconds
+	double srtt;
+	double rttvar;
+	double rto;
+	double minRtt;
+	LONGLONG frequency;
+	LONGLONG start;
+	LONGLONG lastProgress;		// latest ack that acknowledged new packets
+	LONGLONG nextTimerCheck;
+	BOOL finAcked;
+	BOOL failed;				// no progress for RELIABLE_GIVE_UP
+
+	// counters
+	ULONGLONG packets;			// transmissions, first and repeated
+	ULONGLONG retransmits;
+	ULONGLONG fastRetransmits;	// losses found by SACK
+	ULONGLONG timeouts;
+	ULONGLONG lossEvents;
+	ULONGLONG acks;
+	ULONGLONG bytes;			// payload bytes acknowledged
+	ULONGLONG sendErrors;
+	double maxCwnd;
+} RELIABLE_SENDER;
+
+typedef struct _RELIABLE_RECEIVER {
+	DWORD connection;			// 0 before the first transfer
+	SOCKADDR_IN peer;
+	DWORD next;					// every packet before this has arrived
+	DWORD high;					// one past the highest packet seen
+	DWORD echo;					// timestamp for the next ack
+	DWORD unacked;				// in-order packets since the last ack
+	DWORD total;				// packets sent, from the FIN
+	BOOL closing;				// FIN seen
+	BOOL complete;				// reported, either finished or abandoned
+	BOOL abandoned;
+	ULONGLONG lastArrival;		// FILETIME
+	ULONGLONG received[RELIABLE_WINDOW / 64];	// bitmap of packets from next on
+	BOOL saving;				// payloads go to a PAYLOAD_HANDLER, so early ones are held
+	char *held[RELIABLE_WINDOW];	// out-of-order payloads kept for saving
+	DWORD heldLength[RELIABLE_WINDOW];
+	DWORD heldCount;
+
+	// counters
+	ULONGLONG packets;
+	ULONGLONG bytes;			// payload bytes, counted once
+	ULONGLONG duplicates;
+	ULONGLONG outOfOrder;
+	ULONGLONG refused;			// beyond the window, or no room to hold them
+	ULONGLONG acks;
+} RELIABLE_RECEIVER;
+
+BOOL startReliable(RELIABLE_SENDER *, SOCKET, SOCKADDR_IN *, DWORD, char *, IMPAIRMENT *);
+char *reliableBuffer(RELIABLE_SENDER *);
+void reliableSend(RELIABLE_SENDER *, DWORD);
+BOOL finishReliable(RELIABLE_SENDER *);
+void stopReliable(RELIABLE_SENDER *);
+void logReliable(RELIABLE_SENDER *, HANDLE);
+BOOL isReliable(char *, DWORD);
+BOOL reliableReceive(RELIABLE_RECEIVER *, SOCKET, char *, DWORD, SOCKADDR_IN *, TRANSFER_STATS *, PAYLOAD_HANDLER);
+BOOL reliableTick(RELIABLE_RECEIVER *, SOCKET, ULONGLONG);
+BOOL reliableSupersedes(RELIABLE_RECEIVER *, char *);
+void logReceiver(RELIABLE_RECEIVER *, HANDLE);
+void resetReceiver(RELIABLE_RECEIVER *);
\ No newline at end of file
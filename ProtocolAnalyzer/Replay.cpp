@@ -0,0 +1,922 @@
+/*---------------------------------------------------------------------------------
+--	SOURCE FILE:	Replay.cpp -
+--
+--	PROGRAM:		Transport Layer Protocol Analyser
+--
+--	FUNCTIONS:
+--					BOOL openReplay(HANDLE file, int protocol, REPLAY *replay)
+--					void replayCapture(REPLAY *replay, SOCKET sd, struct sockaddr_in *server, double speed, int passes, REPLAY_RESULT *result)
+--					void closeReplay(REPLAY *replay)
+--					BYTE *mapRange(REPLAY *replay, ULONGLONG offset, DWORD length)
+--					BOOL indexPcap(REPLAY *replay, int protocol)
+--					BOOL indexPcapng(REPLAY *replay, int protocol)
+--					BOOL addPacket(REPLAY *replay, int protocol, int linkType, ULONGLONG offset, BYTE *data,
+--						DWORD captured, DWORD original, ULONGLONG time)
+--					BOOL findPayload(BYTE *data, DWORD captured, int linkType, int protocol, DWORD *start,
+--						DWORD *length, REPLAY_FLOW *flow)
+--					BOOL newBytes(REPLAY *replay, REPLAY_FLOW *flow, DWORD *start, DWORD *length)
+--					ULONGLONG toNanoseconds(ULONGLONG ticks, ULONGLONG unitsPerSecond)
+--					DWORD fileDword(REPLAY *replay, BYTE *data)
+--					WORD fileWord(REPLAY *replay, BYTE *data)
+--
+--	DATE:			Oct 19, 2026
+--
+--	REVISIONS:		Oct 19, 2026
+--
+--	DESIGNER:		Gabriella Cheung
+--
+--	PROGRAMMER:		Gabriella Cheung
+--
+--	NOTES:
+--	This file replays the UDP or TCP payloads of a pcap or pcapng capture as the
+--  client's traffic. The file is never read into memory. It is mapped
+--  REPLAY_WINDOW bytes at a time, which also works for 32-bit builds. Opening the
+--  capture walks it once and builds an index holding each payload's file offset,
+--  length and send time. Sends are then made straight from the mapped view.
+--
+--  Ethernet (with VLAN tags), raw IP, BSD loopback and Linux cooked captures are
+--  understood, over IPv4 or IPv6. IP fragments and IPv6 extension headers are
+--  skipped. Only one direction is replayed: payloads sent to the destination
+--  port of the first one, which is normally the server's. TCP payloads are
+--  replayed in capture order, and bytes a connection already carried, which
+--  were retransmitted, are left out.
+--
+---------------------------------------------------------------------------------*/
+#include "resource.h"
+
+#define PCAP_MAGIC				0xA1B2C3D4
+#define PCAP_MAGIC_NS			0xA1B23C4D
+#define PCAPNG_SECTION_HEADER	0x0A0D0D0A
+#define PCAPNG_INTERFACE		0x00000001
+#define PCAPNG_PACKET			0x00000002
+#define PCAPNG_SIMPLE_PACKET	0x00000003
+#define PCAPNG_ENHANCED_PACKET	0x00000006
+#define PCAPNG_BYTE_ORDER		0x1A2B3C4D
+
+#define LINKTYPE_NULL			0
+#define LINKTYPE_RAW_OLD		12
+#define LINKTYPE_RAW			101
+#define LINKTYPE_LINUX_SLL		113
+#define LINKTYPE_IPV4			228
+#define LINKTYPE_IPV6			229
+#define LINKTYPE_LINUX_SLL2		276
+
+BYTE *mapRange(REPLAY *, ULONGLONG, DWORD);
+BOOL indexPcap(REPLAY *, int);
+BOOL indexPcapng(REPLAY *, int);
+BOOL addPacket(REPLAY *, int, int, ULONGLONG, BYTE *, DWORD, DWORD, ULONGLONG);
+BOOL findPayload(BYTE *, DWORD, int, int, DWORD *, DWORD *, REPLAY_FLOW *);
+BOOL newBytes(REPLAY *, REPLAY_FLOW *, DWORD *, DWORD *);
+ULONGLONG toNanoseconds(ULONGLONG, ULONGLONG);
+DWORD fileDword(REPLAY *, BYTE *);
+WORD fileWord(REPLAY *, BYTE *);
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: openReplay
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	BOOL openReplay(HANDLE file, int protocol, REPLAY *replay)
+--
+--	PARAMETERS:	HANDLE file - capture file opened for reading
+--				int protocol - IPPROTO_UDP or IPPROTO_TCP, the payloads to replay
+--				REPLAY *replay - filled with the mapping and the packet index
+--
+--	RETURNS:	TRUE if the capture holds at least one payload to replay
+--
+--	NOTES:
+--	Maps the file and indexes every packet of the requested protocol.
+--
+---------------------------------------------------------------------------------*/
+BOOL openReplay(HANDLE file, int protocol, REPLAY *replay)
+{
+	LARGE_INTEGER size;
+	SYSTEM_INFO system;
+	BYTE *magic;
+	BOOL indexed;
+	char message[256];
+
+	ZeroMemory(replay, sizeof(REPLAY));
+	if (file == NULL || !GetFileSizeEx(file, &size) || size.QuadPart < 24)
+	{
+		writeToScreen("Capture file is empty");
+		return FALSE;
+	}
+	if ((replay->mapping = CreateFileMapping(file, NULL, PAGE_READONLY, 0, 0, NULL)) == NULL)
+	{
+		sprintf(message, "CreateFileMapping failed with error %d", GetLastError());
+		writeToScreen(message);
+		return FALSE;
+	}
+	GetSystemInfo(&system);
+	replay->granularity = system.dwAllocationGranularity;
+	replay->fileSize = size.QuadPart;
+
+	if ((magic = mapRange(replay, 0, 4)) == NULL)
+	{
+		closeReplay(replay);
+		return FALSE;
+	}
+	if (*(DWORD *)magic == PCAPNG_SECTION_HEADER)
+	{
+		indexed = indexPcapng(replay, protocol);
+	}
+	else {
+		indexed = indexPcap(replay, protocol);
+	}
+	if (!indexed || replay->count == 0)
+	{
+		writeToScreen(indexed ? "Capture has no payloads for this protocol" : "File is not a pcap or pcapng capture");
+		closeReplay(replay);
+		return FALSE;
+	}
+	return TRUE;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: replayCapture
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--				Oct 19, 2026 - stops with the transfer
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void replayCapture(REPLAY *replay, SOCKET sd, struct sockaddr_in *server,
+--					double speed, int passes, REPLAY_RESULT *result)
+--
+--	PARAMETERS:	REPLAY *replay - indexed capture from openReplay
+--				SOCKET sd - socket to send on
+--				struct sockaddr_in *server - destination for datagrams, NULL for a
+--											 connected TCP socket
+--				double speed - multiplier on the capture's timing, 0 to send as
+--							   fast as the socket allows
+--				int passes - number of times to send the whole capture
+--				REPLAY_RESULT *result - receives counts and timing error
+--
+--	RETURNS:	none
+--
+--	NOTES:
+--	Every packet has a send time on the capture's schedule, divided by speed.
+--  The loop sleeps while a send is more than REPLAY_SPIN_NS away, because Sleep
+--  can overshoot by a whole scheduler tick, and spins for the rest. The timing
+--  error of a send is how far it was behind its scheduled time.
+--
+---------------------------------------------------------------------------------*/
+void replayCapture(REPLAY *replay, SOCKET sd, struct sockaddr_in *server, double speed, int passes, REPLAY_RESULT *result)
+{
+	LARGE_INTEGER frequency, start, now;
+	ULONGLONG target = 0, elapsed, error;
+	REPLAY_PACKET *packet;
+	BYTE *payload;
+	int sent;
+
+	ZeroMemory(result, sizeof(REPLAY_RESULT));
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&start);
+	for (int pass = 0; pass < passes; pass++)
+	{
+		for (DWORD i = 0; i < replay->count; i++)
+		{
+			packet = &replay->index[i];
+			if (transferStopping || (payload = mapRange(replay, packet->offset, packet->length)) == NULL)
+			{
+				passes = 0;
+				break;
+			}
+			if (speed > 0)
+			{
+				target = result->schedule + (ULONGLONG)(packet->time / speed);
+				while (true)
+				{
+					QueryPerformanceCounter(&now);
+					elapsed = toNanoseconds(now.QuadPart - start.QuadPart, frequency.QuadPart);
+					if (elapsed >= target)
+					{
+						break;
+					}
+					if (target - elapsed > REPLAY_SPIN_NS)
+					{
+						Sleep((DWORD)((target - elapsed - REPLAY_SPIN_NS) / 1000000));
+					}
+					else {
+						YieldProcessor();
+					}
+				}
+				error = elapsed - target;
+				result->totalError += error;
+				if (error > result->maxError)
+				{
+					result->maxError = error;
+				}
+				if (error > REPLAY_LATE_NS)
+				{
+					result->late++;
+				}
+			}
+
+			if (server != NULL)
+			{
+				sent = sendto(sd, (char *)payload, packet->length, 0, (struct sockaddr *)server, sizeof(*server));
+			}
+			else {
+				sent = send(sd, (char *)payload, packet->length, 0);
+			}
+			if (sent == SOCKET_ERROR)
+			{
+				result->errors++;
+				continue;
+			}
+			result->packets++;
+			result->bytes += packet->length;
+		}
+		//the next pass starts where this one's schedule ended
+		result->schedule += (ULONGLONG)(replay->index[replay->count - 1].time / (speed > 0 ? speed : 1));
+	}
+	QueryPerformanceCounter(&now);
+	result->elapsed = toNanoseconds(now.QuadPart - start.QuadPart, frequency.QuadPart);
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: closeReplay
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void closeReplay(REPLAY *replay)
+--
+--	PARAMETERS:	REPLAY *replay - capture opened by openReplay
+--
+--	RETURNS:	none
+--
+--	NOTES:
+--	Unmaps the file and frees the index. The file handle belongs to the caller.
+--
+---------------------------------------------------------------------------------*/
+void closeReplay(REPLAY *replay)
+{
+	if (replay->view != NULL)
+	{
+		UnmapViewOfFile(replay->view);
+	}
+	if (replay->mapping != NULL)
+	{
+		CloseHandle(replay->mapping);
+	}
+	free(replay->index);
+	ZeroMemory(replay, sizeof(REPLAY));
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: mapRange
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	BYTE *mapRange(REPLAY *replay, ULONGLONG offset, DWORD length)
+--
+--	PARAMETERS:	REPLAY *replay - mapped capture
+--				ULONGLONG offset - first byte needed
+--				DWORD length - number of bytes needed
+--
+--	RETURNS:	a pointer to the bytes, or NULL if they are past the end of the file
+--
+--	NOTES:
+--	Moves the window when the range is not already mapped. A pointer from an
+--  earlier call is only valid until the next one.
+--
+---------------------------------------------------------------------------------*/
+BYTE *mapRange(REPLAY *replay, ULONGLONG offset, DWORD length)
+{
+	ULONGLONG start;
+	ULONGLONG size;
+
+	if (offset + length > replay->fileSize)
+	{
+		return NULL;
+	}
+	if (replay->view != NULL && offset >= replay->viewOffset && offset + length <= replay->viewOffset + replay->viewSize)
+	{
+		return (BYTE *)replay->view + (offset - replay->viewOffset);
+	}
+	if (replay->view != NULL)
+	{
+		UnmapViewOfFile(replay->view);
+	}
+	start = offset - offset % replay->granularity;
+	size = REPLAY_WINDOW;
+	if (offset + length - start > size)
+	{
+		size = offset + length - start;
+	}
+	if (start + size > replay->fileSize)
+	{
+		size = replay->fileSize - start;
+	}
+	if ((replay->view = (char *)MapViewOfFile(replay->mapping, FILE_MAP_READ, (DWORD)(start >> 32), (DWORD)start, (SIZE_T)size)) == NULL)
+	{
+		writeToScreen("Unable to map capture file");
+		return NULL;
+	}
+	replay->viewOffset = start;
+	replay->viewSize = (DWORD)size;
+	return (BYTE *)replay->view + (offset - start);
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: indexPcap
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	BOOL indexPcap(REPLAY *replay, int protocol)
+--
+--	PARAMETERS:	REPLAY *replay - mapped capture
+--				int protocol - IPPROTO_UDP or IPPROTO_TCP
+--
+--	RETURNS:	FALSE if the file is not a pcap file
+--
+--	NOTES:
+--	Reads a classic pcap file with microsecond or nanosecond timestamps in
+--  either byte order.
+--
+---------------------------------------------------------------------------------*/
+BOOL indexPcap(REPLAY *replay, int protocol)
+{
+	BYTE *header;
+	DWORD magic, captured, original;
+	ULONGLONG offset, subsecond;
+	int linkType;
+
+	header = mapRange(replay, 0, 24);
+	magic = *(DWORD *)header;
+	if (magic == PCAP_MAGIC || magic == PCAP_MAGIC_NS)
+	{
+		replay->swapped = false;
+	}
+	else if (magic == _byteswap_ulong(PCAP_MAGIC) || magic == _byteswap_ulong(PCAP_MAGIC_NS))
+	{
+		replay->swapped = true;
+		magic = _byteswap_ulong(magic);
+	}
+	else {
+		return FALSE;
+	}
+	subsecond = magic == PCAP_MAGIC_NS ? 1 : 1000;
+	linkType = fileDword(replay, header + 20) & 0x0FFFFFFF;
+
+	for (offset = 24; (header = mapRange(replay, offset, 16)) != NULL; offset += 16 + captured)
+	{
+		ULONGLONG time = fileDword(replay, header) * 1000000000ULL + fileDword(replay, header + 4) * subsecond;
+		captured = fileDword(replay, header + 8);
+		original = fileDword(replay, header + 12);
+		if ((header = mapRange(replay, offset + 16, captured)) == NULL)
+		{
+			break;
+		}
+		if (!addPacket(replay, protocol, linkType, offset + 16, header, captured, original, time))
+		{
+			return TRUE;
+		}
+	}
+	return TRUE;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: indexPcapng
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	BOOL indexPcapng(REPLAY *replay, int protocol)
+--
+--	PARAMETERS:	REPLAY *replay - mapped capture
+--				int protocol - IPPROTO_UDP or IPPROTO_TCP
+--
+--	RETURNS:	FALSE if the file does not start with a section header block
+--
+--	NOTES:
+--	Walks the blocks of every section. Interface description blocks give the
+--  link type and timestamp resolution of the packets that refer to them.
+--  Simple packet blocks have no timestamp and take the previous packet's.
+--
+---------------------------------------------------------------------------------*/
+BOOL indexPcapng(REPLAY *replay, int protocol)
+{
+	BYTE *block;
+	DWORD type, length, captured, original, interfaceId;
+	ULONGLONG offset = 0, time = 0, ticks;
+	WORD code, size = 0;
+	REPLAY_INTERFACE *iface;
+
+	while ((block = mapRange(replay, offset, 12)) != NULL)
+	{
+		type = *(DWORD *)block;
+		if (type == PCAPNG_SECTION_HEADER)
+		{
+			//the byte order mark decides how the rest of the section is read
+			replay->swapped = *(DWORD *)(block + 8) != PCAPNG_BYTE_ORDER;
+			replay->interfaceCount = 0;
+		}
+		else if (offset == 0)
+		{
+			return FALSE;
+		}
+		type = fileDword(replay, block);
+		length = fileDword(replay, block + 4);
+		if (length < 12 || (block = mapRange(replay, offset, length)) == NULL)
+		{
+			break;
+		}
+
+		switch (type)
+		{
+		case PCAPNG_INTERFACE:
+			if (replay->interfaceCount == REPLAY_INTERFACES || length < 20)
+			{
+				break;
+			}
+			iface = &replay->interfaces[replay->interfaceCount++];
+			iface->linkType = fileWord(replay, block + 8);
+			iface->unitsPerSecond = 1000000;
+			for (DWORD option = 16; option + 4 <= length - 4; option += 4 + ((size + 3) & ~3))
+			{
+				code = fileWord(replay, block + option);
+				size = fileWord(replay, block + option + 2);
+				if (code == 0)
+				{
+					break;
+				}
+				if (code == 9 && size == 1)
+				{
+					BYTE resolution = block[option + 4];
+					ULONGLONG units = 1;
+					if (resolution & 0x80)
+					{
+						units <<= (resolution & 0x7F) < 63 ? (resolution & 0x7F) : 63;
+					}
+					else {
+						for (int i = 0; i < (resolution < 19 ? resolution : 19); i++)
+						{
+							units *= 10;
+						}
+					}
+					iface->unitsPerSecond = units;
+				}
+			}
+			break;
+		case PCAPNG_ENHANCED_PACKET:
+		case PCAPNG_PACKET:
+			if (length < 32)
+			{
+				break;
+			}
+			interfaceId = type == PCAPNG_PACKET ? fileWord(replay, block + 8) : fileDword(replay, block + 8);
+			ticks = ((ULONGLONG)fileDword(replay, block + 12) << 32) | fileDword(replay, block + 16);
+			captured = fileDword(replay, block + 20);
+			original = fileDword(replay, block + 24);
+			if (interfaceId >= (DWORD)replay->interfaceCount || captured > length - 32)
+			{
+				replay->skipped++;
+				break;
+			}
+			iface = &replay->interfaces[interfaceId];
+			time = toNanoseconds(ticks, iface->unitsPerSecond);
+			if (!addPacket(replay, protocol, iface->linkType, offset + 28, block + 28, captured, original, time))
+			{
+				return TRUE;
+			}
+			break;
+		case PCAPNG_SIMPLE_PACKET:
+			if (length < 16 || replay->interfaceCount == 0)
+			{
+				break;
+			}
+			original = fileDword(replay, block + 8);
+			captured = original < length - 16 ? original : length - 16;
+			if (!addPacket(replay, protocol, replay->interfaces[0].linkType, offset + 12, block + 12, captured, original, time))
+			{
+				return TRUE;
+			}
+			break;
+		}
+		offset += length;
+	}
+	return TRUE;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: addPacket
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--				Oct 19, 2026 - Skip the other direction and retransmitted TCP bytes
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	BOOL addPacket(REPLAY *replay, int protocol, int linkType, ULONGLONG offset,
+--					BYTE *data, DWORD captured, DWORD original, ULONGLONG time)
+--
+--	PARAMETERS:	REPLAY *replay - capture being indexed
+--				int protocol - IPPROTO_UDP or IPPROTO_TCP
+--				int linkType - link type of the packet
+--				ULONGLONG offset - file offset of the packet data
+--				BYTE *data - mapped packet data
+--				DWORD captured - bytes of the packet in the file
+--				DWORD original - bytes of the packet on the wire
+--				ULONGLONG time - capture timestamp in ns
+--
+--	RETURNS:	FALSE if the index could not grow
+--
+--	NOTES:
+--	Indexes the packet's payload if it carries one of the requested protocol
+--  and goes the same way as the first payload. A TCP payload only keeps the
+--  bytes its connection has not carried yet. Times are kept relative to the
+--  first indexed packet and never go backwards.
+--
+---------------------------------------------------------------------------------*/
+BOOL addPacket(REPLAY *replay, int protocol, int linkType, ULONGLONG offset, BYTE *data, DWORD captured, DWORD original, ULONGLONG time)
+{
+	REPLAY_PACKET *packet;
+	REPLAY_FLOW flow;
+	DWORD start, length;
+
+	if (!findPayload(data, captured, linkType, protocol, &start, &length, &flow))
+	{
+		replay->skipped++;
+		return TRUE;
+	}
+	if (length == 0)
+	{
+		return TRUE;
+	}
+	if (replay->serverPort == 0)
+	{
+		replay->serverPort = flow.destinationPort;
+	}
+	if (flow.destinationPort != replay->serverPort)
+	{
+		replay->replies++;
+		return TRUE;
+	}
+	if (protocol == IPPROTO_TCP && !newBytes(replay, &flow, &start, &length))
+	{
+		replay->retransmitted++;
+		return TRUE;
+	}
+	if (captured < original)
+	{
+		replay->truncated++;
+	}
+	if (replay->count == replay->capacity)
+	{
+		DWORD capacity = replay->capacity > 0 ? replay->capacity * 2 : 4096;
+		if ((packet = (REPLAY_PACKET *)realloc(replay->index, capacity * sizeof(REPLAY_PACKET))) == NULL)
+		{
+			writeToScreen("Capture index is too large, replaying the packets indexed so far");
+			return FALSE;
+		}
+		replay->index = packet;
+		replay->capacity = capacity;
+	}
+	if (replay->count == 0)
+	{
+		replay->firstTime = time;
+	}
+	packet = &replay->index[replay->count];
+	packet->offset = offset + start;
+	packet->length = length;
+	packet->time = time > replay->firstTime ? time - replay->firstTime : 0;
+	if (replay->count > 0 && packet->time < packet[-1].time)
+	{
+		packet->time = packet[-1].time;
+	}
+	replay->count++;
+	return TRUE;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: findPayload
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--				Oct 19, 2026 - Also report the addresses, ports and TCP sequence number
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	BOOL findPayload(BYTE *data, DWORD captured, int linkType, int protocol,
+--					DWORD *start, DWORD *length, REPLAY_FLOW *flow)
+--
+--	PARAMETERS:	BYTE *data - packet data from the capture
+--				DWORD captured - bytes of packet data
+--				int linkType - link type of the packet
+--				int protocol - IPPROTO_UDP or IPPROTO_TCP
+--				DWORD *start - offset of the payload in the packet
+--				DWORD *length - payload bytes present in the capture
+--				REPLAY_FLOW *flow - receives the addresses and ports, and for
+--								TCP the sequence number of the payload
+--
+--	RETURNS:	TRUE if the packet carries the protocol
+--
+--	NOTES:
+--	Header fields are read a byte at a time since nothing in a capture is
+--  aligned.
+--
+---------------------------------------------------------------------------------*/
+BOOL findPayload(BYTE *data, DWORD captured, int linkType, int protocol, DWORD *start, DWORD *length, REPLAY_FLOW *flow)
+{
+	DWORD ip = 0, transport, end, header;
+	WORD etherType = 0;
+	BYTE next;
+
+	switch (linkType)
+	{
+	case LINKTYPE_ETHERNET:
+		ip = 14;
+		if (captured < ip)
+		{
+			return FALSE;
+		}
+		etherType = (data[12] << 8) | data[13];
+		while ((etherType == 0x8100 || etherType == 0x88A8 || etherType == 0x9100) && captured >= ip + 4)
+		{
+			etherType = (data[ip + 2] << 8) | data[ip + 3];
+			ip += 4;
+		}
+		if (etherType != 0x0800 && etherType != 0x86DD)
+		{
+			return FALSE;
+		}
+		break;
+	case LINKTYPE_NULL:
+		ip = 4;
+		break;
+	case LINKTYPE_LINUX_SLL:
+		ip = 16;
+		break;
+	case LINKTYPE_LINUX_SLL2:
+		ip = 20;
+		break;
+	case LINKTYPE_RAW_OLD:
+	case LINKTYPE_RAW:
+	case LINKTYPE_IPV4:
+	case LINKTYPE_IPV6:
+		ip = 0;
+		break;
+	default:
+		return FALSE;
+	}
+	if (captured < ip + 20)
+	{
+		return FALSE;
+	}
+
+	if ((data[ip] >> 4) == 4)
+	{
+		header = (data[ip] & 0x0F) * 4;
+		//skip fragments, only the first one has the transport header
+		if (header < 20 || (((data[ip + 6] << 8) | data[ip + 7]) & 0x3FFF) != 0)
+		{
+			return FALSE;
+		}
+		next = data[ip + 9];
+		transport = ip + header;
+		end = ip + ((data[ip + 2] << 8) | data[ip + 3]);
+		ZeroMemory(flow, sizeof(REPLAY_FLOW));
+		memcpy(flow->source, data + ip + 12, 4);
+		memcpy(flow->destination, data + ip + 16, 4);
+	}
+	else if ((data[ip] >> 4) == 6 && captured >= ip + 40)
+	{
+		next = data[ip + 6];
+		transport = ip + 40;
+		end = transport + ((data[ip + 4] << 8) | data[ip + 5]);
+		memcpy(flow->source, data + ip + 8, 16);
+		memcpy(flow->destination, data + ip + 24, 16);
+	}
+	else {
+		return FALSE;
+	}
+	if (next != protocol || end < transport)
+	{
+		return FALSE;
+	}
+
+	if (protocol == IPPROTO_UDP)
+	{
+		if (captured < transport + 8)
+		{
+			return FALSE;
+		}
+		*start = transport + 8;
+		end = transport + ((data[transport + 4] << 8) | data[transport + 5]);
+	}
+	else {
+		if (captured < transport + 20)
+		{
+			return FALSE;
+		}
+		*start = transport + (data[transport + 12] >> 4) * 4;
+		flow->sequence = (data[transport + 4] << 24) | (data[transport + 5] << 16) | (data[transport + 6] << 8) | data[transport + 7];
+	}
+	flow->sourcePort = (data[transport] << 8) | data[transport + 1];
+	flow->destinationPort = (data[transport + 2] << 8) | data[transport + 3];
+	//the payload ends at the IP length or wherever the capture cut it off
+	if (end > captured)
+	{
+		end = captured;
+	}
+	*length = end > *start ? end - *start : 0;
+	return TRUE;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: newBytes
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	BOOL newBytes(REPLAY *replay, REPLAY_FLOW *flow, DWORD *start, DWORD *length)
+--
+--	PARAMETERS:	REPLAY *replay - capture being indexed
+--				REPLAY_FLOW *flow - the segment's connection and sequence number
+--				DWORD *start - offset of the payload in the packet, moved past
+--								bytes already queued
+--				DWORD *length - payload bytes, less those already queued
+--
+--	RETURNS:	FALSE if every byte of the segment was queued before
+--
+--	NOTES:
+--	Each connection remembers the sequence number after the last byte queued
+--  from it, compared modulo 2^32. A segment that starts below it was
+--  retransmitted, in whole or in part. Once REPLAY_FLOWS connections are
+--  known, further ones are queued as captured.
+--
+---------------------------------------------------------------------------------*/
+BOOL newBytes(REPLAY *replay, REPLAY_FLOW *flow, DWORD *start, DWORD *length)
+{
+	REPLAY_FLOW *known = NULL;
+	DWORD end = flow->sequence + *length;
+	DWORD sent;
+
+	for (int i = 0; i < replay->flowCount; i++)
+	{
+		if (replay->flows[i].sourcePort == flow->sourcePort && replay->flows[i].destinationPort == flow->destinationPort
+			&& memcmp(replay->flows[i].source, flow->source, 16) == 0
+			&& memcmp(replay->flows[i].destination, flow->destination, 16) == 0)
+		{
+			known = &replay->flows[i];
+			break;
+		}
+	}
+	if (known == NULL)
+	{
+		if (replay->flowCount < REPLAY_FLOWS)
+		{
+			known = &replay->flows[replay->flowCount++];
+			*known = *flow;
+			known->sequence = end;
+		}
+		return TRUE;
+	}
+	if ((LONG)(end - known->sequence) <= 0)
+	{
+		return FALSE;
+	}
+	if ((LONG)(known->sequence - flow->sequence) > 0)
+	{
+		sent = known->sequence - flow->sequence;
+		*start += sent;
+		*length -= sent;
+	}
+	known->sequence = end;
+	return TRUE;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: toNanoseconds
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	ULONGLONG toNanoseconds(ULONGLONG ticks, ULONGLONG unitsPerSecond)
+--
+--	PARAMETERS:	ULONGLONG ticks - a time in units of 1/unitsPerSecond seconds
+--				ULONGLONG unitsPerSecond - resolution of ticks
+--
+--	RETURNS:	the time in nanoseconds
+--
+--	NOTES:
+--	Whole seconds and the remainder are converted separately so the
+--  multiplication does not overflow.
+--
+---------------------------------------------------------------------------------*/
+ULONGLONG toNanoseconds(ULONGLONG ticks, ULONGLONG unitsPerSecond)
+{
+	if (unitsPerSecond > 1000000000ULL)
+	{
+		return ticks / (unitsPerSecond / 1000000000ULL);
+	}
+	return (ticks / unitsPerSecond) * 1000000000ULL + (ticks % unitsPerSecond) * 1000000000ULL / unitsPerSecond;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: fileDword
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	DWORD fileDword(REPLAY *replay, BYTE *data)
+--
+--	PARAMETERS:	REPLAY *replay - capture being read
+--				BYTE *data - 32-bit field in the capture's byte order
+--
+--	RETURNS:	the field in host byte order
+--
+--	NOTES:
+--	Capture headers are written in the byte order of the capturing machine.
+--
+---------------------------------------------------------------------------------*/
+DWORD fileDword(REPLAY *replay, BYTE *data)
+{
+	DWORD value = *(UNALIGNED DWORD *)data;
+	return replay->swapped ? _byteswap_ulong(value) : value;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: fileWord
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	WORD fileWord(REPLAY *replay, BYTE *data)
+--
+--	PARAMETERS:	REPLAY *replay - capture being read
+--				BYTE *data - 16-bit field in the capture's byte order
+--
+--	RETURNS:	the field in host byte order
+--
+--	NOTES:
+--	See fileDword.
+--
+---------------------------------------------------------------------------------*/
+WORD fileWord(REPLAY *replay, BYTE *data)
+{
+	WORD value = *(UNALIGNED WORD *)data;
+	return replay->swapped ? _byteswap_ushort(value) : value;
+}
\ No newline at end of file
@@ -0,0 +1,65 @@
+#pragma once
+
+#define REPLAY_WINDOW			(64*1024*1024)	//bytes of the capture mapped at a time
+#define REPLAY_INTERFACES		32
+#define REPLAY_SPIN_NS			20000000		//wait this close to a send by spinning instead of Sleep
+#define REPLAY_LATE_NS			1000000			//sends later than this count as late
+#define REPLAY_FLOWS			256				//TCP connections whose retransmits are recognised
+
+typedef struct _REPLAY_PACKET {
+	ULONGLONG offset;			// file offset of the UDP or TCP payload
+	ULONGLONG time;				// ns after the first replayed packet
+	DWORD length;
+} REPLAY_PACKET;
+
+// One direction of a TCP connection in the capture.
+typedef struct _REPLAY_FLOW {
+	BYTE source[16];			// IPv4 addresses take the first 4 bytes
+	BYTE destination[16];
+	WORD sourcePort;			// host order
+	WORD destinationPort;
+	DWORD sequence;				// of the first byte, then of the byte after the last queued one
+} REPLAY_FLOW;
+
+typedef struct _REPLAY_INTERFACE {
+	int linkType;
+	ULONGLONG unitsPerSecond;	// timestamp resolution
+} REPLAY_INTERFACE;
+
+typedef struct _REPLAY {
+	HANDLE mapping;
+	ULONGLONG fileSize;
+	char *view;					// current window of the file
+	ULONGLONG viewOffset;
+	DWORD viewSize;
+	DWORD granularity;
+	BOOL swapped;				// section was written with the other byte order
+	REPLAY_INTERFACE interfaces[REPLAY_INTERFACES];
+	int interfaceCount;
+	REPLAY_PACKET *index;
+	DWORD count;
+	DWORD capacity;
+	ULONGLONG firstTime;		// capture timestamp of the first indexed packet, ns
+	DWORD skipped;				// packets of another protocol or link type
+	DWORD truncated;			// packets captured shorter than they were sent
+	WORD serverPort;			// destination port of the first payload, 0 until it is seen
+	DWORD replies;				// payloads sent to another port, the other direction
+	DWORD retransmitted;		// TCP payloads already queued once
+	REPLAY_FLOW flows[REPLAY_FLOWS];
+	int flowCount;
+} REPLAY;
+
+typedef struct _REPLAY_RESULT {
+	ULONGLONG packets;
+	ULONGLONG bytes;
+	ULONGLONG schedule;			// ns the capture spans at the requested speed
+	ULONGLONG elapsed;			// ns the replay took
+	ULONGLONG totalError;		// ns, summed over paced sends
+	ULONGLONG maxError;
+	ULONGLONG late;				// paced sends more than REPLAY_LATE_NS behind
+	int errors;					// sends that failed
+} REPLAY_RESULT;
+
+BOOL openReplay(HANDLE, int, REPLAY *);
+void replayCapture(REPLAY *, SOCKET, struct sockaddr_in *, double, int, REPLAY_RESULT *);
+void closeReplay(REPLAY *);
\ No newline at end of file
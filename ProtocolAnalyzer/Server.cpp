@@ -10,13 +10,36 @@
 --					DWORD WINAPI startTCPServer(LPVOID)
 --					void CALLBACK tcpRoutine(DWORD, DWORD, LPOVERLAPPED, DWORD)
 --					DWORD WINAPI tcpThread(LPVOID)
---					long delay(SYSTEMTIME, SYSTEMTIME)
---					void displayStats(TRANSFER_STATS *)
---					void startServer(int udpPort, int tcpPort, HANDLE hFile)
+--					void displayStats(STATS_SNAPSHOT *)
+--					void displayGroups()
+--					void displayFlow(FLOW *flow)
+--					DWORD WINAPI statsSampler(LPVOID)
+--					void growReceiveBuffer()
+--					void savePayload(char *data, DWORD length)
+--					LPSOCKET_INFORMATION newSocketInfo(SOCKET socket, DWORD bufferSize)
+--					void freeSocketInfo(LPSOCKET_INFORMATION socketInfo)
+--					BOOL waitForData(LPSOCKET_INFORMATION socketInfo)
+--					BOOL readConnection(LPSOCKET_INFORMATION socketInfo)
+--					void closeConnection(LPSOCKET_INFORMATION socketInfo)
+--					void startServer(int udpPort, int tcpPort, HANDLE hFile, SERVER_OPTIONS *options)
+--					DWORD WINAPI startUnixServer(LPVOID)
+--					DWORD WINAPI ringThread(LPVOID)
+--					void reportLocal(TRANSFER_STATS *stats)
+--					void compareTransports(STATS_SNAPSHOT *stats)
+--					void reportReliable()
+--					DWORD WINAPI pollThread(LPVOID)
+--					int waitForPoll(LONG seconds)
+--					void displayLatency(STATS_SNAPSHOT *stats)
+--					void compareReceiveModes(STATS_SNAPSHOT *stats)
+--					DWORD WINAPI passiveThread(LPVOID)
+--					void passiveBatch(PACKET_BATCH *batch)
+--					void reportPassive(TRANSFER_STATS *stats)
+--					void displayConversation(CONVERSATION *conversation)
 --
 --	DATE:			Feb 14, 2016
 --
 --	REVISIONS:		Feb 14, 2016
+--					Oct 19, 2026 - statistics moved to sharded counters in Stats.cpp
 --
 --	DESIGNER:		Gabriella Cheung
 --
@@ -32,6 +55,24 @@
 --  While the server is running, it will continue to display statistics obtained
 --  from the data transfers onto the screen.
 --
+--  Two more threads receive the same stream over a Unix domain socket and a
+--  shared-memory ring, found from the TCP port, as baselines without the
+--  network stack. Every report ends with the latest transfer of each
+--  transport side by side.
+--
+--  Reliable UDP transfers (see Reliable.cpp) arrive on the UDP socket; their
+--  packets are acknowledged from the UDP thread and counted as a transport
+--  of their own.
+--
+--  In busy-poll mode a single thread spins on non-blocking receives from the
+--  UDP socket instead, and only blocks once nothing has arrived for the
+--  configured spin time. The latency of timed datagrams is reported for each
+--  receive mode so the two can be compared.
+--
+--  Given an interface, one more thread watches the TCP and UDP traffic
+--  passing through it (see Passive.cpp) and reports the flows it sees with the
+--  same statistics, whichever hosts are at their ends.
+--
 ---------------------------------------------------------------------------------*/
 #include "resource.h"
 
@@ -41,15 +82,66 @@ DWORD WINAPI udpThread(LPVOID);
 DWORD WINAPI startTCPServer(LPVOID);
 void CALLBACK tcpRoutine(DWORD, DWORD, LPOVERLAPPED, DWORD);
 DWORD WINAPI tcpThread(LPVOID);
-long delay(SYSTEMTIME, SYSTEMTIME);
-void displayStats(TRANSFER_STATS *);
+void displayStats(STATS_SNAPSHOT *);
+void displayGroups();
+void displayFlow(FLOW *);
+DWORD WINAPI statsSampler(LPVOID);
+void growReceiveBuffer();
+void savePayload(char *, DWORD);
+LPSOCKET_INFORMATION newSocketInfo(SOCKET, DWORD);
+void freeSocketInfo(LPSOCKET_INFORMATION);
+BOOL waitForData(LPSOCKET_INFORMATION);
+BOOL readConnection(LPSOCKET_INFORMATION);
+void closeConnection(LPSOCKET_INFORMATION);
+DWORD WINAPI startUnixServer(LPVOID);
+DWORD WINAPI ringThread(LPVOID);
+void reportLocal(TRANSFER_STATS *);
+void compareTransports(STATS_SNAPSHOT *);
+void reportReliable();
+DWORD WINAPI pollThread(LPVOID);
+int waitForPoll(LONG);
+void displayLatency(STATS_SNAPSHOT *);
+void compareReceiveModes(STATS_SNAPSHOT *);
+DWORD WINAPI passiveThread(LPVOID);
+void passiveBatch(PACKET_BATCH *);
+void reportPassive(TRANSFER_STATS *);
+void displayConversation(CONVERSATION *);
 
-SOCKET udpSocket, tcpSocket, tcpAcceptSocket;
-TRANSFER_STATS *tcpStats, *udpStats;
+SOCKET udpSocket, tcpSocket;
+SLIST_HEADER acceptedConnections;
+volatile LONG openConnections;
+volatile LONG sampledConnections;		//connections with a TCP_INFO series
+SIZE_T idleWorkingSet;
+TRANSFER_STATS tcpStats, udpStats, unixStats, ringStats, reliableStats;
+TRANSPORT_RESULT transports[TRANSPORTS] = { { "TCP" }, { "UDP" }, { "Unix stream" }, { "Shared memory" }, { "Reliable UDP" } };
+LATENCY_RESULT receiveModes[RECEIVE_MODES] = { { "event-driven" }, { "busy poll" } };
+volatile LONG polledDatagrams;
+BOOL receiveTimestamps;		//the kernel timestamps UDP receives
+BOOL receiveControl;		//UDP receives go through WSARecvMsg for their control data
+RELIABLE_RECEIVER reliable;
+SOCKET unixSocket = INVALID_SOCKET;
+char unixPath[UNIX_PATH_MAX];
 BOOL serverRunning = false;
 int uPort, tPort;
+SERVER_OPTIONS serverOptions;
+PLACEMENT placement;
+int udpReceiveBuffer;
 HANDLE hWriteFile, hServerLogFile;
+BOOL capturing;
+SOCKADDR_IN udpAddress;
 WSAEVENT udpEvent, tcpEvent;
+MULTICAST_GROUP groups[MULTICAST_MAX_GROUPS];
+int groupCount;
+LPFN_WSARECVMSG recvMsg;
+FLOW_TABLE udpFlows;
+HANDLE samplerThread;
+TRANSFER_STATS passiveTcpStats, passiveUdpStats;
+FLOW_TABLE passiveTcpFlows, passiveUdpFlows;
+CONVERSATION_TABLE passiveConversations;
+PASSIVE_FILTER passiveFilter;
+PASSIVE_CAPTURE passive;
+ULONGLONG passiveTcpLast, passiveUdpLast;	//FILETIME of each protocol's latest packet, 0 once reported
+HANDLE passiveThreadHandle;
 
 /*---------------------------------------------------------------------------------
 --	FUNCTION: startServer
@@ -57,37 +149,78 @@ WSAEVENT udpEvent, tcpEvent;
 --	DATE:		Feb 14, 2016
 --
 --	REVISIONS:	Feb 14, 2016
+--				Oct 19, 2026 - takes SERVER_OPTIONS
+--				Oct 19, 2026 - opens the pcapng capture
+--				Oct 19, 2026 - per-process log when receiving multicast
+--				Oct 19, 2026 - sets up and samples the statistics
+--				Oct 19, 2026 - starts the Unix socket and shared-memory servers
+--				Oct 19, 2026 - reliable UDP statistics
+--				Oct 19, 2026 - thread placement
+--				Oct 19, 2026 - passive capture
 --
 --	DESIGNER:	Gabriella Cheung
 --
 --	PROGRAMMER:	Gabriella Cheung
 --
---	INTERFACE:	void startServer(int udpPort, int tcpPort, HANDLE hFile)
+--	INTERFACE:	void startServer(int udpPort, int tcpPort, HANDLE hFile, SERVER_OPTIONS *options)
 --
 --	PARAMETERS:	int udpPort - port of UDP server as specified by user
 --				int tcpPort - port of TCP server as specified by user
---				HANDLE hFile - handle for file to read data from
+--				HANDLE hFile - handle for file to save received data to
+--				SERVER_OPTIONS *options - socket tuning options from the setup dialog
 --
 --	RETURNS:	void
 --
 --	NOTES:
 --	This function starts the server. First it initializes the Winsock 2.2 DLL, then
 --  it creates two threads, one for UDP and one for TCP. The rest of the work is
---  done by the two methods: startUDPServer and startTCPServer.
+--  done by the two methods: startUDPServer and startTCPServer. If pcapng output
+--  was selected, the save file receives whole packets instead of payloads.
+--  A server that joins multicast groups logs to a file named after its process,
+--  since other receivers of the same groups may be running alongside it.
+--  The statistics are set up here, before the threads that record and sample
+--  them start. The local transports are only baselines, so the TCP and UDP
+--  servers run even when they cannot start. The passive capture only starts
+--  when an interface was given.
 --
 ---------------------------------------------------------------------------------*/
-void startServer(int udpPort, int tcpPort, HANDLE hFile)
+void startServer(int udpPort, int tcpPort, HANDLE hFile, SERVER_OPTIONS *options)
 {
 	WSADATA wsaData;
 	WORD wVersionRequested = MAKEWORD(2, 2);
 	int error;
-	HANDLE udpThreadHandle, tcpThreadHandle;
-	DWORD udpThreadId, tcpThreadId;
+	HANDLE udpThreadHandle, tcpThreadHandle, unixThreadHandle, ringThreadHandle;
+	DWORD udpThreadId, tcpThreadId, samplerThreadId, unixThreadId, ringThreadId;
 	char message[256];
+	char logName[64] = "ServerLog.txt";
 
 	hWriteFile = hFile;
+	serverOptions = *options;
+	if (!parsePlacement(serverOptions.placement, &placement))
+	{
+		writeToScreen("Invalid placement");
+		return;
+	}
+	if (!parsePassiveFilter(serverOptions.passiveFilter, &passiveFilter))
+	{
+		writeToScreen("Invalid capture filter");
+		return;
+	}
+	resolvePlacement(&placement, serverOptions.multicastInterface[0] != '\0' ?
+		inet_addr(serverOptions.multicastInterface) : htonl(INADDR_ANY));
 
-	hServerLogFile = openFile("ServerLog.txt", false);
+	//several receivers of the same groups can run on one host, each with its own log
+	if (serverOptions.groups[0] != '\0')
+	{
+		sprintf(logName, "ServerLog-%lu.txt", GetCurrentProcessId());
+	}
+	hServerLogFile = openFile(logName, false);
+	logPlacement(&placement, hServerLogFile);
+	capturing = serverOptions.pcapng && openCapture(hWriteFile, &placement);
+	if (capturing)
+	{
+		writeToScreen("Saving received packets as pcapng");
+	}
 
 	// Initialize the DLL with version Winsock 2.2
 	error = WSAStartup(wVersionRequested, &wsaData);
@@ -97,6 +230,27 @@ void startServer(int udpPort, int tcpPort, HANDLE hFile)
 		return;
 	}
 	serverRunning = true;
+
+	//initialize stats before any thread can record or sample them
+	initStats(&tcpStats, "TCP");
+	setSteadyWindow(&tcpStats, serverOptions.warmup, serverOptions.cooldown);
+	initStats(&udpStats, "UDP");
+	setSteadyWindow(&udpStats, serverOptions.warmup, serverOptions.cooldown);
+	initStats(&unixStats, "Unix stream");
+	setSteadyWindow(&unixStats, serverOptions.warmup, serverOptions.cooldown);
+	initStats(&ringStats, "Shared memory");
+	setSteadyWindow(&ringStats, serverOptions.warmup, serverOptions.cooldown);
+	initStats(&reliableStats, "Reliable UDP");
+	setSteadyWindow(&reliableStats, serverOptions.warmup, serverOptions.cooldown);
+	initStats(&passiveTcpStats, "TCP (passive)");
+	setSteadyWindow(&passiveTcpStats, serverOptions.warmup, serverOptions.cooldown);
+	initStats(&passiveUdpStats, "UDP (passive)");
+	setSteadyWindow(&passiveUdpStats, serverOptions.warmup, serverOptions.cooldown);
+	if ((samplerThread = CreateThread(NULL, 0, statsSampler, NULL, 0, &samplerThreadId)) == NULL)
+	{
+		writeToScreen("Steady-state sampling unavailable");
+	}
+
 	sprintf(message, "Starting UDP Server using port %d", udpPort);
 	writeToScreen(message);
 	sprintf(message, "Starting TCP Server using port %d", tcpPort);
@@ -114,6 +268,19 @@ void startServer(int udpPort, int tcpPort, HANDLE hFile)
 		writeToScreen("UDP server initialization failed");
 		return;
 	}
+	if ((unixThreadHandle = CreateThread(NULL, 0, startUnixServer, (LPVOID)0, 0, &unixThreadId)) == NULL)
+	{
+		writeToScreen("Unix socket server initialization failed");
+	}
+	if ((ringThreadHandle = CreateThread(NULL, 0, ringThread, (LPVOID)0, 0, &ringThreadId)) == NULL)
+	{
+		writeToScreen("Shared-memory server initialization failed");
+	}
+	if (serverOptions.passiveInterface[0] != '\0'
+		&& (passiveThreadHandle = CreateThread(NULL, 0, passiveThread, (LPVOID)0, 0, NULL)) == NULL)
+	{
+		writeToScreen("Passive capture initialization failed");
+	}
 }
 
 /*---------------------------------------------------------------------------------
@@ -122,6 +289,13 @@ void startServer(int udpPort, int tcpPort, HANDLE hFile)
 --	DATE:		Feb 14, 2016
 --
 --	REVISIONS:	Feb 14, 2016
+--				Oct 19, 2026 - stats initialized before the receive thread starts
+--				Oct 19, 2026 - applies receive buffer size
+--				Oct 19, 2026 - removed unused socket information allocation
+--				Oct 19, 2026 - allocates connection state and queues accepted sockets
+--				Oct 19, 2026 - records peer and local addresses
+--				Oct 19, 2026 - statistics set up by startServer
+--				Oct 19, 2026 - thread placement
 --
 --	DESIGNER:	Gabriella Cheung
 --
@@ -138,18 +312,26 @@ void startServer(int udpPort, int tcpPort, HANDLE hFile)
 --  Then it calls listen so the socket will be listening to any incoming connection
 --  requests. It then creates a WSAEvent for the WSAWaitForMultipleEvents call in
 --  the tcpThread method. It creates a thread to run the tcpThread method. Finally
---  it waits for and accepts incoming connection requests.
+--  it waits for and accepts incoming connection requests. Each accepted socket
+--  gets its connection state here and is queued for the tcpThread, which posts
+--  the receives so their completion routines run on that thread.
 --
 ---------------------------------------------------------------------------------*/
 DWORD WINAPI startTCPServer(LPVOID n)
 {
 	struct	sockaddr_in tcpServer;
 
-	LPSOCKET_INFORMATION tcpSocketInfo;
-	DWORD flags, threadId;
+	DWORD threadId;
+	ULONG nonBlocking = 1;
 	int error = 0;
 	char message[256];
 	HANDLE threadHandle;
+	SOCKET acceptSocket;
+	SOCKADDR_IN peer;
+	int peerSize, localSize;
+	LPSOCKET_INFORMATION socketInfo;
+
+	placeThread(GetCurrentThread(), &placement, PLACE_ACCEPT);
 
 	// Create a stream socket
 	if ((tcpSocket = WSASocket(AF_INET, SOCK_STREAM, 0, NULL, 0, WSA_FLAG_OVERLAPPED)) == INVALID_SOCKET)
@@ -169,16 +351,13 @@ DWORD WINAPI startTCPServer(LPVOID n)
 		writeToScreen("Can't bind name to socket");
 	}
 
-	// Create a socket information structure to associate with socket.
-	if ((tcpSocketInfo = (LPSOCKET_INFORMATION)GlobalAlloc(GPTR,
-		sizeof(SOCKET_INFORMATION))) == NULL)
-	{
-		sprintf(message,"GlobalAlloc() failed with error %d\n", GetLastError());
-		writeToScreen(message);
-		return FALSE;
-	}
+	// Accepted sockets inherit the listening socket's buffer. Leaving it unset
+	// keeps Windows' receive window autotuning for TCP.
+	sprintf(message, "TCP receive buffer: %d bytes%s", setSocketBuffer(tcpSocket, SO_RCVBUF, serverOptions.receiveBuffer),
+		serverOptions.receiveBuffer > 0 ? "" : " (window autotuning)");
+	writeToScreen(message);
 
-	if (listen(tcpSocket, 5) == SOCKET_ERROR)
+	if (listen(tcpSocket, SOMAXCONN) == SOCKET_ERROR)
 	{
 		writeToScreen("listen failed");
 	}
@@ -188,23 +367,39 @@ DWORD WINAPI startTCPServer(LPVOID n)
 		writeToScreen("WSACreateEvent() failed");
 	}
 
+	InitializeSListHead(&acceptedConnections);
+	openConnections = 0;
+	sampledConnections = 0;
+	idleWorkingSet = getWorkingSet();
+
 	if ((threadHandle = CreateThread(NULL, 0, tcpThread, (LPVOID)tcpEvent, 0, &threadId)) == NULL)
 	{
 		writeToScreen("CreateThread() failed");
 	}
 
-	//initialize stats struct
-	tcpStats = (TRANSFER_STATS*)malloc(sizeof(TRANSFER_STATS));
-	tcpStats->protocol = "TCP";
-	tcpStats->startTime = { 0 };
-	tcpStats->endTime = { 0 };
-	tcpStats->packetCount = 0;
-	tcpStats->packetSize = 0;
-	tcpStats->totalSize = 0;
-
 	while (serverRunning)
 	{
-		tcpAcceptSocket = accept(tcpSocket, NULL, NULL);
+		peerSize = sizeof(peer);
+		if ((acceptSocket = accept(tcpSocket, (struct sockaddr *)&peer, &peerSize)) == INVALID_SOCKET)
+		{
+			continue;
+		}
+
+		// Connections only own a small state block until data arrives; the
+		// non-blocking mode lets readConnection drain without waiting.
+		ioctlsocket(acceptSocket, FIONBIO, &nonBlocking);
+		if ((socketInfo = newSocketInfo(acceptSocket, 0)) == NULL)
+		{
+			writeToScreen("Not enough memory for the connection, closing it");
+			closesocket(acceptSocket);
+			continue;
+		}
+		socketInfo->Peer = peer;
+		socketInfo->PeerSize = peerSize;
+		localSize = sizeof(socketInfo->Local);
+		getsockname(acceptSocket, (struct sockaddr *)&(socketInfo->Local), &localSize);
+		InterlockedIncrement(&openConnections);
+		InterlockedPushEntrySList(&acceptedConnections, &(socketInfo->Link));
 
 		if (WSASetEvent(tcpEvent) == FALSE)
 		{
@@ -222,6 +417,11 @@ DWORD WINAPI startTCPServer(LPVOID n)
 --	DATE:		Feb 14, 2016
 --
 --	REVISIONS:	Feb 14, 2016
+--				Oct 19, 2026 - resets the connection's frame parser
+--				Oct 19, 2026 - contexts and buffers come from the pool
+--				Oct 19, 2026 - posts zero-byte receives for queued connections
+--				Oct 19, 2026 - names the thread in traces
+--				Oct 19, 2026 - thread placement
 --
 --	DESIGNER:	Gabriella Cheung
 --
@@ -235,22 +435,20 @@ DWORD WINAPI startTCPServer(LPVOID n)
 --
 --	NOTES:
 --	This function calls WSAWaitForMultipleEvents. When it receives an event,
---  it creates a socketInfo data structure and calls WSARecv to read data from
---  the socket into socketInfo. When WSARecv has read data successfully, a
---  completion routine is called.
+--  it takes the connections queued by startTCPServer and posts a zero-byte
+--  WSARecv on each. When data is ready, a completion routine is called.
 --
 ---------------------------------------------------------------------------------*/
 DWORD WINAPI tcpThread(LPVOID lpParameter)
 {
 	LPSOCKET_INFORMATION socketInfo;
+	PSLIST_ENTRY entry, next;
 	WSAEVENT eventArray[1];
-	DWORD index, flags;
-	int error = 0;
-	char message[256];
-	SOCKADDR_IN	client;
-	int clientSize = sizeof(SOCKADDR_IN);
+	DWORD index;
 
 	eventArray[0] = (WSAEVENT)lpParameter;
+	TRACE_THREAD("TCP receive");
+	placeThread(GetCurrentThread(), &placement, PLACE_RECEIVE);
 	while (true)
 	{
 		while (true)
@@ -270,31 +468,15 @@ DWORD WINAPI tcpThread(LPVOID lpParameter)
 
 		WSAResetEvent(eventArray[index - WSA_WAIT_EVENT_0]);
 
-		// Create a socket information structure to associate with socket.
-		if ((socketInfo = (LPSOCKET_INFORMATION)GlobalAlloc(GPTR,
-			sizeof(SOCKET_INFORMATION))) == NULL)
-		{
-			sprintf(message,"GlobalAlloc() failed with error %d\n", GetLastError());
-			writeToScreen(message);
-			return FALSE;
-		}
-
-		// Fill in the details of our accepted socket.
-		socketInfo->Socket = tcpAcceptSocket;
-		ZeroMemory(&(socketInfo->Overlapped), sizeof(WSAOVERLAPPED));
-		socketInfo->BytesSEND = 0;
-		socketInfo->BytesRECV = 0;
-		socketInfo->DataBuf.len = DATA_BUFSIZE;
-		socketInfo->DataBuf.buf = socketInfo->Buffer;
-		socketInfo->Timeout = INFINITE;
-
-		flags = 0;
-		if (WSARecv(socketInfo->Socket, &(socketInfo->DataBuf), 1, NULL, &flags, &(socketInfo->Overlapped), tcpRoutine) == SOCKET_ERROR)
+		// Post a zero-byte receive for every connection accepted since the
+		// last wakeup; several accepts can share one event signal.
+		for (entry = InterlockedFlushSList(&acceptedConnections); entry != NULL; entry = next)
 		{
-			if ((error = WSAGetLastError()) != WSA_IO_PENDING)
+			next = entry->Next;
+			socketInfo = CONTAINING_RECORD(entry, SOCKET_INFORMATION, Link);
+			if (!waitForData(socketInfo))
 			{
-				sprintf(message, "WSARecv failed with error %d", error);
-				writeToScreen(message);
+				closeConnection(socketInfo);
 			}
 		}
 	}
@@ -306,6 +488,15 @@ DWORD WINAPI tcpThread(LPVOID lpParameter)
 --	DATE:		Feb 14, 2016
 --
 --	REVISIONS:	Feb 14, 2016
+--				Oct 19, 2026 - record into sharded stats, report and reset by epoch
+--				Oct 19, 2026 - parses frames and saves payload with its exact length
+--				Oct 19, 2026 - closes the socket and returns its context to the pool
+--				Oct 19, 2026 - zero-byte receives, reads into a borrowed pool buffer
+--				Oct 19, 2026 - steady-state figures
+--				Oct 19, 2026 - CPU cost
+--				Oct 19, 2026 - TCP_INFO summary
+--				Oct 19, 2026 - counts a frame cut short by a failed receive
+--				Oct 19, 2026 - reports once the last connection closes
 --
 --	DESIGNER:	Gabriella Cheung
 --
@@ -322,66 +513,56 @@ DWORD WINAPI tcpThread(LPVOID lpParameter)
 --	RETURNS:	none
 --
 --	NOTES:
---	This function is called when WSARecv successfully reads data from the TCP
---	socket. It updates the statistics and writes the data read to file (if user
---  specified a file to save to). If there were no bytes transferred, the statistics
---  are printed to the screen and reset. It then calls WSARecv so the server will
---  be ready to read data when it arrives.
+--	This function is called when the zero-byte WSARecv on a TCP connection
+--	completes, meaning data is ready. readConnection reads it, updates the
+--  statistics and writes the data read to file (if user specified a file to
+--  save to). The data is run through the connection's frame parser, which
+--  counts the messages completed by these reads and strips the frame headers
+--  before the payload is saved. If the peer closed the connection, its
+--  TCP_INFO summary is logged, and once no other connection is open the
+--  statistics they all added to are printed to the screen and reset.
+--  Otherwise it posts another
+--  zero-byte WSARecv so the server will be ready when more data arrives.
 --
 ---------------------------------------------------------------------------------*/
 void CALLBACK tcpRoutine(DWORD errorCode, DWORD bytesTransferred, LPOVERLAPPED overlapped, DWORD flags)
 {
 	LPSOCKET_INFORMATION socketInfo = (LPSOCKET_INFORMATION)overlapped;
-	DWORD newFlags;
-	char data[MAXLEN] = { 0 };
-	int error = 0;
-	char message[256];
+	STATS_SNAPSHOT snapshot;
+	STATS_COUNTERS messages;
 
 	if (errorCode != 0)
 	{
 		writeToScreen("TCP recv error");
+		ZeroMemory(&messages, sizeof(messages));
+		endFrames(&(socketInfo->Parser), &messages);
+		recordPacket(&tcpStats, 0, NO_SEQUENCE, &messages);
 	}
-
-	if (bytesTransferred > 0)
+	else if (readConnection(socketInfo) && waitForData(socketInfo))
 	{
-		if (tcpStats->startTime.wYear == 0) //start time was never set
-		{
-			GetSystemTime(&(tcpStats->startTime));
-		}
-		GetSystemTime(&(tcpStats->endTime));
-
-		if (hWriteFile != NULL)
-		{
-			if (writeToFile(hWriteFile, socketInfo->DataBuf.buf))
-			{
-				//writeToScreen("Incoming data successfully saved", true);
-			}
-			else {
-				writeToScreen("Saving incoming data failed");
-			}
-		}
-		tcpStats->packetCount++;
-		tcpStats->totalSize += bytesTransferred;
-	}
-	else {
-		displayStats(tcpStats);
-		//reset stats
-		tcpStats->startTime = { 0 };
-		tcpStats->endTime = { 0 };
-		tcpStats->packetCount = 0;
-		tcpStats->packetSize = 0;
-		tcpStats->totalSize = 0;
 		return;
 	}
-	newFlags = 0;
-	if (WSARecv(socketInfo->Socket, &(socketInfo->DataBuf), 1, NULL, &newFlags, &(socketInfo->Overlapped), tcpRoutine) == SOCKET_ERROR)
+
+	if (socketInfo->TcpInfo != NULL)
 	{
-		if ((error = WSAGetLastError()) != WSA_IO_PENDING)
-		{
-			sprintf(message, "WSARecv failed with error %d", error);
-			writeToScreen(message);
-		}
+		finishTcpInfo(socketInfo->TcpInfo);
+		logTcpInfo(socketInfo->TcpInfo, "server", hServerLogFile);
+	}
+	// the statistics are shared by every connection, so the last one to close reports them
+	if (openConnections > 1)
+	{
+		closeConnection(socketInfo);
+		return;
 	}
+	snapshotStats(&tcpStats, &snapshot);
+	steadyState(&tcpStats, &snapshot);
+	transferCost(&tcpStats, &snapshot);
+	snapshot.connections = openConnections;
+	snapshot.workingSet = getWorkingSet();
+	displayStats(&snapshot);
+	//reset stats
+	resetStats(&tcpStats, &snapshot);
+	closeConnection(socketInfo);
 }
 
 /*---------------------------------------------------------------------------------
@@ -390,6 +571,16 @@ void CALLBACK tcpRoutine(DWORD errorCode, DWORD bytesTransferred, LPOVERLAPPED o
 --	DATE:		Feb 14, 2016
 --
 --	REVISIONS:	Feb 14, 2016
+--				Oct 19, 2026 - report and reset stats by epoch
+--				Oct 19, 2026 - receive buffer autotuning and kernel drop accounting
+--				Oct 19, 2026 - joins multicast groups and reports them
+--				Oct 19, 2026 - statistics set up by startServer
+--				Oct 19, 2026 - sets up the flow table
+--				Oct 19, 2026 - skips the report when only reliable datagrams arrived
+--				Oct 19, 2026 - CPU cost
+--				Oct 19, 2026 - thread placement
+--				Oct 19, 2026 - busy-poll receive mode
+--				Oct 19, 2026 - kernel receive timestamps
 --
 --	DESIGNER:	Gabriella Cheung
 --
@@ -410,6 +601,14 @@ void CALLBACK tcpRoutine(DWORD errorCode, DWORD bytesTransferred, LPOVERLAPPED o
 --  signal when the datagrams stop arriving. When the socket times out, it prints
 --	out the statistics collected and the timeout is reset to the original timeout.
 --
+--  If multicast groups were given, the socket is shared with other receivers
+--  on the host, joins each group and asks for IP_PKTINFO. Each group's
+--  statistics are printed after the server-wide ones.
+--
+--  The flow table is set up before the receive thread starts. Flows are
+--  reported by that thread as each goes idle, independently of the
+--  server-wide report here.
+--
 ---------------------------------------------------------------------------------*/
 DWORD WINAPI startUDPServer(LPVOID n)
 {
@@ -420,6 +619,14 @@ DWORD WINAPI startUDPServer(LPVOID n)
 	HANDLE threadHandle;
 	fd_set fds;
 	struct timeval tv;
+	char message[256];
+	STATS_SNAPSHOT snapshot;
+	BOOL transferring = false;
+	DWORD dropsAtStart = 0, dropsAtSample = 0, drops;
+	ULONGLONG lastSample = 0;
+	BOOL reuse = true;
+
+	placeThread(GetCurrentThread(), &placement, PLACE_ACCEPT);
 
 	// Create a datagram socket
 	if ((udpSocket = WSASocket(AF_INET, SOCK_DGRAM, 0, NULL, 0, WSA_FLAG_OVERLAPPED)) == INVALID_SOCKET)
@@ -432,32 +639,68 @@ DWORD WINAPI startUDPServer(LPVOID n)
 	udpServer.sin_family = AF_INET;
 	udpServer.sin_port = htons(uPort);
 	udpServer.sin_addr.s_addr = htonl(INADDR_ANY);
+	udpAddress = udpServer;
+
+	//lets other receivers on this host bind the same port; each gets every group datagram
+	if (serverOptions.groups[0] != '\0'
+		&& setsockopt(udpSocket, SOL_SOCKET, SO_REUSEADDR, (char *)&reuse, sizeof(reuse)) == SOCKET_ERROR)
+	{
+		writeToScreen("Can't share the UDP port");
+	}
 
 	if (bind(udpSocket, (struct sockaddr *)&udpServer, sizeof(udpServer)) == SOCKET_ERROR)
 	{
 		writeToScreen("Can't bind name to socket");
 	}
 
+	groupCount = 0;
+	if (serverOptions.groups[0] != '\0')
+	{
+		groupCount = joinGroups(udpSocket, serverOptions.groups, serverOptions.multicastInterface, groups);
+		if (groupCount > 0 && (setsockopt(udpSocket, IPPROTO_IP, IP_PKTINFO, (char *)&reuse, sizeof(reuse)) == SOCKET_ERROR
+			|| (recvMsg = getRecvMsg(udpSocket)) == NULL))
+		{
+			writeToScreen("Destination addresses unavailable, no per-group statistics");
+			groupCount = 0;
+		}
+	}
+
+	receiveTimestamps = enableTimestamps(udpSocket, TIMESTAMPING_FLAG_RX)
+		&& (recvMsg != NULL || (recvMsg = getRecvMsg(udpSocket)) != NULL);
+	receiveControl = groupCount > 0 || receiveTimestamps;
+	writeToScreen(receiveTimestamps ? "UDP receive timestamps: kernel, taken by the adapter's driver"
+		: "UDP receive timestamps: unavailable, latency is measured from the application only");
+
+	udpReceiveBuffer = setSocketBuffer(udpSocket, SO_RCVBUF, serverOptions.receiveBuffer);
+	sprintf(message, "UDP receive buffer: %d bytes%s", udpReceiveBuffer, serverOptions.autotune ? " (autotuning)" : "");
+	writeToScreen(message);
+	if (!serverOptions.busyPoll)
+	{
+		sprintf(message, "UDP receive: event-driven");
+	}
+	else if (serverOptions.spin > 0)
+	{
+		sprintf(message, "UDP receive: busy poll, blocking after %lu us without data", serverOptions.spin);
+	}
+	else {
+		sprintf(message, "UDP receive: busy poll, never blocking");
+	}
+	writeToScreen(message);
+
 	if ((udpEvent = WSACreateEvent()) == WSA_INVALID_EVENT)
 	{
 		writeToScreen("WSACreateEvent() failed");
 	}
-	
-	if ((threadHandle = CreateThread(NULL, 0, udpThread, (LPVOID)udpEvent, 0, &threadId)) == NULL)
-	{
 
+	if (!initFlows(&udpFlows))
+	{
+		writeToScreen("Unable to allocate the flow table, no per-flow statistics");
 	}
 
-	//initialize stats struct
-	udpStats = (TRANSFER_STATS*)malloc(sizeof(TRANSFER_STATS));
-	udpStats->protocol = "UDP";
-	udpStats->startTime = { 0 };
-	udpStats->endTime = { 0 };
-	udpStats->packetCount = 0;
-	udpStats->packetSize = 0;
-	udpStats->totalSize = 0;
+	if ((threadHandle = CreateThread(NULL, 0, serverOptions.busyPoll ? pollThread : udpThread, (LPVOID)udpEvent, 0, &threadId)) == NULL)
+	{
 
-	char message[256];
+	}
 
 	FD_ZERO(&fds);
 	FD_SET(udpSocket, &fds);
@@ -467,7 +710,8 @@ DWORD WINAPI startUDPServer(LPVOID n)
 
 	while (true)
 	{
-		selectRet = select(udpSocket, &fds, NULL, NULL, &tv);
+		//the polling thread drains the socket, so select would only race it
+		selectRet = serverOptions.busyPoll ? waitForPoll(tv.tv_sec) : select(udpSocket, &fds, NULL, NULL, &tv);
 		if (serverRunning)
 		{
 			if (selectRet == SOCKET_ERROR)
@@ -481,23 +725,51 @@ DWORD WINAPI startUDPServer(LPVOID n)
 			}
 			else if (selectRet == 0)
 			{
-				displayStats(udpStats);
+				snapshotStats(&udpStats, &snapshot);
+				steadyState(&udpStats, &snapshot);
+				transferCost(&udpStats, &snapshot);
+				snapshot.countDrops = true;
+				snapshot.kernelDrops = getUdpKernelDrops() - dropsAtStart;
+				snapshot.receiveBuffer = udpReceiveBuffer;
+				//a transfer of reliable datagrams only is reported by reportReliable
+				if (snapshot.total.packetCount > 0)
+				{
+					displayStats(&snapshot);
+				}
+				displayGroups();
+				transferring = false;
 				tv.tv_sec = 36000000;
 				FD_ZERO(&fds);
 				FD_SET(udpSocket, &fds);
 
 				//reset stats
-				udpStats->startTime = { 0 };
-				udpStats->endTime = { 0 };
-				udpStats->packetCount = 0;
-				udpStats->packetSize = 0;
-				udpStats->totalSize = 0;
+				resetStats(&udpStats, &snapshot);
+				if (receiveTimestamps)
+				{
+					calibrateTimestamps();
+				}
 				if (WSASetEvent(udpEvent) == FALSE)
 				{
 					writeToScreen("Resetting event failed");
 				}
 			}
 			else {
+				if (!transferring) //first datagram of a transfer
+				{
+					dropsAtStart = dropsAtSample = getUdpKernelDrops();
+					lastSample = GetTickCount64();
+					transferring = true;
+				}
+				else if (serverOptions.autotune && GetTickCount64() - lastSample >= DROP_SAMPLE_INTERVAL)
+				{
+					drops = getUdpKernelDrops();
+					if (drops != dropsAtSample)
+					{
+						growReceiveBuffer();
+					}
+					dropsAtSample = drops;
+					lastSample = GetTickCount64();
+				}
 				if (WSASetEvent(udpEvent) == FALSE)
 				{
 					writeToScreen("Resetting event failed");
@@ -520,6 +792,15 @@ DWORD WINAPI startUDPServer(LPVOID n)
 --	DATE:		Feb 14, 2016
 --
 --	REVISIONS:	Feb 14, 2016
+--				Oct 19, 2026 - contexts and buffers come from the pool
+--				Oct 19, 2026 - receive buffer size passed to newSocketInfo
+--				Oct 19, 2026 - sender address kept in the socket information
+--				Oct 19, 2026 - receives with WSARecvMsg when groups are joined
+--				Oct 19, 2026 - wakes every tick to expire idle flows
+--				Oct 19, 2026 - reliable UDP acks and timeouts
+--				Oct 19, 2026 - names the thread in traces
+--				Oct 19, 2026 - thread placement
+--				Oct 19, 2026 - WSARecvMsg for kernel timestamps
 --
 --	DESIGNER:	Gabriella Cheung
 --
@@ -535,7 +816,11 @@ DWORD WINAPI startUDPServer(LPVOID n)
 --	This function calls WSAWaitForMultipleEvents. When it receives an event,
 --  it creates a socketInfo data structure and calls WSARecvFrom to read data from
 --  the socket into socketInfo. When WSARecvFrom has read data successfully, a
---  completion routine is called.
+--  completion routine is called. Once groups are joined WSARecvMsg is used
+--  instead, so the destination address comes back with the datagram.
+--  The wait times out every FLOW_TICK so idle flows are reported even when no
+--  datagrams arrive. The completion routines run on this thread too, so the
+--  flow table is only ever used here.
 --
 ---------------------------------------------------------------------------------*/
 DWORD WINAPI udpThread(LPVOID lpParameter)
@@ -543,24 +828,30 @@ DWORD WINAPI udpThread(LPVOID lpParameter)
 	LPSOCKET_INFORMATION socketInfo;
 	WSAEVENT eventArray[1];
 	DWORD index, flags;
-	int error = 0;
+	LPWSAMSG msg;
+	int error = 0, result;
 	char message[256];
-	SOCKADDR_IN	client;
-	int clientSize = sizeof(SOCKADDR_IN);
 
 	eventArray[0] = (WSAEVENT)lpParameter;
+	TRACE_THREAD("UDP receive");
+	placeThread(GetCurrentThread(), &placement, PLACE_RECEIVE);
 	while (true)
 	{
 		while (true)
 		{
-			index = WSAWaitForMultipleEvents(1, eventArray, FALSE, WSA_INFINITE, TRUE);
+			index = WSAWaitForMultipleEvents(1, eventArray, FALSE, FLOW_TICK, TRUE);
+			expireFlows(&udpFlows, currentFileTime(), displayFlow);
+			if (reliableTick(&reliable, udpSocket, currentFileTime()))
+			{
+				reportReliable();
+			}
 
 			if (index == WSA_WAIT_FAILED)
 			{
 				writeToScreen("WSAWaitForMultipleEvents failed");
 				break;
 			}
-			if (index != WAIT_IO_COMPLETION)
+			if (index != WAIT_IO_COMPLETION && index != WSA_WAIT_TIMEOUT)
 			{
 				break;
 			}
@@ -569,33 +860,213 @@ DWORD WINAPI udpThread(LPVOID lpParameter)
 		WSAResetEvent(eventArray[index - WSA_WAIT_EVENT_0]);
 
 		// Create a socket information structure to associate with socket.
-		if ((socketInfo = (LPSOCKET_INFORMATION)GlobalAlloc(GPTR,
-			sizeof(SOCKET_INFORMATION))) == NULL)
+		if ((socketInfo = newSocketInfo(udpSocket, DATA_BUFSIZE)) == NULL)
 		{
-			sprintf(message, "GlobalAlloc() failed with error %d\n", GetLastError());
-			writeToScreen(message);
-			return FALSE;
+			writeToScreen("Not enough memory for the socket information");
+			continue;
 		}
 
-		// Fill in the details of our accepted socket.
-		socketInfo->Socket = udpSocket;
-		ZeroMemory(&(socketInfo->Overlapped), sizeof(WSAOVERLAPPED));
-		socketInfo->BytesSEND = 0;
-		socketInfo->BytesRECV = 0;
-		socketInfo->DataBuf.len = DATA_BUFSIZE;
-		socketInfo->DataBuf.buf = socketInfo->Buffer;
-		socketInfo->Timeout = INFINITE;
-
 		flags = 0;
-		if (WSARecvFrom(socketInfo->Socket, &(socketInfo->DataBuf), 1, NULL, &flags, (sockaddr *)&client, &clientSize, &(socketInfo->Overlapped), udpRoutine) == SOCKET_ERROR)
+		if (receiveControl)
+		{
+			msg = &(socketInfo->Control->Msg);
+			msg->name = (LPSOCKADDR)&(socketInfo->Peer);
+			msg->namelen = socketInfo->PeerSize;
+			msg->lpBuffers = &(socketInfo->DataBuf);
+			msg->dwBufferCount = 1;
+			msg->Control.buf = socketInfo->Control->Data;
+			msg->Control.len = sizeof(socketInfo->Control->Data);
+			msg->dwFlags = 0;
+			result = recvMsg(socketInfo->Socket, msg, NULL, &(socketInfo->Overlapped), udpRoutine);
+		}
+		else {
+			result = WSARecvFrom(socketInfo->Socket, &(socketInfo->DataBuf), 1, NULL, &flags, (sockaddr *)&(socketInfo->Peer), &(socketInfo->PeerSize), &(socketInfo->Overlapped), udpRoutine);
+		}
+		if (result == SOCKET_ERROR)
 		{
 			if ((error = WSAGetLastError()) != WSA_IO_PENDING)
 			{
 				sprintf(message, "WSARecvFrom failed with error %d", error);
 				writeToScreen(message);
+				freeSocketInfo(socketInfo);
+			}
+		}
+	}
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: pollThread
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--				Oct 19, 2026 - WSARecvMsg for kernel timestamps
+--				Oct 19, 2026 - gives its pool cache back
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	DWORD WINAPI pollThread(LPVOID lpParameter)
+--
+--	PARAMETERS:	LPVOID lpParameter - unused, takes udpThread's place
+--
+--	RETURNS:	DWORD
+--
+--	NOTES:
+--	Receives from the UDP socket in busy-poll mode. The socket is made
+--  non-blocking and read in a loop on this thread, so a datagram is handled
+--  as soon as the stack has it instead of after select, an event and a
+--  completion routine have each woken a thread. Once nothing has arrived for
+--  the spin time the thread blocks in select until the next datagram or the
+--  next FLOW_TICK, and spins again when one comes. A spin of 0 never blocks.
+--  Each datagram goes through udpRoutine, as if its receive had completed,
+--  and flows and reliable UDP timers are serviced every FLOW_TICK.
+--
+--  Windows has no SO_BUSY_POLL, so the spinning is done here in user mode;
+--  pin this thread to a core of its own with the receive placement.
+--
+---------------------------------------------------------------------------------*/
+DWORD WINAPI pollThread(LPVOID lpParameter)
+{
+	LPSOCKET_INFORMATION socketInfo = NULL;
+	LPWSAMSG msg;
+	DWORD bytes, flags;
+	ULONG nonBlocking = 1;
+	LARGE_INTEGER frequency, now, lastData;
+	LONGLONG spinTicks;
+	ULONGLONG tick, lastTick = 0;
+	fd_set fds;
+	struct timeval tv;
+	int result, error;
+	char message[256];
+
+	TRACE_THREAD("UDP busy poll");
+	placeThread(GetCurrentThread(), &placement, PLACE_RECEIVE);
+	if (ioctlsocket(udpSocket, FIONBIO, &nonBlocking) == SOCKET_ERROR)
+	{
+		writeToScreen("Can't make the UDP socket non-blocking");
+		return 0;
+	}
+	QueryPerformanceFrequency(&frequency);
+	spinTicks = frequency.QuadPart * serverOptions.spin / 1000000;
+	QueryPerformanceCounter(&lastData);
+
+	while (serverRunning)
+	{
+		if (socketInfo == NULL && (socketInfo = newSocketInfo(udpSocket, DATA_BUFSIZE)) == NULL)
+		{
+			writeToScreen("Not enough memory for the socket information");
+			Sleep(FLOW_TICK);
+			continue;
+		}
+
+		bytes = 0;
+		flags = 0;
+		if (receiveControl)
+		{
+			msg = &(socketInfo->Control->Msg);
+			msg->name = (LPSOCKADDR)&(socketInfo->Peer);
+			msg->namelen = sizeof(SOCKADDR_IN);
+			msg->lpBuffers = &(socketInfo->DataBuf);
+			msg->dwBufferCount = 1;
+			msg->Control.buf = socketInfo->Control->Data;
+			msg->Control.len = sizeof(socketInfo->Control->Data);
+			msg->dwFlags = 0;
+			result = recvMsg(socketInfo->Socket, msg, &bytes, NULL, NULL);
+		}
+		else {
+			socketInfo->PeerSize = sizeof(SOCKADDR_IN);
+			result = WSARecvFrom(socketInfo->Socket, &(socketInfo->DataBuf), 1, &bytes, &flags, (sockaddr *)&(socketInfo->Peer), &(socketInfo->PeerSize), NULL, NULL);
+		}
+		error = result == SOCKET_ERROR ? WSAGetLastError() : 0;
+
+		if (error == 0 || error == WSAEMSGSIZE)
+		{
+			if (error == WSAEMSGSIZE)
+			{
+				bytes = socketInfo->DataBuf.len;
+			}
+			//udpRoutine returns socketInfo to the pool
+			udpRoutine(error, bytes, &(socketInfo->Overlapped), flags);
+			socketInfo = NULL;
+			polledDatagrams++;
+			QueryPerformanceCounter(&lastData);
+		}
+		else if (error != WSAEWOULDBLOCK && error != WSAECONNRESET)
+		{
+			if (serverRunning)
+			{
+				sprintf(message, "WSARecvFrom failed with error %d", error);
+				writeToScreen(message);
+			}
+			break;
+		}
+		else if (serverOptions.spin > 0 && QueryPerformanceCounter(&now) && now.QuadPart - lastData.QuadPart >= spinTicks)
+		{
+			FD_ZERO(&fds);
+			FD_SET(udpSocket, &fds);
+			tv.tv_sec = 0;
+			tv.tv_usec = FLOW_TICK * 1000;
+			select(udpSocket, &fds, NULL, NULL, &tv);
+		}
+		else {
+			YieldProcessor();
+		}
+
+		tick = GetTickCount64();
+		if (tick - lastTick >= FLOW_TICK)
+		{
+			lastTick = tick;
+			expireFlows(&udpFlows, currentFileTime(), displayFlow);
+			if (reliableTick(&reliable, udpSocket, currentFileTime()))
+			{
+				reportReliable();
 			}
 		}
 	}
+	if (socketInfo != NULL)
+	{
+		freeSocketInfo(socketInfo);
+	}
+	releasePool();
+	return 0;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: waitForPoll
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	int waitForPoll(LONG seconds)
+--
+--	PARAMETERS:	LONG seconds - longest time to wait
+--
+--	RETURNS:	1 if pollThread received a datagram in the time, otherwise 0
+--
+--	NOTES:
+--	Stands in for startUDPServer's select in busy-poll mode. It looks at the
+--  polling thread's count every FLOW_TICK rather than being signalled, so the
+--  polling thread never has to wake anyone. Returns early when the server
+--  stops.
+--
+---------------------------------------------------------------------------------*/
+int waitForPoll(LONG seconds)
+{
+	LONG seen = polledDatagrams;
+	ULONGLONG until = GetTickCount64() + (ULONGLONG)seconds * 1000;
+
+	while (serverRunning && polledDatagrams == seen && GetTickCount64() < until)
+	{
+		Sleep(FLOW_TICK);
+	}
+	return polledDatagrams != seen ? 1 : 0;
 }
 
 /*---------------------------------------------------------------------------------
@@ -604,6 +1075,19 @@ DWORD WINAPI udpThread(LPVOID lpParameter)
 --	DATE:		Feb 14, 2016
 --
 --	REVISIONS:	Feb 14, 2016
+--				Oct 19, 2026 - record into sharded stats
+--				Oct 19, 2026 - records datagram sequence numbers
+--				Oct 19, 2026 - counts the datagram as a message, saves exact length
+--				Oct 19, 2026 - returns its context to the pool
+--				Oct 19, 2026 - captures datagrams as pcapng
+--				Oct 19, 2026 - integrity check through parseDatagram
+--				Oct 19, 2026 - per-group statistics
+--				Oct 19, 2026 - per-flow statistics
+--				Oct 19, 2026 - reliable UDP datagrams
+--				Oct 19, 2026 - trace point
+--				Oct 19, 2026 - latency of timed datagrams
+--				Oct 19, 2026 - splits the latency at the kernel timestamp
+--				Oct 19, 2026 - Report a reliable transfer a new connection cuts off
 --
 --	DESIGNER:	Gabriella Cheung
 --
@@ -622,34 +1106,101 @@ DWORD WINAPI udpThread(LPVOID lpParameter)
 --	NOTES:
 --	This function is called when WSARecvFrom successfully reads data from the UDP
 --	socket. It updates the statistics and writes the data read to file (if user
---  specified a file to save to).
+--  specified a file to save to). If the datagram starts with a DATAGRAM_HEADER,
+--  its sequence number is recorded and the header is not written to the file.
+--  A datagram too large for the buffer completes with WSAEMSGSIZE and is
+--  counted as truncated if it was sent in integrity mode. When the server has
+--  joined multicast groups, the datagram is also counted for the group it was
+--  sent to. Every datagram is also counted for its flow: its sender's address
+--  and port and the flow id from its header.
+--  When capturing to pcapng, the whole datagram is recorded with its sender.
+--  Reliable UDP datagrams are handed to reliableReceive instead, which
+--  acknowledges them and saves their payloads in order. A transfer cut off
+--  by one from a new connection is reported as abandoned first.
+--  The latency of a timed datagram runs from its send time to the start of
+--  this routine, so in event-driven mode it includes the wakeups on the way.
+--  When the kernel timestamped the receive, the time from that timestamp to
+--  this routine is counted apart from the time before it.
 --
 ---------------------------------------------------------------------------------*/
 void CALLBACK udpRoutine(DWORD errorCode, DWORD bytesTransferred, LPOVERLAPPED overlapped, DWORD flags)
 {
 	LPSOCKET_INFORMATION socketInfo = (LPSOCKET_INFORMATION)overlapped;
-	DWORD newFlags;
-	SOCKADDR_IN	client;
-	int clientSize = sizeof(client);
-	int error = 0;
-	char message[256];
+	char *payload;
+	LONG sequence;
+	DWORD flow;
+	STATS_COUNTERS messages = { 0 };
+	LPWSAMSG msg;
+	LPWSACMSGHDR control;
+	MULTICAST_GROUP *group;
+	ULONGLONG received = preciseFileTime(), sent, kernelTime = 0;
+	LARGE_INTEGER arrival;
+	ULONGLONG traceStart = TRACE_START();
+
+	if (receiveTimestamps)
+	{
+		QueryPerformanceCounter(&arrival);
+		kernelTime = receiveTimestamp(&(socketInfo->Control->Msg));
+	}
 
 	if (errorCode != 0)
 	{
 		writeToScreen("UDP recv error");
 	}
 
-	if (bytesTransferred > 0)
+	if (bytesTransferred > 0 && isReliable(socketInfo->DataBuf.buf, bytesTransferred))
 	{
-		if (udpStats->startTime.wYear == 0) //start time was never set
+		if (reliableSupersedes(&reliable, socketInfo->DataBuf.buf))
 		{
-			GetSystemTime(&(udpStats->startTime));
-		}	
-		GetSystemTime(&(udpStats->endTime));
+			reportReliable();
+		}
+		if (reliableReceive(&reliable, udpSocket, socketInfo->DataBuf.buf, bytesTransferred, &(socketInfo->Peer),
+			&reliableStats, capturing || hWriteFile == NULL ? NULL : savePayload))
+		{
+			reportReliable();
+		}
+		if (capturing)
+		{
+			captureUdp(&(socketInfo->Peer), &udpAddress, socketInfo->DataBuf.buf, bytesTransferred);
+		}
+	}
+	else if (bytesTransferred > 0)
+	{
+		payload = parseDatagram(socketInfo->DataBuf.buf, bytesTransferred, errorCode == WSAEMSGSIZE, &sequence, &flow, &sent, &messages);
+		if (sent != 0)
+		{
+			addLatency(&messages, sent, received);
+		}
+		if (kernelTime != 0)
+		{
+			addSpread(&(messages.delivery), counterMicroseconds(arrival.QuadPart - (LONGLONG)kernelTime));
+			if (sent != 0)
+			{
+				addSpread(&(messages.wire), ((LONGLONG)counterToFileTime(kernelTime) - (LONGLONG)sent) / 10);
+			}
+		}
+		recordPacket(&udpStats, bytesTransferred, sequence, &messages);
+		recordFlow(&udpFlows, &(socketInfo->Peer), flow, bytesTransferred, sequence, &messages, currentFileTime());
+		if (groupCount > 0)
+		{
+			msg = &(socketInfo->Control->Msg);
+			for (control = WSA_CMSG_FIRSTHDR(msg); control != NULL; control = WSA_CMSG_NXTHDR(msg, control))
+			{
+				if (control->cmsg_level == IPPROTO_IP && control->cmsg_type == IP_PKTINFO
+					&& (group = findGroup(groups, groupCount, ((IN_PKTINFO *)WSA_CMSG_DATA(control))->ipi_addr)) != NULL)
+				{
+					recordPacket(&(group->stats), bytesTransferred, sequence, &messages);
+				}
+			}
+		}
 
-		if (hWriteFile != NULL)
+		if (capturing)
+		{
+			captureUdp(&(socketInfo->Peer), &udpAddress, socketInfo->DataBuf.buf, bytesTransferred);
+		}
+		else if (hWriteFile != NULL)
 		{
-			if (writeToFile(hWriteFile, socketInfo->DataBuf.buf))
+			if (writeDataToFile(hWriteFile, payload, bytesTransferred - (DWORD)(payload - socketInfo->DataBuf.buf)))
 			{
 				
 			}
@@ -657,9 +1208,9 @@ void CALLBACK udpRoutine(DWORD errorCode, DWORD bytesTransferred, LPOVERLAPPED o
 				writeToScreen("Saving incoming data failed");
 			}
 		}
-		udpStats->packetCount++;
-		udpStats->totalSize += bytesTransferred;
 	}
+	TRACE_END(TRACE_UDP_RECEIVE, traceStart, bytesTransferred);
+	freeSocketInfo(socketInfo);
 }
 
 /*---------------------------------------------------------------------------------
@@ -668,6 +1219,12 @@ void CALLBACK udpRoutine(DWORD errorCode, DWORD bytesTransferred, LPOVERLAPPED o
 --	DATE:		Feb 14, 2016
 --
 --	REVISIONS:	Feb 14, 2016
+--				Oct 19, 2026 - closes the capture
+--				Oct 19, 2026 - stops the sampler
+--				Oct 19, 2026 - removes the Unix socket path
+--				Oct 19, 2026 - releases held reliable UDP payloads
+--				Oct 19, 2026 - stops the passive capture
+--				Oct 19, 2026 - waits for the passive capture delivering its messages
 --
 --	DESIGNER:	Gabriella Cheung
 --
@@ -682,7 +1239,12 @@ void CALLBACK udpRoutine(DWORD errorCode, DWORD bytesTransferred, LPOVERLAPPED o
 --	NOTES:
 --	This function is responsible for server clean up. This method is called when
 --  the application exits or when the user switches from server mode to client
---  mode. It closes the sockets and files before calling WSACleanup.
+--  mode. It closes the sockets and files before calling WSACleanup. A pcapng
+--  capture is flushed before its file is closed. The Unix socket's path is
+--  removed with it; the shared-memory thread sees serverRunning cleared and
+--  releases the ring itself. The passive capture thread is waited for, since
+--  it closes its raw socket on the way out; the wait still delivers its
+--  writeToScreen calls, which would otherwise wait for this thread forever.
 --
 ---------------------------------------------------------------------------------*/
 VOID cleanUpServer()
@@ -690,79 +1252,86 @@ VOID cleanUpServer()
 	if (serverRunning)
 	{
 		serverRunning = false;
+		if (samplerThread != NULL)
+		{
+			WaitForSingleObject(samplerThread, INFINITE);
+			CloseHandle(samplerThread);
+			samplerThread = NULL;
+		}
+		if (passiveThreadHandle != NULL)
+		{
+			waitForThread(passiveThreadHandle, INFINITE);
+			CloseHandle(passiveThreadHandle);
+			passiveThreadHandle = NULL;
+		}
 		WSACloseEvent(tcpEvent);
 		WSACloseEvent(udpEvent);
 		shutdown(udpSocket, SD_BOTH);
 		shutdown(tcpSocket, SD_BOTH);
 		closesocket(udpSocket);
 		closesocket(tcpSocket);
+		if (unixSocket != INVALID_SOCKET)
+		{
+			closesocket(unixSocket);
+			unixSocket = INVALID_SOCKET;
+			DeleteFile(unixPath);
+		}
+		resetReceiver(&reliable);
+		closeCapture();
+		capturing = false;
 		closeFile(hWriteFile);
 		closeFile(hServerLogFile);
 		WSACleanup();
 	}
 }
 
-/*---------------------------------------------------------------------------------
---	FUNCTION: cleanUpServer
---
---	DATE:		Jan 6, 2008
---
---	REVISIONS:	Jan 6, 2008
---
---	DESIGNER:	Aman Abdulla
---
---	PROGRAMMER:	Aman Abdulla
---
---	INTERFACE:	long delay(SYSTEMTIME t1, SYSTEMTIME t2)
---
---	PARAMETERS:	SYSTEMTIME t1, t2 - SYSTEMTIME data structures
---
---	RETURNS:	the difference in milliseconds between the two SYSTEMTIMEs.
---
---	NOTES:
---	This function calculates and returns the difference (in milliseconds) between
---	two SYSTEMTIME data structures.
---
----------------------------------------------------------------------------------*/
-long delay(SYSTEMTIME t1, SYSTEMTIME t2)
-{
-	long d;
-
-	d = (t2.wSecond - t1.wSecond) * 1000;
-	d += (t2.wMilliseconds - t1.wMilliseconds);
-	return(d);
-}
-
 /*---------------------------------------------------------------------------------
 --	FUNCTION: displayStats
 --
 --	DATE:		Feb 14, 2016
 --
 --	REVISIONS:	Feb 14, 2016
+--				Oct 19, 2026 - prints a merged STATS_SNAPSHOT with 64-bit totals
+--				Oct 19, 2026 - reports receive buffer and drop attribution
+--				Oct 19, 2026 - message rate and size distribution
+--				Oct 19, 2026 - reports pool usage
+--				Oct 19, 2026 - reports connections and working set per connection
+--				Oct 19, 2026 - reports capture counts
+--				Oct 19, 2026 - reports integrity results
+--				Oct 19, 2026 - whole-run and steady-state throughput
+--				Oct 19, 2026 - reports flow table usage
+--				Oct 19, 2026 - transport comparison
+--				Oct 19, 2026 - CPU cost per byte and per packet
+--				Oct 19, 2026 - thread placement
+--				Oct 19, 2026 - latency and receive mode comparison
+--				Oct 19, 2026 - receive buffer only where the transport sets it
+--				Oct 19, 2026 - shows pool blocks taken from the heap
 --
 --	DESIGNER:	Gabriella Cheung
 --
 --	PROGRAMMER:	Gabriella Cheung
 --
---	INTERFACE:	void displayStats(TRANSFER_STATS *stats)
+--	INTERFACE:	void displayStats(STATS_SNAPSHOT *stats)
 --
---	PARAMETERS:	TRANSFER_STATS * stats - data structure that contains transfer statistics
+--	PARAMETERS:	STATS_SNAPSHOT * stats - merged transfer statistics since the last reset
 --
 --	RETURNS:	none
 --
 --	NOTES:
 --	This function is responsible for going through the transfer statistics data
 --  structure and printing out the data to the screen. It also writes the same
---  data to the server log file.
+--  data to the server log file, followed by the transport comparison. The
+--  CPU the process used over the transfer follows the throughput.
 --
 ---------------------------------------------------------------------------------*/
-void displayStats(TRANSFER_STATS *stats)
+void displayStats(STATS_SNAPSHOT *stats)
 {
 	char data[256] = { 0 };
 	sprintf(data, "Data received via %s", stats->protocol);
 	writeToScreen(data);
 	strcat(data, "\r\n");
 	writeToFile(hServerLogFile, data);
+	logPlacement(&placement, hServerLogFile);
 	sprintf(data, "Start time: %d-%02d-%02d %02d:%02d:%02d:%03d",
 		(stats->startTime.wYear),
 		(stats->startTime.wMonth),
@@ -785,16 +1354,1425 @@ void displayStats(TRANSFER_STATS *stats)
 	writeToScreen(data);
 	strcat(data, "\r\n");
 	writeToFile(hServerLogFile, data);
-	sprintf(data, "Packets received: %d", stats->packetCount);
+	sprintf(data, "Packets received: %llu", stats->total.packetCount);
 	writeToScreen(data);
 	strcat(data, "\r\n");
 	writeToFile(hServerLogFile, data);
-	sprintf(data, "Total bytes received: %d Bytes", stats->totalSize);
+	sprintf(data, "Total bytes received: %llu Bytes", stats->total.totalSize);
 	writeToScreen(data);
 	strcat(data, "\r\n");
 	writeToFile(hServerLogFile, data);
-	sprintf(data, "Total transfer time: %ld milliseconds", delay(stats->startTime, stats->endTime));
-	writeToScreen(data);
-	strcat(data, "\r\n\r\n");
-	writeToFile(hServerLogFile, data);
+	//only the UDP socket reports its buffer here, TCP's is printed when the server starts
+	if (stats->receiveBuffer > 0)
+	{
+		sprintf(data, "Receive buffer: %d bytes", stats->receiveBuffer);
+		writeToScreen(data);
+		strcat(data, "\r\n");
+		writeToFile(hServerLogFile, data);
+	}
+	if (stats->countDrops)
+	{
+		sprintf(data, "Dropped by kernel (system-wide UDP InErrors): %lu", stats->kernelDrops);
+		writeToScreen(data);
+		strcat(data, "\r\n");
+		writeToFile(hServerLogFile, data);
+		sprintf(data, "Flows: %ld active, high water %ld of %d, %llu datagrams untracked",
+			udpFlows.active, udpFlows.highWater, FLOW_MAX_FLOWS, udpFlows.untracked);
+		writeToScreen(data);
+		strcat(data, "\r\n");
+		writeToFile(hServerLogFile, data);
+	}
+	if (stats->expected > 0)
+	{
+		ULONGLONG missing = stats->expected > stats->total.sequenced ? stats->expected - stats->total.sequenced : 0;
+		ULONGLONG inKernel = missing < stats->kernelDrops ? missing : stats->kernelDrops;
+		sprintf(data, "Datagrams sent: %llu, missing: %llu (kernel: %llu, in flight: %llu)",
+			stats->expected, missing, inKernel, missing - inKernel);
+		writeToScreen(data);
+		strcat(data, "\r\n");
+		writeToFile(hServerLogFile, data);
+	}
+	if (stats->total.messageCount > 0)
+	{
+		sprintf(data, "Messages received: %llu (%llu messages/s)", stats->total.messageCount,
+			stats->transferTime > 0 ? stats->total.messageCount * 1000 / stats->transferTime : stats->total.messageCount);
+		writeToScreen(data);
+		strcat(data, "\r\n");
+		writeToFile(hServerLogFile, data);
+		for (int i = 0; i < MESSAGE_SIZE_BUCKETS; i++)
+		{
+			if (stats->total.messageSizes[i] == 0)
+			{
+				continue;
+			}
+			if (i == MESSAGE_SIZE_BUCKETS - 1)
+			{
+				sprintf(data, "    %lu+ bytes: %llu", messageSizeLimit(i), stats->total.messageSizes[i]);
+			}
+			else {
+				sprintf(data, "    %lu-%lu bytes: %llu", messageSizeLimit(i), messageSizeLimit(i + 1) - 1, stats->total.messageSizes[i]);
+			}
+			writeToScreen(data);
+			strcat(data, "\r\n");
+			writeToFile(hServerLogFile, data);
+		}
+	}
+	if (stats->total.timed > 0 || stats->total.delivery.count > 0)
+	{
+		displayLatency(stats);
+	}
+	if (stats->total.verified + stats->total.corrupted + stats->total.truncated > 0)
+	{
+		sprintf(data, "CRC32C (%s) verified: %llu, corrupted: %llu, truncated: %llu", checksumMethod(),
+			stats->total.verified, stats->total.corrupted, stats->total.truncated);
+		writeToScreen(data);
+		strcat(data, "\r\n");
+		writeToFile(hServerLogFile, data);
+	}
+	if (stats->total.framingErrors > 0)
+	{
+		sprintf(data, "Connections that lost framing: %llu", stats->total.framingErrors);
+		writeToScreen(data);
+		strcat(data, "\r\n");
+		writeToFile(hServerLogFile, data);
+	}
+	if (stats->connections > 0)
+	{
+		sprintf(data, "Open connections: %ld, %Iu bytes of state each", stats->connections, sizeof(SOCKET_INFORMATION));
+		writeToScreen(data);
+		strcat(data, "\r\n");
+		writeToFile(hServerLogFile, data);
+		sprintf(data, "Working set: %Iu KB, %Iu bytes per connection above idle",
+			stats->workingSet / 1024, stats->workingSet > idleWorkingSet ? (stats->workingSet - idleWorkingSet) / stats->connections : 0);
+		writeToScreen(data);
+		strcat(data, "\r\n");
+		writeToFile(hServerLogFile, data);
+	}
+	for (int i = 0; i < POOL_CLASSES; i++)
+	{
+		POOL_STATS pool;
+		getPoolStats(i, &pool);
+		if (pool.highWater == 0)
+		{
+			continue;
+		}
+		sprintf(data, "Pool %lu byte blocks: %ld in use, high water %ld of %ld",
+			pool.blockSize, pool.inUse, pool.highWater, pool.capacity);
+		if (pool.overflowed > 0)
+		{
+			sprintf(data + strlen(data), ", %ld more from the heap", pool.overflowed);
+		}
+		writeToScreen(data);
+		strcat(data, "\r\n");
+		writeToFile(hServerLogFile, data);
+	}
+	if (capturing)
+	{
+		CAPTURE_STATS capture;
+		getCaptureStats(&capture);
+		sprintf(data, "Captured packets: %llu (%llu bytes), dropped from capture: %ld",
+			capture.records, capture.bytes, capture.dropped);
+		writeToScreen(data);
+		strcat(data, "\r\n");
+		writeToFile(hServerLogFile, data);
+	}
+	sprintf(data, "Whole run: %.2f Mbit/s, %.0f messages/s",
+		stats->transferTime > 0 ? stats->total.totalSize * 8.0 / stats->transferTime / 1000 : 0.0,
+		stats->transferTime > 0 ? stats->total.messageCount * 1000.0 / stats->transferTime : 0.0);
+	writeToScreen(data);
+	strcat(data, "\r\n");
+	writeToFile(hServerLogFile, data);
+	if (stats->steadyTime > 0)
+	{
+		sprintf(data, "Steady state (%lu s warmup, %lu s cooldown left out): %llu bytes in %llu milliseconds, %.2f Mbit/s, %.0f messages/s",
+			serverOptions.warmup, serverOptions.cooldown, stats->steadyBytes, stats->steadyTime,
+			stats->steadyBytes * 8.0 / stats->steadyTime / 1000, stats->steadyMessages * 1000.0 / stats->steadyTime);
+	}
+	else {
+		sprintf(data, "Steady state: transfer shorter than the %lu s warmup and %lu s cooldown",
+			serverOptions.warmup, serverOptions.cooldown);
+	}
+	writeToScreen(data);
+	strcat(data, "\r\n");
+	writeToFile(hServerLogFile, data);
+	if (stats->cpu.wallTime > 0)
+	{
+		logCpuCost(&(stats->cpu), stats->total.totalSize, stats->total.packetCount, hServerLogFile);
+	}
+	sprintf(data, "Total transfer time: %llu milliseconds", stats->transferTime);
+	writeToScreen(data);
+	strcat(data, "\r\n\r\n");
+	writeToFile(hServerLogFile, data);
+	compareTransports(stats);
+	if (strcmp(stats->protocol, "UDP") == 0)
+	{
+		compareReceiveModes(stats);
+	}
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: displayGroups
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void displayGroups()
+--
+--	PARAMETERS:	none
+--
+--	RETURNS:	none
+--
+--	NOTES:
+--	Prints one line per multicast group that received datagrams in the transfer,
+--  with the datagrams the sender numbered but this receiver never saw and the
+--  throughput over the group's own first to last datagram, then resets the
+--  group. With several receivers on one host each prints its own loss, so the
+--  receivers can be compared.
+--
+---------------------------------------------------------------------------------*/
+void displayGroups()
+{
+	char data[256];
+	STATS_SNAPSHOT snapshot;
+	ULONGLONG missing;
+
+	for (int i = 0; i < groupCount; i++)
+	{
+		snapshotStats(&(groups[i].stats), &snapshot);
+		if (snapshot.total.packetCount > 0)
+		{
+			missing = snapshot.expected > snapshot.total.sequenced ? snapshot.expected - snapshot.total.sequenced : 0;
+			sprintf(data, "Group %s: %llu datagrams, %llu bytes, missing %llu of %llu (%.2f%%), %.1f Mbit/s",
+				inet_ntoa(groups[i].address), snapshot.total.packetCount, snapshot.total.totalSize,
+				missing, snapshot.expected, snapshot.expected > 0 ? missing * 100.0 / snapshot.expected : 0.0,
+				snapshot.transferTime > 0 ? snapshot.total.totalSize * 8.0 / snapshot.transferTime / 1000 : 0.0);
+			writeToScreen(data);
+			strcat(data, "\r\n");
+			writeToFile(hServerLogFile, data);
+		}
+		resetStats(&(groups[i].stats), &snapshot);
+	}
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: displayFlow
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void displayFlow(FLOW *flow)
+--
+--	PARAMETERS:	FLOW *flow - flow that has been idle for FLOW_IDLE_TIMEOUT
+--
+--	RETURNS:	none
+--
+--	NOTES:
+--	Prints one line for the flow: its sender, datagrams and bytes, the
+--  datagrams the sender numbered but never arrived, and the throughput over
+--  the flow's own first to last datagram. Integrity results are added when
+--  the sender used integrity mode.
+--
+---------------------------------------------------------------------------------*/
+void displayFlow(FLOW *flow)
+{
+	char data[512];
+	struct in_addr address;
+	ULONGLONG expected = flow->highSequence == NO_SEQUENCE ? 0 : (ULONGLONG)flow->highSequence + 1;
+	ULONGLONG missing = expected > flow->sequenced ? expected - flow->sequenced : 0;
+	ULONGLONG elapsed = (flow->lastTime - flow->firstTime) / 10000;
+
+	address.s_addr = flow->address;
+	sprintf(data, "Flow %s:%d id %08lx: %llu datagrams, %llu bytes, missing %llu of %llu (%.2f%%), %.1f Mbit/s over %llu ms",
+		inet_ntoa(address), ntohs(flow->port), flow->id, flow->packets, flow->bytes,
+		missing, expected, expected > 0 ? missing * 100.0 / expected : 0.0,
+		elapsed > 0 ? flow->bytes * 8.0 / elapsed / 1000 : 0.0, elapsed);
+	if (flow->verified + flow->corrupted + flow->truncated > 0)
+	{
+		sprintf(data + strlen(data), ", CRC32C verified %llu, corrupted %llu, truncated %llu",
+			flow->verified, flow->corrupted, flow->truncated);
+	}
+	writeToScreen(data);
+	strcat(data, "\r\n");
+	writeToFile(hServerLogFile, data);
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: statsSampler
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--				Oct 19, 2026 - samples the local transports
+--				Oct 19, 2026 - samples reliable UDP
+--				Oct 19, 2026 - names the thread in traces
+--				Oct 19, 2026 - thread placement
+--				Oct 19, 2026 - samples the passive capture
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	DWORD WINAPI statsSampler(LPVOID lpParameter)
+--
+--	PARAMETERS:	LPVOID lpParameter - unused
+--
+--	RETURNS:	DWORD
+--
+--	NOTES:
+--	Samples every transport's statistics every STATS_SAMPLE_INTERVAL until the
+--  server stops, for the steady-state figures.
+--
+---------------------------------------------------------------------------------*/
+DWORD WINAPI statsSampler(LPVOID lpParameter)
+{
+	TRACE_THREAD("stats sampler");
+	placeThread(GetCurrentThread(), &placement, PLACE_WRITER);
+	while (serverRunning)
+	{
+		Sleep(STATS_SAMPLE_INTERVAL);
+		sampleStats(&tcpStats);
+		sampleStats(&udpStats);
+		sampleStats(&unixStats);
+		sampleStats(&ringStats);
+		sampleStats(&reliableStats);
+		sampleStats(&passiveTcpStats);
+		sampleStats(&passiveUdpStats);
+	}
+	return 0;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: growReceiveBuffer
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void growReceiveBuffer()
+--
+--	PARAMETERS:	none
+--
+--	RETURNS:	none
+--
+--	NOTES:
+--	This function doubles the UDP socket's receive buffer, up to
+--  RCVBUF_AUTOTUNE_MAX. It is called by startUDPServer when the kernel dropped
+--  datagrams since the last sample.
+--
+---------------------------------------------------------------------------------*/
+void growReceiveBuffer()
+{
+	char message[256];
+	int size;
+
+	if (udpReceiveBuffer >= RCVBUF_AUTOTUNE_MAX)
+	{
+		return;
+	}
+	size = udpReceiveBuffer > 0 ? udpReceiveBuffer * 2 : 65536;
+	if (size > RCVBUF_AUTOTUNE_MAX)
+	{
+		size = RCVBUF_AUTOTUNE_MAX;
+	}
+	udpReceiveBuffer = setSocketBuffer(udpSocket, SO_RCVBUF, size);
+	sprintf(message, "Kernel dropped datagrams, UDP receive buffer grown to %d bytes", udpReceiveBuffer);
+	writeToScreen(message);
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: savePayload
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void savePayload(char *data, DWORD length)
+--
+--	PARAMETERS:	char *data - payload bytes from a TCP receive
+--				DWORD length - number of bytes
+--
+--	RETURNS:	none
+--
+--	NOTES:
+--	Payload handler given to parseFrames. It writes the payload to the file the
+--  user chose to save to.
+--
+---------------------------------------------------------------------------------*/
+void savePayload(char *data, DWORD length)
+{
+	if (!writeDataToFile(hWriteFile, data, length))
+	{
+		writeToScreen("Saving incoming data failed");
+	}
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: newSocketInfo
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--				Oct 19, 2026 - clears addresses and byte count
+--				Oct 19, 2026 - room for WSARecvMsg arguments after the UDP buffer
+--				Oct 19, 2026 - no TCP_INFO series
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	LPSOCKET_INFORMATION newSocketInfo(SOCKET socket, DWORD bufferSize)
+--
+--	PARAMETERS:	SOCKET socket - socket the receives will be posted on
+--				DWORD bufferSize - size of the receive buffer, 0 for none
+--
+--	RETURNS:	a socket information structure ready for WSARecv, or NULL if the
+--				pool is exhausted
+--
+--	NOTES:
+--	This function takes the structure and its receive buffer from the pool.
+--  Pool blocks are not zeroed, so every field is set here, and the buffer
+--  itself is left as it is because receives overwrite it. TCP connections ask
+--  for no buffer and post zero-byte receives instead. A UDP buffer is followed
+--  by the WSARecvMsg arguments in the same block; DATA_BUFSIZE is a multiple of
+--  8, so they stay aligned.
+--
+---------------------------------------------------------------------------------*/
+LPSOCKET_INFORMATION newSocketInfo(SOCKET socket, DWORD bufferSize)
+{
+	LPSOCKET_INFORMATION socketInfo;
+
+	if ((socketInfo = (LPSOCKET_INFORMATION)poolAlloc(sizeof(SOCKET_INFORMATION))) == NULL)
+	{
+		return NULL;
+	}
+	socketInfo->Buffer = NULL;
+	socketInfo->Control = NULL;
+	socketInfo->TcpInfo = NULL;
+	if (bufferSize > 0)
+	{
+		if ((socketInfo->Buffer = (CHAR *)poolAlloc(bufferSize + sizeof(RECEIVE_CONTROL))) == NULL)
+		{
+			poolFree(socketInfo);
+			return NULL;
+		}
+		socketInfo->Control = (RECEIVE_CONTROL *)(socketInfo->Buffer + bufferSize);
+	}
+	socketInfo->Socket = socket;
+	ZeroMemory(&(socketInfo->Overlapped), sizeof(WSAOVERLAPPED));
+	socketInfo->DataBuf.len = bufferSize;
+	socketInfo->DataBuf.buf = socketInfo->Buffer;
+	ZeroMemory(&(socketInfo->Parser), sizeof(FRAME_PARSER));
+	ZeroMemory(&(socketInfo->Peer), sizeof(SOCKADDR_IN));
+	socketInfo->PeerSize = sizeof(SOCKADDR_IN);
+	ZeroMemory(&(socketInfo->Local), sizeof(SOCKADDR_IN));
+	socketInfo->Received = 0;
+	return socketInfo;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: freeSocketInfo
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--				Oct 19, 2026 - frees the TCP_INFO series
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void freeSocketInfo(LPSOCKET_INFORMATION socketInfo)
+--
+--	PARAMETERS:	LPSOCKET_INFORMATION socketInfo - structure from newSocketInfo
+--
+--	RETURNS:	none
+--
+--	NOTES:
+--	Returns the structure and its receive buffer to the pool, and frees its
+--  TCP_INFO series. The socket is not closed, since the UDP server shares one
+--  socket between all receives.
+--
+---------------------------------------------------------------------------------*/
+void freeSocketInfo(LPSOCKET_INFORMATION socketInfo)
+{
+	if (socketInfo->Buffer != NULL)
+	{
+		poolFree(socketInfo->Buffer);
+	}
+	if (socketInfo->TcpInfo != NULL)
+	{
+		free(socketInfo->TcpInfo);
+		InterlockedDecrement(&sampledConnections);
+	}
+	poolFree(socketInfo);
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: waitForData
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	BOOL waitForData(LPSOCKET_INFORMATION socketInfo)
+--
+--	PARAMETERS:	LPSOCKET_INFORMATION socketInfo - TCP connection to wait on
+--
+--	RETURNS:	TRUE if the receive was posted, FALSE if the connection should be
+--				closed
+--
+--	NOTES:
+--	Posts a zero-byte WSARecv. It completes when data is ready without any
+--  buffer being locked for it, so an idle connection holds no receive buffer.
+--
+---------------------------------------------------------------------------------*/
+BOOL waitForData(LPSOCKET_INFORMATION socketInfo)
+{
+	DWORD flags = 0;
+	int error;
+	char message[256];
+
+	ZeroMemory(&(socketInfo->Overlapped), sizeof(WSAOVERLAPPED));
+	if (WSARecv(socketInfo->Socket, &(socketInfo->DataBuf), 1, NULL, &flags, &(socketInfo->Overlapped), tcpRoutine) == SOCKET_ERROR)
+	{
+		if ((error = WSAGetLastError()) != WSA_IO_PENDING)
+		{
+			sprintf(message, "WSARecv failed with error %d", error);
+			writeToScreen(message);
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: readConnection
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--				Oct 19, 2026 - captures reads as TCP segments
+--				Oct 19, 2026 - counts checked frames cut short by a close
+--				Oct 19, 2026 - trace point
+--				Oct 19, 2026 - samples TCP_INFO
+--				Oct 19, 2026 - counts frames cut short by a reset
+--				Oct 19, 2026 - closes the connection when no buffer can be had
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	BOOL readConnection(LPSOCKET_INFORMATION socketInfo)
+--
+--	PARAMETERS:	LPSOCKET_INFORMATION socketInfo - TCP connection with data ready
+--
+--	RETURNS:	TRUE if the connection is still open, FALSE if the peer closed it
+--				or the read failed
+--
+--	NOTES:
+--	Called after a zero-byte receive completes. A buffer is borrowed from the
+--  pool only for the reads, which continue until the socket would block. After
+--  READ_BATCH reads the connection is put back in the queue so a fast sender
+--  cannot starve the others; the next zero-byte receive completes at once.
+--  The first TCP_INFO_CONNECTIONS connections have their TCP_INFO sampled
+--  here, on the thread that owns them, from their first read to their close.
+--
+---------------------------------------------------------------------------------*/
+BOOL readConnection(LPSOCKET_INFORMATION socketInfo)
+{
+	char *buffer;
+	int received = 0, error = 0;
+	char message[256];
+	STATS_COUNTERS messages;
+	DWORD receivedBefore = socketInfo->Received;
+	ULONGLONG traceStart = TRACE_START();
+
+	if ((buffer = (char *)poolAlloc(DATA_BUFSIZE)) == NULL)
+	{
+		// the data would still be waiting, so the next zero-byte receive would complete at once
+		writeToScreen("Not enough memory for a receive buffer, closing connection");
+		ZeroMemory(&messages, sizeof(messages));
+		endFrames(&(socketInfo->Parser), &messages);
+		recordPacket(&tcpStats, 0, NO_SEQUENCE, &messages);
+		return FALSE;
+	}
+	if (socketInfo->Received == 0 && socketInfo->TcpInfo == NULL)
+	{
+		if (InterlockedIncrement(&sampledConnections) <= TCP_INFO_CONNECTIONS
+			&& (socketInfo->TcpInfo = (TCP_INFO_SERIES *)malloc(sizeof(TCP_INFO_SERIES))) != NULL)
+		{
+			startTcpInfo(socketInfo->TcpInfo, socketInfo->Socket);
+		}
+		else {
+			InterlockedDecrement(&sampledConnections);
+		}
+	}
+	else if (socketInfo->TcpInfo != NULL)
+	{
+		sampleTcpInfo(socketInfo->TcpInfo);
+	}
+	for (int i = 0; i < READ_BATCH; i++)
+	{
+		if ((received = recv(socketInfo->Socket, buffer, DATA_BUFSIZE, 0)) <= 0)
+		{
+			break;
+		}
+		if (capturing)
+		{
+			captureTcp(&(socketInfo->Peer), &(socketInfo->Local), socketInfo->Received, buffer, received);
+		}
+		socketInfo->Received += received;
+		ZeroMemory(&messages, sizeof(messages));
+		parseFrames(&(socketInfo->Parser), buffer, received, &messages,
+			hWriteFile != NULL && !capturing ? savePayload : NULL);
+		recordPacket(&tcpStats, received, NO_SEQUENCE, &messages);
+	}
+	poolFree(buffer);
+	TRACE_END(TRACE_TCP_RECEIVE, traceStart, socketInfo->Received - receivedBefore);
+
+	if (received == SOCKET_ERROR && (error = WSAGetLastError()) != WSAEWOULDBLOCK)
+	{
+		sprintf(message, "recv failed with error %d", error);
+		writeToScreen(message);
+	}
+	else if (received != 0)
+	{
+		return TRUE;
+	}
+	// a frame cut off by the close or a reset is counted as truncated
+	ZeroMemory(&messages, sizeof(messages));
+	endFrames(&(socketInfo->Parser), &messages);
+	recordPacket(&tcpStats, 0, NO_SEQUENCE, &messages);
+	return FALSE;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: closeConnection
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void closeConnection(LPSOCKET_INFORMATION socketInfo)
+--
+--	PARAMETERS:	LPSOCKET_INFORMATION socketInfo - TCP connection to close
+--
+--	RETURNS:	none
+--
+--	NOTES:
+--	Closes the socket and returns the connection state to the pool.
+--
+---------------------------------------------------------------------------------*/
+void closeConnection(LPSOCKET_INFORMATION socketInfo)
+{
+	closesocket(socketInfo->Socket);
+	freeSocketInfo(socketInfo);
+	InterlockedDecrement(&openConnections);
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: startUnixServer
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--				Oct 19, 2026 - names the thread in traces
+--				Oct 19, 2026 - thread placement
+--				Oct 19, 2026 - gives its pool cache back
+--				Oct 19, 2026 - Back off from failed accepts instead of spinning
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	DWORD WINAPI startUnixServer(LPVOID n)
+--
+--	PARAMETERS:	LPVOID n
+--
+--	RETURNS:	DWORD
+--
+--	NOTES:
+--	Listens on a Unix domain stream socket named after the TCP port and reads
+--  each connection to the end with blocking receives, recording it exactly as
+--  readConnection does for TCP. Connections are served one at a time: this
+--  is a single-stream baseline, not a second TCP server. A path left behind
+--  by a server that did not stop cleanly is removed before binding. A failed
+--  accept is retried after ACCEPT_RETRY, and ACCEPT_FAILURES in a row stop
+--  the server rather than spin.
+--
+---------------------------------------------------------------------------------*/
+DWORD WINAPI startUnixServer(LPVOID n)
+{
+	SOCKADDR_UN address;
+	SOCKET acceptSocket;
+	FRAME_PARSER parser;
+	STATS_COUNTERS messages;
+	char message[256];
+	char *buffer;
+	int received;
+	int failures = 0;
+
+	TRACE_THREAD("Unix stream receive");
+	placeThread(GetCurrentThread(), &placement, PLACE_RECEIVE);
+	memset((char *)&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	if (!localSocketPath(tPort, address.sun_path))
+	{
+		writeToScreen("Unix socket server: temporary directory path is too long");
+		ExitThread(0);
+	}
+	if ((unixSocket = socket(AF_UNIX, SOCK_STREAM, 0)) == INVALID_SOCKET)
+	{
+		writeToScreen("Unix domain sockets unavailable (Windows 10 1803 or later)");
+		ExitThread(0);
+	}
+	strcpy(unixPath, address.sun_path);
+	DeleteFile(unixPath);
+	if (bind(unixSocket, (struct sockaddr *)&address, sizeof(address)) == SOCKET_ERROR
+		|| listen(unixSocket, SOMAXCONN) == SOCKET_ERROR)
+	{
+		sprintf(message, "Can't listen on Unix socket %s, error %d", unixPath, WSAGetLastError());
+		writeToScreen(message);
+		ExitThread(0);
+	}
+	sprintf(message, "Starting Unix socket server at %s", unixPath);
+	writeToScreen(message);
+
+	while (serverRunning)
+	{
+		if ((acceptSocket = accept(unixSocket, NULL, NULL)) == INVALID_SOCKET)
+		{
+			// closing the socket to stop the server fails the accept too
+			if (!serverRunning)
+			{
+				break;
+			}
+			sprintf(message, "Unix socket accept failed, error %d", WSAGetLastError());
+			writeToScreen(message);
+			if (++failures >= ACCEPT_FAILURES)
+			{
+				writeToScreen("Unix socket server stopped after repeated accept failures");
+				break;
+			}
+			Sleep(ACCEPT_RETRY);
+			continue;
+		}
+		failures = 0;
+		if ((buffer = (char *)poolAlloc(DATA_BUFSIZE)) == NULL)
+		{
+			writeToScreen("Not enough memory for a receive buffer, closing connection");
+			closesocket(acceptSocket);
+			continue;
+		}
+		ZeroMemory(&parser, sizeof(FRAME_PARSER));
+		while ((received = recv(acceptSocket, buffer, DATA_BUFSIZE, 0)) > 0)
+		{
+			ZeroMemory(&messages, sizeof(messages));
+			parseFrames(&parser, buffer, received, &messages,
+				hWriteFile != NULL && !capturing ? savePayload : NULL);
+			recordPacket(&unixStats, received, NO_SEQUENCE, &messages);
+		}
+		ZeroMemory(&messages, sizeof(messages));
+		endFrames(&parser, &messages);
+		recordPacket(&unixStats, 0, NO_SEQUENCE, &messages);
+		poolFree(buffer);
+		closesocket(acceptSocket);
+		reportLocal(&unixStats);
+	}
+	releasePool();
+	ExitThread(0);
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: ringThread
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--				Oct 19, 2026 - names the thread in traces
+--				Oct 19, 2026 - thread placement
+--				Oct 19, 2026 - gives its pool cache back
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	DWORD WINAPI ringThread(LPVOID n)
+--
+--	PARAMETERS:	LPVOID n
+--
+--	RETURNS:	DWORD
+--
+--	NOTES:
+--	Creates the shared-memory ring for the TCP port and reads it until the
+--  server stops. Each message the client wrote is one receive, recorded and
+--  parsed for frames like a TCP read. When the client closes the ring the
+--  transfer is reported and the ring is ready for the next client. Reads time
+--  out every RING_WAIT so the thread notices the server stopping.
+--
+---------------------------------------------------------------------------------*/
+DWORD WINAPI ringThread(LPVOID n)
+{
+	RING ring;
+	FRAME_PARSER parser;
+	STATS_COUNTERS messages;
+	char message[256];
+	char *buffer;
+	int received;
+
+	TRACE_THREAD("shared memory receive");
+	placeThread(GetCurrentThread(), &placement, PLACE_RECEIVE);
+	if ((buffer = (char *)poolAlloc(DATA_BUFSIZE)) == NULL || !openRing(&ring, tPort, TRUE))
+	{
+		writeToScreen("Shared-memory ring unavailable");
+		poolFree(buffer);
+		ExitThread(0);
+	}
+	sprintf(message, "Starting shared-memory server on port %d, %d byte ring", tPort, RING_SIZE);
+	writeToScreen(message);
+
+	ZeroMemory(&parser, sizeof(FRAME_PARSER));
+	while (serverRunning)
+	{
+		if ((received = ringRead(&ring, buffer, DATA_BUFSIZE)) < 0)
+		{
+			continue;
+		}
+		ZeroMemory(&messages, sizeof(messages));
+		if (received == 0)
+		{
+			endFrames(&parser, &messages);
+			recordPacket(&ringStats, 0, NO_SEQUENCE, &messages);
+			reportLocal(&ringStats);
+			ZeroMemory(&parser, sizeof(FRAME_PARSER));
+			continue;
+		}
+		parseFrames(&parser, buffer, received, &messages,
+			hWriteFile != NULL && !capturing ? savePayload : NULL);
+		recordPacket(&ringStats, received, NO_SEQUENCE, &messages);
+	}
+	closeRing(&ring);
+	poolFree(buffer);
+	releasePool();
+	ExitThread(0);
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: reportLocal
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--				Oct 19, 2026 - CPU cost
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void reportLocal(TRANSFER_STATS *stats)
+--
+--	PARAMETERS:	TRANSFER_STATS *stats - a local transport's statistics
+--
+--	RETURNS:	none
+--
+--	NOTES:
+--	Prints and resets a local transport's statistics at the end of a transfer,
+--  the way tcpRoutine does when a connection closes.
+--
+---------------------------------------------------------------------------------*/
+void reportLocal(TRANSFER_STATS *stats)
+{
+	STATS_SNAPSHOT snapshot;
+
+	snapshotStats(stats, &snapshot);
+	steadyState(stats, &snapshot);
+	transferCost(stats, &snapshot);
+	displayStats(&snapshot);
+	resetStats(stats, &snapshot);
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: compareTransports
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void compareTransports(STATS_SNAPSHOT *stats)
+--
+--	PARAMETERS:	STATS_SNAPSHOT *stats - transfer just reported
+--
+--	RETURNS:	none
+--
+--	NOTES:
+--	Keeps the transfer as its transport's latest and, once at least two
+--  transports have been measured, prints one line per transport so runs with
+--  the same payloads can be read side by side. Each transport's entry is only
+--  written by the thread that reports that transport.
+--
+---------------------------------------------------------------------------------*/
+void compareTransports(STATS_SNAPSHOT *stats)
+{
+	char data[256];
+	TRANSPORT_RESULT *result = NULL;
+	int reported = 0;
+
+	for (int i = 0; i < TRANSPORTS; i++)
+	{
+		if (strcmp(transports[i].protocol, stats->protocol) == 0)
+		{
+			result = &transports[i];
+		}
+	}
+	if (result == NULL || stats->total.totalSize == 0)
+	{
+		return;
+	}
+	result->bytes = stats->total.totalSize;
+	result->messages = stats->total.messageCount;
+	result->transferTime = stats->transferTime;
+	result->steadyBytes = stats->steadyBytes;
+	result->steadyTime = stats->steadyTime;
+	result->reported = TRUE;
+
+	for (int i = 0; i < TRANSPORTS; i++)
+	{
+		reported += transports[i].reported ? 1 : 0;
+	}
+	if (reported < 2)
+	{
+		return;
+	}
+	sprintf(data, "Transport comparison, latest transfer of each:");
+	writeToScreen(data);
+	strcat(data, "\r\n");
+	writeToFile(hServerLogFile, data);
+	for (int i = 0; i < TRANSPORTS; i++)
+	{
+		result = &transports[i];
+		if (!result->reported)
+		{
+			continue;
+		}
+		sprintf(data, "    %-14s %llu bytes in %llu ms, %.2f Mbit/s, %.0f messages/s, steady state %.2f Mbit/s",
+			result->protocol, result->bytes, result->transferTime,
+			result->transferTime > 0 ? result->bytes * 8.0 / result->transferTime / 1000 : 0.0,
+			result->transferTime > 0 ? result->messages * 1000.0 / result->transferTime : 0.0,
+			result->steadyTime > 0 ? result->steadyBytes * 8.0 / result->steadyTime / 1000 : 0.0);
+		writeToScreen(data);
+		strcat(data, "\r\n");
+		writeToFile(hServerLogFile, data);
+	}
+	writeToFile(hServerLogFile, "\r\n");
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: reportReliable
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void reportReliable()
+--
+--	PARAMETERS:	none
+--
+--	RETURNS:	none
+--
+--	NOTES:
+--	Called from the UDP thread when a reliable UDP transfer finishes or is
+--  abandoned. Prints the receiver's counters, then the transfer statistics
+--  with their comparison against the other transports.
+--
+---------------------------------------------------------------------------------*/
+void reportReliable()
+{
+	logReceiver(&reliable, hServerLogFile);
+	reportLocal(&reliableStats);
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: displayLatency
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--				Oct 19, 2026 - kernel timestamp split
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void displayLatency(STATS_SNAPSHOT *stats)
+--
+--	PARAMETERS:	STATS_SNAPSHOT *stats - transfer being reported
+--
+--	RETURNS:	none
+--
+--	NOTES:
+--	Prints the latency of the transfer's timed datagrams, from the sender's
+--  clock to the receive, with its percentiles and distribution. Percentiles
+--  are the upper limits of the power-of-two buckets they fall in. With kernel
+--  receive timestamps, the latency is then split at the timestamp into the
+--  part up to the kernel and the part spent waiting for the application,
+--  each with its jitter.
+--
+---------------------------------------------------------------------------------*/
+void displayLatency(STATS_SNAPSHOT *stats)
+{
+	char data[256];
+	ULONGLONG *latency = stats->total.latency;
+	ULONGLONG count = stats->total.timed;
+
+	if (count > 0)
+	{
+		sprintf(data, "Latency (%s receive): %llu timed datagrams, mean %.1f us, p50 < %llu us, p90 < %llu us, p99 < %llu us, p99.9 < %llu us",
+			receiveModes[serverOptions.busyPoll ? 1 : 0].mode, count, (double)stats->total.latencyTotal / count,
+			latencyPercentile(latency, count, 0.5), latencyPercentile(latency, count, 0.9),
+			latencyPercentile(latency, count, 0.99), latencyPercentile(latency, count, 0.999));
+		writeToScreen(data);
+		strcat(data, "\r\n");
+		writeToFile(hServerLogFile, data);
+		for (int i = 0; i < LATENCY_BUCKETS; i++)
+		{
+			if (latency[i] == 0)
+			{
+				continue;
+			}
+			if (i == 0)
+			{
+				sprintf(data, "    <1 us: %llu", latency[i]);
+			}
+			else if (i == LATENCY_BUCKETS - 1)
+			{
+				sprintf(data, "    %llu+ us: %llu", latencyLimit(i), latency[i]);
+			}
+			else {
+				sprintf(data, "    %llu-%llu us: %llu", latencyLimit(i), latencyLimit(i + 1) - 1, latency[i]);
+			}
+			writeToScreen(data);
+			strcat(data, "\r\n");
+			writeToFile(hServerLogFile, data);
+		}
+	}
+	if (stats->total.delivery.count > 0)
+	{
+		sprintf(data, "Kernel receive timestamps: sender to kernel mean %.1f us, jitter %.1f us (%llu timed); kernel to application mean %.1f us, jitter %.1f us (%llu datagrams)",
+			spreadMean(&(stats->total.wire)), spreadJitter(&(stats->total.wire)), stats->total.wire.count,
+			spreadMean(&(stats->total.delivery)), spreadJitter(&(stats->total.delivery)), stats->total.delivery.count);
+		writeToScreen(data);
+		strcat(data, "\r\n");
+		writeToFile(hServerLogFile, data);
+	}
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: compareReceiveModes
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void compareReceiveModes(STATS_SNAPSHOT *stats)
+--
+--	PARAMETERS:	STATS_SNAPSHOT *stats - UDP transfer just reported
+--
+--	RETURNS:	none
+--
+--	NOTES:
+--	Keeps the transfer's latency as the latest of the receive mode the server
+--  runs in. The mode is picked when the server starts, so once a transfer has
+--  been received in each, from restarting the server in the other mode, the
+--  two distributions are printed side by side with the difference in their
+--  percentiles.
+--
+---------------------------------------------------------------------------------*/
+void compareReceiveModes(STATS_SNAPSHOT *stats)
+{
+	char data[256];
+	LATENCY_RESULT *result = &receiveModes[serverOptions.busyPoll ? 1 : 0];
+	LATENCY_RESULT *event = &receiveModes[0], *poll = &receiveModes[1];
+	double fractions[] = { 0.5, 0.9, 0.99, 0.999 };
+
+	if (stats->total.timed == 0)
+	{
+		return;
+	}
+	result->reported = TRUE;
+	result->spin = serverOptions.spin;
+	result->timed = stats->total.timed;
+	result->latencyTotal = stats->total.latencyTotal;
+	memcpy(result->latency, stats->total.latency, sizeof(result->latency));
+	if (!event->reported || !poll->reported)
+	{
+		return;
+	}
+
+	sprintf(data, "Receive mode comparison, latest UDP transfer of each (busy poll spin %lu us):", poll->spin);
+	writeToScreen(data);
+	strcat(data, "\r\n");
+	writeToFile(hServerLogFile, data);
+	sprintf(data, "    %-16s %14s %14s %14s", "latency", event->mode, poll->mode, "difference");
+	writeToScreen(data);
+	strcat(data, "\r\n");
+	writeToFile(hServerLogFile, data);
+	sprintf(data, "    %-16s %11.1f us %11.1f us %+11.1f us", "mean",
+		(double)event->latencyTotal / event->timed, (double)poll->latencyTotal / poll->timed,
+		(double)poll->latencyTotal / poll->timed - (double)event->latencyTotal / event->timed);
+	writeToScreen(data);
+	strcat(data, "\r\n");
+	writeToFile(hServerLogFile, data);
+	for (int i = 0; i < sizeof(fractions) / sizeof(fractions[0]); i++)
+	{
+		ULONGLONG eventLimit = latencyPercentile(event->latency, event->timed, fractions[i]);
+		ULONGLONG pollLimit = latencyPercentile(poll->latency, poll->timed, fractions[i]);
+		char name[16], eventText[32], pollText[32];
+
+		sprintf(name, "p%g", fractions[i] * 100);
+		sprintf(eventText, "< %llu us", eventLimit);
+		sprintf(pollText, "< %llu us", pollLimit);
+		sprintf(data, "    %-16s %14s %14s %+11lld us", name, eventText, pollText, (LONGLONG)pollLimit - (LONGLONG)eventLimit);
+		writeToScreen(data);
+		strcat(data, "\r\n");
+		writeToFile(hServerLogFile, data);
+	}
+	for (int i = 0; i < LATENCY_BUCKETS; i++)
+	{
+		char name[32];
+
+		if (event->latency[i] == 0 && poll->latency[i] == 0)
+		{
+			continue;
+		}
+		if (i == 0)
+		{
+			sprintf(name, "<1 us");
+		}
+		else if (i == LATENCY_BUCKETS - 1)
+		{
+			sprintf(name, "%llu+ us", latencyLimit(i));
+		}
+		else {
+			sprintf(name, "%llu-%llu us", latencyLimit(i), latencyLimit(i + 1) - 1);
+		}
+		sprintf(data, "    %-16s %13.2f%% %13.2f%% %+13.2f%%", name,
+			event->latency[i] * 100.0 / event->timed, poll->latency[i] * 100.0 / poll->timed,
+			poll->latency[i] * 100.0 / poll->timed - event->latency[i] * 100.0 / event->timed);
+		writeToScreen(data);
+		strcat(data, "\r\n");
+		writeToFile(hServerLogFile, data);
+	}
+	writeToFile(hServerLogFile, "\r\n");
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: passiveThread
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--				Oct 19, 2026 - conversation table
+--				Oct 19, 2026 - stops reporting once the server is stopping
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	DWORD WINAPI passiveThread(LPVOID n)
+--
+--	PARAMETERS:	LPVOID n - unused
+--
+--	RETURNS:	DWORD
+--
+--	NOTES:
+--	Reads the passive capture until the server stops. Nothing on the wire marks
+--  the end of a transfer, so each protocol is reported once COMM_TIMEOUT has
+--  passed without a packet of it, and each flow after FLOW_IDLE_TIMEOUT like
+--  the UDP server's flows. The conversations are cleared once both protocols
+--  have been reported.
+--
+---------------------------------------------------------------------------------*/
+DWORD WINAPI passiveThread(LPVOID n)
+{
+	char message[256];
+	ULONGLONG now;
+
+	TRACE_THREAD("passive capture");
+	placeThread(GetCurrentThread(), &placement, PLACE_RECEIVE);
+	if (!initFlows(&passiveTcpFlows) || !initFlows(&passiveUdpFlows) || !initConversations(&passiveConversations))
+	{
+		writeToScreen("Passive capture flow tables unavailable");
+		ExitThread(0);
+	}
+	if (!openPassive(&passive, serverOptions.passiveInterface, &passiveFilter))
+	{
+		sprintf(message, "Passive capture on %s unavailable, error %d%s", serverOptions.passiveInterface, WSAGetLastError(),
+			WSAGetLastError() == WSAEACCES ? " (run as administrator)" : "");
+		writeToScreen(message);
+		ExitThread(0);
+	}
+	sprintf(message, "Passive capture on %s: %s, %d receives of %d bytes posted",
+		serverOptions.passiveInterface, passiveFilter.description, PASSIVE_SLOTS, PASSIVE_SLOT_SIZE);
+	writeToScreen(message);
+	strcat(message, "\r\n");
+	writeToFile(hServerLogFile, message);
+
+	passiveTcpLast = passiveUdpLast = 0;
+	while (serverRunning)
+	{
+		if (readPassive(&passive, passiveBatch) < 0)
+		{
+			writeToScreen("Passive capture stopped");
+			break;
+		}
+		//the server is stopping, the GUI thread is waiting for this one
+		if (!serverRunning)
+		{
+			break;
+		}
+		now = currentFileTime();
+		expireFlows(&passiveTcpFlows, now, displayFlow);
+		expireFlows(&passiveUdpFlows, now, displayFlow);
+		if (passiveTcpLast != 0 && now - passiveTcpLast > COMM_TIMEOUT * 10000ULL)
+		{
+			reportPassive(&passiveTcpStats);
+			passiveTcpLast = 0;
+		}
+		if (passiveUdpLast != 0 && now - passiveUdpLast > COMM_TIMEOUT * 10000ULL)
+		{
+			reportPassive(&passiveUdpStats);
+			passiveUdpLast = 0;
+		}
+		//conversations last until both protocols have gone quiet
+		if (passiveTcpLast == 0 && passiveUdpLast == 0 && passiveConversations.used > 0)
+		{
+			initConversations(&passiveConversations);
+		}
+	}
+	closePassive(&passive);
+	ExitThread(0);
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: passiveBatch
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void passiveBatch(PACKET_BATCH *batch)
+--
+--	PARAMETERS:	PACKET_BATCH *batch - dissected packets, protocol 0 for those
+--								the filter dropped
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	The whole batch goes into the conversation table first. UDP payloads are
+--  then parsed like the UDP server's datagrams, so sequence gaps, integrity
+--  and sender timestamps are counted for this program's clients. TCP segments
+--  are counted by their payload; segments without one only acknowledge and
+--  are left out. A flow is one sender's address and port.
+--
+---------------------------------------------------------------------------------*/
+void passiveBatch(PACKET_BATCH *batch)
+{
+	STATS_COUNTERS messages;
+	LONG sequence;
+	DWORD flow;
+	ULONGLONG sent;
+	SOCKADDR_IN source;
+	char *payload;
+
+	addConversations(&passiveConversations, batch);
+	ZeroMemory(&source, sizeof(source));
+	source.sin_family = AF_INET;
+	for (DWORD i = 0; i < batch->count; i++)
+	{
+		if (batch->protocol[i] == 0)
+		{
+			continue;
+		}
+		ZeroMemory(&messages, sizeof(messages));
+		source.sin_addr.s_addr = ((DWORD *)&(batch->source[i]))[3];
+		source.sin_port = batch->sourcePort[i];
+		payload = (char *)batch->data[i] + batch->payload[i];
+		if (batch->protocol[i] == IPPROTO_UDP)
+		{
+			sequence = NO_SEQUENCE;
+			flow = 0;
+			if (batch->length[i] > 0 && !isReliable(payload, batch->length[i]))
+			{
+				parseDatagram(payload, batch->length[i], batch->truncated[i], &sequence, &flow, &sent, &messages);
+				if (sent != 0)
+				{
+					addLatency(&messages, sent, preciseFileTime());
+				}
+			}
+			recordPacket(&passiveUdpStats, batch->length[i], sequence, &messages);
+			recordFlow(&passiveUdpFlows, &source, flow, batch->length[i], sequence, &messages, batch->time[i]);
+			passiveUdpLast = batch->time[i];
+		}
+		else if (batch->length[i] > 0)
+		{
+			recordPacket(&passiveTcpStats, batch->length[i], NO_SEQUENCE, &messages);
+			recordFlow(&passiveTcpFlows, &source, 0, batch->length[i], NO_SEQUENCE, &messages, batch->time[i]);
+			passiveTcpLast = batch->time[i];
+		}
+	}
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: reportPassive
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--				Oct 19, 2026 - largest conversations
+--				Oct 19, 2026 - Report failed receives
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void reportPassive(TRANSFER_STATS *stats)
+--
+--	PARAMETERS:	TRANSFER_STATS *stats - the passive TCP or UDP statistics
+--
+--	RETURNS:	none
+--
+--	NOTES:
+--	Prints the transfer like a local transport's, followed by what the capture
+--  itself saw and how many packets each wait on the port returned.
+--
+---------------------------------------------------------------------------------*/
+void reportPassive(TRANSFER_STATS *stats)
+{
+	char data[320];
+	FLOW_TABLE *flows = stats == &passiveTcpStats ? &passiveTcpFlows : &passiveUdpFlows;
+	CONVERSATION *top[CONVERSATION_TOP];
+	int count;
+	LARGE_INTEGER frequency;
+
+	reportLocal(stats);
+	QueryPerformanceFrequency(&frequency);
+	sprintf(data, "Passive capture: %llu IP packets, %llu kept by the filter, %llu other, %llu failed receives, %.1f packets per batch, %.0f ns each to dissect",
+		passive.packets, passive.matched, passive.other, passive.failed,
+		passive.batches > 0 ? (double)passive.packets / passive.batches : 0.0,
+		passive.packets > 0 ? passive.dissectTime * 1000000000.0 / frequency.QuadPart / passive.packets : 0.0);
+	writeToScreen(data);
+	strcat(data, "\r\n");
+	writeToFile(hServerLogFile, data);
+	sprintf(data, "Flows: %ld active, high water %ld of %d, %llu packets untracked",
+		flows->active, flows->highWater, FLOW_MAX_FLOWS, flows->untracked);
+	writeToScreen(data);
+	strcat(data, "\r\n");
+	writeToFile(hServerLogFile, data);
+	sprintf(data, "Conversations: %ld of %d, %llu packets untracked",
+		passiveConversations.used, CONVERSATION_MAX, passiveConversations.untracked);
+	writeToScreen(data);
+	strcat(data, "\r\n");
+	writeToFile(hServerLogFile, data);
+	count = topConversations(&passiveConversations, stats == &passiveTcpStats ? IPPROTO_TCP : IPPROTO_UDP, top, CONVERSATION_TOP);
+	for (int i = 0; i < count; i++)
+	{
+		displayConversation(top[i]);
+	}
+	writeToFile(hServerLogFile, "\r\n");
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: displayConversation
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void displayConversation(CONVERSATION *conversation)
+--
+--	PARAMETERS:	CONVERSATION *conversation - one of the largest conversations
+--
+--	RETURNS:	none
+--
+--	NOTES:
+--	One line per direction. TCP directions add the flags seen and the
+--  retransmission counts.
+--
+---------------------------------------------------------------------------------*/
+void displayConversation(CONVERSATION *conversation)
+{
+	char data[512];
+	char from[ENDPOINT_LENGTH], to[ENDPOINT_LENGTH];
+	ULONGLONG elapsed = (conversation->lastTime - conversation->firstTime) / 10000;
+	BYTE flags;
+
+	for (int side = 0; side < 2; side++)
+	{
+		if (conversation->packets[side] == 0)
+		{
+			continue;
+		}
+		sprintf(data, "    %s -> %s: %llu packets, %llu bytes, %.1f Mbit/s over %llu ms",
+			formatEndpoint(&(conversation->address[side]), conversation->port[side], from),
+			formatEndpoint(&(conversation->address[1 - side]), conversation->port[1 - side], to),
+			conversation->packets[side], conversation->bytes[side],
+			elapsed > 0 ? conversation->bytes[side] * 8.0 / elapsed / 1000 : 0.0, elapsed);
+		if (conversation->protocol == IPPROTO_TCP)
+		{
+			flags = conversation->flags[side];
+			sprintf(data + strlen(data), ", flags %s%s%s%s%s, retransmitted %llu, out of order %llu",
+				flags & TCP_SYN ? "S" : "", flags & TCP_FIN ? "F" : "", flags & TCP_RST ? "R" : "",
+				flags & TCP_PSH ? "P" : "", flags & TCP_ACK ? "." : "",
+				conversation->retransmitted[side], conversation->outOfOrder[side]);
+		}
+		writeToScreen(data);
+		strcat(data, "\r\n");
+		writeToFile(hServerLogFile, data);
+	}
 }
\ No newline at end of file
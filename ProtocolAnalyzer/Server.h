@@ -3,26 +3,71 @@
 #define MAXLEN					65000	//Buffer length
 #define DATA_BUFSIZE			65000
 #define COMM_TIMEOUT			1000
+#define READ_BATCH				16		//reads per readiness completion before yielding to other connections
+#define TRANSPORTS				5		//TCP, UDP, Unix stream, shared memory and reliable UDP
+#define RECEIVE_MODES			2		//event-driven and busy poll
+#define ACCEPT_RETRY			100		//ms the Unix socket server waits after a failed accept
+#define ACCEPT_FAILURES			10		//failed accepts in a row before it stops
+#define BUSY_POLL_SPIN			100		//us a busy-polling receiver spins without data before blocking, if none is given
+
+// WSARecvMsg arguments for a UDP receive. Kept in the receive buffer's pool
+// block, after the data, so TCP connection state doesn't carry it.
+typedef struct _RECEIVE_CONTROL {
+	WSAMSG Msg;
+	CHAR Data[WSA_CMSG_SPACE(sizeof(IN_PKTINFO)) + WSA_CMSG_SPACE(sizeof(UINT64))];	//receives the destination address and kernel timestamp
+} RECEIVE_CONTROL;
 
 typedef struct _SOCKET_INFORMATION {
 	OVERLAPPED Overlapped;
 	SOCKET Socket;
-	CHAR Buffer[DATA_BUFSIZE];
+	CHAR *Buffer;			//receive buffer from the pool, NULL for TCP connections
 	WSABUF DataBuf;
-	DWORD BytesSEND;
-	DWORD BytesRECV;
-	DWORD Timeout;
+	FRAME_PARSER Parser;
+	SLIST_ENTRY Link;		//queues accepted connections for the TCP thread
+	SOCKADDR_IN Peer;		//sender, filled by accept or WSARecvFrom
+	INT PeerSize;
+	SOCKADDR_IN Local;		//address the connection was accepted on
+	DWORD Received;			//bytes read from the connection, numbers captured segments
+	RECEIVE_CONTROL *Control;	//follows Buffer, NULL for TCP connections
+	TCP_INFO_SERIES *TcpInfo;	//TCP_INFO sampled while reading, NULL for UDP and unsampled connections
 
 } SOCKET_INFORMATION, *LPSOCKET_INFORMATION;
 
-typedef struct _TRANSFER_STATS {
-	SYSTEMTIME startTime;
-	SYSTEMTIME endTime;
-	int packetCount;
-	int packetSize;
+typedef struct _SERVER_OPTIONS {
+	int receiveBuffer;		//SO_RCVBUF for both servers, 0 for system default
+	BOOL autotune;			//grow the UDP receive buffer while the kernel drops datagrams
+	BOOL pcapng;			//write received packets to the save file as pcapng
+	char groups[MULTICAST_SPEC_LENGTH];			//multicast groups for the UDP server to join
+	char multicastInterface[ADDRESS_LENGTH];	//local address to join them on, empty for any
+	DWORD warmup;			//seconds after the first packet left out of the steady state
+	DWORD cooldown;			//seconds before the last packet left out of the steady state
+	char placement[PLACEMENT_SPEC_LENGTH];	//CPUs and NUMA node for the server threads, see Placement.cpp
+	BOOL busyPoll;			//spin on non-blocking UDP receives instead of waiting for completions
+	DWORD spin;				//us without data before a busy-polling receiver blocks, 0 to never block
+	char passiveInterface[ADDRESS_LENGTH];		//local address to watch passing traffic on, empty for none
+	char passiveFilter[PASSIVE_FILTER_LENGTH];	//passing packets to keep, see Passive.cpp
+} SERVER_OPTIONS;
+
+// Latest transfer over one transport, for the comparison printed after each report
+typedef struct _TRANSPORT_RESULT {
 	char *protocol;
-	int totalSize;
-} TRANSFER_STATS;
+	BOOL reported;
+	ULONGLONG bytes;
+	ULONGLONG messages;
+	ULONGLONG transferTime;		//milliseconds
+	ULONGLONG steadyBytes;
+	ULONGLONG steadyTime;
+} TRANSPORT_RESULT;
+
+// Latest UDP transfer received in one receive mode, for the latency comparison
+typedef struct _LATENCY_RESULT {
+	char *mode;
+	BOOL reported;
+	DWORD spin;					//us, for busy poll
+	ULONGLONG timed;
+	ULONGLONG latencyTotal;		//us
+	ULONGLONG latency[LATENCY_BUCKETS];
+} LATENCY_RESULT;
 
-void startServer(int, int, HANDLE);
+void startServer(int, int, HANDLE, SERVER_OPTIONS *);
 void cleanUpServer();
\ No newline at end of file
@@ -0,0 +1,883 @@
+/*---------------------------------------------------------------------------------
+--	SOURCE FILE:	Stats.cpp -
+--
+--	PROGRAM:		Transport Layer Protocol Analyser
+--
+--	FUNCTIONS:
+--					void initStats(TRANSFER_STATS *stats, char *protocol)
+--					void recordPacket(TRANSFER_STATS *stats, DWORD bytes, LONG sequence, STATS_COUNTERS *messages)
+--					void snapshotStats(TRANSFER_STATS *stats, STATS_SNAPSHOT *snapshot)
+--					void resetStats(TRANSFER_STATS *stats, STATS_SNAPSHOT *snapshot)
+--					void setSteadyWindow(TRANSFER_STATS *stats, DWORD warmup, DWORD cooldown)
+--					void sampleStats(TRANSFER_STATS *stats)
+--					void steadyState(TRANSFER_STATS *stats, STATS_SNAPSHOT *snapshot)
+--					void transferCost(TRANSFER_STATS *stats, STATS_SNAPSHOT *snapshot)
+--					void addMessage(STATS_COUNTERS *messages, DWORD size)
+--					DWORD messageSizeLimit(int bucket)
+--					void addLatency(STATS_COUNTERS *messages, ULONGLONG sent, ULONGLONG received)
+--					ULONGLONG latencyLimit(int bucket)
+--					ULONGLONG latencyPercentile(ULONGLONG *latency, ULONGLONG count, double fraction)
+--					void addSpread(LATENCY_SPREAD *spread, LONGLONG microseconds)
+--					double spreadMean(LATENCY_SPREAD *spread)
+--					double spreadJitter(LATENCY_SPREAD *spread)
+--					ULONGLONG currentFileTime()
+--					ULONGLONG preciseFileTime()
+--					void readShard(STATS_SHARD *shard, STATS_SHARD *copy)
+--
+--	DATE:			Oct 19, 2026
+--
+--	REVISIONS:		Oct 19, 2026
+--
+--	DESIGNER:		Gabriella Cheung
+--
+--	PROGRAMMER:		Gabriella Cheung
+--
+--	NOTES:
+--	This file contains the transfer statistics used by the server. Every thread
+--  that records a packet gets its own cache-line-aligned shard of 64-bit counters,
+--  so completion routines running on different threads never contend for the
+--  same memory. The reporter merges the shards into a snapshot.
+--
+--  Counters are never cleared. A reset stores the snapshot's counters as a
+--  baseline and starts a new epoch, and the next snapshot reports the difference.
+--  A packet recorded while a reset is in progress therefore lands in exactly one
+--  report instead of being wiped out.
+--
+--  Steady-state figures leave out a warmup after the first packet and a cooldown
+--  before the last. The end of a transfer is only known once it is over, so a
+--  sampler thread records the running totals every STATS_SAMPLE_INTERVAL and the
+--  report is taken from the samples at the edges of the window.
+--
+--  The process's CPU usage is read when the first packet of a transfer is
+--  recorded, and transferCost reports what has been used since.
+--
+---------------------------------------------------------------------------------*/
+#include "resource.h"
+
+void readShard(STATS_SHARD *, STATS_SHARD *);
+
+static volatile LONG nextShard = 0;
+static __declspec(thread) LONG threadShard = -1;
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: initStats
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--				Oct 19, 2026 - initializes the sample lock
+--				Oct 19, 2026 - CPU usage baseline
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void initStats(TRANSFER_STATS *stats, char *protocol)
+--
+--	PARAMETERS:	TRANSFER_STATS *stats - statistics to initialize
+--				char *protocol - name of protocol shown in the report
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	This function clears all shards and the baseline, and reads the CPU usage
+--  the first epoch starts from. It must be called before any thread records
+--  into the statistics.
+--
+---------------------------------------------------------------------------------*/
+void initStats(TRANSFER_STATS *stats, char *protocol)
+{
+	ZeroMemory(stats, sizeof(TRANSFER_STATS));
+	for (int i = 0; i < MAX_STAT_SHARDS; i++)
+	{
+		stats->shards[i].epoch = -1;
+	}
+	stats->protocol = protocol;
+	InitializeSRWLock(&stats->historyLock);
+	readCpuUsage(&stats->cpuStart);
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: recordPacket
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--				Oct 19, 2026 - integrity counters
+--				Oct 19, 2026 - reads the CPU usage at the first packet
+--				Oct 19, 2026 - trace point
+--				Oct 19, 2026 - latency counters
+--				Oct 19, 2026 - kernel timestamp latency split
+--				Oct 19, 2026 - no longer reads the CPU usage
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void recordPacket(TRANSFER_STATS *stats, DWORD bytes, LONG sequence,
+--					STATS_COUNTERS *messages)
+--
+--	PARAMETERS:	TRANSFER_STATS *stats - statistics to update
+--				DWORD bytes - number of bytes received
+--				LONG sequence - sequence number from the datagram header, or
+--								NO_SEQUENCE if the packet had none
+--				STATS_COUNTERS *messages - messages completed by this packet, built
+--								with addMessage, or NULL
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	This function is called from the receive path for every packet. The calling
+--  thread is assigned a shard the first time it records. The shard's sequence
+--  number is made odd while the counters change so that the reporter never
+--  reads a half-written 64-bit value on 32-bit builds. The compare-exchange only
+--  spins if more than MAX_STAT_SHARDS threads end up sharing a shard.
+--
+--  A call with no bytes only adds the message counters, for results that are
+--  known when a connection closes rather than when data arrives.
+----
+---------------------------------------------------------------------------------*/
+void recordPacket(TRANSFER_STATS *stats, DWORD bytes, LONG sequence, STATS_COUNTERS *messages)
+{
+	STATS_SHARD *shard;
+	LONG writeSequence, epoch;
+	ULONGLONG now = currentFileTime();
+	ULONGLONG traceStart = TRACE_START();
+
+	if (threadShard < 0)
+	{
+		threadShard = (InterlockedIncrement(&nextShard) - 1) % MAX_STAT_SHARDS;
+	}
+	shard = &stats->shards[threadShard];
+
+	while (true)
+	{
+		writeSequence = shard->sequence;
+		if (!(writeSequence & 1) && InterlockedCompareExchange(&shard->sequence, writeSequence + 1, writeSequence) == writeSequence)
+		{
+			break;
+		}
+		YieldProcessor();
+	}
+
+	epoch = stats->epoch;
+	if (shard->epoch != epoch) //first packet on this shard since the last reset
+	{
+		shard->firstTime = now;
+		shard->highSequence = NO_SEQUENCE;
+		shard->epoch = epoch;
+	}
+	if (bytes > 0)
+	{
+		shard->counters.packetCount++;
+	}
+	shard->counters.totalSize += bytes;
+	shard->lastTime = now;
+	if (sequence != NO_SEQUENCE)
+	{
+		shard->counters.sequenced++;
+		if (sequence > shard->highSequence)
+		{
+			shard->highSequence = sequence;
+		}
+	}
+	if (messages != NULL)
+	{
+		shard->counters.messageCount += messages->messageCount;
+		shard->counters.framingErrors += messages->framingErrors;
+		shard->counters.verified += messages->verified;
+		shard->counters.corrupted += messages->corrupted;
+		shard->counters.truncated += messages->truncated;
+		for (int i = 0; i < MESSAGE_SIZE_BUCKETS; i++)
+		{
+			shard->counters.messageSizes[i] += messages->messageSizes[i];
+		}
+		if (messages->timed > 0)
+		{
+			shard->counters.timed += messages->timed;
+			shard->counters.latencyTotal += messages->latencyTotal;
+			for (int i = 0; i < LATENCY_BUCKETS; i++)
+			{
+				shard->counters.latency[i] += messages->latency[i];
+			}
+		}
+		shard->counters.wire.count += messages->wire.count;
+		shard->counters.wire.total += messages->wire.total;
+		shard->counters.wire.squares += messages->wire.squares;
+		shard->counters.delivery.count += messages->delivery.count;
+		shard->counters.delivery.total += messages->delivery.total;
+		shard->counters.delivery.squares += messages->delivery.squares;
+	}
+
+	shard->sequence = writeSequence + 2;
+	TRACE_END(TRACE_RECORD, traceStart, bytes);
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: readShard
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void readShard(STATS_SHARD *shard, STATS_SHARD *copy)
+--
+--	PARAMETERS:	STATS_SHARD *shard - shard being updated by its owner thread
+--				STATS_SHARD *copy - consistent copy of the shard
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	This function copies a shard without blocking the writer. The copy is retried
+--  if the sequence number shows a write was in progress or completed while the
+--  counters were being read.
+--
+---------------------------------------------------------------------------------*/
+void readShard(STATS_SHARD *shard, STATS_SHARD *copy)
+{
+	LONG before, after;
+
+	do
+	{
+		while ((before = shard->sequence) & 1)
+		{
+			YieldProcessor();
+		}
+		MemoryBarrier();
+		copy->epoch = shard->epoch;
+		copy->highSequence = shard->highSequence;
+		copy->counters = shard->counters;
+		copy->firstTime = shard->firstTime;
+		copy->lastTime = shard->lastTime;
+		MemoryBarrier();
+		after = shard->sequence;
+	} while (before != after);
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: snapshotStats
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--				Oct 19, 2026 - keeps first and last packet times
+--				Oct 19, 2026 - trace point
+--				Oct 19, 2026 - skips a shard only when none of its counters moved
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void snapshotStats(TRANSFER_STATS *stats, STATS_SNAPSHOT *snapshot)
+--
+--	PARAMETERS:	TRANSFER_STATS *stats - statistics to read
+--				STATS_SNAPSHOT *snapshot - merged totals since the last reset
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	This function merges all shards into one snapshot. Totals are the difference
+--  between each shard and its baseline, the start time is the earliest first
+--  packet of the current epoch and the end time is the latest packet seen.
+--
+---------------------------------------------------------------------------------*/
+void snapshotStats(TRANSFER_STATS *stats, STATS_SNAPSHOT *snapshot)
+{
+	STATS_SHARD copy;
+	ULONGLONG *now, *base, *total, first = 0, last = 0;
+	LONG highSequence = NO_SEQUENCE;
+	FILETIME fileTime;
+	ULONGLONG traceStart = TRACE_START();
+
+	ZeroMemory(snapshot, sizeof(STATS_SNAPSHOT));
+	snapshot->protocol = stats->protocol;
+	snapshot->epoch = stats->epoch;
+
+	for (int i = 0; i < MAX_STAT_SHARDS; i++)
+	{
+		readShard(&stats->shards[i], &copy);
+		snapshot->raw[i] = copy.counters;
+
+		// a close can record message counters without a packet, so compare them all
+		if (memcmp(&copy.counters, &stats->baseline[i], sizeof(STATS_COUNTERS)) == 0)
+		{
+			continue;
+		}
+		now = (ULONGLONG *)&copy.counters;
+		base = (ULONGLONG *)&stats->baseline[i];
+		total = (ULONGLONG *)&snapshot->total;
+		for (int j = 0; j < STATS_COUNTER_FIELDS; j++)
+		{
+			total[j] += now[j] - base[j];
+		}
+
+		// a shard still tagged with the old epoch was written just before the reset
+		if (copy.epoch != snapshot->epoch)
+		{
+			copy.firstTime = copy.lastTime;
+		}
+		else if (copy.highSequence > highSequence)
+		{
+			highSequence = copy.highSequence;
+		}
+		if (first == 0 || copy.firstTime < first)
+		{
+			first = copy.firstTime;
+		}
+		if (copy.lastTime > last)
+		{
+			last = copy.lastTime;
+		}
+	}
+
+	if (snapshot->total.packetCount > 0)
+	{
+		fileTime.dwLowDateTime = (DWORD)first;
+		fileTime.dwHighDateTime = (DWORD)(first >> 32);
+		FileTimeToSystemTime(&fileTime, &snapshot->startTime);
+		fileTime.dwLowDateTime = (DWORD)last;
+		fileTime.dwHighDateTime = (DWORD)(last >> 32);
+		FileTimeToSystemTime(&fileTime, &snapshot->endTime);
+		snapshot->transferTime = (last - first) / 10000;
+		snapshot->firstTime = first;
+		snapshot->lastTime = last;
+	}
+	if (highSequence != NO_SEQUENCE)
+	{
+		snapshot->expected = (ULONGLONG)highSequence + 1;
+	}
+	TRACE_END(TRACE_SNAPSHOT, traceStart, (DWORD)snapshot->total.packetCount);
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: resetStats
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--				Oct 19, 2026 - drops the samples
+--				Oct 19, 2026 - reads the CPU usage baseline
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void resetStats(TRANSFER_STATS *stats, STATS_SNAPSHOT *snapshot)
+--
+--	PARAMETERS:	TRANSFER_STATS *stats - statistics to reset
+--				STATS_SNAPSHOT *snapshot - snapshot that was just reported
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	This function starts a new epoch. The counters from the reported snapshot
+--  become the new baseline, so anything recorded after the snapshot was taken
+--  shows up in the next report. Only the reporting thread may call this. The
+--  samples belong to the old epoch and are dropped.
+--
+--  The CPU usage the new epoch is measured from is read here, after the
+--  report, so its system-wide snapshot is never taken on the receive path
+--  while a transfer is being measured.
+--
+---------------------------------------------------------------------------------*/
+void resetStats(TRANSFER_STATS *stats, STATS_SNAPSHOT *snapshot)
+{
+	readCpuUsage(&stats->cpuStart);
+	AcquireSRWLockExclusive(&stats->historyLock);
+	for (int i = 0; i < MAX_STAT_SHARDS; i++)
+	{
+		stats->baseline[i] = snapshot->raw[i];
+	}
+	stats->samples = 0;
+	stats->warmedUp = false;
+	InterlockedIncrement(&stats->epoch);
+	ReleaseSRWLockExclusive(&stats->historyLock);
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: setSteadyWindow
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void setSteadyWindow(TRANSFER_STATS *stats, DWORD warmup, DWORD cooldown)
+--
+--	PARAMETERS:	TRANSFER_STATS *stats - statistics to configure
+--				DWORD warmup - seconds left out after the first packet
+--				DWORD cooldown - seconds left out before the last packet
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	Called after initStats, before the sampler starts. The cooldown can't be
+--  longer than the samples kept.
+--
+---------------------------------------------------------------------------------*/
+void setSteadyWindow(TRANSFER_STATS *stats, DWORD warmup, DWORD cooldown)
+{
+	ULONGLONG longest = (ULONGLONG)(STATS_HISTORY - 1) * STATS_SAMPLE_INTERVAL / 1000;
+
+	stats->warmup = (ULONGLONG)warmup * 10000000;
+	stats->cooldown = (cooldown < longest ? cooldown : longest) * 10000000;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: sampleStats
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--				Oct 19, 2026 - trace point
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void sampleStats(TRANSFER_STATS *stats)
+--
+--	PARAMETERS:	TRANSFER_STATS *stats - statistics to sample
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	Called every STATS_SAMPLE_INTERVAL by the server's sampler thread. Nothing
+--  is kept until the first packet of a transfer. The first sample past the
+--  warmup is kept apart from the ring so that long transfers don't overwrite it.
+--
+---------------------------------------------------------------------------------*/
+void sampleStats(TRANSFER_STATS *stats)
+{
+	STATS_SNAPSHOT snapshot;
+	STATS_SAMPLE sample;
+	ULONGLONG traceStart = TRACE_START();
+
+	AcquireSRWLockExclusive(&stats->historyLock);
+	snapshotStats(stats, &snapshot);
+	if (snapshot.total.packetCount > 0 || snapshot.total.messageCount > 0)
+	{
+		sample.time = currentFileTime();
+		sample.bytes = snapshot.total.totalSize;
+		sample.messages = snapshot.total.messageCount;
+		if (!stats->warmedUp && sample.time >= snapshot.firstTime + stats->warmup)
+		{
+			stats->warmupSample = sample;
+			stats->warmedUp = true;
+		}
+		stats->history[stats->samples % STATS_HISTORY] = sample;
+		stats->samples++;
+	}
+	ReleaseSRWLockExclusive(&stats->historyLock);
+	TRACE_END(TRACE_SAMPLE, traceStart, (DWORD)snapshot.total.packetCount);
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: steadyState
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void steadyState(TRANSFER_STATS *stats, STATS_SNAPSHOT *snapshot)
+--
+--	PARAMETERS:	TRANSFER_STATS *stats - statistics the snapshot was taken from
+--				STATS_SNAPSHOT *snapshot - receives the steady-state figures
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	The window runs from the warmup sample to the newest sample taken before
+--  the cooldown, so its edges are accurate to STATS_SAMPLE_INTERVAL. A transfer
+--  shorter than the warmup and cooldown together has no steady state.
+--
+---------------------------------------------------------------------------------*/
+void steadyState(TRANSFER_STATS *stats, STATS_SNAPSHOT *snapshot)
+{
+	STATS_SAMPLE *sample;
+	ULONGLONG end = snapshot->lastTime - stats->cooldown;
+	LONG oldest;
+
+	AcquireSRWLockExclusive(&stats->historyLock);
+	oldest = stats->samples > STATS_HISTORY ? stats->samples - STATS_HISTORY : 0;
+	for (LONG i = stats->samples - 1; stats->warmedUp && i >= oldest; i--)
+	{
+		sample = &stats->history[i % STATS_HISTORY];
+		if (sample->time < stats->warmupSample.time)
+		{
+			break;
+		}
+		if (sample->time <= end)
+		{
+			snapshot->steadyBytes = sample->bytes - stats->warmupSample.bytes;
+			snapshot->steadyMessages = sample->messages - stats->warmupSample.messages;
+			snapshot->steadyTime = (sample->time - stats->warmupSample.time) / 10000;
+			break;
+		}
+	}
+	ReleaseSRWLockExclusive(&stats->historyLock);
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: transferCost
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--				Oct 19, 2026 - measured from the last reset
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void transferCost(TRANSFER_STATS *stats, STATS_SNAPSHOT *snapshot)
+--
+--	PARAMETERS:	TRANSFER_STATS *stats - statistics the snapshot was taken from
+--				STATS_SNAPSHOT *snapshot - receives the CPU usage of the transfer
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	Called by the reporter, not by snapshotStats, since the sampler takes a
+--  snapshot every STATS_SAMPLE_INTERVAL and the usage is costly to read. The
+--  usage runs from the previous report to this one, so it includes the idle
+--  time on either side of a transfer, and the whole process, so it includes
+--  any transfer running alongside on another transport.
+--
+---------------------------------------------------------------------------------*/
+void transferCost(TRANSFER_STATS *stats, STATS_SNAPSHOT *snapshot)
+{
+	cpuSince(&stats->cpuStart, &(snapshot->cpu));
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: addMessage
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void addMessage(STATS_COUNTERS *messages, DWORD size)
+--
+--	PARAMETERS:	STATS_COUNTERS *messages - messages completed by one receive
+--				DWORD size - size of the message in bytes
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	This function counts one message into the size distribution. Buckets are
+--  powers of two starting at 64 bytes, so the bucket is found from the position
+--  of the highest set bit instead of a search.
+--
+---------------------------------------------------------------------------------*/
+void addMessage(STATS_COUNTERS *messages, DWORD size)
+{
+	unsigned long bit;
+	int bucket = 0;
+
+	if (size >= 64 && _BitScanReverse(&bit, size))
+	{
+		bucket = bit - 5;
+		if (bucket >= MESSAGE_SIZE_BUCKETS)
+		{
+			bucket = MESSAGE_SIZE_BUCKETS - 1;
+		}
+	}
+	messages->messageCount++;
+	messages->messageSizes[bucket]++;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: messageSizeLimit
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	DWORD messageSizeLimit(int bucket)
+--
+--	PARAMETERS:	int bucket - index into messageSizes
+--
+--	RETURNS:	the smallest message size counted in the bucket
+--
+--	NOTES:
+--	Used when printing the size distribution. The bucket holds sizes from this
+--  value up to one less than the next bucket's limit.
+--
+---------------------------------------------------------------------------------*/
+DWORD messageSizeLimit(int bucket)
+{
+	return bucket == 0 ? 0 : (DWORD)1 << (bucket + 5);
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: addLatency
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void addLatency(STATS_COUNTERS *messages, ULONGLONG sent, ULONGLONG received)
+--
+--	PARAMETERS:	STATS_COUNTERS *messages - messages completed by one receive
+--				ULONGLONG sent - sender's FILETIME from the message
+--				ULONGLONG received - preciseFileTime when the message was received
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	Counts one message into the latency distribution. Buckets are powers of two
+--  of microseconds, found from the highest set bit like the size buckets. A
+--  message that seems to arrive before it was sent, because the sender's clock
+--  is ahead, is counted as under a microsecond.
+--
+---------------------------------------------------------------------------------*/
+void addLatency(STATS_COUNTERS *messages, ULONGLONG sent, ULONGLONG received)
+{
+	ULONGLONG microseconds = received > sent ? (received - sent) / 10 : 0;
+	unsigned long bit;
+	int bucket = 0;
+
+	if (_BitScanReverse64(&bit, microseconds))
+	{
+		bucket = bit + 1;
+		if (bucket >= LATENCY_BUCKETS)
+		{
+			bucket = LATENCY_BUCKETS - 1;
+		}
+	}
+	messages->timed++;
+	messages->latencyTotal += microseconds;
+	messages->latency[bucket]++;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: latencyLimit
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	ULONGLONG latencyLimit(int bucket)
+--
+--	PARAMETERS:	int bucket - index into latency
+--
+--	RETURNS:	the smallest latency in microseconds counted in the bucket
+--
+---------------------------------------------------------------------------------*/
+ULONGLONG latencyLimit(int bucket)
+{
+	return bucket == 0 ? 0 : (ULONGLONG)1 << (bucket - 1);
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: latencyPercentile
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	ULONGLONG latencyPercentile(ULONGLONG *latency, ULONGLONG count, double fraction)
+--
+--	PARAMETERS:	ULONGLONG *latency - LATENCY_BUCKETS counts
+--				ULONGLONG count - messages counted in them
+--				double fraction - 0.5 for the median, 0.99 for the 99th percentile
+--
+--	RETURNS:	the upper limit in microseconds of the bucket the percentile
+--				falls in, or latencyLimit of the last bucket if it is there
+--
+---------------------------------------------------------------------------------*/
+ULONGLONG latencyPercentile(ULONGLONG *latency, ULONGLONG count, double fraction)
+{
+	ULONGLONG rank = (ULONGLONG)(count * fraction), seen = 0;
+
+	for (int i = 0; i < LATENCY_BUCKETS - 1; i++)
+	{
+		seen += latency[i];
+		if (seen > rank)
+		{
+			return latencyLimit(i + 1);
+		}
+	}
+	return latencyLimit(LATENCY_BUCKETS - 1);
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: addSpread
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void addSpread(LATENCY_SPREAD *spread, LONGLONG microseconds)
+--
+--	PARAMETERS:	LATENCY_SPREAD *spread - part of the latency to count into
+--				LONGLONG microseconds - that part for one message
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	A negative time, from clocks that disagree, is counted as 0 like it is
+--  by addLatency.
+--
+---------------------------------------------------------------------------------*/
+void addSpread(LATENCY_SPREAD *spread, LONGLONG microseconds)
+{
+	ULONGLONG value = microseconds > 0 ? (ULONGLONG)microseconds : 0;
+
+	spread->count++;
+	spread->total += value;
+	spread->squares += value * value;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: spreadMean
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	double spreadMean(LATENCY_SPREAD *spread)
+--
+--	PARAMETERS:	LATENCY_SPREAD *spread - counted with addSpread
+--
+--	RETURNS:	the mean in microseconds, 0 if nothing was counted
+--
+---------------------------------------------------------------------------------*/
+double spreadMean(LATENCY_SPREAD *spread)
+{
+	return spread->count > 0 ? (double)spread->total / spread->count : 0.0;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: spreadJitter
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	double spreadJitter(LATENCY_SPREAD *spread)
+--
+--	PARAMETERS:	LATENCY_SPREAD *spread - counted with addSpread
+--
+--	RETURNS:	the standard deviation in microseconds
+--
+---------------------------------------------------------------------------------*/
+double spreadJitter(LATENCY_SPREAD *spread)
+{
+	double mean = spreadMean(spread);
+	double variance = spread->count > 0 ? (double)spread->squares / spread->count - mean * mean : 0.0;
+
+	return variance > 0 ? sqrt(variance) : 0.0;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: currentFileTime
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	ULONGLONG currentFileTime()
+--
+--	PARAMETERS:	none
+--
+--	RETURNS:	the current system time in 100 nanosecond intervals
+--
+--	NOTES:
+--	A wrapper for GetSystemTimeAsFileTime that returns the time as one 64-bit
+--  value so it can be compared and subtracted directly.
+--
+---------------------------------------------------------------------------------*/
+ULONGLONG currentFileTime()
+{
+	FILETIME fileTime;
+	ULARGE_INTEGER time;
+
+	GetSystemTimeAsFileTime(&fileTime);
+	time.LowPart = fileTime.dwLowDateTime;
+	time.HighPart = fileTime.dwHighDateTime;
+	return time.QuadPart;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: preciseFileTime
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	ULONGLONG preciseFileTime()
+--
+--	PARAMETERS:	none
+--
+--	RETURNS:	the current system time in 100 nanosecond intervals
+--
+--	NOTES:
+--	Like currentFileTime, but from GetSystemTimePreciseAsFileTime, which is
+--  read from the performance counter instead of the last timer tick. Used for
+--  the send and receive times of single messages, where the tick's
+--  millisecond steps would hide the latency being measured.
+--
+---------------------------------------------------------------------------------*/
+ULONGLONG preciseFileTime()
+{
+	FILETIME fileTime;
+	ULARGE_INTEGER time;
+
+	GetSystemTimePreciseAsFileTime(&fileTime);
+	time.LowPart = fileTime.dwLowDateTime;
+	time.HighPart = fileTime.dwHighDateTime;
+	return time.QuadPart;
+}
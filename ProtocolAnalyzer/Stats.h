@@ -0,0 +1,113 @@
+#pragma once
+
+#define CACHE_LINE_SIZE			64
+#define MAX_STAT_SHARDS			64
+#define NO_SEQUENCE				-1
+#define MESSAGE_SIZE_BUCKETS	12		//<64, 64-127, ... 32768-65535, 65536+
+#define STATS_SAMPLE_INTERVAL	100		//ms between samples for the steady-state figures
+#define STATS_HISTORY			1024	//samples kept, bounds the cooldown at 102 seconds
+#define LATENCY_BUCKETS			24		//<1 us, 1 us, 2-3 us, 4-7 us, ... 4194304+ us
+
+// Count, sum and sum of squares of one part of the latency, in microseconds,
+// for its mean and its jitter (standard deviation).
+typedef struct _LATENCY_SPREAD {
+	ULONGLONG count;
+	ULONGLONG total;
+	ULONGLONG squares;
+} LATENCY_SPREAD;
+
+// Cumulative counters. They are never cleared; reports subtract a baseline.
+// Every field is a ULONGLONG, or a struct of them, so the set can be added and
+// subtracted as an array.
+typedef struct _STATS_COUNTERS {
+	ULONGLONG packetCount;
+	ULONGLONG totalSize;
+	ULONGLONG sequenced;		// packets that carried a sequence number
+	ULONGLONG messageCount;		// datagrams, or frames parsed from a TCP stream
+	ULONGLONG framingErrors;	// TCP connections whose framing was lost
+	ULONGLONG verified;			// integrity mode messages whose CRC32C matched
+	ULONGLONG corrupted;		// integrity mode messages whose CRC32C or length did not
+	ULONGLONG truncated;		// integrity mode messages that arrived short
+	ULONGLONG messageSizes[MESSAGE_SIZE_BUCKETS];
+	ULONGLONG timed;			// messages that carried the time they were sent
+	ULONGLONG latencyTotal;		// microseconds from send to receive, summed over them
+	ULONGLONG latency[LATENCY_BUCKETS];
+	LATENCY_SPREAD wire;		// sender's clock to the kernel's receive timestamp
+	LATENCY_SPREAD delivery;	// kernel's receive timestamp to the application
+} STATS_COUNTERS;
+
+#define STATS_COUNTER_FIELDS	(sizeof(STATS_COUNTERS) / sizeof(ULONGLONG))
+
+// Counters owned by one thread. Aligned to a cache line so that threads
+// recording into neighbouring shards never share a line.
+typedef struct __declspec(align(64)) _STATS_SHARD {
+	volatile LONG sequence;		// odd while a writer is updating the shard
+	volatile LONG epoch;		// epoch in which firstTime was taken
+	LONG highSequence;			// highest datagram sequence number in epoch
+	ULONGLONG firstTime;		// FILETIME of first packet in epoch
+	ULONGLONG lastTime;			// FILETIME of most recent packet
+	STATS_COUNTERS counters;
+} STATS_SHARD;
+
+// Totals since the last reset at one point in time.
+typedef struct _STATS_SAMPLE {
+	ULONGLONG time;				// FILETIME
+	ULONGLONG bytes;
+	ULONGLONG messages;
+} STATS_SAMPLE;
+
+typedef struct _TRANSFER_STATS {
+	STATS_SHARD shards[MAX_STAT_SHARDS];
+	STATS_COUNTERS baseline[MAX_STAT_SHARDS];	// shard counters at the last reset
+	volatile LONG epoch;
+	char *protocol;
+	SRWLOCK historyLock;		// held by the sampler and by resets, which change the baseline
+	ULONGLONG warmup;			// FILETIME units excluded after the first packet
+	ULONGLONG cooldown;			// FILETIME units excluded before the last packet
+	BOOL warmedUp;				// warmupSample has been taken
+	STATS_SAMPLE warmupSample;	// first sample after the warmup
+	STATS_SAMPLE history[STATS_HISTORY];	// ring of the latest samples
+	LONG samples;				// samples taken since the last reset
+	CPU_USAGE cpuStart;			// process CPU usage when the epoch started
+} TRANSFER_STATS;
+
+typedef struct _STATS_SNAPSHOT {
+	char *protocol;
+	LONG epoch;
+	SYSTEMTIME startTime;
+	SYSTEMTIME endTime;
+	STATS_COUNTERS total;
+	ULONGLONG transferTime;		// milliseconds between first and last packet
+	ULONGLONG firstTime;		// FILETIME of the first packet
+	ULONGLONG lastTime;			// FILETIME of the last packet
+	ULONGLONG steadyBytes;		// received between the end of the warmup and the start of the cooldown
+	ULONGLONG steadyMessages;
+	ULONGLONG steadyTime;		// milliseconds, 0 if the transfer was too short
+	ULONGLONG expected;			// packets the sender numbered, from the highest sequence seen
+	BOOL countDrops;			// set by the server for datagram sockets
+	DWORD kernelDrops;			// datagrams discarded by the kernel during the transfer
+	int receiveBuffer;			// SO_RCVBUF at the end of the transfer
+	LONG connections;			// TCP connections open when the snapshot was taken
+	SIZE_T workingSet;			// process working set when the snapshot was taken
+	CPU_USAGE cpu;				// process CPU usage from the first packet to the report, see transferCost
+	STATS_COUNTERS raw[MAX_STAT_SHARDS];	// shard counters the snapshot was taken from
+} STATS_SNAPSHOT;
+
+void initStats(TRANSFER_STATS *, char *);
+void recordPacket(TRANSFER_STATS *, DWORD, LONG, STATS_COUNTERS *);
+void snapshotStats(TRANSFER_STATS *, STATS_SNAPSHOT *);
+void resetStats(TRANSFER_STATS *, STATS_SNAPSHOT *);
+void setSteadyWindow(TRANSFER_STATS *, DWORD, DWORD);
+void sampleStats(TRANSFER_STATS *);
+void steadyState(TRANSFER_STATS *, STATS_SNAPSHOT *);
+void transferCost(TRANSFER_STATS *, STATS_SNAPSHOT *);
+void addMessage(STATS_COUNTERS *, DWORD);
+DWORD messageSizeLimit(int);
+void addLatency(STATS_COUNTERS *, ULONGLONG, ULONGLONG);
+ULONGLONG latencyLimit(int);
+ULONGLONG latencyPercentile(ULONGLONG *, ULONGLONG, double);
+void addSpread(LATENCY_SPREAD *, LONGLONG);
+double spreadMean(LATENCY_SPREAD *);
+double spreadJitter(LATENCY_SPREAD *);
+ULONGLONG currentFileTime();
+ULONGLONG preciseFileTime();
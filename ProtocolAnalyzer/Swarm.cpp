@@ -0,0 +1,923 @@
+/*---------------------------------------------------------------------------------
+--	SOURCE FILE:	Swarm.cpp -
+--
+--	PROGRAM:		Transport Layer Protocol Analyser
+--
+--	FUNCTIONS:
+--					BOOL parseSwarm(char *spec, SWARM_SPEC *swarm)
+--					void runSwarm(char *hostname, int port, int packetSize, int repetition,
+--						HANDLE logFile, CLIENT_OPTIONS *options)
+--					DWORD WINAPI swarmWorker(LPVOID lpParameter)
+--					void startConnect(SWARM_WORKER *worker, SWARM_CLIENT *client, LONGLONG now)
+--					void completeClient(SWARM_WORKER *worker, SWARM_CLIENT *client, BOOL succeeded,
+--						DWORD bytes, LONGLONG now)
+--					void scheduleClient(SWARM_WORKER *worker, SWARM_CLIENT *client, LONGLONG now)
+--					void sendClient(SWARM_WORKER *worker, SWARM_CLIENT *client)
+--					void endClient(SWARM_WORKER *worker, SWARM_CLIENT *client, int state, int error)
+--					void stopClients(SWARM_WORKER *worker)
+--					void pushTimer(SWARM_WORKER *worker, SWARM_CLIENT *client, LONGLONG due)
+--					SWARM_CLIENT *popTimer(SWARM_WORKER *worker)
+--					void sumSwarm(SWARM *swarm, SWARM_WORKER *total)
+--
+--	DATE:			Oct 19, 2026
+--
+--	REVISIONS:		Oct 19, 2026
+--
+--	DESIGNER:		Gabriella Cheung
+--
+--	PROGRAMMER:		Gabriella Cheung
+--
+--	NOTES:
+--	This file contains the simulated clients: tens of thousands of TCP
+--  connections driven by a handful of threads. Each client is a small state
+--  machine that connects, sends its messages on the traffic profile's
+--  schedule and closes:
+--
+--		WAIT_CONNECT -> CONNECTING -> WAIT_SEND <-> SENDING -> DONE
+--
+--  and FAILED from any step. Every wait is an overlapped ConnectEx or WSASend,
+--  or a timer, so a client costs its socket and about a hundred bytes of
+--  state, not a thread and its stack. A client only moves on when its
+--  completion or its timer comes up.
+--
+--  Each worker thread is a reactor over its own completion port and a heap of
+--  timers: it takes completions in batches with GetQueuedCompletionStatusEx,
+--  waiting no longer than the earliest timer, then runs the timers that are
+--  due. Clients are dealt to the workers in turn and never move, so no client
+--  is ever touched by two threads. Connects are spread over the run at the
+--  given rate so the server's accept queue is not flooded.
+--
+--  All clients send the same generated payload from one shared buffer, with
+--  the message sizes and gaps of the traffic profile; each starts at a
+--  different place in the profile's tables. Messages are not framed, and the
+--  impairment stage and replay do not apply.
+--
+--  Windows lends each connection to one server address and port a local port
+--  from the dynamic range, 16384 ports by default. Beyond that connects fail
+--  with WSAEADDRINUSE or WSAENOBUFS until the range is widened, for example
+--  with "netsh int ipv4 set dynamicport tcp start=10000 num=55000". Waits are
+--  limited by the system timer, so paced messages go out in small bursts that
+--  keep to the profile's rate.
+--
+--  When the transfer is stopped each worker ends its waiting clients and
+--  closes the sockets of the others, then collects their cancelled
+--  operations, so no overlapped is left pending when the clients are freed.
+--
+---------------------------------------------------------------------------------*/
+#include "resource.h"
+
+DWORD WINAPI swarmWorker(LPVOID);
+void startConnect(SWARM_WORKER *, SWARM_CLIENT *, LONGLONG);
+void completeClient(SWARM_WORKER *, SWARM_CLIENT *, BOOL, DWORD, LONGLONG);
+void scheduleClient(SWARM_WORKER *, SWARM_CLIENT *, LONGLONG);
+void sendClient(SWARM_WORKER *, SWARM_CLIENT *);
+void endClient(SWARM_WORKER *, SWARM_CLIENT *, int, int);
+void stopClients(SWARM_WORKER *);
+void pushTimer(SWARM_WORKER *, SWARM_CLIENT *, LONGLONG);
+SWARM_CLIENT *popTimer(SWARM_WORKER *);
+void sumSwarm(SWARM *, SWARM_WORKER *);
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: parseSwarm
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	BOOL parseSwarm(char *spec, SWARM_SPEC *swarm)
+--
+--	PARAMETERS:	char *spec - settings from the transfer dialog
+--				SWARM_SPEC *swarm - receives the settings
+--
+--	RETURNS:	TRUE if the spec is valid
+--
+--	NOTES:
+--	clients is required. threads are limited to the clients there are.
+--
+---------------------------------------------------------------------------------*/
+BOOL parseSwarm(char *spec, SWARM_SPEC *swarm)
+{
+	char settings[SWARM_SPEC_LENGTH];
+	char *setting, *value, *context = NULL;
+	SYSTEM_INFO system;
+	int number;
+
+	ZeroMemory(swarm, sizeof(SWARM_SPEC));
+	strncpy(settings, spec, sizeof(settings) - 1);
+	settings[sizeof(settings) - 1] = '\0';
+	for (setting = strtok_s(settings, "; ", &context); setting != NULL; setting = strtok_s(NULL, "; ", &context))
+	{
+		if ((value = strchr(setting, '=')) == NULL)
+		{
+			return FALSE;
+		}
+		*value++ = '\0';
+		number = atoi(value);
+		if (strcmp(setting, "clients") == 0 && number > 0 && number <= SWARM_MAX_CLIENTS)
+		{
+			swarm->clients = number;
+		}
+		else if (strcmp(setting, "threads") == 0 && number >= 0 && number <= SWARM_MAX_THREADS)
+		{
+			swarm->threads = number;
+		}
+		else if (strcmp(setting, "rate") == 0 && number >= 0)
+		{
+			swarm->rate = number;
+		}
+		else {
+			return FALSE;
+		}
+	}
+	if (swarm->clients == 0)
+	{
+		return FALSE;
+	}
+	if (swarm->threads == 0)
+	{
+		GetSystemInfo(&system);
+		swarm->threads = system.dwNumberOfProcessors < SWARM_MAX_THREADS ? system.dwNumberOfProcessors : SWARM_MAX_THREADS;
+	}
+	if (swarm->threads > swarm->clients)
+	{
+		swarm->threads = swarm->clients;
+	}
+
+	if (swarm->rate > 0)
+	{
+		sprintf(swarm->description, "%d clients on %d threads, connecting %d a second", swarm->clients, swarm->threads, swarm->rate);
+	}
+	else {
+		sprintf(swarm->description, "%d clients on %d threads, connecting at once", swarm->clients, swarm->threads);
+	}
+	return TRUE;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: runSwarm
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--				Oct 19, 2026 - Resolve host names as well as addresses
+--				Oct 19, 2026 - Report only the clients whose worker started
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void runSwarm(char *hostname, int port, int packetSize, int repetition,
+--					HANDLE logFile, CLIENT_OPTIONS *options)
+--
+--	PARAMETERS:	char *hostname - IP address of the server
+--				int port - TCP port of the server
+--				int packetSize - message size when the profile gives none
+--				int repetition - messages per client when there is no duration
+--				HANDLE logFile - handle for the client log file
+--				CLIENT_OPTIONS *options - transfer settings, with the swarm spec
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	Sets up the clients and workers, prints progress while the workers run and
+--  the totals once every client is done: connections made and failed, the
+--  most open at once, connect time, messages and throughput, CPU cost and
+--  memory per client. The most open at once is sampled with the progress
+--  lines, so it can miss a short peak.
+--
+---------------------------------------------------------------------------------*/
+void runSwarm(char *hostname, int port, int packetSize, int repetition, HANDLE logFile, CLIENT_OPTIONS *options)
+{
+	WSADATA wsaData;
+	SWARM swarm;
+	SWARM_WORKER *worker, total;
+	SWARM_CLIENT *clients;
+	HANDLE threads[SWARM_MAX_THREADS];
+	PLACEMENT placement;
+	struct hostent *hp;
+	CPU_USAGE cpuStart, cpuCost;
+	LARGE_INTEGER frequency, now;
+	SOCKET sd;
+	SIZE_T idleWorkingSet, workingSet, peakWorkingSet;
+	LONG peakOpen = 0;
+	char message[256];
+	double seconds;
+	BOOL ready;
+	int started = 0;
+	int simulated = 0;
+
+	ZeroMemory(&swarm, sizeof(SWARM));
+	if (!parseSwarm(options->swarm, &(swarm.spec)))
+	{
+		writeToScreen("Invalid simulated clients");
+		return;
+	}
+	swarm.profile = (TRAFFIC_PROFILE *)malloc(sizeof(TRAFFIC_PROFILE));
+	if (swarm.profile == NULL || !parseProfile(options->profile, packetSize, swarm.profile))
+	{
+		writeToScreen("Invalid traffic profile");
+		free(swarm.profile);
+		return;
+	}
+	if (!parsePlacement(options->placement, &placement))
+	{
+		writeToScreen("Invalid placement");
+		free(swarm.profile);
+		return;
+	}
+	if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0)
+	{
+		writeToScreen("DLL not found!");
+		free(swarm.profile);
+		return;
+	}
+	swarm.server.sin_family = AF_INET;
+	swarm.server.sin_port = htons(port);
+	if ((hp = gethostbyname(hostname)) == NULL)
+	{
+		writeToScreen("Can't get server's IP address");
+		free(swarm.profile);
+		WSACleanup();
+		return;
+	}
+	memcpy((char *)&(swarm.server.sin_addr), hp->h_addr, hp->h_length);
+	resolvePlacement(&placement, swarm.server.sin_addr.s_addr);
+	logPlacement(&placement, logFile);
+	if ((sd = socket(AF_INET, SOCK_STREAM, 0)) != INVALID_SOCKET)
+	{
+		swarm.connectEx = getConnectEx(sd);
+		closesocket(sd);
+	}
+	if (swarm.connectEx == NULL)
+	{
+		writeToScreen("ConnectEx is not available");
+		free(swarm.profile);
+		WSACleanup();
+		return;
+	}
+
+	// Everything the clients use is allocated before they start, so the
+	// working set grows by what the connections themselves cost
+	idleWorkingSet = getWorkingSet();
+	swarm.sendBuffer = options->sendBuffer;
+	swarm.repetition = repetition;
+	swarm.workers = swarm.spec.threads;
+	swarm.payload = (char *)malloc(swarm.profile->maxSize + 1);
+	swarm.worker = (SWARM_WORKER *)VirtualAlloc(NULL, swarm.workers * sizeof(SWARM_WORKER), MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+	clients = (SWARM_CLIENT *)malloc(swarm.spec.clients * sizeof(SWARM_CLIENT));
+	ready = swarm.payload != NULL && swarm.worker != NULL && clients != NULL;
+	for (int w = 0; w < swarm.workers && ready; w++)
+	{
+		worker = &(swarm.worker[w]);
+		worker->swarm = &swarm;
+		worker->count = swarm.spec.clients / swarm.workers + (w < swarm.spec.clients % swarm.workers ? 1 : 0);
+		worker->first = w * (swarm.spec.clients / swarm.workers) + (w < swarm.spec.clients % swarm.workers ? w : swarm.spec.clients % swarm.workers);
+		worker->clients = clients + worker->first;
+		worker->active = worker->count;
+		worker->timers = (SWARM_TIMER *)malloc(worker->count * sizeof(SWARM_TIMER));
+		worker->port = CreateIoCompletionPort(INVALID_HANDLE_VALUE, NULL, 0, 1);
+		ready = worker->timers != NULL && worker->port != NULL;
+	}
+	if (!ready)
+	{
+		writeToScreen("Not enough memory for the simulated clients");
+		for (int w = 0; swarm.worker != NULL && w < swarm.workers; w++)
+		{
+			free(swarm.worker[w].timers);
+			if (swarm.worker[w].port != NULL)
+			{
+				CloseHandle(swarm.worker[w].port);
+			}
+		}
+		free(swarm.payload);
+		if (swarm.worker != NULL)
+		{
+			VirtualFree(swarm.worker, 0, MEM_RELEASE);
+		}
+		free(clients);
+		free(swarm.profile);
+		WSACleanup();
+		return;
+	}
+	getData(NULL, swarm.payload, swarm.profile->maxSize);
+
+	if (options->duration > 0)
+	{
+		sprintf(message, "Simulating %s; each sends %s for %d seconds to %s port %d",
+			swarm.spec.description, swarm.profile->description, options->duration, hostname, port);
+	}
+	else {
+		sprintf(message, "Simulating %s; each sends %d messages, %s, to %s port %d",
+			swarm.spec.description, repetition, swarm.profile->description, hostname, port);
+	}
+	writeToScreen(message);
+	strcat(message, "\r\n");
+	writeToFile(logFile, message);
+
+	// The connect ramp takes the workers in turn, so they all start at once
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&now);
+	swarm.frequency = frequency.QuadPart;
+	swarm.start = now.QuadPart;
+	swarm.end = options->duration > 0 ? swarm.start + options->duration * swarm.frequency : 0;
+	for (int w = 0; w < swarm.workers; w++)
+	{
+		worker = &(swarm.worker[w]);
+		for (int i = 0; i < worker->count; i++)
+		{
+			ZeroMemory(&(worker->clients[i]), sizeof(SWARM_CLIENT));
+			worker->clients[i].sd = INVALID_SOCKET;
+			worker->clients[i].state = SWARM_WAIT_CONNECT;
+			pushTimer(worker, &(worker->clients[i]), swarm.spec.rate > 0
+				? swarm.start + (LONGLONG)(i * swarm.workers + w) * swarm.frequency / swarm.spec.rate : swarm.start);
+		}
+	}
+	readCpuUsage(&cpuStart);
+	for (int w = 0; w < swarm.workers; w++)
+	{
+		if ((swarm.worker[w].thread = CreateThread(NULL, 0, swarmWorker, &(swarm.worker[w]), 0, NULL)) == NULL)
+		{
+			sprintf(message, "Could not start the simulated clients: %d of %d never started",
+				swarm.spec.clients - simulated, swarm.spec.clients);
+			writeToScreen(message);
+			strcat(message, "\r\n");
+			writeToFile(logFile, message);
+			break;
+		}
+		placeThread(swarm.worker[w].thread, &placement, PLACE_SEND);
+		threads[started++] = swarm.worker[w].thread;
+		simulated += swarm.worker[w].count;
+	}
+
+	peakWorkingSet = getWorkingSet();
+	while (started > 0 && WaitForMultipleObjects(started, threads, TRUE, SWARM_REPORT_INTERVAL) == WAIT_TIMEOUT)
+	{
+		sumSwarm(&swarm, &total);
+		QueryPerformanceCounter(&now);
+		if (total.open > peakOpen)
+		{
+			peakOpen = total.open;
+		}
+		if ((workingSet = getWorkingSet()) > peakWorkingSet)
+		{
+			peakWorkingSet = workingSet;
+		}
+		sprintf(message, "%.0f s: %ld connected, %ld open, %ld failed, %llu messages",
+			(double)(now.QuadPart - swarm.start) / swarm.frequency, total.connected, total.open, total.failed, total.messages);
+		writeToScreen(message);
+		strcat(message, "\r\n");
+		writeToFile(logFile, message);
+	}
+	QueryPerformanceCounter(&now);
+	cpuSince(&cpuStart, &cpuCost);
+
+	sumSwarm(&swarm, &total);
+	seconds = (double)(now.QuadPart - swarm.start) / swarm.frequency;
+	if (total.failed > 0)
+	{
+		sprintf(message, "Simulated clients: %ld of %d connected, %ld failed (last error %ld), %ld open at most",
+			total.connected, simulated, total.failed, total.lastError, peakOpen);
+	}
+	else {
+		sprintf(message, "Simulated clients: %ld of %d connected, %ld open at most",
+			total.connected, simulated, peakOpen);
+	}
+	writeToScreen(message);
+	strcat(message, "\r\n");
+	writeToFile(logFile, message);
+	sprintf(message, "Connect time: mean %.0f us, jitter %.0f us",
+		spreadMean(&(total.connectTime)), spreadJitter(&(total.connectTime)));
+	writeToScreen(message);
+	strcat(message, "\r\n");
+	writeToFile(logFile, message);
+	sprintf(message, "%llu messages (%llu bytes) in %.1f s: %.0f messages/s, %.1f Mbps",
+		total.messages, total.bytes, seconds, seconds > 0 ? total.messages / seconds : 0,
+		seconds > 0 ? total.bytes * 8 / seconds / 1000000 : 0);
+	writeToScreen(message);
+	strcat(message, "\r\n");
+	writeToFile(logFile, message);
+	logCpuCost(&cpuCost, total.bytes, total.messages, logFile);
+	if (peakOpen > 0)
+	{
+		sprintf(message, "Working set: %llu KB at most, %llu bytes for each open client",
+			(ULONGLONG)peakWorkingSet / 1024, (ULONGLONG)(peakWorkingSet - idleWorkingSet) / peakOpen);
+		writeToScreen(message);
+		strcat(message, "\r\n");
+		writeToFile(logFile, message);
+	}
+
+	for (int w = 0; w < swarm.workers; w++)
+	{
+		if (swarm.worker[w].thread != NULL)
+		{
+			CloseHandle(swarm.worker[w].thread);
+		}
+		CloseHandle(swarm.worker[w].port);
+		free(swarm.worker[w].timers);
+	}
+	free(swarm.payload);
+	VirtualFree(swarm.worker, 0, MEM_RELEASE);
+	free(clients);
+	free(swarm.profile);
+	WSACleanup();
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: swarmWorker
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--				Oct 19, 2026 - retires its context switches
+--				Oct 19, 2026 - stops its clients with the transfer
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	DWORD WINAPI swarmWorker(LPVOID lpParameter)
+--
+--	PARAMETERS:	LPVOID lpParameter - the SWARM_WORKER to run
+--
+--	RETURNS:	0 once all its clients are done
+--
+--	NOTES:
+--	Runs the timers that are due, then waits for a batch of completions no
+--  longer than the next timer, until every client has finished or failed.
+--
+---------------------------------------------------------------------------------*/
+DWORD WINAPI swarmWorker(LPVOID lpParameter)
+{
+	SWARM_WORKER *worker = (SWARM_WORKER *)lpParameter;
+	LONGLONG frequency = worker->swarm->frequency;
+	OVERLAPPED_ENTRY entries[SWARM_BATCH];
+	SWARM_CLIENT *client;
+	LARGE_INTEGER now;
+	ULONG count;
+	DWORD wait;
+
+	while (worker->active > 0)
+	{
+		if (transferStopping && !worker->stopping)
+		{
+			stopClients(worker);
+		}
+		QueryPerformanceCounter(&now);
+		while (worker->timerCount > 0 && worker->timers[0].due <= now.QuadPart)
+		{
+			client = popTimer(worker);
+			if (client->state == SWARM_WAIT_CONNECT)
+			{
+				startConnect(worker, client, now.QuadPart);
+			}
+			else {
+				sendClient(worker, client);
+			}
+		}
+		if (worker->active == 0)
+		{
+			break;
+		}
+		wait = SWARM_MAX_WAIT;
+		if (worker->timerCount > 0 && (worker->timers[0].due - now.QuadPart) * 1000 / frequency < SWARM_MAX_WAIT)
+		{
+			wait = (DWORD)((worker->timers[0].due - now.QuadPart) * 1000 / frequency);
+		}
+		if (!GetQueuedCompletionStatusEx(worker->port, entries, SWARM_BATCH, &count, wait, FALSE))
+		{
+			continue;
+		}
+		QueryPerformanceCounter(&now);
+		for (ULONG i = 0; i < count; i++)
+		{
+			completeClient(worker, (SWARM_CLIENT *)entries[i].lpOverlapped, entries[i].Internal == 0,
+				entries[i].dwNumberOfBytesTransferred, now.QuadPart);
+		}
+	}
+	retireThread();
+	return 0;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: startConnect
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void startConnect(SWARM_WORKER *worker, SWARM_CLIENT *client, LONGLONG now)
+--
+--	PARAMETERS:	SWARM_WORKER *worker - worker that owns the client
+--				SWARM_CLIENT *client - client whose turn in the ramp has come
+--				LONGLONG now - QueryPerformanceCounter value
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	Opens the client's socket on the worker's completion port and starts its
+--  ConnectEx, which needs the socket bound first. A client whose turn comes
+--  after a timed run has ended does not connect.
+--
+---------------------------------------------------------------------------------*/
+void startConnect(SWARM_WORKER *worker, SWARM_CLIENT *client, LONGLONG now)
+{
+	SWARM *swarm = worker->swarm;
+	SOCKADDR_IN local;
+	DWORD sent;
+
+	if (swarm->end > 0 && now >= swarm->end)
+	{
+		endClient(worker, client, SWARM_DONE, 0);
+		return;
+	}
+	client->state = SWARM_CONNECTING;
+	client->connectStart = now;
+	if ((client->sd = WSASocket(AF_INET, SOCK_STREAM, IPPROTO_TCP, NULL, 0, WSA_FLAG_OVERLAPPED)) == INVALID_SOCKET)
+	{
+		endClient(worker, client, SWARM_FAILED, WSAGetLastError());
+		return;
+	}
+	memset((char *)&local, 0, sizeof(local));
+	local.sin_family = AF_INET;
+	local.sin_addr.s_addr = htonl(INADDR_ANY);
+	if (bind(client->sd, (struct sockaddr *)&local, sizeof(local)) == SOCKET_ERROR
+		|| CreateIoCompletionPort((HANDLE)client->sd, worker->port, 0, 0) == NULL)
+	{
+		endClient(worker, client, SWARM_FAILED, WSAGetLastError());
+		return;
+	}
+	if (swarm->sendBuffer > 0)
+	{
+		setsockopt(client->sd, SOL_SOCKET, SO_SNDBUF, (char *)&(swarm->sendBuffer), sizeof(int));
+	}
+	ZeroMemory(&(client->overlapped), sizeof(OVERLAPPED));
+	if (!swarm->connectEx(client->sd, (struct sockaddr *)&(swarm->server), sizeof(SOCKADDR_IN), NULL, 0, &sent, &(client->overlapped))
+		&& WSAGetLastError() != WSA_IO_PENDING)
+	{
+		endClient(worker, client, SWARM_FAILED, WSAGetLastError());
+	}
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: completeClient
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--				Oct 19, 2026 - a cancelled client ends without failing
+--				Oct 19, 2026 - reads the error of a failed completion
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void completeClient(SWARM_WORKER *worker, SWARM_CLIENT *client, BOOL succeeded,
+--					DWORD bytes, LONGLONG now)
+--
+--	PARAMETERS:	SWARM_WORKER *worker - worker that owns the client
+--				SWARM_CLIENT *client - client whose connect or send completed
+--				BOOL succeeded - FALSE if it failed
+--				DWORD bytes - bytes a send transferred
+--				LONGLONG now - QueryPerformanceCounter value
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	A completed connect records the connect time and starts the client's
+--  schedule at its own place in the profile's tables; a completed send counts
+--  the message. Either way the client goes on to its next message.
+--
+---------------------------------------------------------------------------------*/
+void completeClient(SWARM_WORKER *worker, SWARM_CLIENT *client, BOOL succeeded, DWORD bytes, LONGLONG now)
+{
+	DWORD flags;
+
+	if (!succeeded && worker->stopping)
+	{
+		endClient(worker, client, SWARM_DONE, 0);
+		return;
+	}
+	if (!succeeded)
+	{
+		// the completion holds an NTSTATUS, which this turns into the WSA error
+		WSAGetOverlappedResult(client->sd, &(client->overlapped), &bytes, FALSE, &flags);
+		endClient(worker, client, SWARM_FAILED, WSAGetLastError());
+		return;
+	}
+	if (client->state == SWARM_CONNECTING)
+	{
+		// without this the socket does not know it is connected, so shutdown and getpeername fail
+		setsockopt(client->sd, SOL_SOCKET, SO_UPDATE_CONNECT_CONTEXT, NULL, 0);
+		worker->connected++;
+		worker->open++;
+		addSpread(&(worker->connectTime), (now - client->connectStart) * 1000000 / worker->swarm->frequency);
+		startCursor(&(client->cursor), now, (DWORD)(worker->first + (client - worker->clients)));
+		client->state = SWARM_WAIT_SEND;
+	}
+	else {
+		client->messages++;
+		worker->messages++;
+		worker->bytes += bytes;
+	}
+	scheduleClient(worker, client, now);
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: scheduleClient
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--				Oct 19, 2026 - ends the client once the transfer stops
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void scheduleClient(SWARM_WORKER *worker, SWARM_CLIENT *client, LONGLONG now)
+--
+--	PARAMETERS:	SWARM_WORKER *worker - worker that owns the client
+--				SWARM_CLIENT *client - connected client with no send outstanding
+--				LONGLONG now - QueryPerformanceCounter value
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	Takes the client's next message from the profile and sends it now, or sets
+--  a timer for when it is due. A client that has sent all its messages, or
+--  whose next message falls after the end of a timed run, is done.
+--
+---------------------------------------------------------------------------------*/
+void scheduleClient(SWARM_WORKER *worker, SWARM_CLIENT *client, LONGLONG now)
+{
+	SWARM *swarm = worker->swarm;
+	LONGLONG due;
+
+	if (worker->stopping || (swarm->end == 0 && client->messages >= (DWORD)swarm->repetition))
+	{
+		endClient(worker, client, SWARM_DONE, 0);
+		return;
+	}
+	client->buffer.buf = swarm->payload;
+	client->buffer.len = scheduleNext(swarm->profile, &(client->cursor), now, &due);
+	if (swarm->end > 0 && due >= swarm->end)
+	{
+		endClient(worker, client, SWARM_DONE, 0);
+	}
+	else if (due > now)
+	{
+		client->state = SWARM_WAIT_SEND;
+		pushTimer(worker, client, due);
+	}
+	else {
+		sendClient(worker, client);
+	}
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: sendClient
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void sendClient(SWARM_WORKER *worker, SWARM_CLIENT *client)
+--
+--	PARAMETERS:	SWARM_WORKER *worker - worker that owns the client
+--				SWARM_CLIENT *client - client whose message is due
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	Starts an overlapped send of the client's message. It completes through
+--  the worker's port even when WSASend finishes at once.
+--
+---------------------------------------------------------------------------------*/
+void sendClient(SWARM_WORKER *worker, SWARM_CLIENT *client)
+{
+	DWORD sent;
+
+	client->state = SWARM_SENDING;
+	ZeroMemory(&(client->overlapped), sizeof(OVERLAPPED));
+	if (WSASend(client->sd, &(client->buffer), 1, &sent, 0, &(client->overlapped), NULL) == SOCKET_ERROR
+		&& WSAGetLastError() != WSA_IO_PENDING)
+	{
+		endClient(worker, client, SWARM_FAILED, WSAGetLastError());
+	}
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: endClient
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--				Oct 19, 2026 - is given the error
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void endClient(SWARM_WORKER *worker, SWARM_CLIENT *client, int state, int error)
+--
+--	PARAMETERS:	SWARM_WORKER *worker - worker that owns the client
+--				SWARM_CLIENT *client - client with no connect or send outstanding
+--				int state - SWARM_DONE or SWARM_FAILED
+--				int error - WSA error of the failure, 0 when done
+--
+--	RETURNS:	void
+--
+---------------------------------------------------------------------------------*/
+void endClient(SWARM_WORKER *worker, SWARM_CLIENT *client, int state, int error)
+{
+	if (state == SWARM_FAILED)
+	{
+		worker->lastError = error;
+		worker->failed++;
+	}
+	if (client->state == SWARM_WAIT_SEND || client->state == SWARM_SENDING)
+	{
+		worker->open--;
+	}
+	if (client->sd != INVALID_SOCKET)
+	{
+		closesocket(client->sd);
+		client->sd = INVALID_SOCKET;
+	}
+	client->state = state;
+	worker->active--;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: stopClients
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void stopClients(SWARM_WORKER *worker)
+--
+--	PARAMETERS:	SWARM_WORKER *worker - worker whose transfer was stopped
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	Every client waiting on a timer ends now. Closing the socket of a client
+--  with a connect or send outstanding cancels it, and the client ends when
+--  the cancellation comes back to the worker.
+--
+---------------------------------------------------------------------------------*/
+void stopClients(SWARM_WORKER *worker)
+{
+	SWARM_CLIENT *client;
+
+	worker->stopping = TRUE;
+	while (worker->timerCount > 0)
+	{
+		endClient(worker, popTimer(worker), SWARM_DONE, 0);
+	}
+	for (int i = 0; i < worker->count; i++)
+	{
+		client = &(worker->clients[i]);
+		if ((client->state == SWARM_CONNECTING || client->state == SWARM_SENDING) && client->sd != INVALID_SOCKET)
+		{
+			closesocket(client->sd);
+			client->sd = INVALID_SOCKET;
+		}
+	}
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: pushTimer
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void pushTimer(SWARM_WORKER *worker, SWARM_CLIENT *client, LONGLONG due)
+--
+--	PARAMETERS:	SWARM_WORKER *worker - worker that owns the client
+--				SWARM_CLIENT *client - client to wake
+--				LONGLONG due - QueryPerformanceCounter value to wake it at
+--
+--	RETURNS:	void
+--
+---------------------------------------------------------------------------------*/
+void pushTimer(SWARM_WORKER *worker, SWARM_CLIENT *client, LONGLONG due)
+{
+	int i = worker->timerCount++;
+
+	while (i > 0 && worker->timers[(i - 1) / 2].due > due)
+	{
+		worker->timers[i] = worker->timers[(i - 1) / 2];
+		i = (i - 1) / 2;
+	}
+	worker->timers[i].due = due;
+	worker->timers[i].client = client;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: popTimer
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	SWARM_CLIENT *popTimer(SWARM_WORKER *worker)
+--
+--	PARAMETERS:	SWARM_WORKER *worker - worker with at least one timer
+--
+--	RETURNS:	the client of the earliest timer, which is removed
+--
+---------------------------------------------------------------------------------*/
+SWARM_CLIENT *popTimer(SWARM_WORKER *worker)
+{
+	SWARM_CLIENT *client = worker->timers[0].client;
+	SWARM_TIMER last = worker->timers[--worker->timerCount];
+	int i = 0, child;
+
+	while ((child = 2 * i + 1) < worker->timerCount)
+	{
+		if (child + 1 < worker->timerCount && worker->timers[child + 1].due < worker->timers[child].due)
+		{
+			child++;
+		}
+		if (last.due <= worker->timers[child].due)
+		{
+			break;
+		}
+		worker->timers[i] = worker->timers[child];
+		i = child;
+	}
+	worker->timers[i] = last;
+	return client;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: sumSwarm
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void sumSwarm(SWARM *swarm, SWARM_WORKER *total)
+--
+--	PARAMETERS:	SWARM *swarm - swarm being run
+--				SWARM_WORKER *total - receives the counters summed over the workers
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	The connect times are only complete once the workers have ended.
+--
+---------------------------------------------------------------------------------*/
+void sumSwarm(SWARM *swarm, SWARM_WORKER *total)
+{
+	SWARM_WORKER *worker;
+
+	ZeroMemory(total, sizeof(SWARM_WORKER));
+	for (int w = 0; w < swarm->workers; w++)
+	{
+		worker = &(swarm->worker[w]);
+		total->connected += worker->connected;
+		total->open += worker->open;
+		total->failed += worker->failed;
+		total->messages += worker->messages;
+		total->bytes += worker->bytes;
+		total->connectTime.count += worker->connectTime.count;
+		total->connectTime.total += worker->connectTime.total;
+		total->connectTime.squares += worker->connectTime.squares;
+		if (worker->lastError != 0)
+		{
+			total->lastError = worker->lastError;
+		}
+	}
+}
\ No newline at end of file
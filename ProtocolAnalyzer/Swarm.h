@@ -0,0 +1,82 @@
+#pragma once
+
+#define SWARM_SPEC_LENGTH		128
+#define SWARM_MAX_CLIENTS		262144
+#define SWARM_MAX_THREADS		MAXIMUM_WAIT_OBJECTS
+#define SWARM_BATCH				64		//completions a worker takes at a time
+#define SWARM_MAX_WAIT			100		//ms a worker waits with nothing due
+#define SWARM_REPORT_INTERVAL	1000	//ms between progress lines
+
+#define SWARM_WAIT_CONNECT		0		//waiting for its turn in the connect ramp
+#define SWARM_CONNECTING		1
+#define SWARM_WAIT_SEND			2		//waiting for its next message to be due
+#define SWARM_SENDING			3
+#define SWARM_DONE				4
+#define SWARM_FAILED			5
+
+// Simulated clients, parsed from a spec such as "clients=50000; threads=4;
+// rate=5000". threads 0 is one per processor, rate 0 connects them all at once.
+typedef struct _SWARM_SPEC {
+	int clients;
+	int threads;
+	int rate;					// connects per second
+	char description[SWARM_SPEC_LENGTH + 32];
+} SWARM_SPEC;
+
+// One simulated client. Only the worker that owns it touches it.
+typedef struct _SWARM_CLIENT {
+	OVERLAPPED overlapped;		// the connect or send in progress
+	SOCKET sd;
+	int state;
+	DWORD messages;				// sent so far
+	WSABUF buffer;				// message being sent, from the shared payload
+	PROFILE_CURSOR cursor;
+	LONGLONG connectStart;
+} SWARM_CLIENT;
+
+typedef struct _SWARM_TIMER {
+	LONGLONG due;				// QueryPerformanceCounter
+	SWARM_CLIENT *client;
+} SWARM_TIMER;
+
+// A reactor thread and the clients it drives. Each worker has its own
+// completion port, so a client's completions always come back to its owner
+// and its state machine needs no locks. The counters are read without locks
+// by the progress reports.
+typedef struct __declspec(align(64)) _SWARM_WORKER {
+	struct _SWARM *swarm;
+	HANDLE port;
+	HANDLE thread;
+	SWARM_CLIENT *clients;
+	int first;					// index of its first client in the swarm
+	int count;
+	int active;					// clients not yet done or failed
+	SWARM_TIMER *timers;		// min-heap by due time, at most one entry per client
+	int timerCount;
+	BOOL stopping;				// the transfer was stopped, clients end as they come back
+	volatile LONG connected;
+	volatile LONG open;
+	volatile LONG failed;
+	volatile LONG lastError;	// WSA error of the latest failure
+	volatile ULONGLONG messages;
+	volatile ULONGLONG bytes;
+	LATENCY_SPREAD connectTime;	// us, read once the worker has ended
+} SWARM_WORKER;
+
+typedef struct _SWARM {
+	SWARM_SPEC spec;
+	SOCKADDR_IN server;
+	LPFN_CONNECTEX connectEx;
+	TRAFFIC_PROFILE *profile;	// shared, each client keeps its own cursor
+	char *payload;				// generated once, every client sends from it
+	int sendBuffer;				// SO_SNDBUF, 0 for the system default
+	int repetition;				// messages per client in a counted run
+	LONGLONG frequency;
+	LONGLONG start;				// QueryPerformanceCounter the connect ramp starts at
+	LONGLONG end;				// timed runs: when clients stop sending, 0 otherwise
+	int workers;
+	SWARM_WORKER *worker;
+} SWARM;
+
+BOOL parseSwarm(char *, SWARM_SPEC *);
+void runSwarm(char *, int, int, int, HANDLE, struct _CLIENT_OPTIONS *);
\ No newline at end of file
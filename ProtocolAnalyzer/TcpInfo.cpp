@@ -0,0 +1,362 @@
+/*---------------------------------------------------------------------------------
+--	SOURCE FILE:	TcpInfo.cpp -
+--
+--	PROGRAM:		Transport Layer Protocol Analyser
+--
+--	FUNCTIONS:
+--					BOOL startTcpInfo(TCP_INFO_SERIES *series, SOCKET sd)
+--					void sampleTcpInfo(TCP_INFO_SERIES *series)
+--					void finishTcpInfo(TCP_INFO_SERIES *series)
+--					void logTcpInfo(TCP_INFO_SERIES *series, char *side, HANDLE logFile)
+--					BOOL readTcpInfo(TCP_INFO_SERIES *series, TCP_INFO_v1 *info)
+--					void takeTcpInfo(TCP_INFO_SERIES *series, LONGLONG now)
+--
+--	DATE:			Oct 19, 2026
+--
+--	REVISIONS:		Oct 19, 2026
+--
+--	DESIGNER:		Gabriella Cheung
+--
+--	PROGRAMMER:		Gabriella Cheung
+--
+--	NOTES:
+--	This file contains the sampling of a TCP connection's own view of the
+--  transfer: its round trip time, congestion window, retransmissions and the
+--  rate data was delivered. Windows 10 1703 and later return these through the
+--  SIO_TCP_INFO ioctl; version 1 of the structure, from 1709, adds how long
+--  the sender was held back by the peer's receive window, by the congestion
+--  window and by the application.
+--
+--  Windows does not expose the slow start threshold, the kernel's RTT
+--  variance or a pacing rate. In their place the series records the mean
+--  deviation of the smoothed RTT between samples, the send-limited times, and
+--  the window rate: the congestion window over the RTT, the rate the window
+--  allows. The delivery rate is taken from the bytes acknowledged, or for the
+--  receiving end the bytes received, between samples.
+--
+--  Samples are taken by the thread that owns the socket, at most every
+--  TCP_INFO_INTERVAL ms. A long transfer fills the series, which then keeps
+--  every other sample and samples half as often, so it always covers the
+--  whole connection.
+--
+---------------------------------------------------------------------------------*/
+#include "resource.h"
+
+BOOL readTcpInfo(TCP_INFO_SERIES *, TCP_INFO_v1 *);
+void takeTcpInfo(TCP_INFO_SERIES *, LONGLONG);
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: startTcpInfo
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	BOOL startTcpInfo(TCP_INFO_SERIES *series, SOCKET sd)
+--
+--	PARAMETERS:	TCP_INFO_SERIES *series - series to start
+--				SOCKET sd - connected TCP socket
+--
+--	RETURNS:	TRUE if the first sample was taken, FALSE if the system has no
+--				SIO_TCP_INFO
+--
+--	NOTES:
+--	Asks for version 1 of TCP_INFO and falls back to version 0. The series is
+--  still set up when both are refused, so it can be logged as unavailable.
+--
+---------------------------------------------------------------------------------*/
+BOOL startTcpInfo(TCP_INFO_SERIES *series, SOCKET sd)
+{
+	LARGE_INTEGER frequency, now;
+
+	ZeroMemory(series, sizeof(TCP_INFO_SERIES));
+	series->sd = sd;
+	QueryPerformanceFrequency(&frequency);
+	series->frequency = frequency.QuadPart;
+	series->interval = series->frequency * TCP_INFO_INTERVAL / 1000;
+	series->version = 1;
+	if (!readTcpInfo(series, &(series->latest)))
+	{
+		series->version = 0;
+		if (!readTcpInfo(series, &(series->latest)))
+		{
+			series->version = TCP_INFO_NONE;
+			return FALSE;
+		}
+	}
+	QueryPerformanceCounter(&now);
+	series->start = now.QuadPart;
+	takeTcpInfo(series, now.QuadPart);
+	return TRUE;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: sampleTcpInfo
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void sampleTcpInfo(TCP_INFO_SERIES *series)
+--
+--	PARAMETERS:	TCP_INFO_SERIES *series - series from startTcpInfo
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	Takes a sample if one is due. Cheap enough to call on every send.
+--
+---------------------------------------------------------------------------------*/
+void sampleTcpInfo(TCP_INFO_SERIES *series)
+{
+	LARGE_INTEGER now;
+
+	if (series->version == TCP_INFO_NONE)
+	{
+		return;
+	}
+	QueryPerformanceCounter(&now);
+	if (now.QuadPart >= series->next)
+	{
+		takeTcpInfo(series, now.QuadPart);
+	}
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: finishTcpInfo
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void finishTcpInfo(TCP_INFO_SERIES *series)
+--
+--	PARAMETERS:	TCP_INFO_SERIES *series - series from startTcpInfo
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	Takes a last sample whether or not one is due, before the socket closes.
+--
+---------------------------------------------------------------------------------*/
+void finishTcpInfo(TCP_INFO_SERIES *series)
+{
+	LARGE_INTEGER now;
+
+	if (series->version == TCP_INFO_NONE)
+	{
+		return;
+	}
+	QueryPerformanceCounter(&now);
+	if (now.QuadPart > series->previousTime)
+	{
+		takeTcpInfo(series, now.QuadPart);
+	}
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: logTcpInfo
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void logTcpInfo(TCP_INFO_SERIES *series, char *side, HANDLE logFile)
+--
+--	PARAMETERS:	TCP_INFO_SERIES *series - series from startTcpInfo
+--				char *side - "client" or "server"
+--				HANDLE logFile - handle for the log file
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	Writes the series to the log file, one line per sample, and prints its
+--  summary to the screen and the log file.
+--
+---------------------------------------------------------------------------------*/
+void logTcpInfo(TCP_INFO_SERIES *series, char *side, HANDLE logFile)
+{
+	char message[256];
+	TCP_INFO_SAMPLE *sample;
+	TCP_INFO_v1 *info = &(series->latest);
+	double elapsed;
+
+	if (series->version == TCP_INFO_NONE)
+	{
+		sprintf(message, "TCP_INFO (%s): unavailable, needs Windows 10 1703 or later", side);
+		writeToScreen(message);
+		strcat(message, "\r\n");
+		writeToFile(logFile, message);
+		return;
+	}
+	sprintf(message, "TCP_INFO (%s) every %lld ms: elapsed ms, RTT us, RTT variation us, cwnd, in flight, send window, retransmitted bytes, timeouts, delivery Mbps, window Mbps\r\n",
+		side, series->interval * 1000 / series->frequency);
+	writeToFile(logFile, message);
+	for (int i = 0; i < series->count; i++)
+	{
+		sample = &(series->samples[i]);
+		sprintf(message, "%lu, %lu, %lu, %lu, %lu, %lu, %lu, %lu, %.1f, %.1f\r\n",
+			sample->elapsed, sample->rtt, sample->rttVariation, sample->cwnd, sample->inFlight,
+			sample->sendWindow, sample->retransmitted, sample->timeouts,
+			sample->deliveryRate * 8 / 1000000.0, sample->windowRate * 8 / 1000000.0);
+		writeToFile(logFile, message);
+	}
+
+	sprintf(message, "TCP_INFO (%s): RTT mean %.0f us, variation %.0f us, minimum %lu us; cwnd %lu bytes at the end, %lu at most, MSS %lu (%llu samples)",
+		side, spreadMean(&(series->rtt)), spreadJitter(&(series->rtt)), info->MinRttUs,
+		info->Cwnd, series->maxCwnd, info->Mss, series->taken);
+	writeToScreen(message);
+	strcat(message, "\r\n");
+	writeToFile(logFile, message);
+	elapsed = (double)(series->previousTime - series->start) / series->frequency;
+	sprintf(message, "TCP_INFO (%s): delivery rate %.1f Mbps mean, %.1f Mbps peak; %lu bytes retransmitted, %lu fast retransmits, %lu timeouts, %lu duplicate ACKs",
+		side, elapsed > 0 ? (series->previousDelivered - series->firstDelivered) * 8 / elapsed / 1000000.0 : 0.0,
+		series->maxDeliveryRate * 8 / 1000000.0, info->BytesRetrans, info->FastRetrans,
+		info->TimeoutEpisodes, info->DupAcksIn);
+	writeToScreen(message);
+	strcat(message, "\r\n");
+	writeToFile(logFile, message);
+	if (series->version == 1 && info->BytesOut > 0)
+	{
+		sprintf(message, "TCP_INFO (%s): sender limited by the receive window for %lu ms, the congestion window for %lu ms, the application for %lu ms",
+			side, info->SndLimTimeRwin, info->SndLimTimeCwnd, info->SndLimTimeSnd);
+		writeToScreen(message);
+		strcat(message, "\r\n");
+		writeToFile(logFile, message);
+	}
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: readTcpInfo
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	BOOL readTcpInfo(TCP_INFO_SERIES *series, TCP_INFO_v1 *info)
+--
+--	PARAMETERS:	TCP_INFO_SERIES *series - series giving the socket and version
+--				TCP_INFO_v1 *info - where to read it; version 0 leaves the
+--					send-limited fields zero
+--
+--	RETURNS:	TRUE if the ioctl succeeded
+--
+---------------------------------------------------------------------------------*/
+BOOL readTcpInfo(TCP_INFO_SERIES *series, TCP_INFO_v1 *info)
+{
+	DWORD version = series->version, bytes;
+
+	ZeroMemory(info, sizeof(TCP_INFO_v1));
+	return WSAIoctl(series->sd, SIO_TCP_INFO, &version, sizeof(version), info,
+		version == 1 ? sizeof(TCP_INFO_v1) : sizeof(TCP_INFO_v0), &bytes, NULL, NULL) == 0;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: takeTcpInfo
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void takeTcpInfo(TCP_INFO_SERIES *series, LONGLONG now)
+--
+--	PARAMETERS:	TCP_INFO_SERIES *series - series to add to
+--				LONGLONG now - QueryPerformanceCounter
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	Reads TCP_INFO and adds a sample. A failed read, as when the connection is
+--  closing, only moves the next sample on. The RTT variation is kept the way
+--  RFC 6298 keeps RTTVAR, from the change in the smoothed RTT.
+--
+---------------------------------------------------------------------------------*/
+void takeTcpInfo(TCP_INFO_SERIES *series, LONGLONG now)
+{
+	TCP_INFO_v1 info;
+	TCP_INFO_SAMPLE *sample;
+	ULONGLONG delivered;
+	ULONG change;
+
+	series->next = now + series->interval;
+	if (!readTcpInfo(series, &info))
+	{
+		return;
+	}
+	delivered = info.BytesIn;
+	if (info.BytesOut > (ULONGLONG)info.BytesRetrans + info.BytesInFlight)
+	{
+		delivered += info.BytesOut - info.BytesRetrans - info.BytesInFlight;
+	}
+
+	if (series->count == TCP_INFO_SAMPLES)
+	{
+		for (int i = 0; i < TCP_INFO_SAMPLES / 2; i++)
+		{
+			series->samples[i] = series->samples[2 * i];
+		}
+		series->count = TCP_INFO_SAMPLES / 2;
+		series->interval *= 2;
+		series->next = now + series->interval;
+	}
+	sample = &(series->samples[series->count++]);
+	if (series->taken == 0)
+	{
+		series->firstDelivered = delivered;
+		series->previousDelivered = delivered;
+		series->previousTime = now;
+	}
+	else {
+		change = info.RttUs > series->latest.RttUs ? info.RttUs - series->latest.RttUs : series->latest.RttUs - info.RttUs;
+		series->rttVariation = (3 * series->rttVariation + change) / 4;
+	}
+	sample->elapsed = (DWORD)((now - series->start) * 1000 / series->frequency);
+	sample->rtt = info.RttUs;
+	sample->rttVariation = series->rttVariation;
+	sample->cwnd = info.Cwnd;
+	sample->inFlight = info.BytesInFlight;
+	sample->sendWindow = info.SndWnd;
+	sample->retransmitted = info.BytesRetrans;
+	sample->timeouts = info.TimeoutEpisodes;
+	sample->deliveryRate = now > series->previousTime && delivered > series->previousDelivered
+		? (ULONGLONG)((double)(delivered - series->previousDelivered) * series->frequency / (now - series->previousTime)) : 0;
+	sample->windowRate = info.RttUs > 0 ? (ULONGLONG)info.Cwnd * 1000000 / info.RttUs : 0;
+
+	addSpread(&(series->rtt), info.RttUs);
+	if (info.Cwnd > series->maxCwnd)
+	{
+		series->maxCwnd = info.Cwnd;
+	}
+	if (sample->deliveryRate > series->maxDeliveryRate)
+	{
+		series->maxDeliveryRate = sample->deliveryRate;
+	}
+	series->latest = info;
+	series->previousTime = now;
+	series->previousDelivered = delivered;
+	series->taken++;
+}
\ No newline at end of file
@@ -0,0 +1,103 @@
+#pragma once
+
+#ifndef SIO_TCP_INFO
+// SIO_TCP_INFO only ships with Windows 10 SDKs from 16299 on
+#define SIO_TCP_INFO			_WSAIORW(IOC_VENDOR, 39)
+typedef struct _TCP_INFO_v0 {
+	INT State;					// TCPSTATE
+	ULONG Mss;
+	ULONG64 ConnectionTimeMs;
+	BOOLEAN TimestampsEnabled;
+	ULONG RttUs;
+	ULONG MinRttUs;
+	ULONG BytesInFlight;
+	ULONG Cwnd;
+	ULONG SndWnd;
+	ULONG RcvWnd;
+	ULONG RcvBuf;
+	ULONG64 BytesOut;
+	ULONG64 BytesIn;
+	ULONG BytesReordered;
+	ULONG BytesRetrans;
+	ULONG FastRetrans;
+	ULONG DupAcksIn;
+	ULONG TimeoutEpisodes;
+	UCHAR SynRetrans;
+} TCP_INFO_v0, *PTCP_INFO_v0;
+typedef struct _TCP_INFO_v1 {
+	INT State;
+	ULONG Mss;
+	ULONG64 ConnectionTimeMs;
+	BOOLEAN TimestampsEnabled;
+	ULONG RttUs;
+	ULONG MinRttUs;
+	ULONG BytesInFlight;
+	ULONG Cwnd;
+	ULONG SndWnd;
+	ULONG RcvWnd;
+	ULONG RcvBuf;
+	ULONG64 BytesOut;
+	ULONG64 BytesIn;
+	ULONG BytesReordered;
+	ULONG BytesRetrans;
+	ULONG FastRetrans;
+	ULONG DupAcksIn;
+	ULONG TimeoutEpisodes;
+	UCHAR SynRetrans;
+	ULONG SndLimTransRwin;
+	ULONG SndLimTimeRwin;		// ms the peer's receive window held the sender back
+	ULONG64 SndLimBytesRwin;
+	ULONG SndLimTransCwnd;
+	ULONG SndLimTimeCwnd;		// ms the congestion window held it back
+	ULONG64 SndLimBytesCwnd;
+	ULONG SndLimTransSnd;
+	ULONG SndLimTimeSnd;		// ms it was limited by the application or its send buffer
+	ULONG64 SndLimBytesSnd;
+} TCP_INFO_v1, *PTCP_INFO_v1;
+#endif
+
+#define TCP_INFO_NONE			((DWORD)-1)	//version when the system has no SIO_TCP_INFO
+#define TCP_INFO_INTERVAL		100		//ms between samples at the start of a connection
+#define TCP_INFO_SAMPLES		256		//samples kept; a full series keeps every other one and samples half as often
+#define TCP_INFO_CONNECTIONS	64		//server connections sampled at once, the rest are not
+
+// One reading of a connection's TCP_INFO.
+typedef struct _TCP_INFO_SAMPLE {
+	DWORD elapsed;				// ms since the first sample
+	ULONG rtt;					// smoothed round trip time, us
+	ULONG rttVariation;			// mean deviation of rtt from one sample to the next, us
+	ULONG cwnd;					// congestion window, bytes
+	ULONG inFlight;				// bytes sent and not yet acknowledged
+	ULONG sendWindow;			// receive window the peer advertised
+	ULONG retransmitted;		// bytes retransmitted so far
+	ULONG timeouts;				// retransmission timeouts so far
+	ULONGLONG deliveryRate;		// bytes per second delivered since the previous sample
+	ULONGLONG windowRate;		// cwnd over rtt, bytes per second
+} TCP_INFO_SAMPLE;
+
+// TCP_INFO of one connection over a transfer. Only the thread that owns the
+// socket may sample it.
+typedef struct _TCP_INFO_SERIES {
+	SOCKET sd;
+	DWORD version;				// 1 or 0, TCP_INFO_NONE if the ioctl is refused
+	LONGLONG frequency;
+	LONGLONG start;				// QueryPerformanceCounter at the first sample
+	LONGLONG interval;			// ticks between samples
+	LONGLONG next;				// when the next sample is due
+	LONGLONG previousTime;		// when latest was read
+	ULONGLONG firstDelivered;	// bytes delivered at the first sample
+	ULONGLONG previousDelivered;
+	ULONG rttVariation;
+	TCP_INFO_v1 latest;
+	LATENCY_SPREAD rtt;			// every sample's rtt, including those thinned out
+	ULONG maxCwnd;
+	ULONGLONG maxDeliveryRate;
+	ULONGLONG taken;			// samples taken; count is the number kept
+	int count;
+	TCP_INFO_SAMPLE samples[TCP_INFO_SAMPLES];
+} TCP_INFO_SERIES;
+
+BOOL startTcpInfo(TCP_INFO_SERIES *, SOCKET);
+void sampleTcpInfo(TCP_INFO_SERIES *);
+void finishTcpInfo(TCP_INFO_SERIES *);
+void logTcpInfo(TCP_INFO_SERIES *, char *, HANDLE);
\ No newline at end of file
@@ -0,0 +1,407 @@
+/*---------------------------------------------------------------------------------
+--	SOURCE FILE:	Timestamp.cpp -
+--
+--	PROGRAM:		Transport Layer Protocol Analyser
+--
+--	FUNCTIONS:
+--					BOOL enableTimestamps(SOCKET sd, DWORD flags)
+--					void calibrateTimestamps()
+--					ULONGLONG counterToFileTime(ULONGLONG counter)
+--					LONGLONG counterMicroseconds(LONGLONG ticks)
+--					ULONGLONG receiveTimestamp(LPWSAMSG msg)
+--					BOOL startTxTimestamps(TX_TIMESTAMPS *tx, SOCKET sd)
+--					int sendTimestamped(TX_TIMESTAMPS *tx, char *data, int length, SOCKADDR_IN *server)
+--					void finishTxTimestamps(TX_TIMESTAMPS *tx)
+--					void logTxTimestamps(TX_TIMESTAMPS *tx, HANDLE logFile)
+--					BOOL collectTxTimestamp(TX_TIMESTAMPS *tx)
+--
+--	DATE:			Oct 19, 2026
+--
+--	REVISIONS:		Oct 19, 2026
+--
+--	DESIGNER:		Gabriella Cheung
+--
+--	PROGRAMMER:		Gabriella Cheung
+--
+--	NOTES:
+--	This file contains the kernel packet timestamps, so the time a datagram
+--  spends waiting for the application is not counted as time on the network.
+--  Windows 10 1903 and later take a timestamp in the adapter's driver as each
+--  datagram is received or sent, enabled per socket with SIO_TIMESTAMPING.
+--  Receive timestamps come back as an SO_TIMESTAMP control message through
+--  WSARecvMsg; transmit timestamps are asked for with an SO_TIMESTAMP_ID
+--  control message on WSASendMsg and collected with SIO_GET_TX_TIMESTAMP.
+--
+--  The timestamps are QueryPerformanceCounter values. Winsock only passes up
+--  these software timestamps; an adapter's hardware clock is not exposed to
+--  sockets, so there is no hardware mode to pick. Older systems refuse the
+--  ioctl and the latency is measured in user space as before.
+--
+--  To compare a receive timestamp with a sender's FILETIME, the counter is
+--  mapped onto the system time from a pair of readings taken at calibration.
+--
+---------------------------------------------------------------------------------*/
+#include "resource.h"
+
+BOOL collectTxTimestamp(TX_TIMESTAMPS *);
+
+static LARGE_INTEGER frequency;
+static ULONGLONG calibrationCounter;
+static ULONGLONG calibrationTime;
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: enableTimestamps
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	BOOL enableTimestamps(SOCKET sd, DWORD flags)
+--
+--	PARAMETERS:	SOCKET sd - datagram socket
+--				DWORD flags - TIMESTAMPING_FLAG_RX, TIMESTAMPING_FLAG_TX or both
+--
+--	RETURNS:	TRUE if the stack will timestamp the socket's datagrams
+--
+--	NOTES:
+--	Also calibrates the counter against the system time the first time.
+--
+---------------------------------------------------------------------------------*/
+BOOL enableTimestamps(SOCKET sd, DWORD flags)
+{
+	TIMESTAMPING_CONFIG config = { 0 };
+	DWORD bytes;
+
+	config.Flags = flags;
+	config.TxTimestampsBuffered = flags & TIMESTAMPING_FLAG_TX ? TX_TIMESTAMPS_BUFFERED : 0;
+	if (WSAIoctl(sd, SIO_TIMESTAMPING, &config, sizeof(config), NULL, 0, &bytes, NULL, NULL) == SOCKET_ERROR)
+	{
+		return FALSE;
+	}
+	if (frequency.QuadPart == 0)
+	{
+		calibrateTimestamps();
+	}
+	return TRUE;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: calibrateTimestamps
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void calibrateTimestamps()
+--
+--	PARAMETERS:	none
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	Reads the counter and the precise system time back to back. The system
+--  time is steered by time synchronisation while the counter is not, so the
+--  server calibrates again between transfers, when no receive is converting.
+--
+---------------------------------------------------------------------------------*/
+void calibrateTimestamps()
+{
+	LARGE_INTEGER counter;
+
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&counter);
+	calibrationTime = preciseFileTime();
+	calibrationCounter = counter.QuadPart;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: counterToFileTime
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	ULONGLONG counterToFileTime(ULONGLONG counter)
+--
+--	PARAMETERS:	ULONGLONG counter - QueryPerformanceCounter value, such as a
+--								kernel timestamp
+--
+--	RETURNS:	the system time at that counter value, as a FILETIME
+--
+---------------------------------------------------------------------------------*/
+ULONGLONG counterToFileTime(ULONGLONG counter)
+{
+	LONGLONG ticks = (LONGLONG)(counter - calibrationCounter);
+
+	return calibrationTime + ticks / frequency.QuadPart * 10000000 + ticks % frequency.QuadPart * 10000000 / frequency.QuadPart;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: counterMicroseconds
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	LONGLONG counterMicroseconds(LONGLONG ticks)
+--
+--	PARAMETERS:	LONGLONG ticks - difference of two counter values
+--
+--	RETURNS:	the difference in microseconds
+--
+---------------------------------------------------------------------------------*/
+LONGLONG counterMicroseconds(LONGLONG ticks)
+{
+	return ticks * 1000000 / frequency.QuadPart;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: receiveTimestamp
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	ULONGLONG receiveTimestamp(LPWSAMSG msg)
+--
+--	PARAMETERS:	LPWSAMSG msg - message filled by WSARecvMsg
+--
+--	RETURNS:	the kernel's receive timestamp, or 0 if it has none
+--
+---------------------------------------------------------------------------------*/
+ULONGLONG receiveTimestamp(LPWSAMSG msg)
+{
+	LPWSACMSGHDR control;
+
+	for (control = WSA_CMSG_FIRSTHDR(msg); control != NULL; control = WSA_CMSG_NXTHDR(msg, control))
+	{
+		if (control->cmsg_level == SOL_SOCKET && control->cmsg_type == SO_TIMESTAMP)
+		{
+			return *(UINT64 *)WSA_CMSG_DATA(control);
+		}
+	}
+	return 0;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: startTxTimestamps
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	BOOL startTxTimestamps(TX_TIMESTAMPS *tx, SOCKET sd)
+--
+--	PARAMETERS:	TX_TIMESTAMPS *tx - state to set up
+--				SOCKET sd - the client's datagram socket
+--
+--	RETURNS:	TRUE if transmit timestamps are available
+--
+---------------------------------------------------------------------------------*/
+BOOL startTxTimestamps(TX_TIMESTAMPS *tx, SOCKET sd)
+{
+	ZeroMemory(tx, sizeof(TX_TIMESTAMPS));
+	tx->sd = sd;
+	tx->nextId = 1;
+	tx->enabled = enableTimestamps(sd, TIMESTAMPING_FLAG_TX);
+	return tx->enabled;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: sendTimestamped
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	int sendTimestamped(TX_TIMESTAMPS *tx, char *data, int length, SOCKADDR_IN *server)
+--
+--	PARAMETERS:	TX_TIMESTAMPS *tx - state from startTxTimestamps
+--				char *data - datagram to send
+--				int length - its length in bytes
+--				SOCKADDR_IN *server - where to send it
+--
+--	RETURNS:	0, or SOCKET_ERROR like sendto
+--
+--	NOTES:
+--	Sends the datagram with WSASendMsg and an SO_TIMESTAMP_ID, so the stack
+--  keeps its transmit timestamp. The previous sample's timestamp is collected
+--  first; if it still isn't there it is counted as missed. This one's is
+--  tried straight away, since a send that completes inline has usually been
+--  timestamped by the time the call returns.
+--
+---------------------------------------------------------------------------------*/
+int sendTimestamped(TX_TIMESTAMPS *tx, char *data, int length, SOCKADDR_IN *server)
+{
+	WSAMSG msg = { 0 };
+	WSABUF buffer;
+	CHAR controlData[WSA_CMSG_SPACE(sizeof(UINT32))] = { 0 };
+	LPWSACMSGHDR control = (LPWSACMSGHDR)controlData;
+	LARGE_INTEGER start;
+	DWORD bytes;
+
+	if (tx->pending && !collectTxTimestamp(tx))
+	{
+		tx->missed++;
+		tx->pending = FALSE;
+	}
+
+	buffer.buf = data;
+	buffer.len = length;
+	msg.name = (LPSOCKADDR)server;
+	msg.namelen = sizeof(SOCKADDR_IN);
+	msg.lpBuffers = &buffer;
+	msg.dwBufferCount = 1;
+	msg.Control.buf = controlData;
+	msg.Control.len = sizeof(controlData);
+	control->cmsg_len = WSA_CMSG_LEN(sizeof(UINT32));
+	control->cmsg_level = SOL_SOCKET;
+	control->cmsg_type = SO_TIMESTAMP_ID;
+	*(UINT32 *)WSA_CMSG_DATA(control) = tx->nextId;
+
+	QueryPerformanceCounter(&start);
+	if (WSASendMsg(tx->sd, &msg, 0, &bytes, NULL, NULL) == SOCKET_ERROR)
+	{
+		return SOCKET_ERROR;
+	}
+	tx->pending = TRUE;
+	tx->pendingId = tx->nextId++;
+	tx->pendingStart = start.QuadPart;
+	collectTxTimestamp(tx);
+	return 0;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: finishTxTimestamps
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void finishTxTimestamps(TX_TIMESTAMPS *tx)
+--
+--	PARAMETERS:	TX_TIMESTAMPS *tx - state from startTxTimestamps
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	Gives the last sample a moment to be timestamped before the socket closes.
+--
+---------------------------------------------------------------------------------*/
+void finishTxTimestamps(TX_TIMESTAMPS *tx)
+{
+	if (tx->pending && !collectTxTimestamp(tx))
+	{
+		Sleep(1);
+		if (!collectTxTimestamp(tx))
+		{
+			tx->missed++;
+			tx->pending = FALSE;
+		}
+	}
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: logTxTimestamps
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void logTxTimestamps(TX_TIMESTAMPS *tx, HANDLE logFile)
+--
+--	PARAMETERS:	TX_TIMESTAMPS *tx - state from startTxTimestamps
+--				HANDLE logFile - handle for the client log file
+--
+--	RETURNS:	void
+--
+---------------------------------------------------------------------------------*/
+void logTxTimestamps(TX_TIMESTAMPS *tx, HANDLE logFile)
+{
+	char message[256];
+
+	if (!tx->enabled)
+	{
+		sprintf(message, "Kernel transmit timestamps: unavailable");
+	}
+	else {
+		sprintf(message, "Application to kernel transmit timestamp: mean %.1f us, jitter %.1f us (1 in %d datagrams, %llu sampled, %llu missed)",
+			spreadMean(&(tx->spread)), spreadJitter(&(tx->spread)), TX_TIMESTAMP_EVERY, tx->spread.count, tx->missed);
+	}
+	writeToScreen(message);
+	strcat(message, "\r\n");
+	writeToFile(logFile, message);
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: collectTxTimestamp
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	BOOL collectTxTimestamp(TX_TIMESTAMPS *tx)
+--
+--	PARAMETERS:	TX_TIMESTAMPS *tx - state with a pending sample
+--
+--	RETURNS:	TRUE if the pending sample's timestamp was collected
+--
+---------------------------------------------------------------------------------*/
+BOOL collectTxTimestamp(TX_TIMESTAMPS *tx)
+{
+	UINT32 id = tx->pendingId;
+	UINT64 timestamp;
+	DWORD bytes;
+
+	if (!tx->pending)
+	{
+		return FALSE;
+	}
+	if (WSAIoctl(tx->sd, SIO_GET_TX_TIMESTAMP, &id, sizeof(id), &timestamp, sizeof(timestamp), &bytes, NULL, NULL) == SOCKET_ERROR)
+	{
+		return FALSE;
+	}
+	addSpread(&(tx->spread), counterMicroseconds((LONGLONG)timestamp - tx->pendingStart));
+	tx->pending = FALSE;
+	return TRUE;
+}
\ No newline at end of file
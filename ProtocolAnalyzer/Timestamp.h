@@ -0,0 +1,41 @@
+#pragma once
+
+#ifndef SIO_TIMESTAMPING
+// Winsock timestamping only ships with Windows 10 SDKs from 18362 on
+#define SIO_TIMESTAMPING		_WSAIOW(IOC_VENDOR, 235)
+#define SIO_GET_TX_TIMESTAMP	_WSAIOW(IOC_VENDOR, 234)
+#define SO_TIMESTAMP			0x300A
+#define SO_TIMESTAMP_ID			0x300B
+#define TIMESTAMPING_FLAG_RX	0x1
+#define TIMESTAMPING_FLAG_TX	0x2
+typedef struct _TIMESTAMPING_CONFIG {
+	ULONG Flags;
+	USHORT TxTimestampsBuffered;
+} TIMESTAMPING_CONFIG, *PTIMESTAMPING_CONFIG;
+#endif
+
+#define TX_TIMESTAMPS_BUFFERED	8		//transmit timestamps the stack keeps for collection
+#define TX_TIMESTAMP_EVERY		64		//datagrams per one sent with a transmit timestamp
+
+// Transmit timestamps of a client's sampled datagrams. One is outstanding at
+// a time; it is collected before the next sample is sent.
+typedef struct _TX_TIMESTAMPS {
+	SOCKET sd;
+	BOOL enabled;				// SIO_TIMESTAMPING took the transmit flag
+	DWORD nextId;
+	BOOL pending;				// pendingId has been sent and not collected
+	DWORD pendingId;
+	LONGLONG pendingStart;		// QueryPerformanceCounter just before its send
+	LATENCY_SPREAD spread;		// application to the kernel's transmit timestamp
+	ULONGLONG missed;			// samples whose timestamp never came
+} TX_TIMESTAMPS;
+
+BOOL enableTimestamps(SOCKET, DWORD);
+void calibrateTimestamps();
+ULONGLONG counterToFileTime(ULONGLONG);
+LONGLONG counterMicroseconds(LONGLONG);
+ULONGLONG receiveTimestamp(LPWSAMSG);
+BOOL startTxTimestamps(TX_TIMESTAMPS *, SOCKET);
+int sendTimestamped(TX_TIMESTAMPS *, char *, int, SOCKADDR_IN *);
+void finishTxTimestamps(TX_TIMESTAMPS *);
+void logTxTimestamps(TX_TIMESTAMPS *, HANDLE);
\ No newline at end of file
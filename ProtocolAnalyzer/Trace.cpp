@@ -0,0 +1,489 @@
+/*---------------------------------------------------------------------------------
+--	SOURCE FILE:	Trace.cpp -
+--
+--	PROGRAM:		Transport Layer Protocol Analyser
+--
+--	FUNCTIONS:
+--					void startTracing()
+--					void stopTracing()
+--					void traceEvent(DWORD point, ULONGLONG start, DWORD value)
+--					void traceThread(char *name)
+--					void releaseTrace()
+--					LONG dumpTrace(char *fileName)
+--					TRACE_RING *newRing()
+--					double ticksPerMicrosecond()
+--					BOOL flushTrace(HANDLE file, char *buffer, DWORD *used, DWORD room)
+--
+--	DATE:			Oct 19, 2026
+--
+--	REVISIONS:		Oct 19, 2026
+--
+--	DESIGNER:		Gabriella Cheung
+--
+--	PROGRAMMER:		Gabriella Cheung
+--
+--	NOTES:
+--	This file contains the trace points on the receive, send, statistics and
+--  file write paths. Each thread that passes a trace point while tracing is on
+--  gets a ring of TRACE_EVENTS events of its own, so recording one takes two
+--  __rdtsc reads and a handful of stores with no lock or interlocked operation.
+--  When a ring is full its oldest events are overwritten.
+--
+--  dumpTrace writes every ring out in the Chrome trace event format, which
+--  chrome://tracing and the Perfetto UI both load. The time stamp counter is
+--  converted to microseconds against QueryPerformanceCounter over the time
+--  since tracing first started, which assumes an invariant TSC, as every
+--  x86 processor of the last decade has.
+--
+--  Building with TRACE_POINTS defined as 0 removes the trace points altogether.
+--
+---------------------------------------------------------------------------------*/
+#include "resource.h"
+
+typedef struct _TRACE_SPAN {
+	ULONGLONG start;			// __rdtsc
+	ULONGLONG end;
+	DWORD point;
+	DWORD value;
+} TRACE_SPAN;
+
+typedef struct _TRACE_RING {
+	volatile LONG head;			// events written so far, only the owning thread writes it
+	volatile LONG released;		// its thread has ended, a thread of the same name may take it
+	DWORD threadId;
+	char name[TRACE_NAME_LENGTH];
+	TRACE_SPAN events[TRACE_EVENTS];
+} TRACE_RING;
+
+TRACE_RING *newRing();
+double ticksPerMicrosecond();
+BOOL flushTrace(HANDLE, char *, DWORD *, DWORD);
+
+volatile BOOL traceEnabled = false;
+static TRACE_RING * volatile rings[TRACE_THREADS];
+static volatile LONG ringCount = 0;
+static __declspec(thread) TRACE_RING *threadRing;
+static __declspec(thread) char *threadName;
+static ULONGLONG baseTicks;			// __rdtsc when tracing first started
+static LONGLONG baseCounter;		// QueryPerformanceCounter at the same moment
+static const char *pointNames[TRACE_POINT_COUNT] = { "UDP receive", "TCP receive", "UDP send", "TCP send",
+	"record packet", "sample stats", "snapshot stats", "file write" };
+static const char *pointCategories[TRACE_POINT_COUNT] = { "receive", "receive", "send", "send",
+	"stats", "stats", "stats", "file" };
+static const char *pointValues[TRACE_POINT_COUNT] = { "bytes", "bytes", "bytes", "bytes",
+	"bytes", "packets", "packets", "bytes" };
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: startTracing
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void startTracing()
+--
+--	PARAMETERS:	none
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	Turns the trace points on. Events recorded before an earlier stopTracing
+--  are kept, so a trace can cover several runs.
+--
+---------------------------------------------------------------------------------*/
+void startTracing()
+{
+	LARGE_INTEGER counter;
+
+	if (baseTicks == 0)
+	{
+		QueryPerformanceCounter(&counter);
+		baseTicks = __rdtsc();
+		baseCounter = counter.QuadPart;
+	}
+	traceEnabled = true;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: stopTracing
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void stopTracing()
+--
+--	PARAMETERS:	none
+--
+--	RETURNS:	void
+--
+---------------------------------------------------------------------------------*/
+void stopTracing()
+{
+	traceEnabled = false;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: traceEvent
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void traceEvent(DWORD point, ULONGLONG start, DWORD value)
+--
+--	PARAMETERS:	DWORD point - TRACE_ constant of the trace point
+--				ULONGLONG start - time stamp counter from TRACE_START
+--				DWORD value - bytes or packets the traced code handled
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	Called through TRACE_END. The head is volatile, and Visual C++ gives
+--  volatile stores release semantics on x86 and x64, so a dump that sees the
+--  new head also sees the event.
+--
+---------------------------------------------------------------------------------*/
+void traceEvent(DWORD point, ULONGLONG start, DWORD value)
+{
+	ULONGLONG end = __rdtsc();
+	TRACE_RING *ring = threadRing;
+	TRACE_SPAN *event;
+	LONG head;
+
+	if (ring == NULL && (ring = newRing()) == NULL)
+	{
+		return;
+	}
+	head = ring->head;
+	event = &(ring->events[head & (TRACE_EVENTS - 1)]);
+	event->start = start;
+	event->end = end;
+	event->point = point;
+	event->value = value;
+	ring->head = head + 1;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: traceThread
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void traceThread(char *name)
+--
+--	PARAMETERS:	char *name - name the calling thread is shown under, a literal
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	Called through TRACE_THREAD, usually at the top of a thread function.
+--  Unnamed threads are shown by their id.
+--
+---------------------------------------------------------------------------------*/
+void traceThread(char *name)
+{
+	threadName = name;
+	if (threadRing != NULL)
+	{
+		strncpy(threadRing->name, name, TRACE_NAME_LENGTH - 1);
+	}
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: releaseTrace
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	void releaseTrace()
+--
+--	PARAMETERS:	none
+--
+--	RETURNS:	void
+--
+--	NOTES:
+--	Called through TRACE_RELEASE by a named thread that is about to end and
+--  whose role will be run again by a new thread, such as a client transfer.
+--  The ring keeps its events and the next thread of the same name records
+--  after them, so the role is one line in the trace however many threads
+--  ran it.
+--
+---------------------------------------------------------------------------------*/
+void releaseTrace()
+{
+	if (threadRing != NULL && threadName != NULL)
+	{
+		threadRing->released = 1;
+		threadRing = NULL;
+	}
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: dumpTrace
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	LONG dumpTrace(char *fileName)
+--
+--	PARAMETERS:	char *fileName - file to write the JSON trace to
+--
+--	RETURNS:	the number of events written, 0 if none were recorded, in which
+--				case no file is written, or -1 if the file could not be written
+--
+--	NOTES:
+--	Tracing may still be on, so each ring is copied before it is written.
+--  Events its thread overwrote while the copy was being taken are left out:
+--  comparing the head before and after shows which they are.
+--
+---------------------------------------------------------------------------------*/
+LONG dumpTrace(char *fileName)
+{
+	TRACE_RING *ring;
+	TRACE_SPAN *copy, *event;
+	HANDLE file;
+	char *buffer;
+	DWORD used = 0, processId = GetCurrentProcessId();
+	LONG threads = ringCount < TRACE_THREADS ? ringCount : TRACE_THREADS;
+	LONG head, first, valid, written = 0;
+	double perMicrosecond;
+	BOOL recorded = false, ok = true;
+
+	for (int i = 0; i < threads; i++)
+	{
+		if (rings[i] != NULL && rings[i]->head > 0)
+		{
+			recorded = true;
+		}
+	}
+	if (!recorded)
+	{
+		return 0;
+	}
+	if ((file = openFile(fileName, false)) == NULL)
+	{
+		return -1;
+	}
+	copy = (TRACE_SPAN *)malloc(sizeof(TRACE_SPAN) * TRACE_EVENTS);
+	buffer = (char *)malloc(TRACE_WRITE_BUFFER);
+	if (copy == NULL || buffer == NULL)
+	{
+		free(copy);
+		free(buffer);
+		closeFile(file);
+		return -1;
+	}
+	perMicrosecond = ticksPerMicrosecond();
+
+	used += sprintf(buffer + used, "{\"otherData\":{\"ticksPerMicrosecond\":\"%.3f\"},\"traceEvents\":[\n", perMicrosecond);
+	used += sprintf(buffer + used, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%lu,\"args\":{\"name\":\"Transport Layer Protocol Analyser\"}}",
+		processId);
+	for (int i = 0; i < threads; i++)
+	{
+		if ((ring = rings[i]) == NULL)
+		{
+			continue;
+		}
+		used += sprintf(buffer + used, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%lu,\"tid\":%lu,\"args\":{\"name\":\"%s\"}}",
+			processId, ring->threadId, ring->name);
+	}
+	for (int i = 0; i < threads && ok; i++)
+	{
+		if ((ring = rings[i]) == NULL)
+		{
+			continue;
+		}
+		head = ring->head;
+		first = head > TRACE_EVENTS ? head - TRACE_EVENTS : 0;
+		for (LONG j = first; j < head; j++)
+		{
+			copy[j - first] = ring->events[j & (TRACE_EVENTS - 1)];
+		}
+		// the event being written when the copy ended may be torn too
+		valid = ring->head - TRACE_EVENTS + 1;
+		for (LONG j = valid > first ? valid : first; j < head && ok; j++)
+		{
+			event = &copy[j - first];
+			if (event->start < baseTicks || event->point >= TRACE_POINT_COUNT)
+			{
+				continue;
+			}
+			used += sprintf(buffer + used, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":%lu,\"tid\":%lu,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"%s\":%lu}}",
+				pointNames[event->point], pointCategories[event->point], processId, ring->threadId,
+				(event->start - baseTicks) / perMicrosecond, (event->end - event->start) / perMicrosecond,
+				pointValues[event->point], event->value);
+			written++;
+			ok = flushTrace(file, buffer, &used, TRACE_WRITE_BUFFER - 512);
+		}
+		ok = ok && flushTrace(file, buffer, &used, TRACE_WRITE_BUFFER - 512);
+	}
+	used += sprintf(buffer + used, "\n]}\n");
+	ok = ok && flushTrace(file, buffer, &used, 0);
+	// the file is opened without truncating it
+	SetEndOfFile(file);
+	closeFile(file);
+	free(copy);
+	free(buffer);
+	return ok ? written : -1;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: newRing
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--				Oct 19, 2026 - reuses a released ring of the same name
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	TRACE_RING *newRing()
+--
+--	PARAMETERS:	none
+--
+--	RETURNS:	the calling thread's ring, or NULL if TRACE_THREADS threads
+--				already have one or there was no memory for it
+--
+--	NOTES:
+--	Rings are never freed, so the events of threads that have exited can still
+--  be dumped. A named thread first looks for a ring a thread of the same name
+--  released.
+--
+---------------------------------------------------------------------------------*/
+TRACE_RING *newRing()
+{
+	TRACE_RING *ring;
+	LONG index, count = ringCount < TRACE_THREADS ? ringCount : TRACE_THREADS;
+
+	for (int i = 0; i < count && threadName != NULL; i++)
+	{
+		if ((ring = rings[i]) != NULL && ring->released && strcmp(ring->name, threadName) == 0
+			&& InterlockedCompareExchange(&(ring->released), 0, 1) == 1)
+		{
+			threadRing = ring;
+			return ring;
+		}
+	}
+	if (ringCount >= TRACE_THREADS || (index = InterlockedIncrement(&ringCount) - 1) >= TRACE_THREADS)
+	{
+		return NULL;
+	}
+	if ((ring = (TRACE_RING *)VirtualAlloc(NULL, sizeof(TRACE_RING), MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE)) == NULL)
+	{
+		return NULL;
+	}
+	ring->threadId = GetCurrentThreadId();
+	if (threadName != NULL)
+	{
+		strncpy(ring->name, threadName, TRACE_NAME_LENGTH - 1);
+	}
+	else {
+		sprintf(ring->name, "thread %lu", ring->threadId);
+	}
+	rings[index] = ring;
+	threadRing = ring;
+	return ring;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: ticksPerMicrosecond
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	double ticksPerMicrosecond()
+--
+--	PARAMETERS:	none
+--
+--	RETURNS:	the time stamp counter's rate
+--
+--	NOTES:
+--	Measured over the time since tracing first started, waiting until at least
+--  100 ms have passed so the reads at either end barely affect it.
+--
+---------------------------------------------------------------------------------*/
+double ticksPerMicrosecond()
+{
+	LARGE_INTEGER frequency, counter;
+	ULONGLONG ticks;
+
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&counter);
+	if (counter.QuadPart - baseCounter < frequency.QuadPart / 10)
+	{
+		Sleep((DWORD)((frequency.QuadPart / 10 - (counter.QuadPart - baseCounter)) * 1000 / frequency.QuadPart) + 1);
+		QueryPerformanceCounter(&counter);
+	}
+	ticks = __rdtsc();
+	return (double)(ticks - baseTicks) * frequency.QuadPart / ((counter.QuadPart - baseCounter) * 1000000.0);
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: flushTrace
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	BOOL flushTrace(HANDLE file, char *buffer, DWORD *used, DWORD room)
+--
+--	PARAMETERS:	HANDLE file - trace file
+--				char *buffer - JSON not yet written
+--				DWORD *used - bytes in the buffer, cleared once they are written
+--				DWORD room - bytes the buffer may hold before it is written
+--
+--	RETURNS:	FALSE if the write failed
+--
+---------------------------------------------------------------------------------*/
+BOOL flushTrace(HANDLE file, char *buffer, DWORD *used, DWORD room)
+{
+	if (*used <= room)
+	{
+		return true;
+	}
+	if (!writeDataToFile(file, buffer, *used))
+	{
+		return false;
+	}
+	*used = 0;
+	return true;
+}
\ No newline at end of file
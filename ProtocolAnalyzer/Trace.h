@@ -0,0 +1,45 @@
+#pragma once
+
+#ifndef TRACE_POINTS
+#define TRACE_POINTS			1		//0 compiles every trace point out
+#endif
+#define TRACE_EVENTS			32768	//events kept per thread, a power of two
+#define TRACE_THREADS			64		//rings that can be made, threads past them are not traced
+#define TRACE_NAME_LENGTH		32
+#define TRACE_WRITE_BUFFER		65536
+#define TRACE_FILE				"trace.json"
+
+// trace points, see pointNames in Trace.cpp
+#define TRACE_UDP_RECEIVE		0
+#define TRACE_TCP_RECEIVE		1
+#define TRACE_UDP_SEND			2
+#define TRACE_TCP_SEND			3
+#define TRACE_RECORD			4
+#define TRACE_SAMPLE			5
+#define TRACE_SNAPSHOT			6
+#define TRACE_FILE_WRITE		7
+#define TRACE_POINT_COUNT		8
+
+// A trace point is a pair: TRACE_START at the top of the traced code and
+// TRACE_END with what it got back, once it is done. While tracing is off
+// TRACE_START costs one load and TRACE_END one compare.
+#if TRACE_POINTS
+#define TRACE_START()					(traceEnabled ? __rdtsc() : 0)
+#define TRACE_END(point, start, value)	((start) != 0 ? traceEvent(point, start, value) : (void)0)
+#define TRACE_THREAD(name)				traceThread(name)
+#define TRACE_RELEASE()					releaseTrace()
+#else
+#define TRACE_START()					0
+#define TRACE_END(point, start, value)	((void)0)
+#define TRACE_THREAD(name)				((void)0)
+#define TRACE_RELEASE()					((void)0)
+#endif
+
+extern volatile BOOL traceEnabled;		//read by every trace point, set by startTracing
+
+void startTracing();
+void stopTracing();
+void traceEvent(DWORD, ULONGLONG, DWORD);
+void traceThread(char *);
+void releaseTrace();
+LONG dumpTrace(char *);
\ No newline at end of file
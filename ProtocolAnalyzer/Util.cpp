@@ -6,7 +6,14 @@
 --	FUNCTIONS:
 --					HANDLE openFile(char* fileName, BOOL readOnly)
 --					BOOL closeFile(HANDLE file)
---					void getData(HANDLE hFile, char * buffer, int size)
+--					BOOL writeDataToFile(HANDLE file, char * data, DWORD length)
+--					int getData(HANDLE hFile, char * buffer, int size)
+--					int setSocketBuffer(SOCKET sd, int option, int size)
+--					DWORD getUdpKernelDrops()
+--					SIZE_T getWorkingSet()
+--					LPFN_WSARECVMSG getRecvMsg(SOCKET sd)
+--					LPFN_CONNECTEX getConnectEx(SOCKET sd)
+--					BOOL waitForThread(HANDLE thread, DWORD timeout)
 --
 --	DATE:			Feb 14, 2016
 --
@@ -127,39 +134,83 @@ BOOL writeToFile(HANDLE file, char * data)
 	return true;
 }
 
+/*---------------------------------------------------------------------------------
+--	FUNCTION: writeDataToFile
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--				Oct 19, 2026 - trace point
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	BOOL writeDataToFile(HANDLE file, char * data, DWORD length)
+--
+--	PARAMETERS:	HANDLE file - handle of file to write to
+--				char * data - data to write to file
+--				DWORD length - number of bytes to write
+--
+--	RETURNS:	true if data was written successfully, false otherwise
+--
+--	NOTES:
+--	Same as writeToFile, but for received data, which is not null terminated
+--  and may contain null bytes.
+--
+---------------------------------------------------------------------------------*/
+BOOL writeDataToFile(HANDLE file, char * data, DWORD length)
+{
+	DWORD charsWritten;
+	ULONGLONG traceStart = TRACE_START();
+	BOOL written = WriteFile(file, data, length, &charsWritten, NULL);
+
+	TRACE_END(TRACE_FILE_WRITE, traceStart, length);
+	if (FALSE == written)
+	{
+		writeToScreen("Unable to write to file");
+		return false;
+	}
+	return true;
+}
+
 /*---------------------------------------------------------------------------------
 --	FUNCTION: getData
 --
 --	DATE:		Feb 14, 2016
 --
 --	REVISIONS:	Feb 14, 2016
+--				Oct 19, 2026 - returns the number of bytes instead of relying on strlen
 --
 --	DESIGNER:	Gabriella Cheung
 --
 --	PROGRAMMER:	Gabriella Cheung
 --
---	INTERFACE:	void getData(HANDLE hFile, char * buffer, int size)
+--	INTERFACE:	int getData(HANDLE hFile, char * buffer, int size)
 --
 --	PARAMETERS:	HANDLE hFile - handle of file to read data from
 --				char * buffer - buffer to save data to
 --				int size - the number of chars to save to buffer
 --
---	RETURNS:	none
+--	RETURNS:	the number of bytes put in the buffer
 --
 --	NOTES:
 --	This function fills the buffer with characters, either read from a file (if
---  file handle is not NULL) or randomly generated.
+--  file handle is not NULL) or randomly generated. File data may contain zero
+--  bytes, so callers must use the count returned rather than strlen, and may
+--  get fewer bytes than they asked for at the end of the file.
 --
 ---------------------------------------------------------------------------------*/
-void getData(HANDLE hFile, char * buffer, int size)
+int getData(HANDLE hFile, char * buffer, int size)
 {
-	DWORD charsRead;
+	DWORD charsRead = size;
 	if (hFile != NULL)
 	{
 		//read from file
 		if (FALSE == ReadFile(hFile, buffer, size, &charsRead, NULL))
 		{
 			writeToScreen("ReadFile failed!");
+			charsRead = 0;
 		}
 	}
 	else {
@@ -173,5 +224,233 @@ void getData(HANDLE hFile, char * buffer, int size)
 			buffer[i] = temp;
 		}
 	}
-	buffer[size] = '\0';
+	buffer[charsRead] = '\0';
+	return charsRead;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: setSocketBuffer
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	int setSocketBuffer(SOCKET sd, int option, int size)
+--
+--	PARAMETERS:	SOCKET sd - socket to configure
+--				int option - SO_RCVBUF or SO_SNDBUF
+--				int size - requested buffer size in bytes, 0 to keep the default
+--
+--	RETURNS:	the buffer size in effect after the call, or -1 on error
+--
+--	NOTES:
+--	This function sets the socket's send or receive buffer and reads the value
+--  back, since the stack is free to round or clamp the requested size.
+--
+---------------------------------------------------------------------------------*/
+int setSocketBuffer(SOCKET sd, int option, int size)
+{
+	int actual = 0;
+	int length = sizeof(actual);
+	char message[256];
+
+	if (size > 0 && setsockopt(sd, SOL_SOCKET, option, (char *)&size, sizeof(size)) == SOCKET_ERROR)
+	{
+		sprintf(message, "setsockopt(%s) failed with error %d",
+			option == SO_RCVBUF ? "SO_RCVBUF" : "SO_SNDBUF", WSAGetLastError());
+		writeToScreen(message);
+	}
+	if (getsockopt(sd, SOL_SOCKET, option, (char *)&actual, &length) == SOCKET_ERROR)
+	{
+		return -1;
+	}
+	return actual;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: getUdpKernelDrops
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	DWORD getUdpKernelDrops()
+--
+--	PARAMETERS:	none
+--
+--	RETURNS:	the number of IPv4 datagrams the stack has discarded on receive
+--
+--	NOTES:
+--	Windows has no per-socket overflow counter, so this reads the system-wide
+--  UDP InErrors counter, which counts datagrams discarded because a socket's
+--  receive buffer was full. Callers take the difference between two readings;
+--  unsigned subtraction handles the counter wrapping.
+--
+---------------------------------------------------------------------------------*/
+DWORD getUdpKernelDrops()
+{
+	MIB_UDPSTATS udpStatistics;
+
+	if (GetUdpStatisticsEx(&udpStatistics, AF_INET) != NO_ERROR)
+	{
+		return 0;
+	}
+	return udpStatistics.dwInErrors;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: getWorkingSet
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	SIZE_T getWorkingSet()
+--
+--	PARAMETERS:	none
+--
+--	RETURNS:	the resident memory of this process in bytes, or 0 on failure
+--
+--	NOTES:
+--	Socket buffers held by the kernel are not part of the working set, so this
+--  only measures what the application itself keeps per connection.
+--
+---------------------------------------------------------------------------------*/
+SIZE_T getWorkingSet()
+{
+	PROCESS_MEMORY_COUNTERS counters;
+
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+	{
+		return 0;
+	}
+	return counters.WorkingSetSize;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: getRecvMsg
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	LPFN_WSARECVMSG getRecvMsg(SOCKET sd)
+--
+--	PARAMETERS:	SOCKET sd - datagram socket the function will be used with
+--
+--	RETURNS:	WSARecvMsg, or NULL if the provider doesn't support it
+--
+--	NOTES:
+--	WSARecvMsg is a Microsoft extension and isn't exported by ws2_32, so it has
+--  to be looked up through the socket. It is the only receive call that
+--  returns control data such as IP_PKTINFO.
+--
+---------------------------------------------------------------------------------*/
+LPFN_WSARECVMSG getRecvMsg(SOCKET sd)
+{
+	LPFN_WSARECVMSG recvMsg = NULL;
+	GUID guid = WSAID_WSARECVMSG;
+	DWORD bytes;
+
+	if (WSAIoctl(sd, SIO_GET_EXTENSION_FUNCTION_POINTER, &guid, sizeof(guid),
+		&recvMsg, sizeof(recvMsg), &bytes, NULL, NULL) == SOCKET_ERROR)
+	{
+		return NULL;
+	}
+	return recvMsg;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: getConnectEx
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	LPFN_CONNECTEX getConnectEx(SOCKET sd)
+--
+--	PARAMETERS:	SOCKET sd - TCP socket the function will be used with
+--
+--	RETURNS:	ConnectEx, or NULL if the provider doesn't support it
+--
+--	NOTES:
+--	ConnectEx is the overlapped connect, looked up like WSARecvMsg. The
+--  socket it is used on must be bound first.
+--
+---------------------------------------------------------------------------------*/
+LPFN_CONNECTEX getConnectEx(SOCKET sd)
+{
+	LPFN_CONNECTEX connectEx = NULL;
+	GUID guid = WSAID_CONNECTEX;
+	DWORD bytes;
+
+	if (WSAIoctl(sd, SIO_GET_EXTENSION_FUNCTION_POINTER, &guid, sizeof(guid),
+		&connectEx, sizeof(connectEx), &bytes, NULL, NULL) == SOCKET_ERROR)
+	{
+		return NULL;
+	}
+	return connectEx;
+}
+
+/*---------------------------------------------------------------------------------
+--	FUNCTION: waitForThread
+--
+--	DATE:		Oct 19, 2026
+--
+--	REVISIONS:	Oct 19, 2026
+--
+--	DESIGNER:	Gabriella Cheung
+--
+--	PROGRAMMER:	Gabriella Cheung
+--
+--	INTERFACE:	BOOL waitForThread(HANDLE thread, DWORD timeout)
+--
+--	PARAMETERS:	HANDLE thread - thread to wait for
+--				DWORD timeout - milliseconds, or INFINITE
+--
+--	RETURNS:	TRUE if the thread ended in time
+--
+--	NOTES:
+--	For the GUI thread. writeToScreen sends to the window's listbox, so a
+--  thread writing to the screen waits for the GUI thread; this delivers the
+--  messages other threads send while it waits, so neither blocks the other.
+--  Posted messages are left in the queue.
+--
+---------------------------------------------------------------------------------*/
+BOOL waitForThread(HANDLE thread, DWORD timeout)
+{
+	MSG msg;
+	ULONGLONG deadline = GetTickCount64() + timeout, now;
+	DWORD result, wait = timeout;
+
+	while ((result = MsgWaitForMultipleObjects(1, &thread, FALSE, wait, QS_SENDMESSAGE)) == WAIT_OBJECT_0 + 1)
+	{
+		PeekMessage(&msg, NULL, 0, 0, PM_NOREMOVE | PM_QS_SENDMESSAGE);
+		if (timeout != INFINITE)
+		{
+			now = GetTickCount64();
+			wait = now < deadline ? (DWORD)(deadline - now) : 0;
+		}
+	}
+	return result == WAIT_OBJECT_0;
 }
\ No newline at end of file
@@ -2,4 +2,11 @@
 HANDLE openFile(char*, BOOL);
 BOOL closeFile(HANDLE);
 BOOL writeToFile(HANDLE, char *);
-void getData(HANDLE, char *, int);
\ No newline at end of file
+BOOL writeDataToFile(HANDLE, char *, DWORD);
+int getData(HANDLE, char *, int);
+int setSocketBuffer(SOCKET, int, int);
+DWORD getUdpKernelDrops();
+SIZE_T getWorkingSet();
+LPFN_WSARECVMSG getRecvMsg(SOCKET);
+LPFN_CONNECTEX getConnectEx(SOCKET);
+BOOL waitForThread(HANDLE, DWORD);
\ No newline at end of file
@@ -3,15 +3,49 @@
 #define _WINSOCK_DEPRECATED_NO_WARNINGS
 
 #include <winsock2.h>
+#include <ws2tcpip.h>
+#include <mswsock.h>
+#include <mstcpip.h>
+#include <iphlpapi.h>
+#include <psapi.h>
+#include <setupapi.h>
+#include <winternl.h>
+#include <intrin.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
+#include <math.h>
 
+#include "Pool.h"
+#include "Checksum.h"
+#include "Cost.h"
+#include "Trace.h"
+#include "Placement.h"
+#include "Stats.h"
+#include "Timestamp.h"
+#include "TcpInfo.h"
+#include "Flow.h"
+#include "Multicast.h"
+#include "Capture.h"
+#include "Dissect.h"
+#include "Passive.h"
+#include "Replay.h"
+#include "Profile.h"
+#include "Impair.h"
+#include "Local.h"
+#include "Message.h"
+#include "Reliable.h"
+#include "Congestion.h"
+#include "Swarm.h"
 #include "Client.h"
 #include "Server.h"
 #include "Util.h"
 
 #pragma comment(lib, "WS2_32.Lib")
+#pragma comment(lib, "IPHLPAPI.Lib")
+#pragma comment(lib, "Psapi.Lib")
+#pragma comment(lib, "Winmm.Lib")
+#pragma comment(lib, "Setupapi.Lib")
 
 #define IDM_HELP		101
 #define IDM_EXIT		102
@@ -44,10 +78,63 @@
 #define IDC_SAVEFILELABEL	127
 #define IDC_SAVEFILEEDIT	128
 #define IDOPENSAVEFILE	129
+#define IDC_SNDBUFLABEL	130
+#define IDC_SNDBUFEDIT	131
+#define IDC_RCVBUFLABEL	132
+#define IDC_RCVBUFEDIT	133
+#define IDC_AUTOTUNECHECK	134
+#define IDC_FRAMECHECK	135
+#define IDC_PCAPNGCHECK	136
+#define IDC_REPLAYCHECK	137
+#define IDC_SPEEDEDIT	138
+#define IDC_SPEEDLABEL	139
+#define IDC_PROFILELABEL	140
+#define IDC_PROFILEEDIT	141
+#define IDC_INTEGRITYCHECK	142
+#define IDC_TTLLABEL	143
+#define IDC_TTLEDIT		144
+#define IDC_LOOPBACKCHECK	145
+#define IDC_MCASTIFLABEL	146
+#define IDC_MCASTIFEDIT	147
+#define IDC_GROUPSLABEL	148
+#define IDC_GROUPSEDIT	149
+#define IDC_DURATIONLABEL	150
+#define IDC_DURATIONEDIT	151
+#define IDC_WARMUPLABEL	152
+#define IDC_WARMUPEDIT	153
+#define IDC_COOLDOWNLABEL	154
+#define IDC_COOLDOWNEDIT	155
+#define IDC_IMPAIRLABEL	156
+#define IDC_IMPAIREDIT	157
+#define IDC_UNIXRADIO	158
+#define IDC_RINGRADIO	159
+#define IDC_RELIABLECHECK	160
+#define IDC_CONGESTIONLABEL	161
+#define IDC_CONGESTIONEDIT	162
+#define IDM_TRACE		163
+#define IDM_DUMPTRACE	164
+#define IDC_PLACEMENTLABEL	165
+#define IDC_PLACEMENTEDIT	166
+#define IDC_BUSYPOLLCHECK	167
+#define IDC_SPINLABEL		168
+#define IDC_SPINEDIT		169
+#define IDC_PASSIVELABEL	170
+#define IDC_PASSIVEEDIT	171
+#define IDC_FILTERLABEL	172
+#define IDC_FILTEREDIT	173
+#define IDM_BENCHMARK	174
+#define IDC_TCPCCLABEL	175
+#define IDC_TCPCCEDIT	176
+#define IDC_MATRIXLABEL	177
+#define IDC_MATRIXEDIT	178
+#define IDC_SWARMLABEL	179
+#define IDC_SWARMEDIT	180
 
 #define UDPSERVPORT 7000
 #define TCPSERVPORT 8000
 #define PACKETSIZE	1024
 #define NUMOFPACKETS 10
+#define RCVBUF_AUTOTUNE_MAX	(64 * 1024 * 1024)	//cap for receive buffer autotuning
+#define DROP_SAMPLE_INTERVAL	100		//ms between kernel drop counter samples
 
 void writeToScreen(LPCSTR);